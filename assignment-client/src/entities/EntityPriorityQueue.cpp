@@ -14,6 +14,7 @@
 const float PrioritizedEntity::DO_NOT_SEND = -1.0e-6f;
 const float PrioritizedEntity::FORCE_REMOVE = -1.0e-5f;
 const float PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY = 1.0f;
+const float PrioritizedEntity::OUT_OF_RANGE_PRIORITY = 1.0e-5f;
 
 void ConicalView::set(const ViewFrustum& viewFrustum) {
     // The ConicalView has two parts: a central sphere (same as ViewFrustum) and a circular cone that bounds the frustum part.
@@ -41,6 +41,7 @@ public:
     static const float DO_NOT_SEND;
     static const float FORCE_REMOVE;
     static const float WHEN_IN_DOUBT_PRIORITY;
+    static const float OUT_OF_RANGE_PRIORITY;
 
     PrioritizedEntity(EntityItemPointer entity, float priority, bool forceRemove = false) : _weakEntity(entity), _rawEntityPointer(entity.get()), _priority(priority), _forceRemove(forceRemove) {}
     EntityItemPointer getEntity() const { return _weakEntity.lock(); }
@@ -12,7 +12,8 @@
 #include <QtCore/QEventLoop>
 #include <QTimer>
 #include <EntityTree.h>
-#include <SimpleEntitySimulation.h>
+#include <ServerPhysicalEntitySimulation.h>
+#include <PhysicsHelpers.h>
 #include <ResourceCache.h>
 #include <ScriptCache.h>
 #include <EntityEditFilters.h>
@@ -34,6 +35,7 @@ const char* LOCAL_MODELS_PERSIST_FILE = "resources/models.svo";
 EntityServer::EntityServer(ReceivedMessage& message) :
     OctreeServer(message),
     _entitySimulation(NULL),
+    _workloadViewsTimer(this),
     _dynamicDomainVerificationTimer(this)
 {
     DependencyManager::set<ResourceManager>();
@@ -53,6 +55,8 @@ EntityServer::EntityServer(ReceivedMessage& message) :
 
     connect(&_dynamicDomainVerificationTimer, &QTimer::timeout, this, &EntityServer::startDynamicDomainVerification);
     _dynamicDomainVerificationTimer.setSingleShot(true);
+
+    connect(&_workloadViewsTimer, &QTimer::timeout, this, &EntityServer::updateWorkloadViews);
 }
 
 EntityServer::~EntityServer() {
@@ -86,10 +90,10 @@ OctreePointer EntityServer::createTree() {
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
     if (!_entitySimulation) {
-        SimpleEntitySimulationPointer simpleSimulation { new SimpleEntitySimulation() };
-        simpleSimulation->setEntityTree(tree);
-        tree->setSimulation(simpleSimulation);
-        _entitySimulation = simpleSimulation;
+        ServerPhysicalEntitySimulationPointer simulation { new ServerPhysicalEntitySimulation() };
+        simulation->setEntityTree(tree);
+        tree->setSimulation(simulation);
+        _entitySimulation = simulation;
     }
 
     DependencyManager::registerInheritance<SpatialParentFinder, AssignmentParentFinder>();
@@ -343,6 +347,78 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
         
         entityEditFilters->addFilter(EntityItemID(), filterURL);
     }
+
+    bool wantServerPhysics = false;
+    readOptionBool(QString("serverPhysics"), settingsSectionObject, wantServerPhysics);
+    qDebug("serverPhysics=%s", debug::valueOf(wantServerPhysics));
+    if (wantServerPhysics) {
+        const int DEFAULT_SERVER_PHYSICS_RATE = 30; // Hz
+        int serverPhysicsRate = DEFAULT_SERVER_PHYSICS_RATE;
+        if (!readOptionInt("serverPhysicsRate", settingsSectionObject, serverPhysicsRate) || serverPhysicsRate <= 0) {
+            serverPhysicsRate = DEFAULT_SERVER_PHYSICS_RATE;
+        }
+        int serverPhysicsBudget = 0;
+        if (!readOptionInt("serverPhysicsBudget", settingsSectionObject, serverPhysicsBudget) || serverPhysicsBudget < 0) {
+            serverPhysicsBudget = 0;
+        }
+
+        auto nodeList = DependencyManager::get<NodeList>();
+        Physics::setSessionUUID(nodeList->getSessionUUID());
+        _entitySimulation->setSessionID(nodeList->getSessionUUID());
+        connect(nodeList.data(), &NodeList::uuidChanged, this, &EntityServer::sessionUUIDChanged);
+
+        _entitySimulation->setTickPeriod(USECS_PER_SECOND / (uint64_t)serverPhysicsRate);
+        _entitySimulation->setStepBudget((uint64_t)serverPhysicsBudget * USECS_PER_MSEC);
+    }
+    _entitySimulation->setPhysicsEnabled(wantServerPhysics);
+
+    bool wantServerWorkload = false;
+    readOptionBool(QString("serverWorkload"), settingsSectionObject, wantServerWorkload);
+    qDebug("serverWorkload=%s", debug::valueOf(wantServerWorkload));
+    if (wantServerWorkload) {
+        const int DEFAULT_WORKLOAD_FULL_RATE_RADIUS = 200; // meters
+        const int DEFAULT_WORKLOAD_RADIUS = 1000;
+        int fullRateRadius = DEFAULT_WORKLOAD_FULL_RATE_RADIUS;
+        if (!readOptionInt("serverWorkloadFullRateRadius", settingsSectionObject, fullRateRadius) || fullRateRadius <= 0) {
+            fullRateRadius = DEFAULT_WORKLOAD_FULL_RATE_RADIUS;
+        }
+        int radius = DEFAULT_WORKLOAD_RADIUS;
+        if (!readOptionInt("serverWorkloadRadius", settingsSectionObject, radius) || radius <= 0) {
+            radius = DEFAULT_WORKLOAD_RADIUS;
+        }
+        const float NEAR_FRACTION_OF_FULL_RATE_RADIUS = 0.25f;
+        _entitySimulation->setWorkloadRadiuses(NEAR_FRACTION_OF_FULL_RATE_RADIUS * (float)fullRateRadius,
+            (float)fullRateRadius, (float)radius);
+
+        const int WORKLOAD_VIEWS_INTERVAL_MSECS = 100;
+        _workloadViewsTimer.start(WORKLOAD_VIEWS_INTERVAL_MSECS);
+    } else {
+        _workloadViewsTimer.stop();
+    }
+    tree->withWriteLock([&] {
+        _entitySimulation->setWorkloadEnabled(wantServerWorkload);
+    });
+}
+
+void EntityServer::updateWorkloadViews() {
+    // agents that don't use a frustum receive everything and aren't viewers in space
+    std::vector<glm::vec3> viewPositions;
+    DependencyManager::get<NodeList>()->eachNode([&viewPositions](const SharedNodePointer& node) {
+        EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
+        if (nodeData && nodeData->getUsesFrustum()) {
+            ViewFrustum viewFrustum;
+            nodeData->copyCurrentViewFrustum(viewFrustum);
+            viewPositions.push_back(viewFrustum.getPosition());
+        }
+    });
+    _entitySimulation->setWorkloadViews(viewPositions);
+}
+
+void EntityServer::sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID) {
+    Physics::setSessionUUID(sessionUUID);
+    if (_entitySimulation) {
+        _entitySimulation->setSessionID(sessionUUID);
+    }
 }
 
 void EntityServer::entityFilterAdded(EntityItemID id, bool success) {
@@ -397,6 +473,21 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    if (_entitySimulation) {
+        statsString += "<b>Entity Server Physics Statistics</b>\r\n";
+        statsString += _entitySimulation->getStatsString();
+        statsString += "\r\n\r\n";
+
+        statsString += "<b>Entity Server Workload Statistics</b>\r\n";
+        if (_entitySimulation->isWorkloadEnabled()) {
+            statsString += QString("     Far kinematic entities: %1\r\n").arg(_entitySimulation->getNumFarKinematicEntities());
+            statsString += QString("Sleeping kinematic entities: %1\r\n").arg(_entitySimulation->getNumSleepingKinematicEntities());
+        } else {
+            statsString += "    disabled\r\n";
+        }
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
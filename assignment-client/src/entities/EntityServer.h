@@ -27,8 +27,8 @@ struct ViewerSendingStats {
     quint64 lastEdited;
 };
 
-class SimpleEntitySimulation;
-using SimpleEntitySimulationPointer = std::shared_ptr<SimpleEntitySimulation>;
+class ServerPhysicalEntitySimulation;
+using ServerPhysicalEntitySimulationPointer = std::shared_ptr<ServerPhysicalEntitySimulation>;
 
 class EntityServer : public OctreeServer, public NewlyCreatedEntityHook {
     Q_OBJECT
@@ -73,10 +73,13 @@ protected:
 private slots:
     void handleEntityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void domainSettingsRequestFailed();
+    void sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID);
+    void updateWorkloadViews();
 
 private:
-    SimpleEntitySimulationPointer _entitySimulation;
+    ServerPhysicalEntitySimulationPointer _entitySimulation;
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
+    QTimer _workloadViewsTimer;
 
     QReadWriteLock _viewerSendingStatsLock;
     QMap<QUuid, QMap<QUuid, ViewerSendingStats>> _viewerSendingStats;
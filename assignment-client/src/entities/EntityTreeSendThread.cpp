@@ -313,9 +313,8 @@ void EntityTreeSendThread::startNewTraversal(const ViewFrustum& view, EntityTree
                                 }
                             } else if (entity->getLastEdited() > knownTimestamp->second
                                     || entity->getLastChangedOnServer() > knownTimestamp->second) {
-                                // it is known and it changed --> put it on the queue with any priority
-                                // TODO: sort these correctly
-                                _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY));
+                                // it is known and it changed --> put it on the queue
+                                _sendQueue.push(PrioritizedEntity(entity, computeChangedEntityPriority(entity)));
                                 _entitiesInQueue.insert(entity.get());
                             }
                         });
@@ -387,9 +386,8 @@ void EntityTreeSendThread::startNewTraversal(const ViewFrustum& view, EntityTree
                         }
                     } else if (entity->getLastEdited() > knownTimestamp->second
                             || entity->getLastChangedOnServer() > knownTimestamp->second) {
-                        // it is known and it changed --> put it on the queue with any priority
-                        // TODO: sort these correctly
-                        _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY));
+                        // it is known and it changed --> put it on the queue
+                        _sendQueue.push(PrioritizedEntity(entity, computeChangedEntityPriority(entity)));
                         _entitiesInQueue.insert(entity.get());
                     }
                 });
@@ -398,6 +396,25 @@ void EntityTreeSendThread::startNewTraversal(const ViewFrustum& view, EntityTree
     }
 }
 
+float EntityTreeSendThread::computeChangedEntityPriority(const EntityItemPointer& entity) const {
+    // The workload region of the entity is relative to the closest viewer, so when it is far or out of range
+    // it is at least as far from this one and there is no need to sort it any further.
+    if (entity->isFarFromViewers()) {
+        return PrioritizedEntity::OUT_OF_RANGE_PRIORITY;
+    }
+    bool success = false;
+    AACube cube = entity->getQueryAACube(success);
+    if (!success) {
+        return PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY;
+    }
+    float priority = _conicalView.computePriority(cube);
+    if (priority == PrioritizedEntity::DO_NOT_SEND) {
+        // it went out of view but the viewer still knows it, so it gets the change after what is in view
+        return PrioritizedEntity::OUT_OF_RANGE_PRIORITY;
+    }
+    return priority;
+}
+
 bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) {
     if (_sendQueue.empty()) {
         OctreeServer::trackEncodeTime(OctreeServer::SKIP_TIME);
@@ -52,6 +52,26 @@ void messageHandler(QtMsgType type, const QMessageLogContext& context, const QSt
 
 int EntityScriptServer::_entitiesScriptEngineCount = 0;
 
+static const int MAX_NUM_SHARDS = 16;
+
+size_t EntityScriptServerShardRouter::shardIndexForEntity(const EntityItemID& entityID, size_t numShards) {
+    return numShards > 1 ? qHash(entityID) % numShards : 0;
+}
+
+void EntityScriptServerShardRouter::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                           const QStringList& params, const QUuid& remoteCallerID) {
+    if (!_engines.empty()) {
+        _engines[shardIndexForEntity(entityID, _engines.size())]->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+    }
+}
+
+QFuture<QVariant> EntityScriptServerShardRouter::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    if (_engines.empty()) {
+        return QFuture<QVariant>();
+    }
+    return _engines[shardIndexForEntity(entityID, _engines.size())]->getLocalEntityScriptDetails(entityID);
+}
+
 EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssignment(message) {
     qInstallMessageHandler(messageHandler);
 
@@ -108,9 +128,11 @@ void EntityScriptServer::handleReloadEntityServerScriptPacket(QSharedPointer<Rec
     if (senderNode->getCanRez() || senderNode->getCanRezTmp() || senderNode->getCanRezCertified() || senderNode->getCanRezTmpCertified()) {
         auto entityID = QUuid::fromRfc4122(message->read(NUM_BYTES_RFC4122_UUID));
 
-        if (_entityViewer.getTree() && !_shuttingDown) {
+        if (_entityViewer.getTree() && !_shuttingDown && !_shards.empty()) {
             qCDebug(entity_script_server) << "Reloading: " << entityID;
-            _entitiesScriptEngine->unloadEntityScript(entityID);
+            postToShard(shardForEntity(entityID), [entityID](ScriptEngine& engine) {
+                engine.unloadEntityScript(entityID);
+            });
             checkAndCallPreload(entityID, true);
         }
     }
@@ -126,7 +148,7 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        if (!_shards.empty() && shardForEntity(entityID)->engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -163,6 +185,19 @@ void EntityScriptServer::handleSettings() {
         return;
     }
 
+    static const QString NUM_SCRIPT_ENGINES_OPTION = "num_script_engines";
+    if (entityScriptServerSettings.contains(NUM_SCRIPT_ENGINES_OPTION)) {
+        int numShards = std::min(std::max(1, entityScriptServerSettings[NUM_SCRIPT_ENGINES_OPTION].toInt()), MAX_NUM_SHARDS);
+        if (numShards != _numShards) {
+            qCDebug(entity_script_server) << "Running entity server scripts on" << numShards << "script engines";
+            _numShards = numShards;
+            if (!_shards.empty()) {
+                // scripts are reloaded from scratch as the entity viewer hears about the entities again
+                clear();
+            }
+        }
+    }
+
     _maxEntityPPS = std::max(0, entityScriptServerSettings[MAX_ENTITY_PPS_OPTION].toInt());
     _entityPPSPerScript = std::max(0, entityScriptServerSettings[ENTITY_PPS_PER_SCRIPT].toInt());
 
@@ -171,7 +206,10 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    for (auto& shard : _shards) {
+        numRunningScripts += shard->engine->getNumRunningEntityScripts();
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -233,8 +271,8 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
-        auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
+    if (!_shards.empty() && _entityViewer.getTree() && !_shuttingDown) {
+        EntityItemID entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
 
@@ -247,7 +285,10 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        QUuid senderID = senderNode->getUUID();
+        postToShard(shardForEntity(entityID), [entityID, method, params, senderID](ScriptEngine& engine) {
+            engine.callEntityScriptMethod(entityID, method, params, senderID);
+        });
     }
 }
 
@@ -274,8 +315,8 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines
+    resetEntitiesScriptEngines();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     entityScriptingInterface->init();
@@ -431,7 +472,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::newEntitiesScriptEngine() {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -447,86 +488,141 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
+
+    newEngine->runInThread();
+    return newEngine;
+}
+
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    std::vector<EntityScriptServerShardPointer> newShards;
+    std::vector<ScriptEnginePointer> engines;
+    for (int i = 0; i < _numShards; ++i) {
+        auto shard = std::make_shared<EntityScriptServerShard>();
+        shard->engine = newEntitiesScriptEngine();
+        shard->lastStatsTime = usecTimestampNow();
+        engines.push_back(shard->engine);
+        newShards.push_back(shard);
+    }
+
+    // every engine ticks at the same rate so we only need one of them to drive the entity viewer
+    connect(engines[0].data(), &ScriptEngine::update, this, [this] {
         _entityViewer.queryOctree();
         _entityViewer.getTree()->update();
     });
 
+    auto router = QSharedPointer<EntityScriptServerShardRouter>::create(engines);
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(router);
 
-    newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
-
-    disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-               this, &EntityScriptServer::updateEntityPPS);
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    _shards.swap(newShards);
 }
 
-
 void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
-        // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
+    // unload and stop the engines
+    // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
+    for (auto& shard : _shards) {
+        shard->engine->unloadAllEntityScripts();
+        shard->engine->stop();
+    }
+    for (auto& shard : _shards) {
+        disconnect(shard->engine.data(), nullptr, this, nullptr);
+        shard->engine->waitTillDoneRunning();
     }
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 }
 
-void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+void EntityScriptServer::shutdownScriptEngines() {
+    for (auto& shard : _shards) {
+        shard->engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
     clear(); // always clear() on shutdown
 }
 
+const EntityScriptServerShardPointer& EntityScriptServer::shardForEntity(const EntityItemID& entityID) const {
+    return _shards[EntityScriptServerShardRouter::shardIndexForEntity(entityID, _shards.size())];
+}
+
+void EntityScriptServer::postToShard(const EntityScriptServerShardPointer& shard, std::function<void(ScriptEngine&)> call) {
+    // run the call on the shard's own thread so we can track how far behind it is
+    ++shard->queueDepth;
+    ScriptEnginePointer engine = shard->engine;
+    QMetaObject::invokeMethod(engine.data(), [shard, engine, call] {
+        --shard->queueDepth;
+        call(*engine);
+    }, Qt::QueuedConnection);
+}
+
 void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
     checkAndCallPreload(entityID);
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown && !_shards.empty()) {
+        postToShard(shardForEntity(entityID), [entityID](ScriptEngine& engine) {
+            engine.unloadEntityScript(entityID, true);
+        });
     }
 }
 
 void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown && !_shards.empty()) {
+        postToShard(shardForEntity(entityID), [entityID](ScriptEngine& engine) {
+            engine.unloadEntityScript(entityID, true);
+        });
         checkAndCallPreload(entityID, reload);
     }
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && !_shards.empty()) {
+        auto& shard = shardForEntity(entityID);
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool notRunning = !_entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        bool notRunning = !shard->engine->getEntityScriptDetails(entityID, details);
         if (entity && (reload || notRunning || details.scriptText != entity->getServerScripts())) {
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
                 qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
+                postToShard(shard, [entityID, scriptUrl, reload](ScriptEngine& engine) {
+                    engine.loadEntityScript(entityID, scriptUrl, reload);
+                });
             }
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    QJsonObject statsObject, shardsObject;
+
+    uint64_t now = usecTimestampNow();
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        auto& shard = _shards[i];
+        uint64_t executionTime = shard->engine->getTotalExecutionTime();
+        uint64_t elapsed = now - shard->lastStatsTime;
+
+        QJsonObject shardStats;
+        shardStats["num_running_scripts"] = shard->engine->getNumRunningEntityScripts();
+        shardStats["queue_depth"] = shard->queueDepth.load();
+        shardStats["cpu_usec_per_sec"] = elapsed > 0 ?
+            (double)(executionTime - shard->lastExecutionTime) * USECS_PER_SECOND / (double)elapsed : 0.0;
+        shardsObject[QString::number(i)] = shardStats;
+
+        shard->lastExecutionTime = executionTime;
+        shard->lastStatsTime = now;
+    }
 
+    statsObject["script_engines"] = shardsObject;
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -559,7 +655,7 @@ void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> mess
 }
 
 void EntityScriptServer::aboutToFinish() {
-    shutdownScriptEngine();
+    shutdownScriptEngines();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
@@ -12,6 +12,9 @@
 #ifndef hifi_EntityScriptServer_h
 #define hifi_EntityScriptServer_h
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -24,6 +27,31 @@
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
 
+// One ScriptEngine thread that runs the server scripts of a subset of the entities
+class EntityScriptServerShard {
+public:
+    ScriptEnginePointer engine;
+    std::atomic<int> queueDepth { 0 }; // calls posted to the engine thread that haven't run yet
+    uint64_t lastExecutionTime { 0 }; // engine execution time at the previous stats packet (usec)
+    uint64_t lastStatsTime { 0 };
+};
+using EntityScriptServerShardPointer = std::shared_ptr<EntityScriptServerShard>;
+
+// Forwards calls made through the EntityScriptingInterface to the shard that runs the entity's script
+class EntityScriptServerShardRouter : public EntitiesScriptEngineProvider {
+public:
+    EntityScriptServerShardRouter(const std::vector<ScriptEnginePointer>& engines) : _engines(engines) {}
+
+    static size_t shardIndexForEntity(const EntityItemID& entityID, size_t numShards);
+
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+private:
+    std::vector<ScriptEnginePointer> _engines;
+};
+
 class EntityScriptServer : public ThreadedAssignment {
     Q_OBJECT
 
@@ -60,9 +88,13 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    void resetEntitiesScriptEngines();
+    ScriptEnginePointer newEntitiesScriptEngine();
     void clear();
-    void shutdownScriptEngine();
+    void shutdownScriptEngines();
+
+    const EntityScriptServerShardPointer& shardForEntity(const EntityItemID& entityID) const;
+    void postToShard(const EntityScriptServerShardPointer& shard, std::function<void(ScriptEngine&)> call);
 
     void addingEntity(const EntityItemID& entityID);
     void deletingEntity(const EntityItemID& entityID);
@@ -74,7 +106,8 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    std::vector<EntityScriptServerShardPointer> _shards;
+    int _numShards { 1 };
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -330,8 +330,6 @@ static const QString RENDER_FORWARD{ "HIFI_RENDER_FORWARD" };
 static bool DISABLE_DEFERRED = QProcessEnvironment::systemEnvironment().contains(RENDER_FORWARD);
 #endif
 
-static const int MAX_CONCURRENT_RESOURCE_DOWNLOADS = 16;
-
 // For processing on QThreadPool, we target a number of threads after reserving some
 // based on how many are being consumed by the application and the display plugin.  However,
 // we will never drop below the 'min' value
@@ -1224,13 +1222,13 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     connect(&_entityEditSender, &EntityEditPacketSender::packetSent, this, &Application::packetSent);
     connect(&_entityEditSender, &EntityEditPacketSender::addingEntityWithCertificate, this, &Application::addingEntityWithCertificate);
 
+    // by default the number of concurrent downloads adapts to each origin, unless a fixed limit is given
     QString concurrentDownloadsStr = getCmdOption(argc, constArgv, "--concurrent-downloads");
     bool success;
     int concurrentDownloads = concurrentDownloadsStr.toInt(&success);
-    if (!success) {
-        concurrentDownloads = MAX_CONCURRENT_RESOURCE_DOWNLOADS;
+    if (success) {
+        ResourceCache::setRequestLimit(concurrentDownloads);
     }
-    ResourceCache::setRequestLimit(concurrentDownloads);
 
     // perhaps override the avatar url.  Since we will test later for validity
     // we don't need to do so here.
@@ -2298,7 +2296,7 @@ void Application::cleanupBeforeQuit() {
     // removal of the items.
     // See https://highfidelity.fogbugz.com/f/cases/5328
     _main3DScene->enqueueFrame(); // flush all the transactions
-    _main3DScene->processTransactionQueue(); // process and apply deletions
+    _main3DScene->flushTransactionQueue(); // process and apply deletions, regardless of the transaction budget
 
     // first stop all timers directly or by invokeMethod
     // depending on what thread they run in
@@ -4661,6 +4659,9 @@ void Application::init() {
         return atan2(maxSize, distance);
     });
 
+    // build collision hulls and meshes off the main thread and keep them between sessions
+    _shapeManager.setAsyncEnabled(true);
+    _shapeManager.setDiskCacheDirectory(PathUtils::getAppLocalDataPath() + "shape_cache/");
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
 
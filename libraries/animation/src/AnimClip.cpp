@@ -43,15 +43,15 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
 
     // poll network anim to see if it's finished loading yet.
     if (_networkAnim && _networkAnim->isLoaded() && _skeleton) {
-        // loading is complete, copy animation frames from network animation, then throw it away.
+        // loading is complete, get the compressed animation frames for our skeleton, then throw it away.
         copyFromNetworkAnim();
         _networkAnim.reset();
     }
 
-    if (_anim.size()) {
+    if (_anim && _anim->getNumFrames() > 0) {
 
         // lazy creation of mirrored animation frames.
-        if (_mirrorFlag && _anim.size() != _mirrorAnim.size()) {
+        if (_mirrorFlag && !_mirrorAnim) {
             buildMirrorAnim();
         }
 
@@ -65,15 +65,14 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = (int)_anim.size();
+        int frameCount = _anim->getNumFrames();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _mirrorFlag ? _mirrorAnim[prevIndex] : _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _mirrorFlag ? _mirrorAnim[nextIndex] : _anim[nextIndex];
+        const AnimClipData& anim = _mirrorFlag ? *_mirrorAnim : *_anim;
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        anim.evaluate(prevIndex, nextIndex, alpha, &_poses[0]);
     }
 
     return _poses;
@@ -94,89 +93,29 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 
 void AnimClip::copyFromNetworkAnim() {
     assert(_networkAnim && _networkAnim->isLoaded() && _skeleton);
-    _anim.clear();
-
-    // build a mapping from animation joint indices to skeleton joint indices.
-    // by matching joints with the same name.
-    const FBXGeometry& geom = _networkAnim->getGeometry();
-    AnimSkeleton animSkeleton(geom);
-    const auto animJointCount = animSkeleton.getNumJoints();
-    const auto skeletonJointCount = _skeleton->getNumJoints();
-    std::vector<int> jointMap;
-    jointMap.reserve(animJointCount);
-    for (int i = 0; i < animJointCount; i++) {
-        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(i));
-        if (skeletonJoint == -1) {
-            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << _url;
-        }
-        jointMap.push_back(skeletonJoint);
-    }
-
-    const int frameCount = geom.animationFrames.size();
-    _anim.resize(frameCount);
-
-    for (int frame = 0; frame < frameCount; frame++) {
-
-        const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
-
-        // init all joints in animation to default pose
-        // this will give us a resonable result for bones in the model skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
-        for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
-        }
-
-        for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
-            int skeletonJoint = jointMap[animJoint];
-
-            const glm::vec3& fbxAnimTrans = fbxAnimFrame.translations[animJoint];
-            const glm::quat& fbxAnimRot = fbxAnimFrame.rotations[animJoint];
-
-            // skip joints that are in the animation but not in the skeleton.
-            if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
 
-                AnimPose preRot, postRot;
-                preRot = animSkeleton.getPreRotationPose(animJoint);
-                postRot = animSkeleton.getPostRotationPose(animJoint);
-
-                // cancel out scale
-                preRot.scale() = glm::vec3(1.0f);
-                postRot.scale() = glm::vec3(1.0f);
-
-                AnimPose rot(glm::vec3(1.0f), fbxAnimRot, glm::vec3());
-
-                // adjust translation offsets, so large translation animatons on the reference skeleton
-                // will be adjusted when played on a skeleton with short limbs.
-                const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint];
-                const AnimPose& relDefaultPose = _skeleton->getRelativeDefaultPose(skeletonJoint);
-                float boneLengthScale = 1.0f;
-                const float EPSILON = 0.0001f;
-                if (fabsf(glm::length(fbxZeroTrans)) > EPSILON) {
-                    boneLengthScale = glm::length(relDefaultPose.trans()) / glm::length(fbxZeroTrans);
-                }
-
-                AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans() + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
-
-                _anim[frame][skeletonJoint] = trans * preRot * rot * postRot;
-            }
-        }
-    }
+    _animURL = _networkAnim->getURL();
+    _anim = DependencyManager::get<AnimationCache>()->getClipData(_animURL, *_skeleton, false, [&] {
+        return AnimClipData::retarget(_networkAnim->getGeometry(), *_skeleton, _url);
+    });
 
     // mirrorAnim will be re-built on demand, if needed.
-    _mirrorAnim.clear();
+    _mirrorAnim.reset();
 
-    _poses.resize(skeletonJointCount);
+    _poses.resize(_skeleton->getNumJoints());
 }
 
 void AnimClip::buildMirrorAnim() {
-    assert(_skeleton);
+    assert(_skeleton && _anim);
 
-    _mirrorAnim.clear();
-    _mirrorAnim.reserve(_anim.size());
-    for (auto& relPoses : _anim) {
-        _mirrorAnim.push_back(relPoses);
-        _skeleton->mirrorRelativePoses(_mirrorAnim.back());
-    }
+    _mirrorAnim = DependencyManager::get<AnimationCache>()->getClipData(_animURL, *_skeleton, true, [&] {
+        std::vector<AnimPoseVec> frames(_anim->getNumFrames(), AnimPoseVec(_anim->getNumJoints()));
+        for (int frame = 0; frame < _anim->getNumFrames(); frame++) {
+            _anim->evaluate(frame, &frames[frame][0]);
+            _skeleton->mirrorRelativePoses(frames[frame]);
+        }
+        return frames;
+    });
 }
 
 const AnimPoseVec& AnimClip::getPosesInternal() const {
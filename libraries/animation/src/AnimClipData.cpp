@@ -0,0 +1,433 @@
+//
+//  AnimClipData.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimClipData.h"
+
+#include <algorithm>
+
+#include <GLMHelpers.h>
+
+#include "AnimationLogging.h"
+#include "AnimUtil.h"
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
+
+const float AnimClipData::ROTATION_TOLERANCE = 0.001f;
+const float AnimClipData::TRANSLATION_TOLERANCE = 0.001f;
+const int AnimClipData::MAX_FRAMES;
+
+// Longest run of frames a key reduction will span.  It keeps the search linear in the number of frames and bounds
+// the error of long, nearly linear runs.
+static const int MAX_KEY_SPAN = 32;
+
+// Picks the frames to keep as keys: the first, the last, and every frame that the keys around it can't interpolate
+// within tolerance.  A constant track keeps only its first frame.
+template <typename T, typename Lerp, typename Within>
+static std::vector<int> reduceKeys(const std::vector<T>& values, Lerp lerpValues, Within within) {
+    const int numValues = (int)values.size();
+    std::vector<int> keys { 0 };
+
+    bool constant = true;
+    for (int i = 1; i < numValues && constant; i++) {
+        constant = within(values[0], values[i]);
+    }
+    if (constant) {
+        return keys;
+    }
+
+    int key = 0;
+    while (key < numValues - 1) {
+        int next = key + 1;
+        while (next + 1 < numValues && next + 1 - key <= MAX_KEY_SPAN) {
+            int candidate = next + 1;
+            bool fits = true;
+            for (int i = key + 1; i < candidate && fits; i++) {
+                float weight = (float)(i - key) / (float)(candidate - key);
+                fits = within(lerpValues(values[key], values[candidate], weight), values[i]);
+            }
+            if (!fits) {
+                break;
+            }
+            next = candidate;
+        }
+        keys.push_back(next);
+        key = next;
+    }
+    return keys;
+}
+
+// The key at or before a frame, and the weight of the key after it
+static inline void findKey(const uint16_t* frames, uint32_t numKeys, int frame, uint32_t& key, float& weight) {
+    if (numKeys < 2) {
+        key = 0;
+        weight = 0.0f;
+        return;
+    }
+    // the first key is frame 0 and the last one is the last frame, so the search only looks at the keys in between
+    const uint16_t* next = std::upper_bound(frames + 1, frames + numKeys - 1, (uint16_t)frame);
+    key = (uint32_t)(next - frames) - 1;
+    weight = (float)(frame - frames[key]) / (float)(*next - frames[key]);
+}
+
+static inline int16_t quantizeSnorm16(float value) {
+    return (int16_t)glm::round(glm::clamp(value, -1.0f, 1.0f) * (float)INT16_MAX);
+}
+
+// Decoding and blending keys works on 4 floats at a time: x, y, z, w for rotations, x, y, z, 0 for vectors.
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+using Vec4 = __m128;
+
+static inline Vec4 makeVec4(const glm::vec3& value) {
+    return _mm_setr_ps(value.x, value.y, value.z, 0.0f);
+}
+
+static inline Vec4 decodeRotation(const int16_t* key) {
+    __m128i packed = _mm_loadl_epi64((const __m128i*)key);
+    // sign extend to 32 bits
+    __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+    return _mm_mul_ps(_mm_cvtepi32_ps(wide), _mm_set1_ps(1.0f / (float)INT16_MAX));
+}
+
+static inline Vec4 decodeVec3(const uint16_t* key, Vec4 min, Vec4 step) {
+    __m128i packed = _mm_loadl_epi64((const __m128i*)key);
+    __m128i wide = _mm_unpacklo_epi16(packed, _mm_setzero_si128());
+    return _mm_add_ps(min, _mm_mul_ps(_mm_cvtepi32_ps(wide), step));
+}
+
+static inline Vec4 dot4(Vec4 a, Vec4 b) {
+    Vec4 product = _mm_mul_ps(a, b);
+    product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+static inline Vec4 lerp4(Vec4 a, Vec4 b, float alpha) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(alpha)));
+}
+
+// same as safeLerp()
+static inline Vec4 nlerp4(Vec4 a, Vec4 b, float alpha) {
+    Vec4 sign = _mm_and_ps(dot4(a, b), _mm_set1_ps(-0.0f));
+    Vec4 result = lerp4(a, _mm_xor_ps(b, sign), alpha);
+    return _mm_div_ps(result, _mm_sqrt_ps(dot4(result, result)));
+}
+
+static inline glm::quat toQuat(Vec4 value) {
+    float components[4];
+    _mm_storeu_ps(components, value);
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+static inline glm::vec3 toVec3(Vec4 value) {
+    float components[4];
+    _mm_storeu_ps(components, value);
+    return glm::vec3(components[0], components[1], components[2]);
+}
+
+#else
+
+using Vec4 = glm::vec4;
+
+static inline Vec4 makeVec4(const glm::vec3& value) {
+    return Vec4(value, 0.0f);
+}
+
+static inline Vec4 decodeRotation(const int16_t* key) {
+    return Vec4(key[0], key[1], key[2], key[3]) * (1.0f / (float)INT16_MAX);
+}
+
+static inline Vec4 decodeVec3(const uint16_t* key, Vec4 min, Vec4 step) {
+    return min + Vec4(key[0], key[1], key[2], 0.0f) * step;
+}
+
+static inline Vec4 lerp4(Vec4 a, Vec4 b, float alpha) {
+    return a + (b - a) * alpha;
+}
+
+static inline Vec4 nlerp4(Vec4 a, Vec4 b, float alpha) {
+    if (glm::dot(a, b) < 0.0f) {
+        b = -b;
+    }
+    return glm::normalize(lerp4(a, b, alpha));
+}
+
+static inline glm::quat toQuat(Vec4 value) {
+    return glm::quat(value.w, value.x, value.y, value.z);
+}
+
+static inline glm::vec3 toVec3(Vec4 value) {
+    return glm::vec3(value);
+}
+
+#endif
+
+AnimClipData::AnimClipData(const std::vector<AnimPoseVec>& frames) {
+    _numFrames = std::min((int)frames.size(), MAX_FRAMES);
+    if (_numFrames < (int)frames.size()) {
+        qCWarning(animation) << "AnimClipData, animation has" << frames.size() << "frames, keeping the first" << MAX_FRAMES;
+    }
+    if (_numFrames == 0) {
+        return;
+    }
+
+    const int numJoints = (int)frames[0].size();
+    _tracks.resize(numJoints);
+
+    std::vector<glm::quat> rotations(_numFrames);
+    std::vector<glm::vec3> translations(_numFrames);
+    std::vector<glm::vec3> scales(_numFrames);
+    for (int joint = 0; joint < numJoints; joint++) {
+        for (int frame = 0; frame < _numFrames; frame++) {
+            const AnimPose& pose = frames[frame][joint];
+            rotations[frame] = pose.rot();
+            translations[frame] = pose.trans();
+            scales[frame] = pose.scale();
+        }
+        _tracks[joint].rotation = compressRotations(rotations);
+        _tracks[joint].translation = compressVec3s(translations);
+        _tracks[joint].scale = compressVec3s(scales);
+    }
+
+    _rotationFrames.shrink_to_fit();
+    _rotations.shrink_to_fit();
+    _vec3Frames.shrink_to_fit();
+    _vec3s.shrink_to_fit();
+}
+
+AnimClipData::RotationTrack AnimClipData::compressRotations(const std::vector<glm::quat>& values) {
+    // keep neighbouring frames in the same hemisphere, so that interpolating between keys takes the short way around
+    std::vector<glm::quat> rotations = values;
+    for (size_t i = 1; i < rotations.size(); i++) {
+        if (glm::dot(rotations[i - 1], rotations[i]) < 0.0f) {
+            rotations[i] = -rotations[i];
+        }
+    }
+
+    // for small angles the distance between two unit quaternions is half the angle between them, and unlike their
+    // dot product it keeps its precision near zero
+    const float maxDistance = 0.5f * ROTATION_TOLERANCE;
+    std::vector<int> keys = reduceKeys(rotations, safeLerp, [maxDistance](const glm::quat& a, const glm::quat& b) {
+        glm::quat difference = glm::dot(a, b) < 0.0f ? a + b : a + (-b);
+        return glm::length(difference) <= maxDistance;
+    });
+
+    RotationTrack track { (uint32_t)_rotations.size(), (uint32_t)keys.size() };
+    for (int key : keys) {
+        const glm::quat& rotation = rotations[key];
+        _rotationFrames.push_back((uint16_t)key);
+        _rotations.push_back({ quantizeSnorm16(rotation.x), quantizeSnorm16(rotation.y),
+                               quantizeSnorm16(rotation.z), quantizeSnorm16(rotation.w) });
+    }
+    return track;
+}
+
+AnimClipData::Vec3Track AnimClipData::compressVec3s(const std::vector<glm::vec3>& values) {
+    float magnitude = 0.0f;
+    for (const auto& value : values) {
+        magnitude = std::max(magnitude, glm::length(value));
+    }
+    const float tolerance = TRANSLATION_TOLERANCE * magnitude;
+    std::vector<int> keys = reduceKeys(values, [](const glm::vec3& a, const glm::vec3& b, float alpha) {
+        return lerp(a, b, alpha);
+    }, [tolerance](const glm::vec3& a, const glm::vec3& b) {
+        return glm::distance(a, b) <= tolerance;
+    });
+
+    // a constant track keeps its value exactly
+    glm::vec3 min = values[keys[0]];
+    glm::vec3 max = min;
+    for (int key : keys) {
+        min = glm::min(min, values[key]);
+        max = glm::max(max, values[key]);
+    }
+    glm::vec3 step = (max - min) / (float)UINT16_MAX;
+
+    Vec3Track track { (uint32_t)_vec3s.size(), (uint32_t)keys.size(), min, step };
+    for (int key : keys) {
+        glm::vec3 quantized;
+        for (int i = 0; i < 3; i++) {
+            quantized[i] = step[i] > 0.0f ? glm::round((values[key][i] - min[i]) / step[i]) : 0.0f;
+        }
+        quantized = glm::clamp(quantized, glm::vec3(0.0f), glm::vec3((float)UINT16_MAX));
+        _vec3Frames.push_back((uint16_t)key);
+        _vec3s.push_back({ (uint16_t)quantized.x, (uint16_t)quantized.y, (uint16_t)quantized.z, 0 });
+    }
+    return track;
+}
+
+glm::quat AnimClipData::evaluateRotation(const RotationTrack& track, int prevFrame, int nextFrame, float alpha) const {
+    const uint16_t* frames = &_rotationFrames[track.offset];
+    const QuantizedQuat* keys = &_rotations[track.offset];
+    const uint32_t lastKey = track.numKeys - 1;
+
+    uint32_t prevKey, nextKey;
+    float prevWeight, nextWeight;
+    findKey(frames, track.numKeys, prevFrame, prevKey, prevWeight);
+    findKey(frames, track.numKeys, nextFrame, nextKey, nextWeight);
+
+    Vec4 a = decodeRotation(&keys[prevKey].x);
+    Vec4 b = decodeRotation(&keys[std::min(prevKey + 1, lastKey)].x);
+    if (prevKey == nextKey) {
+        // both frames are between the same keys, so a single interpolation blends them
+        return toQuat(nlerp4(a, b, lerp(prevWeight, nextWeight, alpha)));
+    }
+
+    Vec4 c = decodeRotation(&keys[nextKey].x);
+    Vec4 d = decodeRotation(&keys[std::min(nextKey + 1, lastKey)].x);
+    return toQuat(nlerp4(nlerp4(a, b, prevWeight), nlerp4(c, d, nextWeight), alpha));
+}
+
+glm::vec3 AnimClipData::evaluateVec3(const Vec3Track& track, int prevFrame, int nextFrame, float alpha) const {
+    const uint16_t* frames = &_vec3Frames[track.offset];
+    const QuantizedVec3* keys = &_vec3s[track.offset];
+    const uint32_t lastKey = track.numKeys - 1;
+    const Vec4 min = makeVec4(track.min);
+    const Vec4 step = makeVec4(track.step);
+
+    uint32_t prevKey, nextKey;
+    float prevWeight, nextWeight;
+    findKey(frames, track.numKeys, prevFrame, prevKey, prevWeight);
+    findKey(frames, track.numKeys, nextFrame, nextKey, nextWeight);
+
+    Vec4 a = decodeVec3(&keys[prevKey].x, min, step);
+    Vec4 b = decodeVec3(&keys[std::min(prevKey + 1, lastKey)].x, min, step);
+    if (prevKey == nextKey) {
+        return toVec3(lerp4(a, b, lerp(prevWeight, nextWeight, alpha)));
+    }
+
+    Vec4 c = decodeVec3(&keys[nextKey].x, min, step);
+    Vec4 d = decodeVec3(&keys[std::min(nextKey + 1, lastKey)].x, min, step);
+    return toVec3(lerp4(lerp4(a, b, prevWeight), lerp4(c, d, nextWeight), alpha));
+}
+
+void AnimClipData::evaluate(int frame, AnimPose* poses) const {
+    evaluate(frame, frame, 0.0f, poses);
+}
+
+void AnimClipData::evaluate(int prevFrame, int nextFrame, float alpha, AnimPose* poses) const {
+    if (_numFrames == 0) {
+        return;
+    }
+    prevFrame = std::min(std::max(0, prevFrame), _numFrames - 1);
+    nextFrame = std::min(std::max(0, nextFrame), _numFrames - 1);
+
+    for (size_t i = 0; i < _tracks.size(); i++) {
+        const Track& track = _tracks[i];
+        poses[i].rot() = evaluateRotation(track.rotation, prevFrame, nextFrame, alpha);
+        poses[i].trans() = evaluateVec3(track.translation, prevFrame, nextFrame, alpha);
+        poses[i].scale() = evaluateVec3(track.scale, prevFrame, nextFrame, alpha);
+    }
+}
+
+size_t AnimClipData::getMemoryUsage() const {
+    return sizeof(AnimClipData) +
+        _tracks.capacity() * sizeof(Track) +
+        _rotationFrames.capacity() * sizeof(uint16_t) +
+        _rotations.capacity() * sizeof(QuantizedQuat) +
+        _vec3Frames.capacity() * sizeof(uint16_t) +
+        _vec3s.capacity() * sizeof(QuantizedVec3);
+}
+
+size_t AnimClipData::getUncompressedSize() const {
+    return (size_t)_numFrames * _tracks.size() * sizeof(AnimPose);
+}
+
+std::vector<AnimPoseVec> AnimClipData::retarget(const FBXGeometry& geom, const AnimSkeleton& skeleton, const QString& url) {
+    std::vector<AnimPoseVec> frames;
+
+    // build a mapping from animation joint indices to skeleton joint indices.
+    // by matching joints with the same name.
+    AnimSkeleton animSkeleton(geom);
+    const auto animJointCount = animSkeleton.getNumJoints();
+    const auto skeletonJointCount = skeleton.getNumJoints();
+    std::vector<int> jointMap;
+    jointMap.reserve(animJointCount);
+    for (int i = 0; i < animJointCount; i++) {
+        int skeletonJoint = skeleton.nameToJointIndex(animSkeleton.getJointName(i));
+        if (skeletonJoint == -1) {
+            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << url;
+        }
+        jointMap.push_back(skeletonJoint);
+    }
+
+    const int frameCount = geom.animationFrames.size();
+    frames.resize(frameCount);
+
+    for (int frame = 0; frame < frameCount; frame++) {
+
+        const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
+
+        // init all joints in animation to default pose
+        // this will give us a resonable result for bones in the model skeleton but not in the animation.
+        frames[frame] = skeleton.getRelativeDefaultPoses();
+
+        for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
+            int skeletonJoint = jointMap[animJoint];
+
+            const glm::vec3& fbxAnimTrans = fbxAnimFrame.translations[animJoint];
+            const glm::quat& fbxAnimRot = fbxAnimFrame.rotations[animJoint];
+
+            // skip joints that are in the animation but not in the skeleton.
+            if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
+
+                AnimPose preRot, postRot;
+                preRot = animSkeleton.getPreRotationPose(animJoint);
+                postRot = animSkeleton.getPostRotationPose(animJoint);
+
+                // cancel out scale
+                preRot.scale() = glm::vec3(1.0f);
+                postRot.scale() = glm::vec3(1.0f);
+
+                AnimPose rot(glm::vec3(1.0f), fbxAnimRot, glm::vec3());
+
+                // adjust translation offsets, so large translation animatons on the reference skeleton
+                // will be adjusted when played on a skeleton with short limbs.
+                const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint];
+                const AnimPose& relDefaultPose = skeleton.getRelativeDefaultPose(skeletonJoint);
+                float boneLengthScale = 1.0f;
+                const float EPSILON = 0.0001f;
+                if (fabsf(glm::length(fbxZeroTrans)) > EPSILON) {
+                    boneLengthScale = glm::length(relDefaultPose.trans()) / glm::length(fbxZeroTrans);
+                }
+
+                AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans() + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
+
+                frames[frame][skeletonJoint] = trans * preRot * rot * postRot;
+            }
+        }
+    }
+    return frames;
+}
+
+uint64_t AnimClipData::hashSkeleton(const AnimSkeleton& skeleton) {
+    // FNV-1a over everything retargeting and mirroring read from the skeleton
+    uint64_t hash = 14695981039346656037ULL;
+    auto addBytes = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+
+    const int numJoints = skeleton.getNumJoints();
+    addBytes(&numJoints, sizeof(numJoints));
+    for (int i = 0; i < numJoints; i++) {
+        const QString& name = skeleton.getJointName(i);
+        addBytes(name.constData(), name.size() * sizeof(QChar));
+        int parentIndex = skeleton.getParentIndex(i);
+        addBytes(&parentIndex, sizeof(parentIndex));
+        const AnimPose& pose = skeleton.getRelativeDefaultPose(i);
+        addBytes(&pose.rot(), sizeof(glm::quat));
+        addBytes(&pose.trans(), sizeof(glm::vec3));
+        addBytes(&pose.scale(), sizeof(glm::vec3));
+    }
+    return hash;
+}
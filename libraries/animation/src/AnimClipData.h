@@ -0,0 +1,99 @@
+//
+//  AnimClipData.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimClipData_h
+#define hifi_AnimClipData_h
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "AnimSkeleton.h"
+
+// The frames of an animation retargeted to a skeleton, compressed and immutable so that every clip that plays
+// the animation on a matching skeleton can share them.
+//
+// Every joint has a rotation, a translation and a scale track.  A track only keeps the frames that can't be
+// interpolated from their neighbours within tolerance, and a constant track keeps a single exact key.  Rotations
+// are stored as 16-bit normalized components, translations and scales as 16-bit offsets into the range of their track.
+class AnimClipData {
+public:
+    using Pointer = std::shared_ptr<const AnimClipData>;
+
+    // largest error the key reduction allows, in radians for rotations and as a fraction of the track's magnitude
+    // for translations and scales
+    static const float ROTATION_TOLERANCE;
+    static const float TRANSLATION_TOLERANCE;
+    static const int MAX_FRAMES = UINT16_MAX + 1;
+
+    // frames[frame][joint]
+    explicit AnimClipData(const std::vector<AnimPoseVec>& frames);
+
+    // Maps the joints of an animation onto a skeleton by name, scaling the animated translations to its bone lengths.
+    // Joints the animation doesn't move keep the skeleton's default pose.
+    static std::vector<AnimPoseVec> retarget(const FBXGeometry& geometry, const AnimSkeleton& skeleton, const QString& url);
+
+    // Identifies the skeletons that can share a retargeted animation
+    static uint64_t hashSkeleton(const AnimSkeleton& skeleton);
+
+    int getNumFrames() const { return _numFrames; }
+    int getNumJoints() const { return (int)_tracks.size(); }
+    size_t getNumKeys() const { return _rotations.size() + _vec3s.size(); }
+
+    size_t getMemoryUsage() const;
+    // size of the same frames stored as AnimPoseVecs
+    size_t getUncompressedSize() const;
+
+    // Decodes the relative poses of one frame
+    void evaluate(int frame, AnimPose* poses) const;
+    // Decodes the relative poses of two frames and blends them, like ::blend()
+    void evaluate(int prevFrame, int nextFrame, float alpha, AnimPose* poses) const;
+
+private:
+    struct QuantizedQuat {
+        int16_t x, y, z, w;
+    };
+    // padded so that a key is a single 64-bit load
+    struct QuantizedVec3 {
+        uint16_t x, y, z, pad;
+    };
+
+    struct RotationTrack {
+        uint32_t offset;
+        uint32_t numKeys;
+    };
+    struct Vec3Track {
+        uint32_t offset;
+        uint32_t numKeys;
+        glm::vec3 min;
+        glm::vec3 step;
+    };
+    struct Track {
+        RotationTrack rotation;
+        Vec3Track translation;
+        Vec3Track scale;
+    };
+
+    RotationTrack compressRotations(const std::vector<glm::quat>& values);
+    Vec3Track compressVec3s(const std::vector<glm::vec3>& values);
+
+    glm::quat evaluateRotation(const RotationTrack& track, int prevFrame, int nextFrame, float alpha) const;
+    glm::vec3 evaluateVec3(const Vec3Track& track, int prevFrame, int nextFrame, float alpha) const;
+
+    int _numFrames { 0 };
+    std::vector<Track> _tracks;
+
+    // keys of every track, indexed by the track offsets
+    std::vector<uint16_t> _rotationFrames;
+    std::vector<QuantizedQuat> _rotations;
+    std::vector<uint16_t> _vec3Frames;
+    std::vector<QuantizedVec3> _vec3s;
+};
+
+#endif // hifi_AnimClipData_h
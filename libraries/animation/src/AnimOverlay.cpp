@@ -60,10 +60,7 @@ const AnimPoseVec& AnimOverlay::evaluate(const AnimVariantMap& animVars, const A
             _poses.resize(underPoses.size());
             assert(_boneSetVec.size() == _poses.size());
 
-            for (size_t i = 0; i < _poses.size(); i++) {
-                float alpha = _boneSetVec[i] * _alpha;
-                ::blend(1, &underPoses[i], &overPoses[i], alpha, &_poses[i]);
-            }
+            ::blend(_poses.size(), &underPoses[0], &overPoses[0], _alpha, &_boneSetVec[0], &_poses[0]);
         }
     }
     return _poses;
@@ -13,10 +13,85 @@
 #include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
+
 const AnimPose AnimPose::identity = AnimPose(glm::vec3(1.0f),
                                              glm::quat(),
                                              glm::vec3(0.0f));
 
+// A pose whose scale is positive and uniform multiplies and inverts as a scale, a rotation and a translation, which
+// is much cheaper than a round trip through matrices.  Any other scale can shear, so it still goes through them.
+static bool isPositiveUniformScale(const glm::vec3& scale) {
+    const float EPSILON = 0.0001f;
+    return scale.x > 0.0f && fabsf(scale.y - scale.x) <= EPSILON * scale.x && fabsf(scale.z - scale.x) <= EPSILON * scale.x;
+}
+
+static bool isPositiveScale(const glm::vec3& scale) {
+    return scale.x > 0.0f && scale.y > 0.0f && scale.z > 0.0f;
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// quaternions are x, y, z, w and vectors x, y, z, 0
+static inline __m128 loadQuat(const glm::quat& q) {
+    return _mm_loadu_ps(&q.x);
+}
+
+static inline __m128 loadVec3(const glm::vec3& v) {
+    return _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+}
+
+static inline __m128 splat(__m128 v, int lane) {
+    switch (lane) {
+    case 0: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+    case 1: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+    case 2: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+    default: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+}
+
+static inline __m128 quatMul(__m128 a, __m128 b) {
+    // each term is a component of a times a permutation of b, with the signs of the Hamilton product
+    __m128 result = _mm_mul_ps(splat(a, 3), b);
+    __m128 x = _mm_mul_ps(splat(a, 0), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)));
+    __m128 y = _mm_mul_ps(splat(a, 1), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)));
+    __m128 z = _mm_mul_ps(splat(a, 2), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)));
+    result = _mm_add_ps(result, _mm_xor_ps(x, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+    result = _mm_add_ps(result, _mm_xor_ps(y, _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+    return _mm_add_ps(result, _mm_xor_ps(z, _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+}
+
+static inline __m128 cross(__m128 a, __m128 b) {
+    __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 result = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+    return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// same as glm's quat * vec3: v + 2 * (w * (q x v) + q x (q x v))
+static inline __m128 rotate(__m128 q, __m128 v) {
+    __m128 uv = cross(q, v);
+    __m128 uuv = cross(q, uv);
+    __m128 offset = _mm_add_ps(_mm_mul_ps(uv, splat(q, 3)), uuv);
+    return _mm_add_ps(v, _mm_add_ps(offset, offset));
+}
+
+static inline glm::quat toQuat(__m128 value) {
+    glm::quat result;
+    _mm_storeu_ps(&result.x, value);
+    return result;
+}
+
+static inline glm::vec3 toVec3(__m128 value) {
+    float components[4];
+    _mm_storeu_ps(components, value);
+    return glm::vec3(components[0], components[1], components[2]);
+}
+
+#endif
+
 AnimPose::AnimPose(const glm::mat4& mat) {
     static const float EPSILON = 0.0001f;
     _scale = extractScale(mat);
@@ -55,12 +130,27 @@ glm::vec3 AnimPose::xformVectorFast(const glm::vec3& rhs) const {
 }
 
 AnimPose AnimPose::operator*(const AnimPose& rhs) const {
+    if (isPositiveUniformScale(_scale) && isPositiveScale(rhs._scale)) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+        __m128 rot = loadQuat(_rot);
+        __m128 trans = _mm_mul_ps(_mm_set1_ps(_scale.x), loadVec3(rhs._trans));
+        return AnimPose(_scale.x * rhs._scale, toQuat(quatMul(rot, loadQuat(rhs._rot))),
+                        toVec3(_mm_add_ps(loadVec3(_trans), rotate(rot, trans))));
+#else
+        return AnimPose(_scale.x * rhs._scale, _rot * rhs._rot, _trans + _rot * (_scale.x * rhs._trans));
+#endif
+    }
     glm::mat4 result;
     glm_mat4u_mul(*this, rhs, result);
     return AnimPose(result);
 }
 
 AnimPose AnimPose::inverse() const {
+    if (isPositiveUniformScale(_scale)) {
+        float invScale = 1.0f / _scale.x;
+        glm::quat invRot = glm::inverse(_rot);
+        return AnimPose(glm::vec3(invScale), invRot, invRot * (-invScale * _trans));
+    }
     return AnimPose(glm::inverse(static_cast<glm::mat4>(*this)));
 }
 
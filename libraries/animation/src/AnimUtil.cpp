@@ -11,28 +11,106 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
 
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
-    for (size_t i = 0; i < numPoses; i++) {
-        const AnimPose& aPose = a[i];
-        const AnimPose& bPose = b[i];
-
-        // adjust signs if necessary
-        const glm::quat& q1 = aPose.rot();
-        glm::quat q2 = bPose.rot();
-        float dot = glm::dot(q1, q2);
-        if (dot < 0.0f) {
-            q2 = -q2;
-        }
+// AnimPose is scale x, y, z, rot x, y, z, w, trans x, y, z
+static_assert(sizeof(AnimPose) == 10 * sizeof(float), "blend() expects AnimPose to be 10 packed floats");
+
+static inline void blendPose(const AnimPose& a, const AnimPose& b, float alpha, AnimPose& result) {
+    result.scale() = lerp(a.scale(), b.scale(), alpha);
+    result.rot() = safeLerp(a.rot(), b.rot(), alpha);
+    result.trans() = lerp(a.trans(), b.trans(), alpha);
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
-        result[i].scale() = lerp(aPose.scale(), bPose.scale(), alpha);
-        result[i].rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
-        result[i].trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+static inline __m128 lerp4(__m128 a, __m128 b, __m128 alpha) {
+    return _mm_add_ps(_mm_mul_ps(a, _mm_sub_ps(_mm_set1_ps(1.0f), alpha)), _mm_mul_ps(b, alpha));
+}
+
+// Blends 4 poses with one alpha each.  The 4 rotations are transposed into a register per component, so that their
+// sign adjustments, lerps and normalizations are done together, then transposed back.
+static inline void blend4(const AnimPose* a, const AnimPose* b, __m128 alphas, AnimPose* result) {
+    __m128 ax = _mm_loadu_ps(&a[0].rot().x);
+    __m128 ay = _mm_loadu_ps(&a[1].rot().x);
+    __m128 az = _mm_loadu_ps(&a[2].rot().x);
+    __m128 aw = _mm_loadu_ps(&a[3].rot().x);
+    _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+    __m128 bx = _mm_loadu_ps(&b[0].rot().x);
+    __m128 by = _mm_loadu_ps(&b[1].rot().x);
+    __m128 bz = _mm_loadu_ps(&b[2].rot().x);
+    __m128 bw = _mm_loadu_ps(&b[3].rot().x);
+    _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+    // flip b where it is in the other hemisphere from a
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                            _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    __m128 sign = _mm_and_ps(dot, _mm_set1_ps(-0.0f));
+    __m128 x = lerp4(ax, _mm_xor_ps(bx, sign), alphas);
+    __m128 y = lerp4(ay, _mm_xor_ps(by, sign), alphas);
+    __m128 z = lerp4(az, _mm_xor_ps(bz, sign), alphas);
+    __m128 w = lerp4(aw, _mm_xor_ps(bw, sign), alphas);
+
+    __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                      _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+    __m128 oneOverLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+    x = _mm_mul_ps(x, oneOverLength);
+    y = _mm_mul_ps(y, oneOverLength);
+    z = _mm_mul_ps(z, oneOverLength);
+    w = _mm_mul_ps(w, oneOverLength);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+
+    // scale and trans are lerped as scale.xyz + rot.x and rot.w + trans.xyz, which stay within the pose; the
+    // rotation lanes are overwritten below.  Everything is loaded before it is stored, so result can alias a or b.
+    float alpha[4];
+    _mm_storeu_ps(alpha, alphas);
+    __m128 scales[4];
+    __m128 translations[4];
+    for (int i = 0; i < 4; i++) {
+        const float* aFloats = &a[i].scale().x;
+        const float* bFloats = &b[i].scale().x;
+        __m128 poseAlpha = _mm_set1_ps(alpha[i]);
+        scales[i] = lerp4(_mm_loadu_ps(aFloats), _mm_loadu_ps(bFloats), poseAlpha);
+        translations[i] = lerp4(_mm_loadu_ps(aFloats + 6), _mm_loadu_ps(bFloats + 6), poseAlpha);
+    }
+    __m128 rotations[4] = { x, y, z, w };
+    for (int i = 0; i < 4; i++) {
+        float* resultFloats = &result[i].scale().x;
+        _mm_storeu_ps(resultFloats, scales[i]);
+        _mm_storeu_ps(resultFloats + 6, translations[i]);
+        _mm_storeu_ps(resultFloats + 3, rotations[i]);
     }
 }
 
+#endif
+
+static void blendPoses(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, const float* weights,
+                       AnimPose* result) {
+    size_t i = 0;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    for (; i + 4 <= numPoses; i += 4) {
+        __m128 alphas = _mm_set1_ps(alpha);
+        if (weights) {
+            alphas = _mm_mul_ps(alphas, _mm_loadu_ps(weights + i));
+        }
+        blend4(a + i, b + i, alphas, result + i);
+    }
+#endif
+    for (; i < numPoses; i++) {
+        blendPose(a[i], b[i], weights ? alpha * weights[i] : alpha, result[i]);
+    }
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blendPoses(numPoses, a, b, alpha, nullptr, result);
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, const float* weights, AnimPose* result) {
+    blendPoses(numPoses, a, b, alpha, weights, result);
+}
+
 glm::quat averageQuats(size_t numQuats, const glm::quat* quats) {
     if (numQuats == 0) {
         return glm::quat();
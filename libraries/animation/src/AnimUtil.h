@@ -15,6 +15,8 @@
 
 // this is where the magic happens
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
+// same, with the alpha of each pose scaled by its weight
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, const float* weights, AnimPose* result);
 
 glm::quat averageQuats(size_t numQuats, const glm::quat* quats);
 
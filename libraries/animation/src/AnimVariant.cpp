@@ -9,6 +9,11 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <deque>
+
+#include <QHash>
+#include <QReadWriteLock>
 #include <QScriptEngine>
 #include <QScriptValueIterator>
 #include <QThread>
@@ -17,6 +22,124 @@
 
 const AnimVariant AnimVariant::False = AnimVariant();
 
+namespace {
+
+struct KeyRegistry {
+    QReadWriteLock lock;
+    QHash<QString, int> ids;
+    // a deque so that interning a name never moves the others
+    std::deque<QString> names;
+};
+
+KeyRegistry& getKeyRegistry() {
+    static KeyRegistry registry;
+    return registry;
+}
+
+}
+
+AnimVariantKey::AnimVariantKey(const QString& name) {
+    if (name.isEmpty()) {
+        return;
+    }
+
+    KeyRegistry& registry = getKeyRegistry();
+    {
+        QReadLocker locker(&registry.lock);
+        auto iter = registry.ids.constFind(name);
+        if (iter != registry.ids.constEnd()) {
+            _id = iter.value();
+            return;
+        }
+    }
+
+    QWriteLocker locker(&registry.lock);
+    auto iter = registry.ids.constFind(name);
+    if (iter != registry.ids.constEnd()) {
+        _id = iter.value();
+    } else {
+        _id = (int)registry.names.size();
+        registry.names.push_back(name);
+        registry.ids.insert(name, _id);
+    }
+}
+
+AnimVariantKey AnimVariantKey::find(const QString& name) {
+    KeyRegistry& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return fromID(registry.ids.value(name, -1));
+}
+
+int AnimVariantKey::getNumKeys() {
+    KeyRegistry& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return (int)registry.names.size();
+}
+
+QString AnimVariantKey::getName() const {
+    if (_id < 0) {
+        return QString();
+    }
+    KeyRegistry& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return registry.names[_id];
+}
+
+void AnimVariantMap::reserveSlot(int id) {
+    if (id >= (int)_flags.size()) {
+        // make room for every name interned so far, so that the map rarely grows again
+        size_t size = std::max(id + 1, AnimVariantKey::getNumKeys());
+        _variants.resize(size);
+        _flags.resize(size, 0);
+    }
+}
+
+void AnimVariantMap::setVariant(const AnimVariantKey& key, AnimVariant&& variant) {
+    int id = key.getID();
+    if (id < 0) {
+        return;
+    }
+    reserveSlot(id);
+    _variants[id] = std::move(variant);
+    _flags[id] |= IS_SET;
+}
+
+void AnimVariantMap::unset(const AnimVariantKey& key) {
+    if (find(key)) {
+        int id = key.getID();
+        _variants[id] = AnimVariant();
+        _flags[id] &= ~IS_SET;
+    }
+}
+
+void AnimVariantMap::setTrigger(const AnimVariantKey& key) {
+    int id = key.getID();
+    if (id < 0) {
+        return;
+    }
+    reserveSlot(id);
+    if (!(_flags[id] & IS_TRIGGER)) {
+        _flags[id] |= IS_TRIGGER;
+        _triggers.push_back(id);
+    }
+}
+
+void AnimVariantMap::clearTriggers() {
+    for (int id : _triggers) {
+        _flags[id] &= ~IS_TRIGGER;
+    }
+    _triggers.clear();
+}
+
+void AnimVariantMap::clearMap() {
+    for (size_t id = 0; id < _flags.size(); id++) {
+        if (_flags[id] & IS_SET) {
+            _variants[id] = AnimVariant();
+            _flags[id] &= ~IS_SET;
+        }
+    }
+}
+
 QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const {
     if (QThread::currentThread() != engine->thread()) {
         qCWarning(animation) << "Cannot create Javacript object from non-script thread" << QThread::currentThread();
@@ -51,24 +174,32 @@ QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine,
     };
     if (useNames) { // copy only the requested names
         for (const QString& name : names) {
-            auto search = _map.find(name);
-            if (search != _map.end()) {
-                setOne(name, search->second);
-            } else if (_triggers.count(name) == 1) {
+            // don't intern names that nothing has set
+            AnimVariantKey key = AnimVariantKey::find(name);
+            const AnimVariant* variant = find(key);
+            if (variant) {
+                setOne(name, *variant);
+            } else if (isTrigger(key)) {
                 target.setProperty(name, true);
             } // scripts are allowed to request names that do not exist
         }
 
     } else {  // copy all of them
-        for (auto& pair : _map) {
-            setOne(pair.first, pair.second);
+        for (int id = 0; id < (int)_flags.size(); id++) {
+            if (_flags[id] & IS_SET) {
+                setOne(AnimVariantKey::fromID(id).getName(), _variants[id]);
+            }
         }
     }
     return target;
 }
 void AnimVariantMap::copyVariantsFrom(const AnimVariantMap& other) {
-    for (auto& pair : other._map) {
-        _map[pair.first] = pair.second;
+    for (int id = 0; id < (int)other._flags.size(); id++) {
+        if (other._flags[id] & IS_SET) {
+            reserveSlot(id);
+            _variants[id] = other._variants[id];
+            _flags[id] |= IS_SET;
+        }
     }
 }
 
@@ -17,6 +17,8 @@
 #include <glm/gtx/quaternion.hpp>
 #include <map>
 #include <set>
+#include <stdint.h>
+#include <vector>
 #include <QScriptValue>
 #include <StreamUtils.h>
 #include <GLMHelpers.h>
@@ -114,119 +116,108 @@ protected:
     } _val;
 };
 
+// A variable name interned to a small integer id, so that the anim graph can find its variables in an AnimVariantMap
+// by index instead of by string.  Names are interned the first time they are seen, usually when AnimNodeLoader builds
+// the graph, and are never released.  An empty name is an invalid key, which every lookup answers with its default.
+class AnimVariantKey {
+public:
+    AnimVariantKey() {}
+    AnimVariantKey(const QString& name);
+    AnimVariantKey(const char* name) : AnimVariantKey(QString(name)) {}
+
+    // Answers the key of a name that has already been interned, or an invalid key, without interning it.
+    static AnimVariantKey find(const QString& name);
+    static int getNumKeys();
+
+    bool isValid() const { return _id >= 0; }
+    int getID() const { return _id; }
+    QString getName() const;
+
+    bool operator==(const AnimVariantKey& other) const { return _id == other._id; }
+    bool operator!=(const AnimVariantKey& other) const { return _id != other._id; }
+
+private:
+    friend class AnimVariantMap;
+    static AnimVariantKey fromID(int id) { AnimVariantKey key; key._id = id; return key; }
+
+    int _id { -1 };
+};
+
 class AnimVariantMap {
 public:
 
-    bool lookup(const QString& key, bool defaultValue) const {
+    bool lookup(const AnimVariantKey& key, bool defaultValue) const {
         // check triggers first, then map
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else if (_triggers.find(key) != _triggers.end()) {
+        if (isTrigger(key)) {
             return true;
         } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getBool() : defaultValue;
+            const AnimVariant* variant = find(key);
+            return variant ? variant->getBool() : defaultValue;
         }
     }
 
-    int lookup(const QString& key, int defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getInt() : defaultValue;
-        }
+    int lookup(const AnimVariantKey& key, int defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getInt() : defaultValue;
     }
 
-    float lookup(const QString& key, float defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getFloat() : defaultValue;
-        }
+    float lookup(const AnimVariantKey& key, float defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getFloat() : defaultValue;
     }
 
-    const glm::vec3& lookupRaw(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getVec3() : defaultValue;
-        }
+    const glm::vec3& lookupRaw(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getVec3() : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometry(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformPoint(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometry(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? transformPoint(_rigToGeometryMat, variant->getVec3()) : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometryVector(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformVectorFast(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometryVector(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? transformVectorFast(_rigToGeometryMat, variant->getVec3()) : defaultValue;
     }
 
-    const glm::quat& lookupRaw(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getQuat() : defaultValue;
-        }
+    const glm::quat& lookupRaw(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getQuat() : defaultValue;
     }
 
-    glm::quat lookupRigToGeometry(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? _rigToGeometryRot * iter->second.getQuat() : defaultValue;
-        }
+    glm::quat lookupRigToGeometry(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? _rigToGeometryRot * variant->getQuat() : defaultValue;
     }
 
-    const QString& lookup(const QString& key, const QString& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getString() : defaultValue;
-        }
+    const QString& lookup(const AnimVariantKey& key, const QString& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getString() : defaultValue;
     }
 
-    void set(const QString& key, bool value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, int value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, float value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::vec3& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::quat& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const QString& value) { _map[key] = AnimVariant(value); }
-    void unset(const QString& key) { _map.erase(key); }
+    void set(const AnimVariantKey& key, bool value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, int value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, float value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::vec3& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::quat& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const QString& value) { setVariant(key, AnimVariant(value)); }
+    void unset(const AnimVariantKey& key);
 
-    void setTrigger(const QString& key) { _triggers.insert(key); }
-    void clearTriggers() { _triggers.clear(); }
+    void setTrigger(const AnimVariantKey& key);
+    void clearTriggers();
 
     void setRigToGeometryTransform(const glm::mat4& rigToGeometry) {
         _rigToGeometryMat = rigToGeometry;
         _rigToGeometryRot = glmExtractRotation(rigToGeometry);
     }
 
-    void clearMap() { _map.clear(); }
-    bool hasKey(const QString& key) const { return _map.find(key) != _map.end(); }
+    void clearMap();
+    bool hasKey(const AnimVariantKey& key) const { return find(key) != nullptr; }
 
-    const AnimVariant& get(const QString& key) const {
-        auto iter = _map.find(key);
-        if (iter != _map.end()) {
-            return iter->second;
-        } else {
-            return AnimVariant::False;
-        }
+    const AnimVariant& get(const AnimVariantKey& key) const {
+        const AnimVariant* variant = find(key);
+        return variant ? *variant : AnimVariant::False;
     }
 
     // Answer a Plain Old Javascript Object (for the given engine) all of our values set as properties.
@@ -238,25 +229,30 @@ public:
 #ifdef NDEBUG
     void dump() const {
         qCDebug(animation) << "AnimVariantMap =";
-        for (auto& pair : _map) {
-            switch (pair.second.getType()) {
+        for (int id = 0; id < (int)_flags.size(); id++) {
+            if (!(_flags[id] & IS_SET)) {
+                continue;
+            }
+            QString name = AnimVariantKey::fromID(id).getName();
+            const AnimVariant& variant = _variants[id];
+            switch (variant.getType()) {
             case AnimVariant::Type::Bool:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getBool();
+                qCDebug(animation) << "    " << name << "=" << variant.getBool();
                 break;
             case AnimVariant::Type::Int:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getInt();
+                qCDebug(animation) << "    " << name << "=" << variant.getInt();
                 break;
             case AnimVariant::Type::Float:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getFloat();
+                qCDebug(animation) << "    " << name << "=" << variant.getFloat();
                 break;
             case AnimVariant::Type::Vec3:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getVec3();
+                qCDebug(animation) << "    " << name << "=" << variant.getVec3();
                 break;
             case AnimVariant::Type::Quat:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getQuat();
+                qCDebug(animation) << "    " << name << "=" << variant.getQuat();
                 break;
             case AnimVariant::Type::String:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getString();
+                qCDebug(animation) << "    " << name << "=" << variant.getString();
                 break;
             default:
                 assert(("invalid AnimVariant::Type", false));
@@ -266,8 +262,33 @@ public:
 #endif
 
 protected:
-    std::map<QString, AnimVariant> _map;
-    std::set<QString> _triggers;
+    enum SlotFlags : uint8_t {
+        IS_SET = 0x1,
+        IS_TRIGGER = 0x2
+    };
+
+    const AnimVariant* find(const AnimVariantKey& key) const {
+        int id = key.getID();
+        if (id >= 0 && id < (int)_flags.size() && (_flags[id] & IS_SET)) {
+            return &_variants[id];
+        } else {
+            return nullptr;
+        }
+    }
+
+    bool isTrigger(const AnimVariantKey& key) const {
+        int id = key.getID();
+        return id >= 0 && id < (int)_flags.size() && (_flags[id] & IS_TRIGGER);
+    }
+
+    void setVariant(const AnimVariantKey& key, AnimVariant&& variant);
+    void reserveSlot(int id);
+
+    // indexed by AnimVariantKey::getID()
+    std::vector<AnimVariant> _variants;
+    std::vector<uint8_t> _flags;
+    // ids of the set triggers, so that clearing them doesn't have to visit every slot
+    std::vector<int> _triggers;
     glm::mat4 _rigToGeometryMat;
     glm::quat _rigToGeometryRot;
 };
@@ -41,6 +41,65 @@ AnimationPointer AnimationCache::getAnimation(const QUrl& url) {
     return getResource(url).staticCast<Animation>();
 }
 
+AnimClipData::Pointer AnimationCache::getClipData(const QUrl& url, const AnimSkeleton& skeleton, bool mirrored,
+                                                  const FramesGetter& getFrames) {
+    ClipDataKey key(url.toString(), AnimClipData::hashSkeleton(skeleton), mirrored);
+    {
+        std::lock_guard<std::mutex> lock(_clipDataMutex);
+        auto it = _clipData.find(key);
+        if (it != _clipData.end()) {
+            if (auto clipData = it->second.lock()) {
+                return clipData;
+            }
+        }
+    }
+
+    // compress outside the lock, if another clip got there first we use its copy
+    auto clipData = std::make_shared<const AnimClipData>(getFrames());
+    qCDebug(animation) << "Compressed animation" << url.toDisplayString() << (mirrored ? "mirrored," : ",")
+        << clipData->getNumFrames() << "frames," << clipData->getNumJoints() << "joints,"
+        << clipData->getMemoryUsage() << "bytes from" << clipData->getUncompressedSize();
+
+    std::lock_guard<std::mutex> lock(_clipDataMutex);
+    auto& entry = _clipData[key];
+    if (auto existing = entry.lock()) {
+        return existing;
+    }
+    entry = clipData;
+
+    // drop the entries of the clips nothing plays anymore
+    for (auto it = _clipData.begin(); it != _clipData.end();) {
+        if (it->second.expired()) {
+            it = _clipData.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return clipData;
+}
+
+size_t AnimationCache::getNumClipData() {
+    std::lock_guard<std::mutex> lock(_clipDataMutex);
+    size_t result = 0;
+    for (const auto& entry : _clipData) {
+        if (!entry.second.expired()) {
+            result++;
+        }
+    }
+    return result;
+}
+
+size_t AnimationCache::getClipDataMemoryUsage() {
+    std::lock_guard<std::mutex> lock(_clipDataMutex);
+    size_t result = 0;
+    for (const auto& entry : _clipData) {
+        if (auto clipData = entry.second.lock()) {
+            result += clipData->getMemoryUsage();
+        }
+    }
+    return result;
+}
+
 QSharedPointer<Resource> AnimationCache::createResource(const QUrl& url, const QSharedPointer<Resource>& fallback,
     const void* extra) {
     return QSharedPointer<Resource>(new Animation(url), &Resource::deleter);
@@ -12,6 +12,11 @@
 #ifndef hifi_AnimationCache_h
 #define hifi_AnimationCache_h
 
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <QtCore/QRunnable>
 #include <QtScript/QScriptEngine>
 #include <QtScript/QScriptValue>
@@ -20,6 +25,8 @@
 #include <FBXReader.h>
 #include <ResourceCache.h>
 
+#include "AnimClipData.h"
+
 class Animation;
 
 typedef QSharedPointer<Animation> AnimationPointer;
@@ -28,6 +35,8 @@ typedef QSharedPointer<Animation> AnimationPointer;
 class AnimationCache : public ResourceCache, public Dependency  {
     Q_OBJECT
     SINGLETON_DEPENDENCY
+    Q_PROPERTY(size_t numClipData READ getNumClipData NOTIFY dirty)
+    Q_PROPERTY(size_t sizeClipData READ getClipDataMemoryUsage NOTIFY dirty)
 
     /**jsdoc
      * @namespace AnimationCache
@@ -45,6 +54,15 @@ public:
     Q_INVOKABLE AnimationPointer getAnimation(const QString& url) { return getAnimation(QUrl(url)); }
     Q_INVOKABLE AnimationPointer getAnimation(const QUrl& url);
 
+    using FramesGetter = std::function<std::vector<AnimPoseVec>()>;
+
+    // Returns the compressed frames of an animation retargeted to a skeleton.  Every clip that plays the animation
+    // on a matching skeleton shares them; getFrames is only called when no clip holds them yet.
+    AnimClipData::Pointer getClipData(const QUrl& url, const AnimSkeleton& skeleton, bool mirrored, const FramesGetter& getFrames);
+
+    size_t getNumClipData();
+    size_t getClipDataMemoryUsage();
+
 protected:
 
     virtual QSharedPointer<Resource> createResource(const QUrl& url, const QSharedPointer<Resource>& fallback,
@@ -53,6 +71,10 @@ private:
     explicit AnimationCache(QObject* parent = NULL);
     virtual ~AnimationCache() { }
 
+    using ClipDataKey = std::tuple<QString, uint64_t, bool>;
+
+    std::mutex _clipDataMutex;
+    std::map<ClipDataKey, std::weak_ptr<const AnimClipData>> _clipData;
 };
 
 Q_DECLARE_METATYPE(AnimationPointer)
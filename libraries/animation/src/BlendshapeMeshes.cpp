@@ -0,0 +1,134 @@
+//
+//  BlendshapeMeshes.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlendshapeMeshes.h"
+
+#include <TBBHelpers.h>
+#include <graphics/BufferViewHelpers.h>
+
+BlendshapeMeshes::BlendshapeMeshes(const FBXGeometry& geometry) {
+    _meshes.resize(geometry.meshes.size());
+    for (int i = 0; i < geometry.meshes.size(); i++) {
+        const FBXMesh& fbxMesh = geometry.meshes.at(i);
+        if (fbxMesh.blendshapes.isEmpty()) {
+            continue;
+        }
+        Mesh& mesh = _meshes[i];
+        const int numVertices = fbxMesh.vertices.size();
+        mesh.vertices = fbxMesh.vertices;
+        mesh.blendshapes = fbxMesh.blendshapes;
+        mesh.normals.resize(numVertices, glm::vec3(0.0f));
+        mesh.tangents.resize(numVertices, glm::vec3(0.0f));
+        std::copy(fbxMesh.normals.begin(), fbxMesh.normals.begin() + qMin(fbxMesh.normals.size(), numVertices), mesh.normals.begin());
+        std::copy(fbxMesh.tangents.begin(), fbxMesh.tangents.begin() + qMin(fbxMesh.tangents.size(), numVertices), mesh.tangents.begin());
+
+        mesh.normalsAndTangents.resize(2 * numVertices);
+        for (int j = 0; j < numVertices; j++) {
+#if FBX_PACK_NORMALS
+            buffer_helpers::packNormalAndTangent(mesh.normals[j], mesh.tangents[j],
+                mesh.normalsAndTangents[2 * j], mesh.normalsAndTangents[2 * j + 1]);
+#else
+            mesh.normalsAndTangents[2 * j] = mesh.normals[j];
+            mesh.normalsAndTangents[2 * j + 1] = mesh.tangents[j];
+#endif
+        }
+    }
+}
+
+BlendedVertices::BlendedVertices(const std::shared_ptr<const BlendshapeMeshes>& meshes) :
+    _meshes(meshes) {
+    _blendedMeshes.resize(meshes->getNumMeshes());
+    for (int i = 0; i < meshes->getNumMeshes(); i++) {
+        if (!meshes->isBlendshaped(i)) {
+            continue;
+        }
+        BlendedMesh& blended = _blendedMeshes[i];
+        const int numVertices = meshes->getNumVertices(i);
+        blended.vertices.assign(meshes->getVertices(i).begin(), meshes->getVertices(i).end());
+        blended.normalsAndTangents = meshes->getNormalsAndTangents(i);
+        blended.normals.resize(numVertices);
+        blended.tangents.resize(numVertices);
+        blended.isBlended.resize(numVertices, 0);
+    }
+}
+
+void BlendedVertices::blend(const QVector<float>& coefficients) {
+    for (int i = 0; i < _meshes->getNumMeshes(); i++) {
+        if (_meshes->isBlendshaped(i)) {
+            blendMesh(i, coefficients);
+        }
+    }
+}
+
+void BlendedVertices::blendMesh(int meshIndex, const QVector<float>& coefficients) {
+    const BlendshapeMeshes::Mesh& mesh = _meshes->_meshes[meshIndex];
+    BlendedMesh& blended = _blendedMeshes[meshIndex];
+
+    // Put back the base mesh where the previous blend of this buffer moved it
+    for (int index : blended.blendedIndices) {
+        blended.vertices[index] = mesh.vertices[index];
+        blended.normalsAndTangents[2 * index] = mesh.normalsAndTangents[2 * index];
+        blended.normalsAndTangents[2 * index + 1] = mesh.normalsAndTangents[2 * index + 1];
+    }
+    blended.blendedIndices.clear();
+
+    // Accumulate the active blendshapes over the vertices they move only
+    int begin = mesh.vertices.size();
+    int end = 0;
+    const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+    for (int i = 0, n = qMin(coefficients.size(), mesh.blendshapes.size()); i < n; i++) {
+        float vertexCoefficient = coefficients.at(i);
+        const float EPSILON = 0.0001f;
+        if (vertexCoefficient < EPSILON) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
+        const int* indices = blendshape.indices.constData();
+        const glm::vec3* vertices = blendshape.vertices.constData();
+        const glm::vec3* normals = blendshape.normals.constData();
+        const glm::vec3* tangents = blendshape.tangents.constData();
+        const int numTangents = blendshape.tangents.size();
+        for (int j = 0; j < blendshape.indices.size(); j++) {
+            int index = indices[j];
+            if (!blended.isBlended[index]) {
+                blended.isBlended[index] = 1;
+                blended.blendedIndices.push_back(index);
+                blended.normals[index] = mesh.normals[index];
+                blended.tangents[index] = mesh.tangents[index];
+                begin = std::min(begin, index);
+                end = std::max(end, index + 1);
+            }
+            blended.vertices[index] += vertices[j] * vertexCoefficient;
+            blended.normals[index] += normals[j] * normalCoefficient;
+            if (j < numTangents) {
+                blended.tangents[index] += tangents[j] * normalCoefficient;
+            }
+        }
+    }
+    blended.blendedBegin = begin;
+    blended.blendedEnd = end;
+
+    // Pack the blended normals and tangents, in chunks over the worker threads for the meshes moving many vertices
+    const size_t PACK_GRAIN_SIZE = 4096;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, blended.blendedIndices.size(), PACK_GRAIN_SIZE),
+            [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t k = range.begin(); k < range.end(); k++) {
+            int index = blended.blendedIndices[k];
+            blended.isBlended[index] = 0;
+#if FBX_PACK_NORMALS
+            buffer_helpers::packNormalAndTangent(blended.normals[index], blended.tangents[index],
+                blended.normalsAndTangents[2 * index], blended.normalsAndTangents[2 * index + 1]);
+#else
+            blended.normalsAndTangents[2 * index] = blended.normals[index];
+            blended.normalsAndTangents[2 * index + 1] = blended.tangents[index];
+#endif
+        }
+    });
+}
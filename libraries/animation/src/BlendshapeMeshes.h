@@ -0,0 +1,92 @@
+//
+//  BlendshapeMeshes.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlendshapeMeshes_h
+#define hifi_BlendshapeMeshes_h
+
+#include <memory>
+#include <vector>
+
+#include <FBXReader.h>
+
+// The base vertices and blendshapes of the blendshaped meshes of a model, with the normals and tangents packed as in
+// the blended vertex buffers. Immutable once built, shared by the buffers blending them on the worker threads.
+class BlendshapeMeshes {
+public:
+    BlendshapeMeshes() {}
+    explicit BlendshapeMeshes(const FBXGeometry& geometry);
+
+    int getNumMeshes() const { return (int)_meshes.size(); }
+    bool isBlendshaped(int mesh) const { return !_meshes[mesh].blendshapes.isEmpty(); }
+    int getNumVertices(int mesh) const { return _meshes[mesh].vertices.size(); }
+
+    const QVector<glm::vec3>& getVertices(int mesh) const { return _meshes[mesh].vertices; }
+    // interleaved normal then tangent of each vertex
+    const std::vector<NormalType>& getNormalsAndTangents(int mesh) const { return _meshes[mesh].normalsAndTangents; }
+
+private:
+    friend class BlendedVertices;
+
+    class Mesh {
+    public:
+        QVector<glm::vec3> vertices;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> tangents;
+        std::vector<NormalType> normalsAndTangents;
+        QVector<FBXBlendshape> blendshapes;
+    };
+    std::vector<Mesh> _meshes;
+};
+
+// The blended vertices of the blendshaped meshes of a model, in the layout of their vertex buffers: the positions then the
+// interleaved normals and tangents of each mesh. Filled on a worker thread then uploaded on the main thread, a buffer
+// can be blended again once uploaded.
+//
+// A blend only writes the vertices moved by the active blendshapes, and restores the ones moved by the previous blend of
+// the buffer. The other vertices keep the base mesh.
+class BlendedVertices {
+public:
+    explicit BlendedVertices(const std::shared_ptr<const BlendshapeMeshes>& meshes);
+
+    const std::shared_ptr<const BlendshapeMeshes>& getMeshes() const { return _meshes; }
+
+    void blend(const QVector<float>& coefficients);
+
+    const std::vector<glm::vec3>& getVertices(int mesh) const { return _blendedMeshes[mesh].vertices; }
+    const std::vector<NormalType>& getNormalsAndTangents(int mesh) const { return _blendedMeshes[mesh].normalsAndTangents; }
+
+    // The range of the vertices of the mesh moved by the last blend, begin >= end when none moved
+    int getBlendedBegin(int mesh) const { return _blendedMeshes[mesh].blendedBegin; }
+    int getBlendedEnd(int mesh) const { return _blendedMeshes[mesh].blendedEnd; }
+
+private:
+    void blendMesh(int mesh, const QVector<float>& coefficients);
+
+    class BlendedMesh {
+    public:
+        std::vector<glm::vec3> vertices;
+        std::vector<NormalType> normalsAndTangents;
+
+        std::vector<int> blendedIndices;
+        int blendedBegin { 0 };
+        int blendedEnd { 0 };
+
+        // the unpacked normals and tangents of the blended vertices, and which vertices are blended
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> tangents;
+        std::vector<uint8_t> isBlended;
+    };
+
+    std::shared_ptr<const BlendshapeMeshes> _meshes;
+    std::vector<BlendedMesh> _blendedMeshes;
+};
+
+using BlendedVerticesPointer = std::shared_ptr<BlendedVertices>;
+
+#endif // hifi_BlendshapeMeshes_h
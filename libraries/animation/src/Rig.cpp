@@ -23,6 +23,8 @@
 #include <PerfStat.h>
 #include <ScriptValueUtils.h>
 #include <shared/NsightHelpers.h>
+#include <TBBHelpers.h>
+#include <tbb/task_arena.h>
 
 #include "AnimationLogging.h"
 #include "AnimClip.h"
@@ -1029,7 +1031,7 @@ void Rig::updateAnimationStateHandlers() { // called on avatar update thread (wh
 
         // Gather results in (likely from an earlier update).
         // Note: the behavior is undefined if a handler (re-)sets a trigger. Scripts should not be doing that.
-        _animVars.copyVariantsFrom(value.results); // If multiple handlers write the same anim var, the last registgered wins. (_map preserves order).
+        _animVars.copyVariantsFrom(value.results); // If multiple handlers write the same anim var, the last registered wins (_stateHandlers is ordered by id).
     }
 }
 
@@ -1037,21 +1039,32 @@ void Rig::updateAnimations(float deltaTime, const glm::mat4& rootTransform, cons
     DETAILED_PROFILE_RANGE_EX(simulation_animation_detail, __FUNCTION__, 0xffff00ff, 0);
     DETAILED_PERFORMANCE_TIMER("updateAnimations");
 
+    prepareAnimations(deltaTime, rootTransform, rigToWorldTransform);
+    evaluateAnimations();
+}
+
+void Rig::prepareAnimations(float deltaTime, const glm::mat4& rootTransform, const glm::mat4& rigToWorldTransform) {
     setModelOffset(rootTransform);
+    _preparedDeltaTime = deltaTime;
+    _preparedRigToWorldTransform = rigToWorldTransform;
 
     if (_animNode && _enabledAnimations) {
         DETAILED_PERFORMANCE_TIMER("handleTriggers");
 
         updateAnimationStateHandlers();
         _animVars.setRigToGeometryTransform(_rigToGeometryTransform);
+    }
+}
 
+void Rig::evaluateAnimations() {
+    if (_animNode && _enabledAnimations) {
         AnimContext context(_enableDebugDrawIKTargets, _enableDebugDrawIKConstraints, _enableDebugDrawIKChains,
-                            getGeometryToRigTransform(), rigToWorldTransform);
+                            getGeometryToRigTransform(), _preparedRigToWorldTransform);
 
         // evaluate the animation
         AnimNode::Triggers triggersOut;
 
-        _internalPoseSet._relativePoses = _animNode->evaluate(_animVars, context, deltaTime, triggersOut);
+        _internalPoseSet._relativePoses = _animNode->evaluate(_animVars, context, _preparedDeltaTime, triggersOut);
         if ((int)_internalPoseSet._relativePoses.size() != _animSkeleton->getNumJoints()) {
             // animations haven't fully loaded yet.
             _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
@@ -1071,6 +1084,26 @@ void Rig::updateAnimations(float deltaTime, const glm::mat4& rootTransform, cons
     }
 }
 
+void Rig::evaluateAnimationsInParallel(const std::vector<Rig*>& rigs, int maxConcurrency) {
+    PROFILE_RANGE(simulation_animation, __FUNCTION__);
+
+    // one rig per task, a graph is far more work than scheduling it
+    auto evaluate = [&] {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, rigs.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                rigs[i]->evaluateAnimations();
+            }
+        });
+    };
+
+    if (maxConcurrency > 0) {
+        tbb::task_arena arena(maxConcurrency);
+        arena.execute(evaluate);
+    } else {
+        evaluate();
+    }
+}
+
 void Rig::updateFromEyeParameters(const EyeParameters& params) {
     updateEyeJoint(params.leftEyeJointIndex, params.modelTranslation, params.modelRotation, params.eyeLookAt, params.eyeSaccade);
     updateEyeJoint(params.rightEyeJointIndex, params.modelTranslation, params.modelRotation, params.eyeLookAt, params.eyeSaccade);
@@ -165,6 +165,8 @@ public:
     // rig space
     glm::mat4 getJointTransform(int jointIndex) const;
     AnimPose getJointPose(int jointIndex) const;
+    // rig space, the poses getJointPose() returns for every joint
+    const AnimPoseVec& getAbsoluteJointPoses() const { return _internalPoseSet._absolutePoses; }
 
     // Start or stop animations as needed.
     void computeMotionAnimationState(float deltaTime, const glm::vec3& worldPosition, const glm::vec3& worldVelocity, const glm::quat& worldRotation, CharacterControllerState ccState);
@@ -172,6 +174,15 @@ public:
     // Regardless of who started the animations or how many, update the joints.
     void updateAnimations(float deltaTime, const glm::mat4& rootTransform, const glm::mat4& rigToWorldTransform);
 
+    // updateAnimations() split in two, so that the anim graphs of many rigs can be evaluated together.
+    // prepareAnimations() runs the state handlers and must be called from the thread that owns the rig.
+    void prepareAnimations(float deltaTime, const glm::mat4& rootTransform, const glm::mat4& rigToWorldTransform);
+    // Evaluates the anim graph into the rig's poses.  It touches nothing shared with other rigs.
+    void evaluateAnimations();
+    // Calls evaluateAnimations() on prepared rigs in parallel and returns when they are all done.
+    // maxConcurrency limits the number of worker threads, 0 uses all of them.
+    static void evaluateAnimationsInParallel(const std::vector<Rig*>& rigs, int maxConcurrency = 0);
+
     void updateFromControllerParameters(const ControllerParameters& params, float dt);
     void updateFromEyeParameters(const EyeParameters& params);
 
@@ -253,7 +264,7 @@ protected:
         std::vector<bool> _overrideFlags;
     };
 
-    // Only accessed by the main thread
+    // Only accessed by the main thread, or by the task evaluating this rig
     PoseSet _internalPoseSet;
 
     // Copy of the _poseSet for external threads.
@@ -284,6 +295,10 @@ protected:
     glm::vec3 _lastPosition;
     glm::vec3 _lastVelocity;
 
+    // arguments of the last prepareAnimations()
+    float _preparedDeltaTime { 0.0f };
+    glm::mat4 _preparedRigToWorldTransform;
+
     QUrl _animGraphURL;
     std::shared_ptr<AnimNode> _animNode;
     std::shared_ptr<AnimSkeleton> _animSkeleton;
@@ -0,0 +1,217 @@
+//
+//  SkinClusters.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SkinClusters.h"
+
+#include <GLMHelpers.h>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
+
+SkinClusters::SkinClusters(const FBXGeometry& geometry) {
+    _meshOffsets.push_back(0);
+    for (const FBXMesh& mesh : geometry.meshes) {
+        for (const FBXCluster& cluster : mesh.clusters) {
+            _jointIndices.push_back(cluster.jointIndex);
+            _inverseBindMatrices.push_back(cluster.inverseBindMatrix);
+            _inverseBindTransforms.push_back(cluster.inverseBindTransform);
+
+            // the components Transform::mult() composes, their identity when the transform doesn't use them
+            const Transform& bind = cluster.inverseBindTransform;
+            glm::vec3 scale = bind.isScaling() ? bind.getScale() : glm::vec3(1.0f);
+            glm::quat rot = bind.isRotating() ? bind.getRotation() : glm::quat();
+            glm::vec3 trans = bind.isTranslating() ? bind.getTranslation() : glm::vec3(0.0f);
+            _bindScaleX.push_back(scale.x);
+            _bindScaleY.push_back(scale.y);
+            _bindScaleZ.push_back(scale.z);
+            _bindRotX.push_back(rot.x);
+            _bindRotY.push_back(rot.y);
+            _bindRotZ.push_back(rot.z);
+            _bindRotW.push_back(rot.w);
+            _bindTransX.push_back(trans.x);
+            _bindTransY.push_back(trans.y);
+            _bindTransZ.push_back(trans.z);
+        }
+        _meshOffsets.push_back((int)_jointIndices.size());
+    }
+}
+
+void SkinClusters::evalJointMatrices(const AnimPoseVec& jointPoses, std::vector<glm::mat4>& jointMatrices) {
+    // the identity comes last, for the joint indices out of range
+    jointMatrices.resize(jointPoses.size() + 1);
+    for (size_t i = 0; i < jointPoses.size(); i++) {
+        jointMatrices[i] = jointPoses[i];
+    }
+    jointMatrices.back() = glm::mat4();
+}
+
+void SkinClusters::computeMatrices(int mesh, const std::vector<glm::mat4>& jointMatrices, glm::mat4* clusterMatrices) const {
+    const uint32_t identity = (uint32_t)jointMatrices.size() - 1;
+    const int begin = _meshOffsets[mesh];
+    const int end = _meshOffsets[mesh + 1];
+    for (int i = begin; i < end; i++) {
+        uint32_t joint = (uint32_t)_jointIndices[i];
+        const glm::mat4& jointMatrix = jointMatrices[joint < identity ? joint : identity];
+        glm_mat4u_mul(jointMatrix, _inverseBindMatrices[i], clusterMatrices[i - begin]);
+    }
+}
+
+void SkinClusters::computePoses(const AnimPoseVec& jointPoses, Poses& poses) const {
+    const int numClusters = getNumClusters();
+    const uint32_t numJoints = (uint32_t)jointPoses.size();
+    poses.scaleX.resize(numClusters);
+    poses.scaleY.resize(numClusters);
+    poses.scaleZ.resize(numClusters);
+    poses.rotX.resize(numClusters);
+    poses.rotY.resize(numClusters);
+    poses.rotZ.resize(numClusters);
+    poses.rotW.resize(numClusters);
+    poses.transX.resize(numClusters);
+    poses.transY.resize(numClusters);
+    poses.transZ.resize(numClusters);
+    poses.nonUniformClusters.clear();
+
+    // Gather the joint poses of the clusters into the output arrays
+    for (int i = 0; i < numClusters; i++) {
+        uint32_t joint = (uint32_t)_jointIndices[i];
+        const AnimPose& pose = (joint < numJoints) ? jointPoses[joint] : AnimPose::identity;
+        const glm::vec3& scale = pose.scale();
+        if (scale.x != scale.y || scale.x != scale.z || scale.x == 0.0f) {
+            poses.nonUniformClusters.push_back(i);
+        }
+        poses.scaleX[i] = scale.x;
+        poses.scaleY[i] = scale.y;
+        poses.scaleZ[i] = scale.z;
+        poses.rotX[i] = pose.rot().x;
+        poses.rotY[i] = pose.rot().y;
+        poses.rotZ[i] = pose.rot().z;
+        poses.rotW[i] = pose.rot().w;
+        poses.transX[i] = pose.trans().x;
+        poses.transY[i] = pose.trans().y;
+        poses.transZ[i] = pose.trans().z;
+    }
+
+    // Then compose them with the inverse bind transforms, component by component:
+    // with a uniform joint scale s, the cluster is (s * bindScale, jointRot * bindRot, jointTrans + jointRot * (s * bindTrans))
+    float* scaleX = poses.scaleX.data();
+    float* scaleY = poses.scaleY.data();
+    float* scaleZ = poses.scaleZ.data();
+    float* rotX = poses.rotX.data();
+    float* rotY = poses.rotY.data();
+    float* rotZ = poses.rotZ.data();
+    float* rotW = poses.rotW.data();
+    float* transX = poses.transX.data();
+    float* transY = poses.transY.data();
+    float* transZ = poses.transZ.data();
+    const float* bindScaleX = _bindScaleX.data();
+    const float* bindScaleY = _bindScaleY.data();
+    const float* bindScaleZ = _bindScaleZ.data();
+    const float* bindRotX = _bindRotX.data();
+    const float* bindRotY = _bindRotY.data();
+    const float* bindRotZ = _bindRotZ.data();
+    const float* bindRotW = _bindRotW.data();
+    const float* bindTransX = _bindTransX.data();
+    const float* bindTransY = _bindTransY.data();
+    const float* bindTransZ = _bindTransZ.data();
+    int i = 0;
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    // four clusters at a time, each register holding one component of the four
+    const __m128 two = _mm_set1_ps(2.0f);
+    for (; i + 4 <= numClusters; i += 4) {
+        __m128 s = _mm_loadu_ps(scaleX + i);
+        __m128 qx = _mm_loadu_ps(rotX + i);
+        __m128 qy = _mm_loadu_ps(rotY + i);
+        __m128 qz = _mm_loadu_ps(rotZ + i);
+        __m128 qw = _mm_loadu_ps(rotW + i);
+
+        // rotate the scaled bind translation by the joint rotation: v + 2 * cross(q, cross(q, v) + w * v)
+        __m128 vx = _mm_mul_ps(s, _mm_loadu_ps(bindTransX + i));
+        __m128 vy = _mm_mul_ps(s, _mm_loadu_ps(bindTransY + i));
+        __m128 vz = _mm_mul_ps(s, _mm_loadu_ps(bindTransZ + i));
+        __m128 cx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(qy, vz), _mm_mul_ps(qz, vy)), _mm_mul_ps(qw, vx));
+        __m128 cy = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(qz, vx), _mm_mul_ps(qx, vz)), _mm_mul_ps(qw, vy));
+        __m128 cz = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(qx, vy), _mm_mul_ps(qy, vx)), _mm_mul_ps(qw, vz));
+        _mm_storeu_ps(transX + i, _mm_add_ps(_mm_loadu_ps(transX + i),
+            _mm_add_ps(vx, _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qy, cz), _mm_mul_ps(qz, cy))))));
+        _mm_storeu_ps(transY + i, _mm_add_ps(_mm_loadu_ps(transY + i),
+            _mm_add_ps(vy, _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qz, cx), _mm_mul_ps(qx, cz))))));
+        _mm_storeu_ps(transZ + i, _mm_add_ps(_mm_loadu_ps(transZ + i),
+            _mm_add_ps(vz, _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qx, cy), _mm_mul_ps(qy, cx))))));
+
+        __m128 bx = _mm_loadu_ps(bindRotX + i);
+        __m128 by = _mm_loadu_ps(bindRotY + i);
+        __m128 bz = _mm_loadu_ps(bindRotZ + i);
+        __m128 bw = _mm_loadu_ps(bindRotW + i);
+        _mm_storeu_ps(rotX + i, _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(qw, bx), _mm_mul_ps(qx, bw)), _mm_mul_ps(qy, bz)), _mm_mul_ps(qz, by)));
+        _mm_storeu_ps(rotY + i, _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(qw, by), _mm_mul_ps(qx, bz)), _mm_mul_ps(qy, bw)), _mm_mul_ps(qz, bx)));
+        _mm_storeu_ps(rotZ + i, _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, bz), _mm_mul_ps(qx, by)), _mm_mul_ps(qy, bx)), _mm_mul_ps(qz, bw)));
+        _mm_storeu_ps(rotW + i, _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(qw, bw), _mm_mul_ps(qx, bx)), _mm_mul_ps(qy, by)), _mm_mul_ps(qz, bz)));
+
+        _mm_storeu_ps(scaleX + i, _mm_mul_ps(s, _mm_loadu_ps(bindScaleX + i)));
+        _mm_storeu_ps(scaleY + i, _mm_mul_ps(s, _mm_loadu_ps(bindScaleY + i)));
+        _mm_storeu_ps(scaleZ + i, _mm_mul_ps(s, _mm_loadu_ps(bindScaleZ + i)));
+    }
+#endif
+
+    // the remaining clusters, or all of them without SSE
+    for (; i < numClusters; i++) {
+        float s = scaleX[i];
+        float qx = rotX[i];
+        float qy = rotY[i];
+        float qz = rotZ[i];
+        float qw = rotW[i];
+
+        float vx = s * bindTransX[i];
+        float vy = s * bindTransY[i];
+        float vz = s * bindTransZ[i];
+        float cx = qy * vz - qz * vy + qw * vx;
+        float cy = qz * vx - qx * vz + qw * vy;
+        float cz = qx * vy - qy * vx + qw * vz;
+        transX[i] += vx + 2.0f * (qy * cz - qz * cy);
+        transY[i] += vy + 2.0f * (qz * cx - qx * cz);
+        transZ[i] += vz + 2.0f * (qx * cy - qy * cx);
+
+        float bx = bindRotX[i];
+        float by = bindRotY[i];
+        float bz = bindRotZ[i];
+        float bw = bindRotW[i];
+        rotX[i] = qw * bx + qx * bw + qy * bz - qz * by;
+        rotY[i] = qw * by - qx * bz + qy * bw + qz * bx;
+        rotZ[i] = qw * bz + qx * by - qy * bx + qz * bw;
+        rotW[i] = qw * bw - qx * bx - qy * by - qz * bz;
+
+        scaleX[i] = s * bindScaleX[i];
+        scaleY[i] = s * bindScaleY[i];
+        scaleZ[i] = s * bindScaleZ[i];
+    }
+
+    // The few clusters of non uniformly scaled joints go through Transform
+    for (int cluster : poses.nonUniformClusters) {
+        uint32_t joint = (uint32_t)_jointIndices[cluster];
+        const AnimPose& pose = (joint < numJoints) ? jointPoses[joint] : AnimPose::identity;
+        Transform jointTransform(pose.rot(), pose.scale(), pose.trans());
+        Transform clusterTransform;
+        Transform::mult(clusterTransform, jointTransform, _inverseBindTransforms[cluster]);
+        glm::vec3 scale = clusterTransform.getScale();
+        glm::quat rot = clusterTransform.getRotation();
+        glm::vec3 trans = clusterTransform.getTranslation();
+        scaleX[cluster] = scale.x;
+        scaleY[cluster] = scale.y;
+        scaleZ[cluster] = scale.z;
+        rotX[cluster] = rot.x;
+        rotY[cluster] = rot.y;
+        rotZ[cluster] = rot.z;
+        rotW[cluster] = rot.w;
+        transX[cluster] = trans.x;
+        transY[cluster] = trans.y;
+        transZ[cluster] = trans.z;
+    }
+}
@@ -0,0 +1,70 @@
+//
+//  SkinClusters.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SkinClusters_h
+#define hifi_SkinClusters_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <FBX.h>
+
+#include "AnimPose.h"
+
+// The skin clusters of every mesh of a model, with the components of their inverse bind transforms in separate arrays,
+// to turn the absolute joint poses of the model into the cluster matrices or poses of all its meshes in one pass.
+//
+// The computations are const, several models can compute their clusters on different threads at once.
+class SkinClusters {
+public:
+    // The cluster poses for dual quaternion skinning, one array per component
+    class Poses {
+    public:
+        glm::vec3 getScale(int cluster) const { return glm::vec3(scaleX[cluster], scaleY[cluster], scaleZ[cluster]); }
+        glm::quat getRotation(int cluster) const { return glm::quat(rotW[cluster], rotX[cluster], rotY[cluster], rotZ[cluster]); }
+        glm::vec3 getTranslation(int cluster) const { return glm::vec3(transX[cluster], transY[cluster], transZ[cluster]); }
+
+        std::vector<float> scaleX, scaleY, scaleZ;
+        std::vector<float> rotX, rotY, rotZ, rotW;
+        std::vector<float> transX, transY, transZ;
+        // the clusters of joints with a non uniform scale, which can't be composed component by component
+        std::vector<int> nonUniformClusters;
+    };
+
+    SkinClusters() {}
+    explicit SkinClusters(const FBXGeometry& geometry);
+
+    int getNumMeshes() const { return (int)_meshOffsets.size() - 1; }
+    int getNumClusters() const { return (int)_jointIndices.size(); }
+    // index of the first cluster of a mesh in the cluster arrays
+    int getMeshOffset(int mesh) const { return _meshOffsets[mesh]; }
+
+    // The rig space matrices of the joints, the clusters of joints missing from the poses get the identity
+    static void evalJointMatrices(const AnimPoseVec& jointPoses, std::vector<glm::mat4>& jointMatrices);
+
+    // Matrix palette skinning: the joint matrix times the inverse bind matrix of each cluster of the mesh
+    void computeMatrices(int mesh, const std::vector<glm::mat4>& jointMatrices, glm::mat4* clusterMatrices) const;
+
+    // Dual quaternion skinning: the joint pose composed with the inverse bind transform of every cluster of the model,
+    // the same as Transform::mult() of the joint transform by the inverse bind transform
+    void computePoses(const AnimPoseVec& jointPoses, Poses& poses) const;
+
+private:
+    std::vector<int> _meshOffsets;
+    std::vector<int> _jointIndices;
+    std::vector<glm::mat4> _inverseBindMatrices;
+    std::vector<Transform> _inverseBindTransforms;
+
+    // the components of the inverse bind transforms
+    std::vector<float> _bindScaleX, _bindScaleY, _bindScaleZ;
+    std::vector<float> _bindRotX, _bindRotY, _bindRotZ, _bindRotW;
+    std::vector<float> _bindTransX, _bindTransY, _bindTransZ;
+};
+
+#endif // hifi_SkinClusters_h
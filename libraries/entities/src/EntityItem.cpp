@@ -31,6 +31,7 @@
 #include <SharedUtil.h> // usecTimestampNow()
 #include <LogHandler.h>
 #include <Extents.h>
+#include <workload/Space.h>
 
 #include "EntityScriptingInterface.h"
 #include "EntitiesLogging.h"
@@ -1159,6 +1160,11 @@ bool EntityItem::isMoving() const {
     return hasVelocity() || hasAngularVelocity();
 }
 
+bool EntityItem::isFarFromViewers() const {
+    uint8_t region = _region;
+    return region == workload::Space::REGION_FAR || region == workload::Space::REGION_UNKNOWN;
+}
+
 bool EntityItem::isMovingRelativeToParent() const {
     return hasLocalVelocity() || hasLocalAngularVelocity();
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_EntityItem_h
 #define hifi_EntityItem_h
 
+#include <atomic>
 #include <memory>
 #include <stdint.h>
 
@@ -377,6 +378,18 @@ public:
 
     bool isSimulated() const { return _simulated; }
 
+    // proxy of the entity in the workload::Space of its EntitySimulation, -1 when it has none
+    int32_t getSpaceIndex() const { return _spaceIndex; }
+    void setSpaceIndex(int32_t index) { _spaceIndex = index; }
+
+    // workload::Space region of the entity relative to the closest viewer, UNCATEGORIZED when its simulation doesn't
+    // keep track of viewers
+    static const uint8_t UNCATEGORIZED = UINT8_MAX;
+    uint8_t getRegion() const { return _region; }
+    void setRegion(uint8_t region) { _region = region; }
+    // whether the entity is in the far region of the closest viewer or out of range of every viewer
+    bool isFarFromViewers() const;
+
     void* getPhysicsInfo() const { return _physicsInfo; }
 
     void setPhysicsInfo(void* data) { _physicsInfo = data; }
@@ -604,6 +617,8 @@ protected:
     EntityTreeElementPointer _element; // set by EntityTreeElement
     void* _physicsInfo { nullptr }; // set by EntitySimulation
     bool _simulated { false }; // set by EntitySimulation
+    std::atomic<uint8_t> _region { UNCATEGORIZED }; // set by EntitySimulation, read by the send threads
+    int32_t _spaceIndex { -1 }; // set by EntitySimulation
 
     bool addActionInternal(EntitySimulationPointer simulation, EntityDynamicPointer action);
     bool removeActionInternal(const QUuid& actionID, EntitySimulationPointer simulation = nullptr);
@@ -233,8 +233,12 @@ void EntitySimulation::clearEntities() {
 
 void EntitySimulation::moveSimpleKinematics(uint64_t now) {
     PROFILE_RANGE_EX(simulation_physics, "MoveSimples", 0xffff00ff, (uint64_t)_simpleKinematicEntities.size());
-    SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
-    while (itemItr != _simpleKinematicEntities.end()) {
+    moveKinematicEntities(_simpleKinematicEntities, now);
+}
+
+void EntitySimulation::moveKinematicEntities(SetOfEntities& entities, uint64_t now) {
+    SetOfEntities::iterator itemItr = entities.begin();
+    while (itemItr != entities.end()) {
         EntityItemPointer entity = *itemItr;
 
         // The entity-server doesn't know where avatars are, so don't attempt to do simple extrapolation for
@@ -249,7 +253,7 @@ void EntitySimulation::moveSimpleKinematics(uint64_t now) {
             ++itemItr;
         } else {
             // the entity is no longer non-physical-kinematic
-            itemItr = _simpleKinematicEntities.erase(itemItr);
+            itemItr = entities.erase(itemItr);
         }
     }
 }
@@ -95,6 +95,11 @@ protected:
     void callUpdateOnEntitiesThatNeedIt(uint64_t now);
     virtual void sortEntitiesThatMoved();
 
+    // extrapolates the entities that are still non-physical-kinematic and removes the others from the set
+    void moveKinematicEntities(SetOfEntities& entities, uint64_t now);
+
+    const SetOfEntities& getAllEntities() const { return _allEntities; }
+
     QMutex _mutex{ QMutex::Recursive };
 
     SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
@@ -12,11 +12,41 @@
 #include "SimpleEntitySimulation.h"
 
 #include <DirtyOctreeElementOperator.h>
+#include <workload/Space.h>
 
 #include "EntityItem.h"
 #include "EntitiesLogging.h"
 
 const uint64_t MAX_OWNERLESS_PERIOD = 2 * USECS_PER_SECOND;
+const uint64_t FAR_KINEMATIC_STEP_PERIOD = USECS_PER_SECOND / 5;
+
+const float DEFAULT_WORKLOAD_NEAR_RADIUS = 50.0f; // meters
+const float DEFAULT_WORKLOAD_MID_RADIUS = 200.0f;
+const float DEFAULT_WORKLOAD_FAR_RADIUS = 1000.0f;
+
+static workload::Space::Sphere computeSphere(const EntityItemPointer& entity) {
+    bool success;
+    AACube cube = entity->getQueryAACube(success);
+    if (success) {
+        const float HALF_SQRT_THREE = 0.866025f;
+        return workload::Space::Sphere(cube.calcCenter(), HALF_SQRT_THREE * cube.getScale());
+    }
+    // its ancestry isn't known yet so it may be anywhere: keep it in range of every viewer
+    return workload::Space::Sphere(0.0f, 0.0f, 0.0f, (float)TREE_SCALE);
+}
+
+SimpleEntitySimulation::SimpleEntitySimulation() :
+    EntitySimulation(),
+    _space(new workload::Space())
+{
+    _workloadRadiuses[0] = DEFAULT_WORKLOAD_NEAR_RADIUS;
+    _workloadRadiuses[1] = DEFAULT_WORKLOAD_MID_RADIUS;
+    _workloadRadiuses[2] = DEFAULT_WORKLOAD_FAR_RADIUS;
+}
+
+SimpleEntitySimulation::~SimpleEntitySimulation() {
+    clearEntitiesInternal();
+}
 
 void SimpleEntitySimulation::clearOwnership(const QUuid& ownerID) {
     QMutexLocker lock(&_mutex);
@@ -50,16 +80,65 @@ void SimpleEntitySimulation::clearOwnership(const QUuid& ownerID) {
     }
 }
 
+void SimpleEntitySimulation::setWorkloadEnabled(bool enabled) {
+    QMutexLocker lock(&_mutex);
+    if (enabled != _workloadEnabled) {
+        _workloadEnabled = enabled;
+        if (enabled) {
+            addAllProxies();
+        } else {
+            removeAllProxies(usecTimestampNow());
+        }
+        QMutexLocker viewsLock(&_viewsMutex);
+        _viewsChanged = true;
+    }
+}
+
+void SimpleEntitySimulation::setWorkloadRadiuses(float nearRadius, float midRadius, float farRadius) {
+    QMutexLocker lock(&_viewsMutex);
+    _workloadRadiuses[0] = nearRadius;
+    _workloadRadiuses[1] = glm::max(midRadius, nearRadius);
+    _workloadRadiuses[2] = glm::max(farRadius, _workloadRadiuses[1]);
+    _viewsChanged = true;
+}
+
+void SimpleEntitySimulation::setWorkloadViews(const std::vector<glm::vec3>& positions) {
+    QMutexLocker lock(&_viewsMutex);
+    if (positions != _viewPositions) {
+        _viewPositions = positions;
+        _viewsChanged = true;
+    }
+}
+
+int SimpleEntitySimulation::getNumFarKinematicEntities() {
+    QMutexLocker lock(&_mutex);
+    return _farKinematicEntities.size();
+}
+
+int SimpleEntitySimulation::getNumSleepingKinematicEntities() {
+    QMutexLocker lock(&_mutex);
+    return _sleepingKinematicEntities.size();
+}
+
 void SimpleEntitySimulation::updateEntitiesInternal(uint64_t now) {
     expireStaleOwnerships(now);
     stopOwnerlessEntities(now);
+    updateWorkload(now);
+    if (now >= _nextFarKinematicStep) {
+        PROFILE_RANGE_EX(simulation_physics, "MoveFarSimples", 0xffff00ff, (uint64_t)_farKinematicEntities.size());
+        moveKinematicEntities(_farKinematicEntities, now);
+        _nextFarKinematicStep = now + FAR_KINEMATIC_STEP_PERIOD;
+    }
 }
 
 void SimpleEntitySimulation::addEntityInternal(EntityItemPointer entity) {
+    if (_workloadEnabled) {
+        QMutexLocker lock(&_mutex);
+        addProxy(entity);
+    }
     if (entity->isMovingRelativeToParent() && !entity->getPhysicsInfo()) {
         QMutexLocker lock(&_mutex);
-        _simpleKinematicEntities.insert(entity);
-        entity->setLastSimulated(usecTimestampNow());
+        addKinematicEntity(entity, usecTimestampNow());
     }
     if (!entity->getSimulatorID().isNull()) {
         QMutexLocker lock(&_mutex);
@@ -77,19 +156,28 @@ void SimpleEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
     EntitySimulation::removeEntityInternal(entity);
     _entitiesWithSimulationOwner.remove(entity);
     _entitiesThatNeedSimulationOwner.remove(entity);
+    _farKinematicEntities.remove(entity);
+    _sleepingKinematicEntities.remove(entity);
+
+    int32_t proxyId = entity->getSpaceIndex();
+    if (proxyId != -1) {
+        _space->deleteProxy(proxyId);
+        _proxyEntities[proxyId].reset();
+        entity->setSpaceIndex(-1);
+    }
+    entity->setRegion(EntityItem::UNCATEGORIZED);
 }
 
 void SimpleEntitySimulation::changeEntityInternal(EntityItemPointer entity) {
     {
         QMutexLocker lock(&_mutex);
+        if (_workloadEnabled && (entity->getDirtyFlags() & (Simulation::DIRTY_POSITION | Simulation::DIRTY_SHAPE))) {
+            updateProxy(entity);
+        }
         if (entity->isMovingRelativeToParent() && !entity->getPhysicsInfo()) {
-            int numKinematicEntities = _simpleKinematicEntities.size();
-            _simpleKinematicEntities.insert(entity);
-            if (numKinematicEntities != _simpleKinematicEntities.size()) {
-                entity->setLastSimulated(usecTimestampNow());
-            }
+            addKinematicEntity(entity, usecTimestampNow());
         } else {
-            _simpleKinematicEntities.remove(entity);
+            removeKinematicEntity(entity);
         }
     }
     if (entity->getSimulatorID().isNull()) {
@@ -113,6 +201,17 @@ void SimpleEntitySimulation::clearEntitiesInternal() {
     QMutexLocker lock(&_mutex);
     _entitiesWithSimulationOwner.clear();
     _entitiesThatNeedSimulationOwner.clear();
+    _farKinematicEntities.clear();
+    _sleepingKinematicEntities.clear();
+
+    for (auto& entity : _proxyEntities) {
+        if (entity) {
+            entity->setSpaceIndex(-1);
+            entity->setRegion(EntityItem::UNCATEGORIZED);
+        }
+    }
+    _proxyEntities.clear();
+    _space.reset(new workload::Space());
 }
 
 void SimpleEntitySimulation::sortEntitiesThatMoved() {
@@ -120,6 +219,9 @@ void SimpleEntitySimulation::sortEntitiesThatMoved() {
     while (itemItr != _entitiesToSort.end()) {
         EntityItemPointer entity = *itemItr;
         entity->updateQueryAACube();
+        if (_workloadEnabled) {
+            updateProxy(entity);
+        }
         ++itemItr;
     }
     EntitySimulation::sortEntitiesThatMoved();
@@ -179,3 +281,131 @@ void SimpleEntitySimulation::stopOwnerlessEntities(uint64_t now) {
         }
     }
 }
+
+void SimpleEntitySimulation::addKinematicEntity(const EntityItemPointer& entity, uint64_t now) {
+    if (_simpleKinematicEntities.contains(entity) || _farKinematicEntities.contains(entity) ||
+            _sleepingKinematicEntities.contains(entity)) {
+        return;
+    }
+    entity->setLastSimulated(now);
+    uint8_t region = entity->getRegion();
+    if (region == workload::Space::REGION_UNKNOWN) {
+        _sleepingKinematicEntities.insert(entity);
+    } else if (region == workload::Space::REGION_FAR) {
+        _farKinematicEntities.insert(entity);
+    } else {
+        _simpleKinematicEntities.insert(entity);
+    }
+}
+
+void SimpleEntitySimulation::removeKinematicEntity(const EntityItemPointer& entity) {
+    _simpleKinematicEntities.remove(entity);
+    _farKinematicEntities.remove(entity);
+    _sleepingKinematicEntities.remove(entity);
+}
+
+void SimpleEntitySimulation::addProxy(const EntityItemPointer& entity) {
+    int32_t proxyId = _space->createProxy(computeSphere(entity));
+    if (proxyId >= (int32_t)_proxyEntities.size()) {
+        _proxyEntities.resize(proxyId + 1);
+    }
+    _proxyEntities[proxyId] = entity;
+    entity->setSpaceIndex(proxyId);
+    // a new proxy is out of range until the next update categorizes it
+    entity->setRegion(workload::Space::REGION_UNKNOWN);
+}
+
+void SimpleEntitySimulation::updateProxy(const EntityItemPointer& entity) {
+    int32_t proxyId = entity->getSpaceIndex();
+    if (proxyId != -1) {
+        _space->updateProxy(proxyId, computeSphere(entity));
+    }
+}
+
+void SimpleEntitySimulation::updateWorkload(uint64_t now) {
+    if (!_workloadEnabled) {
+        return;
+    }
+    PROFILE_RANGE(simulation_physics, "Workload");
+    {
+        QMutexLocker lock(&_viewsMutex);
+        if (_viewsChanged) {
+            std::vector<workload::Space::View> views;
+            views.reserve(_viewPositions.size());
+            for (const auto& position : _viewPositions) {
+                views.emplace_back(position, _workloadRadiuses[0], _workloadRadiuses[1], _workloadRadiuses[2]);
+            }
+            _space->setViews(views);
+            _viewsChanged = false;
+        }
+    }
+
+    std::vector<workload::Space::Change> changes;
+    _space->categorizeAndGetChanges(changes);
+    for (const auto& change : changes) {
+        const EntityItemPointer& entity = _proxyEntities[change.proxyId];
+        if (!entity) {
+            continue;
+        }
+        entity->setRegion(change.region);
+
+        // the kinematic entities move to the set of their new region, from whichever set holds them
+        bool wasSleeping = _sleepingKinematicEntities.contains(entity);
+        if (!wasSleeping && !_farKinematicEntities.contains(entity) && !_simpleKinematicEntities.contains(entity)) {
+            continue;
+        }
+        removeKinematicEntity(entity);
+        if (wasSleeping) {
+            wakeEntity(entity, now);
+        }
+        if (change.region == workload::Space::REGION_UNKNOWN) {
+            _sleepingKinematicEntities.insert(entity);
+        } else if (change.region == workload::Space::REGION_FAR) {
+            _farKinematicEntities.insert(entity);
+        } else {
+            _simpleKinematicEntities.insert(entity);
+        }
+    }
+}
+
+void SimpleEntitySimulation::wakeEntity(const EntityItemPointer& entity, uint64_t now) {
+    // it resumes its motion from where it stopped, which the viewers that knew it need to hear about
+    entity->setLastSimulated(now);
+    entity->markAsChangedOnServer();
+    if (auto element = entity->getElement()) {
+        DirtyOctreeElementOperator op(element);
+        getEntityTree()->recurseTreeWithOperator(&op);
+    }
+}
+
+void SimpleEntitySimulation::addAllProxies() {
+    for (auto& entity : getAllEntities()) {
+        addProxy(entity);
+    }
+    // the kinematic entities sleep like their proxies until the next update categorizes them
+    for (auto& entity : _simpleKinematicEntities) {
+        _sleepingKinematicEntities.insert(entity);
+    }
+    _simpleKinematicEntities.clear();
+}
+
+void SimpleEntitySimulation::removeAllProxies(uint64_t now) {
+    for (auto& entity : _farKinematicEntities) {
+        _simpleKinematicEntities.insert(entity);
+    }
+    for (auto& entity : _sleepingKinematicEntities) {
+        wakeEntity(entity, now);
+        _simpleKinematicEntities.insert(entity);
+    }
+    _farKinematicEntities.clear();
+    _sleepingKinematicEntities.clear();
+
+    for (auto& entity : _proxyEntities) {
+        if (entity) {
+            entity->setSpaceIndex(-1);
+            entity->setRegion(EntityItem::UNCATEGORIZED);
+        }
+    }
+    _proxyEntities.clear();
+    _space.reset(new workload::Space());
+}
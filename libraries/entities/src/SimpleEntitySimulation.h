@@ -12,21 +12,44 @@
 #ifndef hifi_SimpleEntitySimulation_h
 #define hifi_SimpleEntitySimulation_h
 
+#include <memory>
+#include <vector>
+
 #include "EntitySimulation.h"
 
+namespace workload {
+    class Space;
+}
+
 class SimpleEntitySimulation;
 using SimpleEntitySimulationPointer = std::shared_ptr<SimpleEntitySimulation>;
 
 
 /// provides simple velocity + gravity extrapolation of EntityItem's
+///
+/// When the workload is enabled the entities are categorized by their distance to the closest viewer: those in
+/// the far region are extrapolated at a lower rate and those beyond it stop until a viewer comes back in range.
 
 class SimpleEntitySimulation : public EntitySimulation {
 public:
-    SimpleEntitySimulation() : EntitySimulation() { }
-    ~SimpleEntitySimulation() { clearEntitiesInternal(); }
+    SimpleEntitySimulation();
+    ~SimpleEntitySimulation();
 
     void clearOwnership(const QUuid& ownerID);
 
+    /// \param enabled whether to categorize the entities by their distance to the viewers
+    void setWorkloadEnabled(bool enabled);
+    bool isWorkloadEnabled() const { return _workloadEnabled; }
+
+    /// \param nearRadius, midRadius, farRadius radiuses of the regions around every viewer (meters)
+    void setWorkloadRadiuses(float nearRadius, float midRadius, float farRadius);
+
+    /// \param positions of the viewers, they are applied on the next update so this can be called from any thread
+    void setWorkloadViews(const std::vector<glm::vec3>& positions);
+
+    int getNumFarKinematicEntities();
+    int getNumSleepingKinematicEntities();
+
 protected:
     void updateEntitiesInternal(uint64_t now) override;
     void addEntityInternal(EntityItemPointer entity) override;
@@ -39,10 +62,31 @@ protected:
     void expireStaleOwnerships(uint64_t now);
     void stopOwnerlessEntities(uint64_t now);
 
+    void addKinematicEntity(const EntityItemPointer& entity, uint64_t now);
+    void removeKinematicEntity(const EntityItemPointer& entity);
+    void addProxy(const EntityItemPointer& entity);
+    void updateProxy(const EntityItemPointer& entity);
+    void updateWorkload(uint64_t now);
+    void wakeEntity(const EntityItemPointer& entity, uint64_t now);
+    void addAllProxies();
+    void removeAllProxies(uint64_t now);
+
     SetOfEntities _entitiesWithSimulationOwner;
     SetOfEntities _entitiesThatNeedSimulationOwner;
     uint64_t _nextOwnerlessExpiry { 0 };
     uint64_t _nextStaleOwnershipExpiry { (uint64_t)(-1) };
+
+    std::unique_ptr<workload::Space> _space;
+    std::vector<EntityItemPointer> _proxyEntities; // indexed by proxy
+    SetOfEntities _farKinematicEntities; // kinematic entities that are extrapolated at a lower rate
+    SetOfEntities _sleepingKinematicEntities; // kinematic entities that are out of range of every viewer
+    uint64_t _nextFarKinematicStep { 0 };
+    float _workloadRadiuses[3];
+    bool _workloadEnabled { false };
+
+    QMutex _viewsMutex;
+    std::vector<glm::vec3> _viewPositions;
+    bool _viewsChanged { false };
 };
 
 #endif // hifi_SimpleEntitySimulation_h
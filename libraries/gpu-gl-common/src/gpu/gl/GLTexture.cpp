@@ -224,8 +224,14 @@ TransferJob::TransferJob(const GLTexture& parent, uint16_t sourceMip, uint16_t t
     // Buffering can invoke disk IO, so it should be off of the main and render threads
     _bufferingLambda = [=] {
         auto mipStorage = _parent._gpuObject.accessStoredMipFace(sourceMip, face);
-        if (mipStorage) {
+        // testing a lazy file storage maps it, and fails if it can't be mapped
+        if (mipStorage && *mipStorage) {
             _mipData = mipStorage->createView(_transferSize, _transferOffset);
+            // KTX mips are file mappings paged in on first read, copy the lines here so the transfer only reads memory
+            // and the file is released as soon as the buffering is done
+            if (_mipData && std::dynamic_pointer_cast<const storage::LazyFileStorage>(mipStorage)) {
+                _mipData = _mipData->toMemoryStorage();
+            }
         } else {
             qCWarning(gpugllogging) << "Buffering failed because mip could not be retrieved from texture " << _parent._source.c_str() ;
         }
@@ -38,12 +38,64 @@ static const int MAX_NUM_UNIFORM_BUFFERS = 12;
 static const int MAX_NUM_RESOURCE_BUFFERS = 16;
 static const int MAX_NUM_RESOURCE_TEXTURES = 16;
 
-size_t Batch::_commandsMax { BATCH_PREALLOCATE_MIN };
-size_t Batch::_commandOffsetsMax { BATCH_PREALLOCATE_MIN };
-size_t Batch::_paramsMax { BATCH_PREALLOCATE_MIN };
-size_t Batch::_dataMax { BATCH_PREALLOCATE_MIN };
-size_t Batch::_objectsMax { BATCH_PREALLOCATE_MIN };
-size_t Batch::_drawCallInfosMax { BATCH_PREALLOCATE_MIN };
+std::atomic<size_t> Batch::_commandsMax { BATCH_PREALLOCATE_MIN };
+std::atomic<size_t> Batch::_commandOffsetsMax { BATCH_PREALLOCATE_MIN };
+std::atomic<size_t> Batch::_paramsMax { BATCH_PREALLOCATE_MIN };
+std::atomic<size_t> Batch::_dataMax { BATCH_PREALLOCATE_MIN };
+std::atomic<size_t> Batch::_objectsMax { BATCH_PREALLOCATE_MIN };
+std::atomic<size_t> Batch::_drawCallInfosMax { BATCH_PREALLOCATE_MIN };
+
+// The storage of the commands, params and data of the batches.
+// A batch lives for the frame it is recorded in: it is destroyed once the frame is executed, and gives its storage back
+// to the pool, for a batch of a later frame to record in without allocating nor growing it again.
+// The batches are recorded on the render and worker threads and destroyed on the present thread, so the pool is shared.
+class BatchStorage {
+public:
+    Batch::Commands commands;
+    Batch::CommandOffsets commandOffsets;
+    Batch::Params params;
+    Batch::Bytes data;
+
+    void swap(Batch& batch) {
+        commands.swap(batch._commands);
+        commandOffsets.swap(batch._commandOffsets);
+        params.swap(batch._params);
+        data.swap(batch._data);
+    }
+};
+
+// Beyond this many, the storage released is freed
+static const size_t MAX_POOLED_BATCH_STORAGES = 256;
+
+static std::mutex batchStoragePoolMutex;
+static std::vector<BatchStorage> batchStoragePool;
+
+static bool acquireBatchStorage(Batch& batch) {
+    std::lock_guard<std::mutex> lock(batchStoragePoolMutex);
+    if (batchStoragePool.empty()) {
+        return false;
+    }
+    batchStoragePool.back().swap(batch);
+    batchStoragePool.pop_back();
+    return true;
+}
+
+static void releaseBatchStorage(Batch& batch) {
+    // a batch copied into a frame is left without storage
+    if (batch._commands.capacity() == 0) {
+        return;
+    }
+    batch._commands.clear();
+    batch._commandOffsets.clear();
+    batch._params.clear();
+    batch._data.clear();
+
+    std::lock_guard<std::mutex> lock(batchStoragePoolMutex);
+    if (batchStoragePool.size() < MAX_POOLED_BATCH_STORAGES) {
+        batchStoragePool.emplace_back();
+        batchStoragePool.back().swap(batch);
+    }
+}
 
 Batch::Batch(const char* name) {
 #ifdef DEBUG
@@ -51,10 +103,12 @@ Batch::Batch(const char* name) {
         _name = name;
     }
 #endif
-    _commands.reserve(_commandsMax);
-    _commandOffsets.reserve(_commandOffsetsMax);
-    _params.reserve(_paramsMax);
-    _data.reserve(_dataMax);
+    if (!acquireBatchStorage(*this)) {
+        _commands.reserve(_commandsMax);
+        _commandOffsets.reserve(_commandOffsetsMax);
+        _params.reserve(_paramsMax);
+        _data.reserve(_dataMax);
+    }
     _objects.reserve(_objectsMax);
     _drawCallInfos.reserve(_drawCallInfosMax);
 }
@@ -92,21 +146,23 @@ Batch::Batch(const Batch& batch_) {
 }
 
 Batch::~Batch() {
-    _commandsMax = std::max(_commands.size(), _commandsMax);
-    _commandOffsetsMax = std::max(_commandOffsets.size(), _commandOffsetsMax);
-    _paramsMax = std::max(_params.size(), _paramsMax);
-    _dataMax = std::max(_data.size(), _dataMax);
-    _objectsMax = std::max(_objects.size(), _objectsMax);
-    _drawCallInfosMax = std::max(_drawCallInfos.size(), _drawCallInfosMax);
+    growBatchPreallocation(_commandsMax, _commands.size());
+    growBatchPreallocation(_commandOffsetsMax, _commandOffsets.size());
+    growBatchPreallocation(_paramsMax, _params.size());
+    growBatchPreallocation(_dataMax, _data.size());
+    growBatchPreallocation(_objectsMax, _objects.size());
+    growBatchPreallocation(_drawCallInfosMax, _drawCallInfos.size());
+
+    releaseBatchStorage(*this);
 }
 
 void Batch::clear() {
-    _commandsMax = std::max(_commands.size(), _commandsMax);
-    _commandOffsetsMax = std::max(_commandOffsets.size(), _commandOffsetsMax);
-    _paramsMax = std::max(_params.size(), _paramsMax);
-    _dataMax = std::max(_data.size(), _dataMax);
-    _objectsMax = std::max(_objects.size(), _objectsMax);
-    _drawCallInfosMax = std::max(_drawCallInfos.size(), _drawCallInfosMax);
+    growBatchPreallocation(_commandsMax, _commands.size());
+    growBatchPreallocation(_commandOffsetsMax, _commandOffsets.size());
+    growBatchPreallocation(_paramsMax, _params.size());
+    growBatchPreallocation(_dataMax, _data.size());
+    growBatchPreallocation(_objectsMax, _objects.size());
+    growBatchPreallocation(_drawCallInfosMax, _drawCallInfos.size());
 
     _commands.clear();
     _commandOffsets.clear();
@@ -11,6 +11,7 @@
 #include "Context.h"
 
 #include <shared/GlobalAppProperties.h>
+#include <TBBHelpers.h>
 
 #include "Frame.h"
 #include "GPULogging.h"
@@ -73,6 +74,19 @@ void Context::appendFrameBatch(Batch& batch) {
     _currentFrame->batches.push_back(batch);
 }
 
+void Context::recordFrameBatches(const char* name, size_t numBatches, const BatchRecorder& record) {
+    PROFILE_RANGE(render_gpu, __FUNCTION__);
+    std::vector<std::unique_ptr<Batch>> batches(numBatches);
+    tbb::parallel_for((size_t)0, numBatches, [&](size_t index) {
+        batches[index].reset(new Batch(name));
+        record(*batches[index], index);
+    });
+
+    for (auto& batch : batches) {
+        appendFrameBatch(*batch);
+    }
+}
+
 FramePointer Context::endFrame() {
     assert(_frameActive);
     auto result = _currentFrame;
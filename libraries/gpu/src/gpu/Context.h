@@ -163,6 +163,11 @@ public:
 
     void beginFrame(const glm::mat4& renderView = glm::mat4(), const glm::mat4& renderPose = glm::mat4());
     void appendFrameBatch(Batch& batch);
+
+    // Record several batches in parallel on the worker threads, then append them to the frame in order.
+    // record is called with each batch and its index: it MUST only touch its batch and thread safe state
+    using BatchRecorder = std::function<void(Batch& batch, size_t index)>;
+    void recordFrameBatches(const char* name, size_t numBatches, const BatchRecorder& record);
     FramePointer endFrame();
 
     // MUST only be called on the rendering thread
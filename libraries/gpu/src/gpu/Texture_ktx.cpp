@@ -12,6 +12,8 @@
 
 #include "Texture.h"
 
+#include <algorithm>
+
 #include <QtCore/QByteArray>
 
 #include <ktx/KTX.h>
@@ -163,18 +165,24 @@ KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry) : KtxStorage(cacheE
 
 KtxStorage::KtxStorage(const std::string& filename) : _filename(filename) {
     {
-        // We are doing a lot of work here just to get descriptor data
-        ktx::StoragePointer storage{ new storage::FileStorage(_filename.c_str()) };
-        auto ktxPointer = ktx::KTX::create(storage);
-        _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxPointer->toDescriptor()));
+        // Only read the header and key values, the mips are mapped from the file as they're requested
+        auto reader = ktx::KTXReader::open(_filename);
+        if (reader) {
+            _ktxDescriptor.reset(new ktx::KTXDescriptor(reader->getDescriptor()));
+        } else {
+            qWarning() << "Failed to read ktx " << QString::fromStdString(_filename);
+            _ktxDescriptor.reset(new ktx::KTXDescriptor(ktx::Header(), ktx::KeyValues(), ktx::ImageDescriptors()));
+        }
         if (_ktxDescriptor->images.size() < _ktxDescriptor->header.numberOfMipmapLevels) {
             qWarning() << "Bad images found in ktx";
         }
 
         _offsetToMinMipKV = _ktxDescriptor->getValueOffsetForKey(ktx::HIFI_MIN_POPULATED_MIP_KEY);
-        if (_offsetToMinMipKV) {
-            auto data = storage->data() + ktx::KTX_HEADER_SIZE + _offsetToMinMipKV;
-            _minMipLevelAvailable = *data;
+        auto minMipKeyValue = std::find_if(_ktxDescriptor->keyValues.begin(), _ktxDescriptor->keyValues.end(), [](const ktx::KeyValue& keyValue) {
+            return keyValue._key == ktx::HIFI_MIN_POPULATED_MIP_KEY;
+        });
+        if (_offsetToMinMipKV && minMipKeyValue != _ktxDescriptor->keyValues.end() && !minMipKeyValue->_value.empty()) {
+            _minMipLevelAvailable = minMipKeyValue->_value[0];
         } else {
             // Assume all mip levels are available
             _minMipLevelAvailable = 0;
@@ -227,18 +235,14 @@ PixelsPointer KtxStorage::getMipFace(uint16 level, uint8 face) const {
     auto faceOffset = _ktxDescriptor->getMipFaceTexelsOffset(level, face);
     auto faceSize = _ktxDescriptor->getMipFaceTexelsSize(level, face);
     if (faceSize != 0 && faceOffset != 0) {
-        std::lock_guard<std::mutex> lock(*_cacheFileMutex);
-        auto file = maybeOpenFile();
-        if (file) {
-            auto storageView = file->createView(faceSize, faceOffset);
-            if (storageView) {
-                return storageView->toMemoryStorage();
-            } else {
-                qWarning() << "Failed to get a valid storageView for faceSize=" << faceSize << "  faceOffset=" << faceOffset << "out of valid file " << QString::fromStdString(_filename);
-            }
-        } else {
-            qWarning() << "Failed to get a valid file out of maybeOpenFile " << QString::fromStdString(_filename);
+        // Map just this face, and only once it's read, rather than copying it out of a mapping of the whole file.
+        // The backend's texture buffering copies the lines it transfers, off the render thread.  Populated mips are
+        // never written again so the mapping doesn't need _cacheFileMutex.
+        auto storage = std::make_shared<storage::LazyFileStorage>(QString::fromStdString(_filename), faceOffset, faceSize);
+        if (storage->isOpen()) {
+            return storage;
         }
+        qWarning() << "Failed to open faceSize=" << faceSize << "  faceOffset=" << faceOffset << "out of file " << QString::fromStdString(_filename);
     }
     return nullptr;
 }
@@ -530,12 +534,12 @@ TexturePointer Texture::build(const ktx::KTXDescriptor& descriptor) {
 }
 
 TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const std::string& source) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str()));
-    if (!ktxPointer) {
+    auto reader = ktx::KTXReader::open(cacheEntry->getFilepath());
+    if (!reader) {
         return nullptr;
     }
 
-    auto texture = build(ktxPointer->toDescriptor());
+    auto texture = build(reader->getDescriptor());
     if (texture) {
         texture->setKtxBacking(cacheEntry);
         if (texture->source().empty()) {
@@ -547,12 +551,12 @@ TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const
 }
 
 TexturePointer Texture::unserialize(const std::string& ktxfile) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(ktxfile.c_str()));
-    if (!ktxPointer) {
+    auto reader = ktx::KTXReader::open(ktxfile);
+    if (!reader) {
         return nullptr;
     }
 
-    auto texture = build(ktxPointer->toDescriptor());
+    auto texture = build(reader->getDescriptor());
     if (texture) {
         texture->setKtxBacking(ktxfile);
         texture->setSource(ktxfile);
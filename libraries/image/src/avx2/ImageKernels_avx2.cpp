@@ -0,0 +1,175 @@
+//
+//  ImageKernels_avx2.cpp
+//  libraries/image/src/avx2
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#include "../image/ImageKernels.h"
+
+namespace image {
+
+void countAlphaRow_AVX2(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents) {
+    const __m256i opaque = _mm256_set1_epi32(255);
+    const __m256i transparent = _mm256_setzero_si256();
+    __m256i opaques = _mm256_setzero_si256();
+    __m256i transparents = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i alpha = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i*)(pixels + i)), 24);
+        // matching lanes are -1
+        opaques = _mm256_sub_epi32(opaques, _mm256_cmpeq_epi32(alpha, opaque));
+        transparents = _mm256_sub_epi32(transparents, _mm256_cmpeq_epi32(alpha, transparent));
+    }
+
+    int32_t lanes[16];
+    _mm256_storeu_si256((__m256i*)lanes, opaques);
+    _mm256_storeu_si256((__m256i*)(lanes + 8), transparents);
+    int rowOpaques = 0;
+    int rowTransparents = 0;
+    for (int j = 0; j < 8; ++j) {
+        rowOpaques += lanes[j];
+        rowTransparents += lanes[j + 8];
+    }
+    numOpaques += rowOpaques;
+    numTranslucents += i - rowOpaques - rowTransparents;
+
+    countAlphaRow_ref(pixels + i, count - i, numOpaques, numTranslucents);
+}
+
+// Low byte of trunc((d + 1) * 127.5), in 16-bit lanes (see encodeSobel())
+static inline __m256i encodeSobel_AVX2(__m256i d) {
+    __m256i n = _mm256_add_epi16(d, _mm256_set1_epi16(1));
+    __m256i negative = _mm256_cmpgt_epi16(_mm256_setzero_si256(), n);
+    __m256i scaled = _mm256_sub_epi16(_mm256_mullo_epi16(n, _mm256_set1_epi16(255)), negative);
+    return _mm256_and_si256(_mm256_srli_epi16(scaled, 1), _mm256_set1_epi16(0xff));
+}
+
+static inline __m256i loadHeights_AVX2(const uint8_t* heights) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)heights));
+}
+
+void bumpToNormalRow_AVX2(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width) {
+    const __m128i alphaAndZ = _mm_set1_epi16(SOBEL_NORMAL_ALPHA_AND_Z >> 16);
+
+    if (width > 0) {
+        normals[0] = sobelNormal(prevRow, row, nextRow, 0, width);
+    }
+
+    // interior pixels, whose neighbours need no clamping
+    int x = 1;
+    for (; x + 17 <= width; x += 16) {
+        __m256i prevLeft = loadHeights_AVX2(prevRow + x - 1);
+        __m256i prevCenter = loadHeights_AVX2(prevRow + x);
+        __m256i prevRight = loadHeights_AVX2(prevRow + x + 1);
+        __m256i rowLeft = loadHeights_AVX2(row + x - 1);
+        __m256i rowRight = loadHeights_AVX2(row + x + 1);
+        __m256i nextLeft = loadHeights_AVX2(nextRow + x - 1);
+        __m256i nextCenter = loadHeights_AVX2(nextRow + x);
+        __m256i nextRight = loadHeights_AVX2(nextRow + x + 1);
+
+        __m256i prevSum = _mm256_add_epi16(_mm256_add_epi16(prevLeft, prevRight), _mm256_slli_epi16(prevCenter, 1));
+        __m256i nextSum = _mm256_add_epi16(_mm256_add_epi16(nextLeft, nextRight), _mm256_slli_epi16(nextCenter, 1));
+        __m256i leftSum = _mm256_add_epi16(_mm256_add_epi16(prevLeft, nextLeft), _mm256_slli_epi16(rowLeft, 1));
+        __m256i rightSum = _mm256_add_epi16(_mm256_add_epi16(prevRight, nextRight), _mm256_slli_epi16(rowRight, 1));
+
+        __m256i blue = encodeSobel_AVX2(_mm256_sub_epi16(nextSum, prevSum));
+        __m256i green = encodeSobel_AVX2(_mm256_sub_epi16(rightSum, leftSum));
+        __m256i greenBlue = _mm256_or_si256(blue, _mm256_slli_epi16(green, 8));
+
+        // 256-bit unpacks work within each 128-bit lane, so widen each half on its own
+        __m128i low = _mm256_castsi256_si128(greenBlue);
+        __m128i high = _mm256_extracti128_si256(greenBlue, 1);
+        _mm_storeu_si128((__m128i*)(normals + x), _mm_unpacklo_epi16(low, alphaAndZ));
+        _mm_storeu_si128((__m128i*)(normals + x + 4), _mm_unpackhi_epi16(low, alphaAndZ));
+        _mm_storeu_si128((__m128i*)(normals + x + 8), _mm_unpacklo_epi16(high, alphaAndZ));
+        _mm_storeu_si128((__m128i*)(normals + x + 12), _mm_unpackhi_epi16(high, alphaAndZ));
+    }
+
+    for (; x < width; ++x) {
+        normals[x] = sobelNormal(prevRow, row, nextRow, x, width);
+    }
+}
+
+// Splits 4 interleaved RGB floats into one register per channel
+static inline void deinterleaveRGB(const float* rgb, __m128& red, __m128& green, __m128& blue) {
+    // r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3
+    __m128 a = _mm_loadu_ps(rgb);
+    __m128 b = _mm_loadu_ps(rgb + 4);
+    __m128 c = _mm_loadu_ps(rgb + 8);
+    red = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    green = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)),
+                           _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    blue = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)),
+                          _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+static inline __m256 combine(__m128 low, __m128 high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+// R11G11B10F bits of one 11-bit channel (see packFloat11_SSE2)
+static inline __m256i packFloat11_AVX2(__m256 value) {
+    value = _mm256_andnot_ps(_mm256_cmp_ps(value, _mm256_set1_ps(6.10e-5f), _CMP_LT_OQ), value);
+    value = _mm256_min_ps(_mm256_set1_ps(6.50e4f), value);
+
+    __m256i bits = _mm256_castps_si256(value);
+    __m256i exponent = _mm256_srli_epi32(_mm256_sub_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(0x7f800000)),
+                                                          _mm256_set1_epi32(0x38000000)), 17);
+    __m256i result = _mm256_or_si256(_mm256_and_si256(exponent, _mm256_set1_epi32(0x07c0)),
+                                     _mm256_and_si256(_mm256_srli_epi32(bits, 17), _mm256_set1_epi32(0x003f)));
+
+    __m256i isZero = _mm256_castps_si256(_mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_EQ_OQ));
+    __m256i isNaN = _mm256_castps_si256(_mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+    result = _mm256_andnot_si256(isZero, result);
+    return _mm256_or_si256(result, _mm256_and_si256(isNaN, _mm256_set1_epi32(0x07ff)));
+}
+
+void packR11G11B10FRow_AVX2(const float* rgb, uint32_t* packed, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8, rgb += 24) {
+        __m128 red0, green0, blue0;
+        __m128 red1, green1, blue1;
+        deinterleaveRGB(rgb, red0, green0, blue0);
+        deinterleaveRGB(rgb + 12, red1, green1, blue1);
+
+        __m256i result = packFloat11_AVX2(combine(red0, red1));
+        result = _mm256_or_si256(result, _mm256_slli_epi32(packFloat11_AVX2(combine(green0, green1)), 11));
+        result = _mm256_or_si256(result, _mm256_slli_epi32(_mm256_srli_epi32(packFloat11_AVX2(combine(blue0, blue1)), 1), 22));
+        _mm256_storeu_si256((__m256i*)(packed + i), result);
+    }
+
+    packR11G11B10FRow_ref(rgb, packed + i, count - i);
+}
+
+void convertToR11G11B10FRow_AVX2(const uint32_t* pixels, uint32_t* packed, int count) {
+    const R11G11B10FTable& table = getGammaToR11G11B10FTable();
+    const __m256i channelMask = _mm256_set1_epi32(0xff);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i pixel = _mm256_loadu_si256((const __m256i*)(pixels + i));
+        __m256i red = _mm256_and_si256(_mm256_srli_epi32(pixel, 16), channelMask);
+        __m256i green = _mm256_and_si256(_mm256_srli_epi32(pixel, 8), channelMask);
+        __m256i blue = _mm256_and_si256(pixel, channelMask);
+
+        __m256i result = _mm256_i32gather_epi32((const int*)table.red, red, 4);
+        result = _mm256_or_si256(result, _mm256_i32gather_epi32((const int*)table.green, green, 4));
+        result = _mm256_or_si256(result, _mm256_i32gather_epi32((const int*)table.blue, blue, 4));
+        _mm256_storeu_si256((__m256i*)(packed + i), result);
+    }
+
+    convertToR11G11B10FRow_ref(pixels + i, packed + i, count - i);
+}
+
+} // namespace image
+
+#endif
@@ -11,6 +11,8 @@
 
 #include "Image.h"
 
+#include <mutex>
+
 #include <glm/gtc/packing.hpp>
 
 #include <QtCore/QtGlobal>
@@ -23,7 +25,9 @@
 #include <Profile.h>
 #include <StatTracker.h>
 #include <GLMHelpers.h>
+#include <TBBHelpers.h>
 
+#include "ImageKernels.h"
 #include "ImageLogging.h"
 
 using namespace gpu;
@@ -43,6 +47,7 @@ static std::atomic<bool> compressColorTextures { false };
 static std::atomic<bool> compressNormalTextures { false };
 static std::atomic<bool> compressGrayscaleTextures { false };
 static std::atomic<bool> compressCubeTextures { false };
+static std::atomic<bool> parallelProcessing { true };
 
 uint rectifyDimension(const uint& dimension) {
     if (dimension == 0) {
@@ -219,23 +224,12 @@ void setCubeTexturesCompressionEnabled(bool enabled) {
     compressCubeTextures.store(enabled);
 }
 
-static float denormalize(float value, const float minValue) {
-    return value < minValue ? 0.0f : value;
+bool isParallelProcessingEnabled() {
+    return parallelProcessing.load();
 }
 
-uint32 packR11G11B10F(const glm::vec3& color) {
-    // Denormalize else unpacking gives high and incorrect values
-    // See https://www.khronos.org/opengl/wiki/Small_Float_Formats for this min value
-    static const auto minValue = 6.10e-5f;
-    static const auto maxValue = 6.50e4f;
-    glm::vec3 ucolor;
-    ucolor.r = denormalize(color.r, minValue);
-    ucolor.g = denormalize(color.g, minValue);
-    ucolor.b = denormalize(color.b, minValue);
-    ucolor.r = std::min(ucolor.r, maxValue);
-    ucolor.g = std::min(ucolor.g, maxValue);
-    ucolor.b = std::min(ucolor.b, maxValue);
-    return glm::packF2x11_1x10(ucolor);
+void setParallelProcessingEnabled(bool enabled) {
+    parallelProcessing.store(enabled);
 }
 
 QImage processRawImageData(QByteArray&& content, const std::string& filename) {
@@ -344,7 +338,8 @@ QImage processSourceImage(QImage&& srcImage, bool cubemap) {
 
 #if defined(NVTT_API)
 struct OutputHandler : public nvtt::OutputHandler {
-    OutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
+    OutputHandler(gpu::Texture* texture, int face, std::mutex* textureMutex) :
+        _texture(texture), _textureMutex(textureMutex), _face(face) {}
 
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         _size = size;
@@ -363,6 +358,11 @@ struct OutputHandler : public nvtt::OutputHandler {
 
     virtual void endImage() override {
         if (_face >= 0) {
+            // faces of a cube may be compressed in parallel, but the texture storage isn't thread-safe
+            std::unique_lock<std::mutex> lock;
+            if (_textureMutex) {
+                lock = std::unique_lock<std::mutex>(*_textureMutex);
+            }
             _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
         } else {
             _texture->assignStoredMip(_miplevel, _size, static_cast<const gpu::Byte*>(_data));
@@ -374,17 +374,20 @@ struct OutputHandler : public nvtt::OutputHandler {
     gpu::Byte* _data{ nullptr };
     gpu::Byte* _current{ nullptr };
     gpu::Texture* _texture{ nullptr };
+    std::mutex* _textureMutex{ nullptr };
     int _miplevel = 0;
     int _size = 0;
     int _face = -1;
 };
 
 struct PackedFloatOutputHandler : public OutputHandler {
-    PackedFloatOutputHandler(gpu::Texture* texture, int face, gpu::Element format) : OutputHandler(texture, face) {
+    PackedFloatOutputHandler(gpu::Texture* texture, int face, std::mutex* textureMutex, gpu::Element format) :
+            OutputHandler(texture, face, textureMutex) {
         if (format == gpu::Element::COLOR_RGB9E5) {
             _packFunc = glm::packF3x9_E1x5;
         } else if (format == gpu::Element::COLOR_R11G11B10) {
             _packFunc = packR11G11B10F;
+            _packRowFunc = packR11G11B10FRow;
         } else {
             qCWarning(imagelogging) << "Unknown handler format";
             Q_UNREACHABLE();
@@ -403,6 +406,27 @@ struct PackedFloatOutputHandler : public OutputHandler {
             const float* floatBegin = (const float*)data;
             const float* floatEnd = floatBegin + floatCount;
 
+            // finish the texel split across the previous write
+            while (_coordIndex != 0 && floatBegin < floatEnd) {
+                _pixel[_coordIndex] = *floatBegin;
+                floatBegin++;
+                _coordIndex++;
+                if (_coordIndex == 3) {
+                    uint32 packedRGB = _packFunc(_pixel);
+                    _coordIndex = 0;
+                    OutputHandler::writeData(&packedRGB, sizeof(packedRGB));
+                }
+            }
+
+            if (_packRowFunc) {
+                // pack all the whole texels straight into the mip
+                int texelCount = (int)(floatEnd - floatBegin) / 3;
+                assert(_current + texelCount * sizeof(uint32) <= _data + _size);
+                _packRowFunc(floatBegin, reinterpret_cast<uint32_t*>(_current), texelCount);
+                _current += texelCount * sizeof(uint32);
+                floatBegin += texelCount * 3;
+            }
+
             while (floatBegin < floatEnd) {
                 _pixel[_coordIndex] = *floatBegin;
                 floatBegin++;
@@ -419,6 +443,7 @@ struct PackedFloatOutputHandler : public OutputHandler {
     }
 
     std::function<uint32(const glm::vec3&)> _packFunc;
+    void (*_packRowFunc)(const float*, uint32_t*, int) { nullptr };
     glm::vec3 _pixel;
     int _coordIndex{ 0 };
 };
@@ -429,13 +454,24 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+// Runs nvtt's block compression tasks on the TBB worker threads, or in order on the calling thread
+// when parallel processing is disabled.
+class TaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
+    TaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
 
     const std::atomic<bool>& _abortProcessing;
 
     virtual void dispatch(nvtt::Task* task, void* context, int count) override {
+        if (parallelProcessing.load()) {
+            tbb::parallel_for(tbb::blocked_range<int>(0, count), [&](const tbb::blocked_range<int>& range) {
+                for (int i = range.begin(); i != range.end() && !_abortProcessing.load(); ++i) {
+                    task(context, i);
+                }
+            });
+            return;
+        }
+
         for (int i = 0; i < count; i++) {
             if (!_abortProcessing.load()) {
                 task(context, i);
@@ -446,7 +482,7 @@ public:
     }
 };
 
-void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face, std::mutex* textureMutex) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -520,9 +556,9 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
     if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
         // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
-        outputHandler.reset(new PackedFloatOutputHandler(texture, face, mipFormat));
+        outputHandler.reset(new PackedFloatOutputHandler(texture, face, textureMutex, mipFormat));
     } else {
-        outputHandler.reset(new OutputHandler(texture, face));
+        outputHandler.reset(new OutputHandler(texture, face, textureMutex));
     }
 
     outputOptions.setOutputHandler(outputHandler.get());
@@ -532,8 +568,7 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     surface.setAlphaMode(alphaMode);
     surface.setWrapMode(wrapMode);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
+    TaskDispatcher dispatcher(abortProcessing);
     context.setTaskDispatcher(&dispatcher);
 
     context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
@@ -543,7 +578,7 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     }
 }
 
-void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face, std::mutex* textureMutex) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -660,12 +695,12 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
     nvtt::OutputOptions outputOptions;
     outputOptions.setOutputHeader(false);
-    OutputHandler outputHandler(texture, face);
+    OutputHandler outputHandler(texture, face, textureMutex);
     outputOptions.setOutputHandler(&outputHandler);
     MyErrorHandler errorHandler;
     outputOptions.setErrorHandler(&errorHandler);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
+    TaskDispatcher dispatcher(abortProcessing);
     nvtt::Compressor compressor;
     compressor.setTaskDispatcher(&dispatcher);
     compressor.process(inputOptions, compressionOptions, outputOptions);
@@ -675,14 +710,15 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
 
 
-void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1) {
+void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1,
+                  std::mutex* textureMutex = nullptr) {
 #if CPU_MIPMAPS
     PROFILE_RANGE(resource_parse, "generateMips");
 
     if (image.format() == QIMAGE_HDR_FORMAT) {
-        generateHDRMips(texture, std::move(image), abortProcessing, face);
+        generateHDRMips(texture, std::move(image), abortProcessing, face, textureMutex);
     } else  {
-        generateLDRMips(texture, std::move(image), abortProcessing, face);
+        generateLDRMips(texture, std::move(image), abortProcessing, face, textureMutex);
     }
 #else
     texture->setAutoGenerateMips(true);
@@ -693,24 +729,18 @@ void processTextureAlpha(const QImage& srcImage, bool& validAlpha, bool& alphaAs
     PROFILE_RANGE(resource_parse, "processTextureAlpha");
     validAlpha = false;
     alphaAsMask = true;
-    const uint8 OPAQUE_ALPHA = 255;
-    const uint8 TRANSPARENT_ALPHA = 0;
 
     // Figure out if we can use a mask for alpha or not
     int numOpaques = 0;
     int numTranslucents = 0;
     const int NUM_PIXELS = srcImage.width() * srcImage.height();
     const int MAX_TRANSLUCENT_PIXELS_FOR_ALPHAMASK = (int)(0.05f * (float)(NUM_PIXELS));
-    const QRgb* data = reinterpret_cast<const QRgb*>(srcImage.constBits());
-    for (int i = 0; i < NUM_PIXELS; ++i) {
-        auto alpha = qAlpha(data[i]);
-        if (alpha == OPAQUE_ALPHA) {
-            numOpaques++;
-        } else if (alpha != TRANSPARENT_ALPHA) {
-            if (++numTranslucents > MAX_TRANSLUCENT_PIXELS_FOR_ALPHAMASK) {
-                alphaAsMask = false;
-                break;
-            }
+    for (int y = 0; y < srcImage.height(); ++y) {
+        const uint32_t* line = reinterpret_cast<const uint32_t*>(srcImage.constScanLine(y));
+        countAlphaRow(line, srcImage.width(), numOpaques, numTranslucents);
+        if (numTranslucents > MAX_TRANSLUCENT_PIXELS_FOR_ALPHAMASK) {
+            alphaAsMask = false;
+            break;
         }
     }
     validAlpha = (numOpaques != NUM_PIXELS);
@@ -786,18 +816,6 @@ gpu::TexturePointer TextureUsage::process2DTextureColorFromImage(QImage&& srcIma
     return theTexture;
 }
 
-int clampPixelCoordinate(int coordinate, int maxCoordinate) {
-    return coordinate - ((int)(coordinate < 0) * coordinate) + ((int)(coordinate > maxCoordinate) * (maxCoordinate - coordinate));
-}
-
-const int RGBA_MAX = 255;
-
-// transform -1 - 1 to 0 - 255 (from sobel value to rgb)
-double mapComponent(double sobelValue) {
-    const double factor = RGBA_MAX / 2.0;
-    return (sobelValue + 1.0) * factor;
-}
-
 QImage processBumpMap(QImage&& image) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
@@ -809,53 +827,16 @@ QImage processBumpMap(QImage&& image) {
 
     // PR 5540 by AlessandroSigna integrated here as a specialized TextureLoader for bumpmaps
     // The conversion is done using the Sobel Filter to calculate the derivatives from the grayscale image
-    const double pStrength = 2.0;
     int width = localCopy.width();
     int height = localCopy.height();
 
     QImage result(width, height, QImage::Format_ARGB32);
 
-    for (int i = 0; i < width; i++) {
-        const int iNextClamped = clampPixelCoordinate(i + 1, width - 1);
-        const int iPrevClamped = clampPixelCoordinate(i - 1, width - 1);
-
-        for (int j = 0; j < height; j++) {
-            const int jNextClamped = clampPixelCoordinate(j + 1, height - 1);
-            const int jPrevClamped = clampPixelCoordinate(j - 1, height - 1);
-
-            // surrounding pixels
-            const QRgb topLeft = localCopy.pixel(iPrevClamped, jPrevClamped);
-            const QRgb top = localCopy.pixel(iPrevClamped, j);
-            const QRgb topRight = localCopy.pixel(iPrevClamped, jNextClamped);
-            const QRgb right = localCopy.pixel(i, jNextClamped);
-            const QRgb bottomRight = localCopy.pixel(iNextClamped, jNextClamped);
-            const QRgb bottom = localCopy.pixel(iNextClamped, j);
-            const QRgb bottomLeft = localCopy.pixel(iNextClamped, jPrevClamped);
-            const QRgb left = localCopy.pixel(i, jPrevClamped);
-
-            // take their gray intensities
-            // since it's a grayscale image, the value of each component RGB is the same
-            const double tl = qRed(topLeft);
-            const double t = qRed(top);
-            const double tr = qRed(topRight);
-            const double r = qRed(right);
-            const double br = qRed(bottomRight);
-            const double b = qRed(bottom);
-            const double bl = qRed(bottomLeft);
-            const double l = qRed(left);
-
-            // apply the sobel filter
-            const double dX = (tr + pStrength * r + br) - (tl + pStrength * l + bl);
-            const double dY = (bl + pStrength * b + br) - (tl + pStrength * t + tr);
-            const double dZ = RGBA_MAX / pStrength;
-
-            glm::vec3 v(dX, dY, dZ);
-            glm::normalize(v);
-
-            // convert to rgb from the value obtained computing the filter
-            QRgb qRgbValue = qRgba(mapComponent(v.z), mapComponent(v.y), mapComponent(v.x), 1.0);
-            result.setPixel(i, j, qRgbValue);
-        }
+    for (int y = 0; y < height; y++) {
+        const uint8_t* prevLine = localCopy.constScanLine(std::max(y - 1, 0));
+        const uint8_t* line = localCopy.constScanLine(y);
+        const uint8_t* nextLine = localCopy.constScanLine(std::min(y + 1, height - 1));
+        bumpToNormalRow(prevLine, line, nextLine, reinterpret_cast<uint32_t*>(result.scanLine(y)), width);
     }
 
     return result;
@@ -1236,6 +1217,19 @@ QImage convertToHDRFormat(QImage&& srcImage, gpu::Element format) {
     }
 
     localCopy = localCopy.convertToFormat(QImage::Format_ARGB32);
+
+#ifndef DEBUG_COLOR_PACKING
+    if (format.getSemantic() == gpu::R11G11B10) {
+        for (auto y = 0; y < localCopy.height(); y++) {
+            const uint32_t* srcLine = reinterpret_cast<const uint32_t*>(localCopy.constScanLine(y));
+            uint32_t* hdrLine = reinterpret_cast<uint32_t*>(hdrImage.scanLine(y));
+            convertToR11G11B10FRow(srcLine, hdrLine, localCopy.width());
+        }
+        return hdrImage;
+    }
+#endif
+
+    const float* gammaToLinear = getGammaToLinearTable();
     for (auto y = 0; y < localCopy.height(); y++) {
         const QRgb* srcLineIt = reinterpret_cast<const QRgb*>( localCopy.constScanLine(y) );
         const QRgb* srcLineEnd = srcLineIt + localCopy.width();
@@ -1243,14 +1237,10 @@ QImage convertToHDRFormat(QImage&& srcImage, gpu::Element format) {
         glm::vec3 color;
 
         while (srcLineIt < srcLineEnd) {
-            color.r = qRed(*srcLineIt);
-            color.g = qGreen(*srcLineIt);
-            color.b = qBlue(*srcLineIt);
             // Normalize and apply gamma
-            color /= 255.0f;
-            color.r = powf(color.r, 2.2f);
-            color.g = powf(color.g, 2.2f);
-            color.b = powf(color.b, 2.2f);
+            color.r = gammaToLinear[qRed(*srcLineIt)];
+            color.g = gammaToLinear[qGreen(*srcLineIt)];
+            color.b = gammaToLinear[qBlue(*srcLineIt)];
             *hdrLineIt = packFunc(color);
 #ifdef DEBUG_COLOR_PACKING
             glm::vec3 ucolor = unpackFunc(*hdrLineIt);
@@ -1355,8 +1345,18 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(QImage&& srcI
             theTexture->overrideIrradiance(irradiance);
         }
 
-        for (uint8 face = 0; face < faces.size(); ++face) {
-            generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face);
+        if (parallelProcessing.load()) {
+            // each face has its own mip chain so they compress independently
+            std::mutex textureMutex;
+            tbb::parallel_for(0, (int)faces.size(), [&](int face) {
+                if (!abortProcessing.load()) {
+                    generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face, &textureMutex);
+                }
+            });
+        } else {
+            for (uint8 face = 0; face < faces.size(); ++face) {
+                generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face);
+            }
         }
     }
 
@@ -92,6 +92,10 @@ void setNormalTexturesCompressionEnabled(bool enabled);
 void setGrayscaleTexturesCompressionEnabled(bool enabled);
 void setCubeTexturesCompressionEnabled(bool enabled);
 
+// Compress mip blocks and cube faces on the TBB worker threads (the default)
+bool isParallelProcessingEnabled();
+void setParallelProcessingEnabled(bool enabled);
+
 gpu::TexturePointer processImage(QByteArray&& content, const std::string& url,
                                  int maxNumPixels, TextureUsage::Type textureType,
                                  const std::atomic<bool>& abortProcessing = false);
@@ -0,0 +1,286 @@
+//
+//  ImageKernels.cpp
+//  libraries/image/src/image
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageKernels.h"
+
+#include <cmath>
+
+#include <glm/gtc/packing.hpp>
+
+namespace image {
+
+static float denormalize(float value, const float minValue) {
+    return value < minValue ? 0.0f : value;
+}
+
+uint32_t packR11G11B10F(const glm::vec3& color) {
+    // Denormalize else unpacking gives high and incorrect values
+    // See https://www.khronos.org/opengl/wiki/Small_Float_Formats for this min value
+    static const auto minValue = 6.10e-5f;
+    static const auto maxValue = 6.50e4f;
+    glm::vec3 ucolor;
+    ucolor.r = denormalize(color.r, minValue);
+    ucolor.g = denormalize(color.g, minValue);
+    ucolor.b = denormalize(color.b, minValue);
+    ucolor.r = std::min(ucolor.r, maxValue);
+    ucolor.g = std::min(ucolor.g, maxValue);
+    ucolor.b = std::min(ucolor.b, maxValue);
+    return glm::packF2x11_1x10(ucolor);
+}
+
+const float* getGammaToLinearTable() {
+    static const struct Table {
+        Table() {
+            for (int i = 0; i < 256; ++i) {
+                values[i] = powf((float)i / 255.0f, 2.2f);
+            }
+        }
+        float values[256];
+    } table;
+    return table.values;
+}
+
+const R11G11B10FTable& getGammaToR11G11B10FTable() {
+    static const struct Table : public R11G11B10FTable {
+        Table() {
+            // the channels of R11G11B10F are packed independently so they can be looked up separately
+            const float* linear = getGammaToLinearTable();
+            for (int i = 0; i < 256; ++i) {
+                red[i] = packR11G11B10F(glm::vec3(linear[i], 0.0f, 0.0f));
+                green[i] = packR11G11B10F(glm::vec3(0.0f, linear[i], 0.0f));
+                blue[i] = packR11G11B10F(glm::vec3(0.0f, 0.0f, linear[i]));
+            }
+        }
+    } table;
+    return table;
+}
+
+//
+// Reference implementations
+//
+
+static const uint32_t OPAQUE_ALPHA = 255;
+static const uint32_t TRANSPARENT_ALPHA = 0;
+
+void countAlphaRow_ref(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents) {
+    for (int i = 0; i < count; ++i) {
+        uint32_t alpha = pixels[i] >> 24;
+        if (alpha == OPAQUE_ALPHA) {
+            ++numOpaques;
+        } else if (alpha != TRANSPARENT_ALPHA) {
+            ++numTranslucents;
+        }
+    }
+}
+
+void bumpToNormalRow_ref(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width) {
+    for (int x = 0; x < width; ++x) {
+        normals[x] = sobelNormal(prevRow, row, nextRow, x, width);
+    }
+}
+
+void packR11G11B10FRow_ref(const float* rgb, uint32_t* packed, int count) {
+    for (int i = 0; i < count; ++i, rgb += 3) {
+        packed[i] = packR11G11B10F(glm::vec3(rgb[0], rgb[1], rgb[2]));
+    }
+}
+
+void convertToR11G11B10FRow_ref(const uint32_t* pixels, uint32_t* packed, int count) {
+    const R11G11B10FTable& table = getGammaToR11G11B10FTable();
+    for (int i = 0; i < count; ++i) {
+        uint32_t pixel = pixels[i];
+        packed[i] = table.red[(pixel >> 16) & 0xff] | table.green[(pixel >> 8) & 0xff] | table.blue[pixel & 0xff];
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>  // SSE2
+
+#include "CPUDetect.h"
+
+//
+// SSE2 implementations
+//
+
+void countAlphaRow_SSE2(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents) {
+    const __m128i opaque = _mm_set1_epi32(OPAQUE_ALPHA);
+    const __m128i transparent = _mm_set1_epi32(TRANSPARENT_ALPHA);
+    __m128i opaques = _mm_setzero_si128();
+    __m128i transparents = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i alpha = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(pixels + i)), 24);
+        // matching lanes are -1
+        opaques = _mm_sub_epi32(opaques, _mm_cmpeq_epi32(alpha, opaque));
+        transparents = _mm_sub_epi32(transparents, _mm_cmpeq_epi32(alpha, transparent));
+    }
+
+    int32_t lanes[8];
+    _mm_storeu_si128((__m128i*)lanes, opaques);
+    _mm_storeu_si128((__m128i*)(lanes + 4), transparents);
+    int rowOpaques = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    int rowTransparents = lanes[4] + lanes[5] + lanes[6] + lanes[7];
+    numOpaques += rowOpaques;
+    numTranslucents += i - rowOpaques - rowTransparents;
+
+    countAlphaRow_ref(pixels + i, count - i, numOpaques, numTranslucents);
+}
+
+// Low byte of trunc((d + 1) * 127.5), see encodeSobel().  Only the low 9 bits of (d + 1) * 255 matter, so
+// 16-bit lanes are enough even though the product itself overflows them.
+static inline __m128i encodeSobel_SSE2(__m128i d) {
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i scale = _mm_set1_epi16(255);
+    const __m128i lowByte = _mm_set1_epi16(0xff);
+    __m128i n = _mm_add_epi16(d, one);
+    __m128i negative = _mm_cmpgt_epi16(_mm_setzero_si128(), n);
+    // round toward zero: add one to negative values before halving
+    __m128i scaled = _mm_sub_epi16(_mm_mullo_epi16(n, scale), negative);
+    return _mm_and_si128(_mm_srli_epi16(scaled, 1), lowByte);
+}
+
+static inline __m128i loadHeights_SSE2(const uint8_t* heights) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)heights), _mm_setzero_si128());
+}
+
+void bumpToNormalRow_SSE2(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width) {
+    const __m128i alphaAndZ = _mm_set1_epi16(SOBEL_NORMAL_ALPHA_AND_Z >> 16);
+
+    if (width > 0) {
+        normals[0] = sobelNormal(prevRow, row, nextRow, 0, width);
+    }
+
+    // interior pixels, whose neighbours need no clamping
+    int x = 1;
+    for (; x + 9 <= width; x += 8) {
+        __m128i prevLeft = loadHeights_SSE2(prevRow + x - 1);
+        __m128i prevCenter = loadHeights_SSE2(prevRow + x);
+        __m128i prevRight = loadHeights_SSE2(prevRow + x + 1);
+        __m128i rowLeft = loadHeights_SSE2(row + x - 1);
+        __m128i rowRight = loadHeights_SSE2(row + x + 1);
+        __m128i nextLeft = loadHeights_SSE2(nextRow + x - 1);
+        __m128i nextCenter = loadHeights_SSE2(nextRow + x);
+        __m128i nextRight = loadHeights_SSE2(nextRow + x + 1);
+
+        __m128i prevSum = _mm_add_epi16(_mm_add_epi16(prevLeft, prevRight), _mm_slli_epi16(prevCenter, 1));
+        __m128i nextSum = _mm_add_epi16(_mm_add_epi16(nextLeft, nextRight), _mm_slli_epi16(nextCenter, 1));
+        __m128i leftSum = _mm_add_epi16(_mm_add_epi16(prevLeft, nextLeft), _mm_slli_epi16(rowLeft, 1));
+        __m128i rightSum = _mm_add_epi16(_mm_add_epi16(prevRight, nextRight), _mm_slli_epi16(rowRight, 1));
+
+        __m128i blue = encodeSobel_SSE2(_mm_sub_epi16(nextSum, prevSum));
+        __m128i green = encodeSobel_SSE2(_mm_sub_epi16(rightSum, leftSum));
+        __m128i greenBlue = _mm_or_si128(blue, _mm_slli_epi16(green, 8));
+
+        _mm_storeu_si128((__m128i*)(normals + x), _mm_unpacklo_epi16(greenBlue, alphaAndZ));
+        _mm_storeu_si128((__m128i*)(normals + x + 4), _mm_unpackhi_epi16(greenBlue, alphaAndZ));
+    }
+
+    for (; x < width; ++x) {
+        normals[x] = sobelNormal(prevRow, row, nextRow, x, width);
+    }
+}
+
+// R11G11B10F bits of one channel, as packR11G11B10F computes them for the 11-bit channels.  The 10-bit
+// channel is the same value shifted right once.
+static inline __m128i packFloat11_SSE2(__m128 value) {
+    const __m128 minValue = _mm_set1_ps(6.10e-5f);
+    const __m128 maxValue = _mm_set1_ps(6.50e4f);
+    const __m128i exponentMask = _mm_set1_epi32(0x7f800000);
+    const __m128i exponentBias = _mm_set1_epi32(0x38000000);
+    const __m128i exponentBits = _mm_set1_epi32(0x07c0);
+    const __m128i mantissaBits = _mm_set1_epi32(0x003f);
+    const __m128i nanBits = _mm_set1_epi32(0x07ff);
+
+    // denormalize, then clamp with the value as the second operand so NaNs pass through like std::min
+    value = _mm_andnot_ps(_mm_cmplt_ps(value, minValue), value);
+    value = _mm_min_ps(maxValue, value);
+
+    __m128i bits = _mm_castps_si128(value);
+    __m128i exponent = _mm_srli_epi32(_mm_sub_epi32(_mm_and_si128(bits, exponentMask), exponentBias), 17);
+    __m128i result = _mm_or_si128(_mm_and_si128(exponent, exponentBits), _mm_and_si128(_mm_srli_epi32(bits, 17), mantissaBits));
+
+    __m128i isZero = _mm_castps_si128(_mm_cmpeq_ps(value, _mm_setzero_ps()));
+    __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(value, value));
+    result = _mm_andnot_si128(isZero, result);
+    return _mm_or_si128(result, _mm_and_si128(isNaN, nanBits));
+}
+
+void packR11G11B10FRow_SSE2(const float* rgb, uint32_t* packed, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4, rgb += 12) {
+        // r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3
+        __m128 a = _mm_loadu_ps(rgb);
+        __m128 b = _mm_loadu_ps(rgb + 4);
+        __m128 c = _mm_loadu_ps(rgb + 8);
+
+        __m128 rest = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2));
+        __m128 red = _mm_shuffle_ps(a, rest, _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 green = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)),
+                                      _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 blue = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)),
+                                     _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        __m128i result = packFloat11_SSE2(red);
+        result = _mm_or_si128(result, _mm_slli_epi32(packFloat11_SSE2(green), 11));
+        result = _mm_or_si128(result, _mm_slli_epi32(_mm_srli_epi32(packFloat11_SSE2(blue), 1), 22));
+        _mm_storeu_si128((__m128i*)(packed + i), result);
+    }
+
+    packR11G11B10FRow_ref(rgb, packed + i, count - i);
+}
+
+//
+// Runtime CPU dispatch
+//
+
+void countAlphaRow(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents) {
+    static auto f = cpuSupportsAVX2() ? countAlphaRow_AVX2 : countAlphaRow_SSE2;
+    (*f)(pixels, count, numOpaques, numTranslucents);   // dispatch
+}
+
+void bumpToNormalRow(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width) {
+    static auto f = cpuSupportsAVX2() ? bumpToNormalRow_AVX2 : bumpToNormalRow_SSE2;
+    (*f)(prevRow, row, nextRow, normals, width);    // dispatch
+}
+
+void packR11G11B10FRow(const float* rgb, uint32_t* packed, int count) {
+    static auto f = cpuSupportsAVX2() ? packR11G11B10FRow_AVX2 : packR11G11B10FRow_SSE2;
+    (*f)(rgb, packed, count);   // dispatch
+}
+
+void convertToR11G11B10FRow(const uint32_t* pixels, uint32_t* packed, int count) {
+    // without a gather instruction SSE2 has nothing to add to the table lookups
+    static auto f = cpuSupportsAVX2() ? convertToR11G11B10FRow_AVX2 : convertToR11G11B10FRow_ref;
+    (*f)(pixels, packed, count);    // dispatch
+}
+
+#else
+
+void countAlphaRow(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents) {
+    countAlphaRow_ref(pixels, count, numOpaques, numTranslucents);
+}
+
+void bumpToNormalRow(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width) {
+    bumpToNormalRow_ref(prevRow, row, nextRow, normals, width);
+}
+
+void packR11G11B10FRow(const float* rgb, uint32_t* packed, int count) {
+    packR11G11B10FRow_ref(rgb, packed, count);
+}
+
+void convertToR11G11B10FRow(const uint32_t* pixels, uint32_t* packed, int count) {
+    convertToR11G11B10FRow_ref(pixels, packed, count);
+}
+
+#endif
+
+} // namespace image
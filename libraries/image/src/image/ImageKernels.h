@@ -0,0 +1,82 @@
+//
+//  ImageKernels.h
+//  libraries/image/src/image
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_image_ImageKernels_h
+#define hifi_image_ImageKernels_h
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+// Row kernels for the per-texel work of the texture pipeline.
+//
+// Each kernel dispatches at runtime to the widest instruction set the CPU supports.  The _ref versions are the
+// reference implementation and every SIMD version must produce bit-identical output.
+namespace image {
+
+uint32_t packR11G11B10F(const glm::vec3& color);
+
+// Counts the fully opaque and the partially transparent pixels of a row of ARGB32 pixels.
+void countAlphaRow(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents);
+void countAlphaRow_ref(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents);
+void countAlphaRow_SSE2(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents);
+void countAlphaRow_AVX2(const uint32_t* pixels, int count, int& numOpaques, int& numTranslucents);
+
+// Maps a Sobel derivative to a channel the way the original floating point filter did: truncating
+// (d + 1) * 127.5 to an int and keeping the low byte.  That filter never normalized its vector, so the
+// value wraps and z is constant; this is kept bit for bit so that baked normal maps don't change.
+inline uint32_t encodeSobel(int d) {
+    return (uint32_t)(((d + 1) * 255) / 2) & 0xff;
+}
+
+const uint32_t SOBEL_NORMAL_ALPHA_AND_Z = 0x01ff0000;
+
+inline uint32_t sobelNormal(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, int x, int width) {
+    int left = std::max(x - 1, 0);
+    int right = std::min(x + 1, width - 1);
+    int dX = (nextRow[left] + 2 * nextRow[x] + nextRow[right]) - (prevRow[left] + 2 * prevRow[x] + prevRow[right]);
+    int dY = (prevRow[right] + 2 * row[right] + nextRow[right]) - (prevRow[left] + 2 * row[left] + nextRow[left]);
+    return SOBEL_NORMAL_ALPHA_AND_Z | (encodeSobel(dY) << 8) | encodeSobel(dX);
+}
+
+// Sobel filter of a row of 8-bit heights into ARGB32 normals.  prevRow and nextRow are the neighbouring rows,
+// already clamped to the image edges by the caller.
+void bumpToNormalRow(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width);
+void bumpToNormalRow_ref(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width);
+void bumpToNormalRow_SSE2(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width);
+void bumpToNormalRow_AVX2(const uint8_t* prevRow, const uint8_t* row, const uint8_t* nextRow, uint32_t* normals, int width);
+
+// Packs interleaved linear RGB floats into R11G11B10F texels.
+void packR11G11B10FRow(const float* rgb, uint32_t* packed, int count);
+void packR11G11B10FRow_ref(const float* rgb, uint32_t* packed, int count);
+void packR11G11B10FRow_SSE2(const float* rgb, uint32_t* packed, int count);
+void packR11G11B10FRow_AVX2(const float* rgb, uint32_t* packed, int count);
+
+// Converts a row of gamma 2.2 ARGB32 pixels into linear R11G11B10F texels.
+void convertToR11G11B10FRow(const uint32_t* pixels, uint32_t* packed, int count);
+void convertToR11G11B10FRow_ref(const uint32_t* pixels, uint32_t* packed, int count);
+void convertToR11G11B10FRow_AVX2(const uint32_t* pixels, uint32_t* packed, int count);
+
+// Linear value of each 8-bit gamma 2.2 channel value
+const float* getGammaToLinearTable();
+
+// Packed R11G11B10F bits of each 8-bit gamma 2.2 channel value, already shifted into place for each channel
+struct R11G11B10FTable {
+    uint32_t red[256];
+    uint32_t green[256];
+    uint32_t blue[256];
+};
+const R11G11B10FTable& getGammaToR11G11B10FTable();
+
+} // namespace image
+
+#endif // hifi_image_ImageKernels_h
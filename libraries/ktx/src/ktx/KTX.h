@@ -385,6 +385,32 @@ namespace ktx {
         friend struct KTXDescriptor;
     };
 
+    // Reads a KTX file on disk without loading its images.  Only the header and key/values are read up
+    // front, the image table is laid out from the header, and each mip face is exposed as a storage that
+    // maps its range of the file the first time its data is accessed.  Memory then grows with the mips that
+    // are actually used rather than with the size of the files.
+    class KTXReader {
+    public:
+        // Returns null if the file can't be read or isn't a complete KTX
+        static std::unique_ptr<KTXReader> open(const std::string& filename);
+
+        const KTXDescriptor& getDescriptor() const { return *_descriptor; }
+        const Header& getHeader() const { return _descriptor->header; }
+        const std::string& getFilename() const { return _filename; }
+        size_t getFileSize() const { return _fileSize; }
+
+        // Lazily mapped texels of a mip face, or null if there is no such face
+        storage::StoragePointer getMipFaceTexelsData(uint16_t mip = 0, uint8_t face = 0) const;
+
+    private:
+        KTXReader(const std::string& filename, size_t fileSize, std::unique_ptr<KTXDescriptor> descriptor) :
+            _filename(filename), _fileSize(fileSize), _descriptor(std::move(descriptor)) {}
+
+        const std::string _filename;
+        const size_t _fileSize;
+        const std::unique_ptr<KTXDescriptor> _descriptor;
+    };
+
 }
 
 Q_DECLARE_METATYPE(ktx::KTXDescriptor*);
@@ -13,6 +13,7 @@
 #include <list>
 #include <QtGlobal>
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 
 #ifndef _MSC_VER
 #define NOEXCEPT noexcept
@@ -210,4 +211,76 @@ namespace ktx {
 
         return result;
     }
+
+    std::unique_ptr<KTXReader> KTXReader::open(const std::string& filename) {
+        QFile file(QString::fromStdString(filename));
+        if (!file.open(QFile::ReadOnly)) {
+            qWarning() << "Unable to open KTX file" << file.fileName();
+            return nullptr;
+        }
+        const size_t fileSize = (size_t)file.size();
+
+        // header and key/values are the only parts read in full
+        QByteArray headerBytes = file.read(KTX_HEADER_SIZE);
+        if (!KTX::checkHeaderFromStorage(fileSize, reinterpret_cast<const Byte*>(headerBytes.constData()))) {
+            return nullptr;
+        }
+        Header header;
+        memcpy(&header, headerBytes.constData(), KTX_HEADER_SIZE);
+
+        QByteArray keyValueBytes = file.read(header.bytesOfKeyValueData);
+        if ((size_t)keyValueBytes.size() != header.bytesOfKeyValueData) {
+            qWarning() << "KTX deserialization error: length is too short for metadata";
+            return nullptr;
+        }
+        KeyValues keyValues = KTX::parseKeyValues(header.bytesOfKeyValueData, reinterpret_cast<const Byte*>(keyValueBytes.constData()));
+
+        // lay out the images from the header, the same way parseImages finds them, checking each image size
+        // without reading any texels
+        const size_t texelsStart = KTX_HEADER_SIZE + header.bytesOfKeyValueData;
+        const auto numFaces = header.numberOfFaces;
+        const bool isCube = numFaces == NUM_CUBEMAPFACES;
+        ImageDescriptors images;
+        size_t imageOffset = 0;
+        for (uint32_t level = 0; level < header.getNumberOfLevels(); ++level) {
+            auto faceSize = (uint32_t)header.evalImageSize(level);
+            if (!checkAlignment(faceSize)) {
+                return nullptr;
+            }
+            size_t imageSize = isCube ? NUM_CUBEMAPFACES * faceSize : faceSize;
+            auto padding = evalPadding(imageSize);
+            size_t imageStart = texelsStart + imageOffset + IMAGE_SIZE_WIDTH;
+            if (imageStart + imageSize > fileSize) {
+                qWarning() << "KTX deserialization error: length is too short for image" << level;
+                return nullptr;
+            }
+
+            uint32_t storedImageSize { 0 };
+            if (!file.seek(texelsStart + imageOffset) ||
+                file.read(reinterpret_cast<char*>(&storedImageSize), sizeof(storedImageSize)) != sizeof(storedImageSize) ||
+                storedImageSize != faceSize) {
+                qWarning() << "KTX deserialization error: invalid image size for level" << level;
+                return nullptr;
+            }
+
+            ImageHeader::FaceOffsets faceOffsets;
+            for (uint32_t face = 0; face < (isCube ? NUM_CUBEMAPFACES : 1); ++face) {
+                faceOffsets.push_back(imageStart + face * faceSize);
+            }
+            images.emplace_back(ImageHeader(isCube, imageOffset, faceSize, padding), faceOffsets);
+            imageOffset += IMAGE_SIZE_WIDTH + imageSize + padding;
+        }
+
+        std::unique_ptr<KTXDescriptor> descriptor(new KTXDescriptor(header, keyValues, images));
+        return std::unique_ptr<KTXReader>(new KTXReader(filename, fileSize, std::move(descriptor)));
+    }
+
+    storage::StoragePointer KTXReader::getMipFaceTexelsData(uint16_t mip, uint8_t face) const {
+        auto faceSize = _descriptor->getMipFaceTexelsSize(mip, face);
+        if (faceSize == 0) {
+            return nullptr;
+        }
+        auto faceOffset = _descriptor->getMipFaceTexelsOffset(mip, face);
+        return std::make_shared<storage::LazyFileStorage>(QString::fromStdString(_filename), faceOffset, faceSize);
+    }
 }
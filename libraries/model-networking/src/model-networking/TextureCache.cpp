@@ -478,14 +478,11 @@ void NetworkTexture::makeLocalRequest() {
 
     path = FileUtils::selectFile(path);
 
-    auto storage = std::make_shared<storage::FileStorage>(path);
-    std::unique_ptr<ktx::KTX> ktxFile;
-    if (storage) {
-        ktxFile = ktx::KTX::create(storage);
-    }
+    // Only the header and key values are read here, the mips are mapped from the file as the backend needs them
+    auto ktxReader = ktx::KTXReader::open(path.toStdString());
     std::shared_ptr<ktx::KTXDescriptor> ktxDescriptor;
-    if (ktxFile) {
-        ktxDescriptor = std::make_shared<ktx::KTXDescriptor>(ktxFile->toDescriptor());
+    if (ktxReader) {
+        ktxDescriptor = std::make_shared<ktx::KTXDescriptor>(ktxReader->getDescriptor());
     }
 
     gpu::TexturePointer texture;
@@ -32,23 +32,63 @@
                            (((x) > (max)) ? (max) :\
                                             (x)))
 
-void ResourceCacheSharedItems::appendActiveRequest(QWeakPointer<Resource> resource) {
+bool ResourceCacheSharedItems::appendActiveRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    if (!strongResource) {
+        return false;
+    }
+
+    LoadingRequest request;
+    request.resource = resource;
+    request.key = strongResource.data();
+    request.origin = resourceOriginForURL(strongResource->getURL());
+    request.startTime = usecTimestampNow();
+
     Lock lock(_mutex);
-    _loadingRequests.append(resource);
+    int& numLoading = _numLoadingRequests[request.origin];
+    ResourceRequestLimiter& limiter = _requestLimiters[request.origin];
+    if (numLoading >= limiter.getLimit()) {
+        return false;
+    }
+    ++numLoading;
+    limiter.requestStarted(numLoading);
+    _loadingRequests.append(request);
+    return true;
 }
 
 void ResourceCacheSharedItems::appendPendingRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    if (!strongResource) {
+        return;
+    }
+
+    PendingRequest request;
+    request.resource = resource;
+    request.key = strongResource.data();
+    request.priority = strongResource->getLoadPriority();
+    ResourceOrigin origin = resourceOriginForURL(strongResource->getURL());
+
     Lock lock(_mutex);
-    _pendingRequests.append(resource);
+    request.sequence = ++_pendingSequence;
+    strongResource->_isPendingRequest = true;
+    _pendingRequests[origin].push(request);
+}
+
+void ResourceCacheSharedItems::pendingRequestPriorityChanged(Resource* resource) {
+    Lock lock(_mutex);
+    _changedPendingRequests.insert(resource);
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _pendingRequests) {
-        if (resource) {
-            result.append(resource);
+    for (const auto& queue : _pendingRequests) {
+        for (const auto& request : queue.getRequests()) {
+            auto resource = request.resource.lock();
+            if (resource) {
+                result.append(resource);
+            }
         }
     }
 
@@ -57,14 +97,19 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
 
 uint32_t ResourceCacheSharedItems::getPendingRequestsCount() const {
     Lock lock(_mutex);
-    return _pendingRequests.size();
+    uint32_t count = 0;
+    for (const auto& queue : _pendingRequests) {
+        count += queue.size();
+    }
+    return count;
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _loadingRequests) {
+    foreach(const LoadingRequest& request, _loadingRequests) {
+        auto resource = request.resource.lock();
         if (resource) {
             result.append(resource);
         }
@@ -79,15 +124,24 @@ uint32_t ResourceCacheSharedItems::getLoadingRequestsCount() const {
 }
 
 void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
+    auto doneResource = resource.lock();
+    uint64_t now = usecTimestampNow();
     Lock lock(_mutex);
 
     // resource can only be removed if it still has a ref-count, as
     // QWeakPointer has no operator== implementation for two weak ptrs, so
     // manually loop in case resource has been freed.
     for (int i = 0; i < _loadingRequests.size();) {
-        auto request = _loadingRequests.at(i);
+        const LoadingRequest& request = _loadingRequests.at(i);
         // Clear our resource and any freed resources
-        if (!request || request.data() == resource.data()) {
+        if (!request.resource) {
+            --_numLoadingRequests[request.origin];
+            _loadingRequests.removeAt(i);
+            continue;
+        }
+        if (doneResource && request.key == doneResource.data()) {
+            finishLoadingRequest(request, doneResource, now);
+            --_numLoadingRequests[request.origin];
             _loadingRequests.removeAt(i);
             continue;
         }
@@ -95,40 +149,205 @@ void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
     }
 }
 
-QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    QSharedPointer<Resource> highestResource;
+void ResourceCacheSharedItems::finishLoadingRequest(const LoadingRequest& request, const QSharedPointer<Resource>& resource, uint64_t now) {
+    uint64_t latency = now - request.startTime;
+    uint64_t firstByteTime = resource->_requestFirstByteTime;
+    if (firstByteTime > request.startTime && firstByteTime < now) {
+        // time to first byte measures the origin rather than the size of the asset
+        latency = firstByteTime - request.startTime;
+    }
+    _requestLimiters[request.origin].requestCompleted(now, latency, resource->getBytesReceived());
+}
+
+void ResourceCacheSharedItems::setRequestLimit(int limit) {
+    Lock lock(_mutex);
+    for (auto& limiter : _requestLimiters) {
+        limiter.setFixedLimit(limit);
+    }
+}
+
+int ResourceCacheSharedItems::getRequestLimit() const {
     Lock lock(_mutex);
+    int limit = 0;
+    for (const auto& limiter : _requestLimiters) {
+        limit += limiter.getLimit();
+    }
+    return limit;
+}
 
-    bool currentHighestIsFile = false;
+QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
+    Lock lock(_mutex);
+    updatePendingPriorities();
+
+    while (true) {
+        // local files always go first, otherwise take the best request among origins with a free slot
+        PendingRequestQueue* bestQueue = nullptr;
+        for (int origin = 0; origin < NUM_RESOURCE_ORIGINS; ++origin) {
+            PendingRequestQueue& queue = _pendingRequests[origin];
+            if (queue.isEmpty() || _numLoadingRequests[origin] >= _requestLimiters[origin].getLimit()) {
+                continue;
+            }
+            if (origin == RESOURCE_ORIGIN_FILE) {
+                bestQueue = &queue;
+                break;
+            }
+            if (!bestQueue || queue.top().priority > bestQueue->top().priority ||
+                    (queue.top().priority == bestQueue->top().priority && queue.top().sequence > bestQueue->top().sequence)) {
+                bestQueue = &queue;
+            }
+        }
+        if (!bestQueue) {
+            return QSharedPointer<Resource>();
+        }
 
-    for (int i = 0; i < _pendingRequests.size();) {
         // Clear any freed resources
-        auto resource = _pendingRequests.at(i).lock();
+        auto resource = bestQueue->top().resource.lock();
+        bestQueue->pop();
+        if (resource) {
+            resource->_isPendingRequest = false;
+            return resource;
+        }
+    }
+}
+
+void ResourceCacheSharedItems::updatePendingPriorities() {
+    // Priorities are only recomputed in batches when a download slot frees up: entries flagged by
+    // pendingRequestPriorityChanged() are re-sorted in place, and every so often the whole queue is
+    // refreshed to catch owners that went away without clearing their priority.
+    const uint64_t PENDING_PRIORITY_REFRESH_PERIOD = USECS_PER_SECOND;
+    uint64_t now = usecTimestampNow();
+    if (now > _nextPendingPriorityRefresh) {
+        _nextPendingPriorityRefresh = now + PENDING_PRIORITY_REFRESH_PERIOD;
+        _changedPendingRequests.clear();
+        for (auto& queue : _pendingRequests) {
+            queue.updateAllPriorities();
+        }
+        return;
+    }
+
+    foreach (Resource* key, _changedPendingRequests) {
+        for (auto& queue : _pendingRequests) {
+            if (queue.updatePriority(key)) {
+                break;
+            }
+        }
+    }
+    _changedPendingRequests.clear();
+}
+
+void ResourceCacheSharedItems::PendingRequestQueue::push(const PendingRequest& request) {
+    auto itr = _indices.find(request.key);
+    if (itr != _indices.end()) {
+        // already queued (or a freed resource at the same address): update the entry in place
+        int index = itr.value();
+        set(index, request);
+        siftUp(index);
+        siftDown(index);
+        return;
+    }
+
+    int index = (int)_heap.size();
+    _heap.push_back(request);
+    _indices.insert(request.key, index);
+    siftUp(index);
+}
+
+bool ResourceCacheSharedItems::PendingRequestQueue::updatePriority(Resource* key) {
+    auto itr = _indices.find(key);
+    if (itr == _indices.end()) {
+        return false;
+    }
+    int index = itr.value();
+    auto resource = _heap[index].resource.lock();
+    if (!resource) {
+        removeAt(index);
+        return false;
+    }
+    _heap[index].priority = resource->getLoadPriority();
+    siftUp(index);
+    siftDown(index);
+    return true;
+}
+
+void ResourceCacheSharedItems::PendingRequestQueue::updateAllPriorities() {
+    int size = (int)_heap.size();
+    for (int i = 0; i < size;) {
+        auto resource = _heap[i].resource.lock();
         if (!resource) {
-            _pendingRequests.removeAt(i);
+            // drop freed resources, re-heapified below
+            _indices.remove(_heap[i].key);
+            --size;
+            if (i != size) {
+                set(i, _heap[size]);
+            }
+            _heap.pop_back();
             continue;
         }
+        _heap[i].priority = resource->getLoadPriority();
+        ++i;
+    }
+    for (int i = size / 2 - 1; i >= 0; --i) {
+        siftDown(i);
+    }
+}
+
+bool ResourceCacheSharedItems::PendingRequestQueue::isHigherPriority(const PendingRequest& a, const PendingRequest& b) {
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.sequence > b.sequence;
+}
+
+void ResourceCacheSharedItems::PendingRequestQueue::set(int index, const PendingRequest& request) {
+    _heap[index] = request;
+    _indices[request.key] = index;
+}
 
-        // Check load priority
-        float priority = resource->getLoadPriority();
-        bool isFile = resource->getURL().scheme() == URL_SCHEME_FILE;
-        if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
-            highestPriority = priority;
-            highestIndex = i;
-            highestResource = resource;
-            currentHighestIsFile = isFile;
+void ResourceCacheSharedItems::PendingRequestQueue::siftUp(int index) {
+    PendingRequest request = _heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!isHigherPriority(request, _heap[parent])) {
+            break;
         }
-        i++;
+        set(index, _heap[parent]);
+        index = parent;
     }
+    set(index, request);
+}
 
-    if (highestIndex >= 0) {
-        _pendingRequests.takeAt(highestIndex);
+void ResourceCacheSharedItems::PendingRequestQueue::siftDown(int index) {
+    int size = (int)_heap.size();
+    PendingRequest request = _heap[index];
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && isHigherPriority(_heap[child + 1], _heap[child])) {
+            ++child;
+        }
+        if (!isHigherPriority(_heap[child], request)) {
+            break;
+        }
+        set(index, _heap[child]);
+        index = child;
     }
+    set(index, request);
+}
 
-    return highestResource;
+void ResourceCacheSharedItems::PendingRequestQueue::removeAt(int index) {
+    _indices.remove(_heap[index].key);
+    int last = (int)_heap.size() - 1;
+    if (index != last) {
+        set(index, _heap[last]);
+        _heap.pop_back();
+        // NOTE: if the moved request sifts up, the one left at index came from above it so siftDown() is a no-op
+        siftUp(index);
+        siftDown(index);
+    } else {
+        _heap.pop_back();
+    }
 }
 
 ScriptableResource::ScriptableResource(const QUrl& url) :
@@ -321,7 +540,7 @@ QVariantList ResourceCache::getResourceList() {
 }
  
 void ResourceCache::setRequestLimit(int limit) {
-    _requestLimit = limit;
+    DependencyManager::get<ResourceCacheSharedItems>()->setRequestLimit(limit);
 
     // Now go fill any new request spots
     while (attemptHighestPriorityRequest()) {
@@ -476,14 +695,12 @@ bool ResourceCache::attemptRequest(QSharedPointer<Resource> resource) {
 
 
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    if (_requestsActive >= _requestLimit) {
+    if (!sharedItems->appendActiveRequest(resource)) {
         // wait until a slot becomes available
         sharedItems->appendPendingRequest(resource);
         return false;
     }
-    
-    ++_requestsActive;
-    sharedItems->appendActiveRequest(resource);
+
     resource->makeRequest();
     return true;
 }
@@ -492,9 +709,10 @@ void ResourceCache::requestCompleted(QWeakPointer<Resource> resource) {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
 
     sharedItems->removeRequest(resource);
-    --_requestsActive;
 
-    attemptHighestPriorityRequest();
+    // the limit for this origin may have grown, so fill every free slot
+    while (attemptHighestPriorityRequest()) {
+    }
 }
 
 bool ResourceCache::attemptHighestPriorityRequest() {
@@ -503,9 +721,9 @@ bool ResourceCache::attemptHighestPriorityRequest() {
     return (resource && attemptRequest(resource));
 }
 
-const int DEFAULT_REQUEST_LIMIT = 10;
-int ResourceCache::_requestLimit = DEFAULT_REQUEST_LIMIT;
-int ResourceCache::_requestsActive = 0;
+int ResourceCache::getRequestLimit() {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getRequestLimit();
+}
 
 static int requestID = 0;
 
@@ -534,6 +752,7 @@ void Resource::ensureLoading() {
 void Resource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
     if (!(_failedToLoad)) {
         _loadPriorities.insert(owner, priority);
+        loadPriorityChanged();
     }
 }
 
@@ -545,11 +764,22 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
             it != priorities.constEnd(); it++) {
         _loadPriorities.insert(it.key(), it.value());
     }
+    loadPriorityChanged();
 }
 
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
     if (!(_failedToLoad)) {
         _loadPriorities.remove(owner);
+        loadPriorityChanged();
+    }
+}
+
+void Resource::loadPriorityChanged() {
+    if (_isPendingRequest) {
+        auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+        if (sharedItems) {
+            sharedItems->pendingRequestPriorityChanged(this);
+        }
     }
 }
 
@@ -693,11 +923,15 @@ void Resource::makeRequest() {
     connect(_request, &ResourceRequest::finished, this, &Resource::handleReplyFinished);
 
     _bytesReceived = _bytesTotal = _bytes = 0;
+    _requestFirstByteTime = 0;
 
     _request->send();
 }
 
 void Resource::handleDownloadProgress(uint64_t bytesReceived, uint64_t bytesTotal) {
+    if (_requestFirstByteTime == 0 && bytesReceived > 0) {
+        _requestFirstByteTime = usecTimestampNow();
+    }
     _bytesReceived = bytesReceived;
     _bytesTotal = bytesTotal;
 }
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
@@ -24,6 +25,7 @@
 #include <QtCore/QWeakPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
 
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -33,6 +35,7 @@
 #include <DependencyManager.h>
 
 #include "ResourceManager.h"
+#include "ResourceRequestLimiter.h"
 
 Q_DECLARE_METATYPE(size_t)
 
@@ -67,20 +70,85 @@ class ResourceCacheSharedItems : public Dependency  {
 
 public:
     void appendPendingRequest(QWeakPointer<Resource> newRequest);
-    void appendActiveRequest(QWeakPointer<Resource> newRequest);
+    /// \return false if all request slots for the resource's origin are in use
+    bool appendActiveRequest(QWeakPointer<Resource> newRequest);
     void removeRequest(QWeakPointer<Resource> doneRequest);
     QList<QSharedPointer<Resource>> getPendingRequests();
     uint32_t getPendingRequestsCount() const;
     QList<QSharedPointer<Resource>> getLoadingRequests();
+    /// \return highest priority pending request whose origin has a free request slot
     QSharedPointer<Resource> getHighestPendingRequest();
     uint32_t getLoadingRequestsCount() const;
 
+    /// Flags a pending resource whose load priority changed so it is re-sorted before the next dispatch.
+    void pendingRequestPriorityChanged(Resource* resource);
+
+    /// \param limit fixed number of concurrent requests per origin, or zero to adapt to each origin
+    void setRequestLimit(int limit);
+    /// \return current concurrent request limit, summed over origins
+    int getRequestLimit() const;
+
 private:
     ResourceCacheSharedItems() = default;
 
+    class PendingRequest {
+    public:
+        QWeakPointer<Resource> resource;
+        Resource* key;
+        float priority;
+        uint32_t sequence; // newer requests win ties
+    };
+
+    // max-heap of pending requests, with the heap index of each resource so entries can be re-sorted in place.
+    // Requests are ordered by the load priority they had when last refreshed, which can be up to a second stale for
+    // owners destroyed without clearing their priority, and the newest request wins ties.
+    class PendingRequestQueue {
+    public:
+        bool isEmpty() const { return _heap.empty(); }
+        uint32_t size() const { return (uint32_t)_heap.size(); }
+        const PendingRequest& top() const { return _heap[0]; }
+        const std::vector<PendingRequest>& getRequests() const { return _heap; }
+
+        void push(const PendingRequest& request);
+        void pop() { removeAt(0); }
+        /// \return false if the resource isn't queued or has been freed
+        bool updatePriority(Resource* key);
+        /// recompute every priority and drop freed resources
+        void updateAllPriorities();
+
+    private:
+        static bool isHigherPriority(const PendingRequest& a, const PendingRequest& b);
+        void set(int index, const PendingRequest& request);
+        void siftUp(int index);
+        void siftDown(int index);
+        void removeAt(int index);
+
+        std::vector<PendingRequest> _heap;
+        QHash<Resource*, int> _indices;
+    };
+
+    class LoadingRequest {
+    public:
+        QWeakPointer<Resource> resource;
+        Resource* key;
+        ResourceOrigin origin;
+        uint64_t startTime;
+    };
+
+    void updatePendingPriorities();
+    void finishLoadingRequest(const LoadingRequest& request, const QSharedPointer<Resource>& resource, uint64_t now);
+
     mutable Mutex _mutex;
-    QList<QWeakPointer<Resource>> _pendingRequests;
-    QList<QWeakPointer<Resource>> _loadingRequests;
+
+    // local files are always loaded first
+    PendingRequestQueue _pendingRequests[NUM_RESOURCE_ORIGINS];
+    QSet<Resource*> _changedPendingRequests;
+    uint64_t _nextPendingPriorityRefresh { 0 };
+    uint32_t _pendingSequence { 0 };
+
+    QList<LoadingRequest> _loadingRequests;
+    int _numLoadingRequests[NUM_RESOURCE_ORIGINS] { 0, 0, 0 };
+    ResourceRequestLimiter _requestLimiters[NUM_RESOURCE_ORIGINS];
 };
 
 /// Wrapper to expose resources to JS/QML
@@ -230,10 +298,11 @@ public:
      */
     Q_INVOKABLE QVariantList getResourceList();
 
+    /// \param limit fixed number of concurrent downloads per origin, or zero to adapt them to each origin
     static void setRequestLimit(int limit);
-    static int getRequestLimit() { return _requestLimit; }
+    static int getRequestLimit();
 
-    static int getRequestsActive() { return _requestsActive; }
+    static int getRequestsActive() { return getLoadingRequestCount(); }
     
     void setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize);
     qint64 getUnusedResourceCacheSize() const { return _unusedResourcesMaxSize; }
@@ -313,9 +382,6 @@ private:
     void resetResourceCounters();
     void removeResource(const QUrl& url, qint64 size = 0);
 
-    static int _requestLimit;
-    static int _requestsActive;
-
     // Resources
     QHash<QUrl, QWeakPointer<Resource>> _resources;
     QReadWriteLock _resourcesLock { QReadWriteLock::Recursive };
@@ -425,8 +491,13 @@ protected slots:
     void attemptRequest();
 
 protected:
+    friend class ResourceCacheSharedItems;
+
     virtual void init(bool resetLoaded = true);
 
+    /// Lets the pending queue know to re-sort this resource, if it is waiting for a download slot.
+    void loadPriorityChanged();
+
     /// Called by ResourceCache to begin loading this Resource.
     /// This method can be overriden to provide custom request functionality. If this is done,
     /// downloadFinished and ResourceCache::requestCompleted must be called.
@@ -465,12 +536,14 @@ protected:
     bool _loaded = false;
 
     QHash<QPointer<QObject>, float> _loadPriorities;
+    std::atomic<bool> _isPendingRequest { false }; // set by ResourceCacheSharedItems
     QWeakPointer<Resource> _self;
     QPointer<ResourceCache> _cache;
 
     qint64 _bytesReceived{ 0 };
     qint64 _bytesTotal{ 0 };
     qint64 _bytes{ 0 };
+    std::atomic<uint64_t> _requestFirstByteTime { 0 }; // usec, read by ResourceCacheSharedItems
 
     int _requestID;
     ResourceRequest* _request{ nullptr };
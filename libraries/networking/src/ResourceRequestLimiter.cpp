@@ -0,0 +1,99 @@
+//
+//  ResourceRequestLimiter.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceRequestLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <NumericalConstants.h>
+
+#include "NetworkingConstants.h"
+#include "NetworkLogging.h"
+
+ResourceOrigin resourceOriginForURL(const QUrl& url) {
+    QString scheme = url.scheme();
+    if (scheme == URL_SCHEME_FILE || scheme == URL_SCHEME_QRC) {
+        return RESOURCE_ORIGIN_FILE;
+    }
+    if (scheme == URL_SCHEME_ATP) {
+        return RESOURCE_ORIGIN_ATP;
+    }
+    if (scheme != URL_SCHEME_HTTP && scheme != URL_SCHEME_HTTPS && scheme != URL_SCHEME_FTP) {
+        // don't let a mistyped scheme jump ahead of the network loads, the request itself will fail
+        qCDebug(resourceLog) << "Unknown scheme (" << scheme << ") for URL: " << url.url();
+    }
+    return RESOURCE_ORIGIN_HTTP;
+}
+
+const uint64_t WINDOW_PERIOD = USECS_PER_SECOND / 4;
+const uint32_t MIN_WINDOW_COUNT = 4;
+
+// latency can grow this much over the best seen before we back off
+const float LATENCY_TOLERANCE = 1.5f;
+// smallest fraction of the limit we keep in a single back off
+const float MIN_GRADIENT = 0.5f;
+// the best latency drifts up by this fraction of the difference each window, so the limiter recovers
+// when the route to the origin changes
+const float MIN_LATENCY_DRIFT = 0.01f;
+// growing the limit must not cost more throughput than this
+const float THROUGHPUT_TOLERANCE = 0.9f;
+
+void ResourceRequestLimiter::setFixedLimit(int limit) {
+    _fixedLimit = std::max(0, limit);
+}
+
+void ResourceRequestLimiter::requestStarted(int numActive) {
+    if (numActive >= getLimit()) {
+        _windowSaturated = true;
+    }
+}
+
+void ResourceRequestLimiter::requestCompleted(uint64_t now, uint64_t latency, int64_t bytes) {
+    if (_windowCount == 0) {
+        _windowStart = now - std::min(now, latency);
+    }
+    _windowLatency += latency;
+    _windowBytes += std::max((int64_t)0, bytes);
+    ++_windowCount;
+
+    if (_windowCount >= MIN_WINDOW_COUNT && now - _windowStart >= WINDOW_PERIOD) {
+        updateLimit(now);
+    }
+}
+
+void ResourceRequestLimiter::updateLimit(uint64_t now) {
+    float averageLatency = (float)_windowLatency / (float)_windowCount;
+    float throughput = (float)_windowBytes * (float)USECS_PER_SECOND / (float)std::max((uint64_t)1, now - _windowStart);
+
+    if (_minLatency == 0.0f || averageLatency < _minLatency) {
+        _minLatency = averageLatency;
+    } else {
+        _minLatency += MIN_LATENCY_DRIFT * (averageLatency - _minLatency);
+    }
+
+    float gradient = std::max(MIN_GRADIENT, std::min(1.0f, LATENCY_TOLERANCE * _minLatency / std::max(1.0f, averageLatency)));
+    if (gradient < 1.0f) {
+        // requests are queueing at the origin
+        _limit *= gradient;
+    } else if (_windowSaturated && throughput >= THROUGHPUT_TOLERANCE * _throughput) {
+        // we're using every slot and more of them still pays off
+        _limit += sqrtf(_limit);
+    }
+    _limit = std::max((float)MIN_LIMIT, std::min((float)MAX_LIMIT, _limit));
+
+    _averageLatency = averageLatency;
+    _throughput = throughput;
+
+    _windowLatency = 0;
+    _windowBytes = 0;
+    _windowCount = 0;
+    _windowSaturated = false;
+}
@@ -0,0 +1,72 @@
+//
+//  ResourceRequestLimiter.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceRequestLimiter_h
+#define hifi_ResourceRequestLimiter_h
+
+#include <stdint.h>
+
+#include <QtCore/QUrl>
+
+// Downloads are throttled separately for each kind of origin
+enum ResourceOrigin : uint8_t {
+    RESOURCE_ORIGIN_FILE = 0,
+    RESOURCE_ORIGIN_ATP,
+    RESOURCE_ORIGIN_HTTP,
+    NUM_RESOURCE_ORIGINS
+};
+
+ResourceOrigin resourceOriginForURL(const QUrl& url);
+
+/// Adapts the number of concurrent requests to one kind of origin from the latency and throughput of
+/// completed requests.  It backs off when latency climbs above the best seen (requests are queueing at
+/// the origin) and grows while every slot is in use, latency stays flat and throughput keeps up.
+class ResourceRequestLimiter {
+public:
+    static const int DEFAULT_LIMIT = 10;
+    static const int MIN_LIMIT = 2;
+    static const int MAX_LIMIT = 64;
+
+    /// \param limit fixed number of concurrent requests, or zero to adapt
+    void setFixedLimit(int limit);
+    bool isAdaptive() const { return _fixedLimit == 0; }
+
+    int getLimit() const { return _fixedLimit > 0 ? _fixedLimit : (int)_limit; }
+
+    /// \param numActive number of requests in flight, including the one just started
+    void requestStarted(int numActive);
+
+    /// \param latency time from start of request to first byte (usec)
+    /// \param bytes size of the response
+    void requestCompleted(uint64_t now, uint64_t latency, int64_t bytes);
+
+    uint64_t getMinLatency() const { return (uint64_t)_minLatency; }
+    uint64_t getAverageLatency() const { return (uint64_t)_averageLatency; }
+    float getThroughput() const { return _throughput; } // bytes per second
+
+private:
+    void updateLimit(uint64_t now);
+
+    float _limit { (float)DEFAULT_LIMIT };
+    int _fixedLimit { 0 };
+
+    // current sample window
+    uint64_t _windowStart { 0 };
+    uint64_t _windowLatency { 0 };
+    int64_t _windowBytes { 0 };
+    uint32_t _windowCount { 0 };
+    bool _windowSaturated { false };
+
+    float _minLatency { 0.0f };
+    float _averageLatency { 0.0f };
+    float _throughput { 0.0f };
+};
+
+#endif // hifi_ResourceRequestLimiter_h
@@ -315,7 +315,9 @@ const btCollisionShape* EntityMotionState::computeNewShape() {
     ShapeInfo shapeInfo;
     assert(entityTreeIsLocked());
     _entity->computeShapeInfo(shapeInfo);
-    return getShapeManager()->getShape(shapeInfo);
+    const btCollisionShape* shape = getShapeManager()->getShape(shapeInfo);
+    _isShapePending = !shape && getShapeManager()->isPending(shapeInfo);
+    return shape;
 }
 
 void EntityMotionState::setShape(const btCollisionShape* shape) {
@@ -291,6 +291,10 @@ bool ObjectMotionState::handleHardAndEasyChanges(uint32_t& flags, PhysicsEngine*
         }
         const btCollisionShape* newShape = computeNewShape();
         if (!newShape) {
+            if (_isShapePending) {
+                // the new shape is being built on a worker thread --> keep the old one and try again later
+                return false;
+            }
             qCDebug(physics) << "Warning: failed to generate new shape!";
             // failed to generate new shape! --> keep old shape and remove shape-change flag
             flags &= ~Simulation::DIRTY_SHAPE;
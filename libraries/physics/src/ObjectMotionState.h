@@ -186,6 +186,7 @@ protected:
 
     uint32_t _lastKinematicStep;
     bool _hasInternalKinematicChanges { false };
+    bool _isShapePending { false }; // set by computeNewShape() when the ShapeManager is still building the shape
 };
 
 using SetOfMotionStates = QSet<ObjectMotionState*>;
@@ -17,6 +17,7 @@
 
 #include <PerfStat.h>
 #include <Profile.h>
+#include <TBBHelpers.h>
 
 #include "CharacterController.h"
 #include "ObjectMotionState.h"
@@ -63,6 +64,14 @@ void PhysicsEngine::init() {
         // in order for its broadphase collision queries to work correctly. Look at how we use
         // _activeStaticBodies to track and update the Aabb's of moved static objects.
         _dynamicsWorld->setForceUpdateAllAabbs(false);
+        _dynamicsWorld->setMultithreaded(_multithreaded);
+    }
+}
+
+void PhysicsEngine::setMultithreaded(bool multithreaded) {
+    _multithreaded = multithreaded;
+    if (_dynamicsWorld) {
+        _dynamicsWorld->setMultithreaded(multithreaded);
     }
 }
 
@@ -172,9 +181,7 @@ QList<EntityDynamicPointer> PhysicsEngine::removeDynamicsForBody(btRigidBody* bo
 
 void PhysicsEngine::removeObjects(const VectorOfMotionStates& objects) {
     // bump and prune contacts for all objects in the list
-    for (auto object : objects) {
-        bumpAndPruneContacts(object);
-    }
+    bumpAndPruneContacts(objects);
 
     if (_activeStaticBodies.size() > 0) {
         // _activeStaticBodies was not cleared last frame.
@@ -259,7 +266,9 @@ VectorOfMotionStates PhysicsEngine::changeObjects(const VectorOfMotionStates& ob
 
 void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
     // remove object from DynamicsWorld
-    bumpAndPruneContacts(object);
+    VectorOfMotionStates objects;
+    objects.push_back(object);
+    bumpAndPruneContacts(objects);
     btRigidBody* body = object->getRigidBody();
     if (body) {
         _dynamicsWorld->removeRigidBody(body);
@@ -269,18 +278,38 @@ void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
 }
 
 void PhysicsEngine::removeContacts(ObjectMotionState* motionState) {
-    // trigger events for new/existing/old contacts
-    ContactMap::iterator contactItr = _contactMap.begin();
-    while (contactItr != _contactMap.end()) {
-        if (contactItr->first._a == motionState || contactItr->first._b == motionState) {
-            contactItr = _contactMap.erase(contactItr);
+    uint32_t i = 0;
+    while (i < _contactMap.size()) {
+        const ContactKey& key = _contactMap.getKey(i);
+        if (key._a == motionState || key._b == motionState) {
+            // NOTE: removeAt() moves the last contact into slot i so we don't advance
+            _contactMap.removeAt(i);
         } else {
-            ++contactItr;
+            ++i;
+        }
+    }
+}
+
+void PhysicsEngine::removeContacts(const std::set<void*>& motionStates) {
+    uint32_t i = 0;
+    while (i < _contactMap.size()) {
+        const ContactKey& key = _contactMap.getKey(i);
+        if (motionStates.find(key._a) != motionStates.end() || motionStates.find(key._b) != motionStates.end()) {
+            _contactMap.removeAt(i);
+        } else {
+            ++i;
         }
     }
 }
 
 void PhysicsEngine::stepSimulation() {
+    const float MAX_TIMESTEP = (float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
+    float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
+    _clock.reset();
+    stepSimulation(btMin(dt, MAX_TIMESTEP));
+}
+
+void PhysicsEngine::stepSimulation(float timeStep) {
     CProfileManager::Reset();
     BT_PROFILE("stepSimulation");
     // NOTE: the grand order of operations is:
@@ -289,11 +318,6 @@ void PhysicsEngine::stepSimulation() {
     // (3) synchronize outgoing motion states
     // (4) send outgoing packets
 
-    const float MAX_TIMESTEP = (float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
-    float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
-    _clock.reset();
-    float timeStep = btMin(dt, MAX_TIMESTEP);
-
     if (_myAvatarController) {
         DETAILED_PROFILE_RANGE(simulation_physics, "avatarController");
         BT_PROFILE("avatarController");
@@ -467,6 +491,44 @@ void PhysicsEngine::doOwnershipInfection(const btCollisionObject* objectA, const
     }
 }
 
+static bool manifoldIsTouchingAndActive(const btPersistentManifold* contactManifold) {
+    if (contactManifold->getNumContacts() > 0) {
+        // if both objects are inactive we stop tracking this contact,
+        // which will eventually trigger a CONTACT_EVENT_TYPE_END
+        const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
+        const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
+        return objectA->isActive() || objectB->isActive();
+    }
+    return false;
+}
+
+// below this many manifolds the overhead of dispatching to worker threads outweighs the work itself
+const int MIN_NUM_MANIFOLDS_FOR_PARALLEL_SCAN = 512;
+
+void PhysicsEngine::updateContact(btPersistentManifold* contactManifold) {
+    // TODO: require scripts to register interest in callbacks for specific objects
+    // so we can filter out most collision events right here.
+    const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
+    const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
+
+    ObjectMotionState* a = static_cast<ObjectMotionState*>(objectA->getUserPointer());
+    ObjectMotionState* b = static_cast<ObjectMotionState*>(objectB->getUserPointer());
+    if (a || b) {
+        bool isNew = false;
+        uint32_t index = _contactMap.findOrInsert(ContactKey(a, b), isNew);
+        // the manifold has up to 4 distinct points, but only extract info from the first
+        _contactMap.getInfo(index).update(_numContactFrames, contactManifold->getContactPoint(0));
+        ++_contactStats.numProcessed;
+        if (isNew) {
+            ++_contactStats.numStarted;
+        }
+    }
+
+    if (!Physics::getSessionUUID().isNull()) {
+        doOwnershipInfection(objectA, objectB);
+    }
+}
+
 void PhysicsEngine::updateContactMap() {
     DETAILED_PROFILE_RANGE(simulation_physics, "updateContactMap");
     BT_PROFILE("updateContactMap");
@@ -474,29 +536,26 @@ void PhysicsEngine::updateContactMap() {
 
     // update all contacts every frame
     int numManifolds = _collisionDispatcher->getNumManifolds();
-    for (int i = 0; i < numManifolds; ++i) {
-        btPersistentManifold* contactManifold =  _collisionDispatcher->getManifoldByIndexInternal(i);
-        if (contactManifold->getNumContacts() > 0) {
-            // TODO: require scripts to register interest in callbacks for specific objects
-            // so we can filter out most collision events right here.
-            const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
-            const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
-
-            if (!(objectA->isActive() || objectB->isActive())) {
-                // both objects are inactive so stop tracking this contact,
-                // which will eventually trigger a CONTACT_EVENT_TYPE_END
-                continue;
+    _contactStats.numManifolds += (uint32_t)numManifolds;
+    if (_multithreaded && numManifolds >= MIN_NUM_MANIFOLDS_FOR_PARALLEL_SCAN) {
+        // Most manifolds in a large scene belong to resting (inactive) objects so we scan them in parallel
+        // and only visit the interesting ones serially, because ContactMap and bump() are not thread-safe.
+        _manifoldIsTouching.resize(numManifolds);
+        tbb::parallel_for(tbb::blocked_range<int>(0, numManifolds), [&](const tbb::blocked_range<int>& range) {
+            for (int i = range.begin(); i != range.end(); ++i) {
+                _manifoldIsTouching[i] = manifoldIsTouchingAndActive(_collisionDispatcher->getManifoldByIndexInternal(i));
             }
-
-            ObjectMotionState* a = static_cast<ObjectMotionState*>(objectA->getUserPointer());
-            ObjectMotionState* b = static_cast<ObjectMotionState*>(objectB->getUserPointer());
-            if (a || b) {
-                // the manifold has up to 4 distinct points, but only extract info from the first
-                _contactMap[ContactKey(a, b)].update(_numContactFrames, contactManifold->getContactPoint(0));
+        });
+        for (int i = 0; i < numManifolds; ++i) {
+            if (_manifoldIsTouching[i]) {
+                updateContact(_collisionDispatcher->getManifoldByIndexInternal(i));
             }
-
-            if (!Physics::getSessionUUID().isNull()) {
-                doOwnershipInfection(objectA, objectB);
+        }
+    } else {
+        for (int i = 0; i < numManifolds; ++i) {
+            btPersistentManifold* contactManifold = _collisionDispatcher->getManifoldByIndexInternal(i);
+            if (manifoldIsTouchingAndActive(contactManifold)) {
+                updateContact(contactManifold);
             }
         }
     }
@@ -551,20 +610,23 @@ void PhysicsEngine::doOwnershipInfectionForConstraints() {
 }
 
 const CollisionEvents& PhysicsEngine::getCollisionEvents() {
+    // NOTE: clear() keeps the capacity so the event buffer is recycled from frame to frame
     _collisionEvents.clear();
 
     // scan known contacts and trigger events
-    ContactMap::iterator contactItr = _contactMap.begin();
-
-    while (contactItr != _contactMap.end()) {
-        ContactInfo& contact = contactItr->second;
+    // NOTE: unlike the harvesting in updateContactMap() this scan stays serial: it is a cheap pass over the contacts,
+    // and removeAt() compacts the map in place so which contact sits at which index depends on the previous ones
+    uint32_t i = 0;
+    while (i < _contactMap.size()) {
+        ContactInfo& contact = _contactMap.getInfo(i);
         ContactEventType type = contact.computeType(_numContactFrames);
         const btScalar SIGNIFICANT_DEPTH = -0.002f; // penetrations have negative distance
         if (type != CONTACT_EVENT_TYPE_CONTINUE ||
                 (contact.distance < SIGNIFICANT_DEPTH &&
                  contact.readyForContinue(_numContactFrames))) {
-            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(contactItr->first._a);
-            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(contactItr->first._b);
+            const ContactKey& key = _contactMap.getKey(i);
+            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(key._a);
+            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(key._b);
 
             // NOTE: the MyAvatar RigidBody is the only object in the simulation that does NOT have a MotionState
             // which means should we ever want to report ALL collision events against the avatar we can
@@ -599,11 +661,20 @@ const CollisionEvents& PhysicsEngine::getCollisionEvents() {
         }
 
         if (type == CONTACT_EVENT_TYPE_END) {
-            contactItr = _contactMap.erase(contactItr);
+            // NOTE: removeAt() moves the last contact into slot i so we don't advance
+            _contactMap.removeAt(i);
+            ++_contactStats.numEnded;
         } else {
-            ++contactItr;
+            ++i;
         }
     }
+
+    _contactStats.numEvents = (uint32_t)_collisionEvents.size();
+    PROFILE_COUNTER(simulation_physics, "contacts", {
+        { "processed", (int)_contactStats.numProcessed },
+        { "changed", (int)(_contactStats.numStarted + _contactStats.numEnded) } });
+    _lastContactStats = _contactStats;
+    _contactStats = ContactStats();
     return _collisionEvents;
 }
 
@@ -657,20 +728,28 @@ void PhysicsEngine::saveNextPhysicsStats(QString filename) {
 // CF_DISABLE_VISUALIZE_OBJECT = 32, //disable debug drawing
 // CF_DISABLE_SPU_COLLISION_PROCESSING = 64//disable parallel/SPU processing
 
-void PhysicsEngine::bumpAndPruneContacts(ObjectMotionState* motionState) {
-    // Find all objects that touch the object corresponding to motionState and flag the other objects
+void PhysicsEngine::bumpAndPruneContacts(const VectorOfMotionStates& motionStates) {
+    // Find all objects that touch the objects corresponding to motionStates and flag the other objects
     // for simulation ownership by the local simulation.
+    // NOTE: we visit each manifold once for the whole batch rather than once per removed object
 
-    assert(motionState);
-    btCollisionObject* object = motionState->getRigidBody();
+    std::set<const btCollisionObject*> objects;
+    std::set<void*> prunedStates;
+    for (auto motionState : motionStates) {
+        assert(motionState);
+        prunedStates.insert(motionState);
+        if (motionState->getRigidBody()) {
+            objects.insert(motionState->getRigidBody());
+        }
+    }
 
     int numManifolds = _collisionDispatcher->getNumManifolds();
-    for (int i = 0; i < numManifolds; ++i) {
+    for (int i = 0; i < numManifolds && !objects.empty(); ++i) {
         btPersistentManifold* contactManifold =  _collisionDispatcher->getManifoldByIndexInternal(i);
         if (contactManifold->getNumContacts() > 0) {
             const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
             const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
-            if (objectB == object) {
+            if (objects.find(objectB) != objects.end()) {
                 if (!objectA->isStaticOrKinematicObject()) {
                     ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(objectA->getUserPointer());
                     if (motionStateA) {
@@ -678,7 +757,8 @@ void PhysicsEngine::bumpAndPruneContacts(ObjectMotionState* motionState) {
                         objectA->setActivationState(ACTIVE_TAG);
                     }
                 }
-            } else if (objectA == object) {
+            }
+            if (objects.find(objectA) != objects.end()) {
                 if (!objectB->isStaticOrKinematicObject()) {
                     ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(objectB->getUserPointer());
                     if (motionStateB) {
@@ -689,7 +769,7 @@ void PhysicsEngine::bumpAndPruneContacts(ObjectMotionState* motionState) {
             }
         }
     }
-    removeContacts(motionState);
+    removeContacts(prunedStates);
 }
 
 void PhysicsEngine::setCharacterController(CharacterController* character) {
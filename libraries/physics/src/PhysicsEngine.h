@@ -14,6 +14,7 @@
 
 #include <stdint.h>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include <QUuid>
@@ -42,7 +43,69 @@ public:
     void* _b; // ObjectMotionState pointer
 };
 
-using ContactMap = std::map<ContactKey, ContactInfo>;
+class ContactKeyHash {
+public:
+    size_t operator()(const ContactKey& key) const {
+        std::hash<void*> hasher;
+        return hasher(key._a) ^ (hasher(key._b) * 31);
+    }
+};
+
+// ContactMap stores ContactInfos in a dense array indexed by a hash of their ContactKey.
+// Lookups are O(1), scanning every contact touches contiguous memory, and slots are reused
+// rather than allocated and freed as contacts come and go.
+class ContactMap {
+public:
+    /// \return index of contact for key, created as needed (in which case isNew is set true)
+    uint32_t findOrInsert(const ContactKey& key, bool& isNew) {
+        auto result = _indices.emplace(key, (uint32_t)_keys.size());
+        isNew = result.second;
+        if (isNew) {
+            _keys.push_back(key);
+            _infos.push_back(ContactInfo());
+        }
+        return result.first->second;
+    }
+
+    uint32_t size() const { return (uint32_t)_keys.size(); }
+    const ContactKey& getKey(uint32_t index) const { return _keys[index]; }
+    ContactInfo& getInfo(uint32_t index) { return _infos[index]; }
+
+    /// \brief remove contact at index by moving the last contact into its slot
+    void removeAt(uint32_t index) {
+        uint32_t last = size() - 1;
+        _indices.erase(_keys[index]);
+        if (index != last) {
+            _keys[index] = _keys[last];
+            _infos[index] = _infos[last];
+            _indices[_keys[index]] = index;
+        }
+        _keys.pop_back();
+        _infos.pop_back();
+    }
+
+    void clear() {
+        _indices.clear();
+        _keys.clear();
+        _infos.clear();
+    }
+
+private:
+    std::unordered_map<ContactKey, uint32_t, ContactKeyHash> _indices;
+    std::vector<ContactKey> _keys;
+    btAlignedObjectArray<ContactInfo> _infos; // ContactInfo holds aligned btVector3s
+};
+
+// per-frame accounting of contact tracking work, reset by getCollisionEvents()
+class ContactStats {
+public:
+    uint32_t numManifolds { 0 }; // manifolds scanned, summed over substeps
+    uint32_t numProcessed { 0 }; // touching manifolds with an active body, summed over substeps
+    uint32_t numStarted { 0 };   // new contacts
+    uint32_t numEnded { 0 };     // contacts that went away
+    uint32_t numEvents { 0 };    // CollisionEvents emitted
+};
+
 using CollisionEvents = std::vector<Collision>;
 
 class PhysicsEngine {
@@ -61,6 +124,7 @@ public:
     void reinsertObject(ObjectMotionState* object);
 
     void stepSimulation();
+    void stepSimulation(float timeStep);
     void harvestPerformanceStats();
     void printPerformanceStatsToFile(const QString& filename);
     void updateContactMap();
@@ -75,6 +139,9 @@ public:
     /// \return reference to list of Collision events.  The list is only valid until beginning of next simulation loop.
     const CollisionEvents& getCollisionEvents();
 
+    /// \return contact tracking work done between the last two calls to getCollisionEvents()
+    const ContactStats& getContactStats() const { return _lastContactStats; }
+
     /// \brief prints timings for last frame if stats have been requested.
     void dumpStatsIfNecessary();
 
@@ -91,6 +158,10 @@ public:
 
     void dumpNextStats() { _dumpNextStats = true; }
 
+    /// \brief spread the per-object post-step work (motion state sync, contact scan) across worker threads
+    void setMultithreaded(bool multithreaded);
+    bool isMultithreaded() const { return _multithreaded; }
+
     EntityDynamicPointer getDynamicByID(const QUuid& dynamicID) const;
     bool addDynamic(EntityDynamicPointer dynamic);
     void removeDynamic(const QUuid dynamicID);
@@ -100,12 +171,14 @@ private:
     QList<EntityDynamicPointer> removeDynamicsForBody(btRigidBody* body);
     void addObjectToDynamicsWorld(ObjectMotionState* motionState);
 
-    /// \brief bump any objects that touch this one, then remove contact info
-    void bumpAndPruneContacts(ObjectMotionState* motionState);
+    /// \brief bump any objects that touch these, then remove their contact info
+    void bumpAndPruneContacts(const VectorOfMotionStates& motionStates);
 
     void removeContacts(ObjectMotionState* motionState);
+    void removeContacts(const std::set<void*>& motionStates);
 
     void doOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB);
+    void updateContact(btPersistentManifold* contactManifold);
 
     btClock _clock;
     btDefaultCollisionConfiguration* _collisionConfig = NULL;
@@ -116,7 +189,10 @@ private:
     btGhostPairCallback* _ghostPairCallback = NULL;
 
     ContactMap _contactMap;
+    ContactStats _contactStats;
+    ContactStats _lastContactStats;
     CollisionEvents _collisionEvents;
+    std::vector<uint8_t> _manifoldIsTouching;
     QHash<QUuid, EntityDynamicPointer> _objectDynamics;
     QHash<btRigidBody*, QSet<QUuid>> _objectDynamicsByBody;
     std::set<btRigidBody*> _activeStaticBodies;
@@ -127,11 +203,12 @@ private:
     CharacterController* _myAvatarController;
 
     uint32_t _numContactFrames = 0;
-    uint32_t _numSubsteps;
+    uint32_t _numSubsteps { 0 };
 
     bool _dumpNextStats { false };
     bool _saveNextStats { false };
     bool _hasOutgoingChanges { false };
+    bool _multithreaded { true };
 
 };
 
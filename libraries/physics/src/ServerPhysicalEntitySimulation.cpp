@@ -0,0 +1,361 @@
+//
+//  ServerPhysicalEntitySimulation.cpp
+//  libraries/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ServerPhysicalEntitySimulation.h"
+
+#include <DirtyOctreeElementOperator.h>
+#include <Profile.h>
+
+#include "PhysicsHelpers.h"
+
+const uint64_t DEFAULT_SERVER_PHYSICS_TICK_PERIOD = USECS_PER_SECOND / 30;
+const uint64_t MIN_SERVER_PHYSICS_TICK_PERIOD = (uint64_t)(PHYSICS_ENGINE_FIXED_SUBSTEP * (float)USECS_PER_SECOND);
+// beyond this the PhysicsEngine drops time rather than take more substeps
+const uint64_t MAX_SERVER_PHYSICS_TICK_PERIOD =
+    (uint64_t)((float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP * (float)USECS_PER_SECOND);
+
+// server-owned objects are broadcast no more often than this while they move
+const uint64_t SERVER_PHYSICS_PUBLISH_PERIOD = USECS_PER_SECOND / 5;
+
+const float STEP_TIME_TIMESCALE = 0.1f; // blend factor for running average of step time
+
+ServerPhysicalEntitySimulation::ServerPhysicalEntitySimulation() :
+    SimpleEntitySimulation(),
+    _tickPeriod(DEFAULT_SERVER_PHYSICS_TICK_PERIOD),
+    _adjustedTickPeriod(DEFAULT_SERVER_PHYSICS_TICK_PERIOD)
+{
+}
+
+ServerPhysicalEntitySimulation::~ServerPhysicalEntitySimulation() {
+    clearPhysics();
+}
+
+void ServerPhysicalEntitySimulation::setPhysicsEnabled(bool enabled) {
+    QMutexLocker lock(&_mutex);
+    if (enabled == _physicsEnabled) {
+        return;
+    }
+    if (enabled) {
+        // NOTE: the ShapeManager is a process-wide singleton from the point of view of ObjectMotionState
+        ObjectMotionState::setShapeManager(&_shapeManager);
+        _physicsEngine = std::make_shared<PhysicsEngine>(Vectors::ZERO);
+        _physicsEngine->init();
+        _nextStepTime = 0;
+        _adjustedTickPeriod = _tickPeriod;
+    } else {
+        clearPhysics();
+        _physicsEngine.reset();
+    }
+    _physicsEnabled = enabled;
+}
+
+void ServerPhysicalEntitySimulation::setSessionID(const QUuid& sessionID) {
+    QUuid oldSessionID;
+    {
+        QMutexLocker lock(&_mutex);
+        oldSessionID = _sessionID;
+        _sessionID = sessionID;
+    }
+    if (!oldSessionID.isNull() && oldSessionID != sessionID) {
+        // anything we owned under the old ID is now orphaned
+        clearOwnership(oldSessionID);
+    }
+}
+
+void ServerPhysicalEntitySimulation::setTickPeriod(uint64_t tickPeriod) {
+    QMutexLocker lock(&_mutex);
+    _tickPeriod = glm::clamp(tickPeriod, MIN_SERVER_PHYSICS_TICK_PERIOD, MAX_SERVER_PHYSICS_TICK_PERIOD);
+    _adjustedTickPeriod = _tickPeriod;
+}
+
+QString ServerPhysicalEntitySimulation::getStatsString() {
+    QMutexLocker lock(&_mutex);
+    QString statsString;
+    if (!_physicsEnabled) {
+        statsString += "    disabled\r\n";
+        return statsString;
+    }
+    statsString += QString("         Physical objects: %1\r\n").arg(_physicalObjects.size());
+    statsString += QString("     Owned by this server: %1\r\n").arg(_numOwned);
+    statsString += QString("   Configured tick period: %1 msecs\r\n").arg((float)_tickPeriod / (float)USECS_PER_MSEC);
+    statsString += QString("     Adjusted tick period: %1 msecs\r\n").arg((float)_adjustedTickPeriod / (float)USECS_PER_MSEC);
+    statsString += QString("        Step budget (CPU): %1 msecs\r\n").arg((float)_stepBudget / (float)USECS_PER_MSEC);
+    statsString += QString("    Average step time     : %1 msecs\r\n").arg(_averageStepTime / (float)USECS_PER_MSEC);
+    statsString += QString("    Steps over budget     : %1 of %2\r\n").arg(_numStepsOverBudget).arg(_numSteps);
+    return statsString;
+}
+
+// begin EntitySimulation overrides
+void ServerPhysicalEntitySimulation::updateEntitiesInternal(uint64_t now) {
+    SimpleEntitySimulation::updateEntitiesInternal(now);
+    if (_physicsEnabled && now >= _nextStepTime) {
+        stepPhysics(now);
+    }
+}
+
+void ServerPhysicalEntitySimulation::addEntityInternal(EntityItemPointer entity) {
+    QMutexLocker lock(&_mutex);
+    bool simulate = _physicsEnabled && shouldBeSimulatedOnServer(entity);
+    if (simulate && entity->getSimulatorID().isNull() && entity->getDynamic() && entity->hasLocalVelocity()) {
+        // claim before the base class sorts the entity into its ownership lists
+        claimOwnership(entity, usecTimestampNow());
+    }
+    SimpleEntitySimulation::addEntityInternal(entity);
+    if (simulate) {
+        _entitiesToAddToPhysics.insert(entity);
+    }
+}
+
+void ServerPhysicalEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
+    QMutexLocker lock(&_mutex);
+    SimpleEntitySimulation::removeEntityInternal(entity);
+    _entitiesToAddToPhysics.remove(entity);
+    EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
+    if (motionState) {
+        removeFromPhysics(motionState);
+    }
+}
+
+void ServerPhysicalEntitySimulation::changeEntityInternal(EntityItemPointer entity) {
+    QMutexLocker lock(&_mutex);
+    if (!_physicsEnabled) {
+        SimpleEntitySimulation::changeEntityInternal(entity);
+        return;
+    }
+
+    bool simulate = shouldBeSimulatedOnServer(entity);
+    if (simulate && entity->getSimulatorID().isNull() && entity->getDynamic() && entity->hasLocalVelocity()) {
+        claimOwnership(entity, usecTimestampNow());
+    }
+
+    // the base class clears the dirty flags but the PhysicsEngine still needs them to update the RigidBody
+    uint32_t dirtyFlags = entity->getDirtyFlags();
+    SimpleEntitySimulation::changeEntityInternal(entity);
+
+    EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
+    if (motionState) {
+        if (simulate) {
+            entity->markDirtyFlags(dirtyFlags & DIRTY_PHYSICS_FLAGS);
+            _incomingChanges.insert(motionState);
+        } else {
+            removeFromPhysics(motionState);
+            if (entity->isMovingRelativeToParent()) {
+                // hand it back to simple extrapolation
+                addKinematicEntity(entity, usecTimestampNow());
+            }
+        }
+    } else if (simulate) {
+        _entitiesToAddToPhysics.insert(entity);
+    } else {
+        _entitiesToAddToPhysics.remove(entity);
+    }
+}
+
+void ServerPhysicalEntitySimulation::clearEntitiesInternal() {
+    QMutexLocker lock(&_mutex);
+    clearPhysics();
+    SimpleEntitySimulation::clearEntitiesInternal();
+}
+// end EntitySimulation overrides
+
+bool ServerPhysicalEntitySimulation::shouldBeSimulatedOnServer(const EntityItemPointer& entity) const {
+    if (entity->isDead() || !entity->shouldBePhysical() || entity->getClientOnly() || !entity->getParentID().isNull()) {
+        return false;
+    }
+
+    // the server doesn't load model geometry so it can't build mesh-derived shapes
+    switch (entity->getShapeType()) {
+        case SHAPE_TYPE_HULL:
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return false;
+        default:
+            break;
+    }
+
+    if (entity->getDynamic()) {
+        // leave objects owned by clients to their owners
+        return entity->getSimulatorID().isNull() || isOwnedByServer(entity);
+    }
+    // everything else participates only as a static collider
+    return !entity->isMovingRelativeToParent() && !entity->hasActions();
+}
+
+bool ServerPhysicalEntitySimulation::isOwnedByServer(const EntityItemPointer& entity) const {
+    return !_sessionID.isNull() && entity->getSimulatorID() == _sessionID;
+}
+
+void ServerPhysicalEntitySimulation::claimOwnership(const EntityItemPointer& entity, uint64_t now) {
+    if (_sessionID.isNull()) {
+        return;
+    }
+    // VOLUNTEER is the lowest priority that blocks other volunteers so clients stop bidding on this object,
+    // but anyone who actually interacts with it bids higher and takes over
+    entity->setSimulationOwner(_sessionID, VOLUNTEER_SIMULATION_PRIORITY);
+    entity->setSimulationOwnershipExpiry(now + MAX_INCOMING_SIMULATION_UPDATE_PERIOD);
+    _entitiesWithSimulationOwner.insert(entity);
+    _entitiesThatNeedSimulationOwner.remove(entity);
+    _nextStaleOwnershipExpiry = glm::min(_nextStaleOwnershipExpiry, entity->getSimulationOwnershipExpiry());
+}
+
+void ServerPhysicalEntitySimulation::releaseOwnership(const EntityItemPointer& entity) {
+    entity->clearSimulationOwnership();
+    _entitiesWithSimulationOwner.remove(entity);
+}
+
+void ServerPhysicalEntitySimulation::publish(const EntityItemPointer& entity, uint64_t now) {
+    if (isOwnedByServer(entity)) {
+        entity->setSimulationOwnershipExpiry(now + MAX_INCOMING_SIMULATION_UPDATE_PERIOD);
+    }
+    entity->markAsChangedOnServer();
+    if (entity->getElement()) {
+        DirtyOctreeElementOperator op(entity->getElement());
+        getEntityTree()->recurseTreeWithOperator(&op);
+    }
+}
+
+void ServerPhysicalEntitySimulation::removeFromPhysics(EntityMotionState* motionState) {
+    // we hold _mutex and the tree lock and the engine is only stepped from updateEntitiesInternal()
+    // so the body can be removed and the MotionState deleted right away
+    VectorOfMotionStates objectsToRemove;
+    objectsToRemove.push_back(motionState);
+    _physicsEngine->removeObjects(objectsToRemove);
+    _incomingChanges.remove(motionState);
+    _physicalObjects.remove(motionState);
+    // NOTE: the EntityMotionState dtor clears the entity's backpointer
+    delete motionState;
+}
+
+void ServerPhysicalEntitySimulation::addObjectsToPhysics() {
+    VectorOfMotionStates objectsToAdd;
+    SetOfEntities::iterator entityItr = _entitiesToAddToPhysics.begin();
+    while (entityItr != _entitiesToAddToPhysics.end()) {
+        EntityItemPointer entity = (*entityItr);
+        if (entity->getPhysicsInfo() || !shouldBeSimulatedOnServer(entity)) {
+            entityItr = _entitiesToAddToPhysics.erase(entityItr);
+        } else if (entity->isReadyToComputeShape()) {
+            ShapeInfo shapeInfo;
+            entity->computeShapeInfo(shapeInfo);
+            btCollisionShape* shape = const_cast<btCollisionShape*>(_shapeManager.getShape(shapeInfo));
+            if (shape) {
+                EntityMotionState* motionState = new EntityMotionState(shape, entity);
+                entity->setPhysicsInfo(static_cast<void*>(motionState));
+                _physicalObjects.insert(motionState);
+                removeKinematicEntity(entity);
+                objectsToAdd.push_back(motionState);
+            } else if (_shapeManager.isPending(shapeInfo)) {
+                ++entityItr;
+                continue;
+            }
+            entityItr = _entitiesToAddToPhysics.erase(entityItr);
+        } else {
+            ++entityItr;
+        }
+    }
+    if (!objectsToAdd.empty()) {
+        _physicsEngine->addObjects(objectsToAdd);
+    }
+}
+
+void ServerPhysicalEntitySimulation::stepPhysics(uint64_t now) {
+    PROFILE_RANGE(simulation_physics, "ServerPhysics");
+    uint64_t startTime = usecTimestampNow();
+
+    addObjectsToPhysics();
+    if (!_incomingChanges.empty()) {
+        VectorOfMotionStates objectsToChange;
+        for (auto motionState : _incomingChanges) {
+            objectsToChange.push_back(motionState);
+        }
+        _incomingChanges.clear();
+        for (auto object : _physicsEngine->changeObjects(objectsToChange)) {
+            // e.g. a new shape that is still being built
+            _incomingChanges.insert(static_cast<EntityMotionState*>(object));
+        }
+    }
+
+    _physicsEngine->stepSimulation();
+    if (_physicsEngine->hasOutgoingChanges()) {
+        handleChangedMotionStates(_physicsEngine->getChangedMotionStates(), now);
+        handleDeactivatedMotionStates(_physicsEngine->getDeactivatedMotionStates(), now);
+        // we don't dispatch collision events on the server but this also prunes stale contacts
+        _physicsEngine->getCollisionEvents();
+    }
+
+    _numOwned = 0;
+    for (auto object : _physicalObjects) {
+        if (isOwnedByServer(static_cast<EntityMotionState*>(object)->getEntity())) {
+            ++_numOwned;
+        }
+    }
+
+    // stretch the tick when over budget, relax back toward the configured rate when comfortably under
+    uint64_t stepTime = usecTimestampNow() - startTime;
+    _averageStepTime = (1.0f - STEP_TIME_TIMESCALE) * _averageStepTime + STEP_TIME_TIMESCALE * (float)stepTime;
+    ++_numSteps;
+    if (_stepBudget > 0) {
+        if (stepTime > _stepBudget) {
+            ++_numStepsOverBudget;
+            _adjustedTickPeriod = glm::min(2 * _adjustedTickPeriod, MAX_SERVER_PHYSICS_TICK_PERIOD);
+        } else if (stepTime < _stepBudget / 2 && _adjustedTickPeriod > _tickPeriod) {
+            _adjustedTickPeriod = glm::max(_tickPeriod, (7 * _adjustedTickPeriod) / 8);
+        }
+    }
+    _nextStepTime = now + _adjustedTickPeriod;
+}
+
+void ServerPhysicalEntitySimulation::handleChangedMotionStates(const VectorOfMotionStates& motionStates, uint64_t now) {
+    for (auto state : motionStates) {
+        if (state->getType() != MOTIONSTATE_TYPE_ENTITY) {
+            continue;
+        }
+        EntityItemPointer entity = static_cast<EntityMotionState*>(state)->getEntity();
+        _entitiesToSort.insert(entity);
+        if (entity->getSimulatorID().isNull() && entity->getDynamic()) {
+            // something knocked an orphan into motion
+            claimOwnership(entity, now);
+            publish(entity, now);
+        } else if (isOwnedByServer(entity) && now - entity->getLastChangedOnServer() > SERVER_PHYSICS_PUBLISH_PERIOD) {
+            publish(entity, now);
+        }
+    }
+}
+
+void ServerPhysicalEntitySimulation::handleDeactivatedMotionStates(const VectorOfMotionStates& motionStates, uint64_t now) {
+    for (auto state : motionStates) {
+        if (state->getType() != MOTIONSTATE_TYPE_ENTITY) {
+            continue;
+        }
+        EntityItemPointer entity = static_cast<EntityMotionState*>(state)->getEntity();
+        if (isOwnedByServer(entity)) {
+            // come to rest and let go so anybody can pick it up without a bid war
+            entity->setVelocity(Vectors::ZERO);
+            entity->setAngularVelocity(Vectors::ZERO);
+            entity->setAcceleration(Vectors::ZERO);
+            releaseOwnership(entity);
+            publish(entity, now);
+            _entitiesToSort.insert(entity);
+        }
+    }
+}
+
+void ServerPhysicalEntitySimulation::clearPhysics() {
+    if (_physicsEngine) {
+        _physicsEngine->removeSetOfObjects(_physicalObjects);
+    }
+    for (auto object : _physicalObjects) {
+        delete static_cast<EntityMotionState*>(object);
+    }
+    _physicalObjects.clear();
+    _incomingChanges.clear();
+    _entitiesToAddToPhysics.clear();
+}
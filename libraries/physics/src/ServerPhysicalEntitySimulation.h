@@ -0,0 +1,94 @@
+//
+//  ServerPhysicalEntitySimulation.h
+//  libraries/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ServerPhysicalEntitySimulation_h
+#define hifi_ServerPhysicalEntitySimulation_h
+
+#include <stdint.h>
+
+#include <SimpleEntitySimulation.h>
+
+#include "EntityMotionState.h"
+#include "PhysicsEngine.h"
+#include "ShapeManager.h"
+
+class ServerPhysicalEntitySimulation;
+using ServerPhysicalEntitySimulationPointer = std::shared_ptr<ServerPhysicalEntitySimulation>;
+
+/// SimpleEntitySimulation that can optionally step a headless PhysicsEngine on the server.
+///
+/// When enabled the server simulates dynamic entities that have no simulation owner (or that it owns itself)
+/// and uses static entities as colliders.  It takes VOLUNTEER ownership of the objects it moves, so clients
+/// stop bidding on orphans but can still take over with a higher priority (e.g. when they grab or bump them).
+/// Entities owned by clients are left to their owners and are only extrapolated, as before.
+class ServerPhysicalEntitySimulation : public SimpleEntitySimulation {
+public:
+    ServerPhysicalEntitySimulation();
+    ~ServerPhysicalEntitySimulation();
+
+    /// \param enabled whether to step physics for unowned and server-owned entities
+    void setPhysicsEnabled(bool enabled);
+    bool isPhysicsEnabled() const { return _physicsEnabled; }
+
+    /// \param sessionID the UUID under which the server claims simulation ownership
+    void setSessionID(const QUuid& sessionID);
+
+    /// \param tickPeriod minimum time between physics steps (usec)
+    void setTickPeriod(uint64_t tickPeriod);
+
+    /// \param stepBudget CPU time allowed per physics step (usec), zero for no limit.  Steps that go over budget
+    /// stretch the tick period until the cost per second of simulation fits again.
+    void setStepBudget(uint64_t stepBudget) { _stepBudget = stepBudget; }
+
+    QString getStatsString();
+
+protected:
+    void updateEntitiesInternal(uint64_t now) override;
+    void addEntityInternal(EntityItemPointer entity) override;
+    void removeEntityInternal(EntityItemPointer entity) override;
+    void changeEntityInternal(EntityItemPointer entity) override;
+    void clearEntitiesInternal() override;
+
+private:
+    bool shouldBeSimulatedOnServer(const EntityItemPointer& entity) const;
+    bool isOwnedByServer(const EntityItemPointer& entity) const;
+    void claimOwnership(const EntityItemPointer& entity, uint64_t now);
+    void releaseOwnership(const EntityItemPointer& entity);
+    void publish(const EntityItemPointer& entity, uint64_t now);
+
+    void removeFromPhysics(EntityMotionState* motionState);
+    void addObjectsToPhysics();
+    void stepPhysics(uint64_t now);
+    void handleChangedMotionStates(const VectorOfMotionStates& motionStates, uint64_t now);
+    void handleDeactivatedMotionStates(const VectorOfMotionStates& motionStates, uint64_t now);
+    void clearPhysics();
+
+    ShapeManager _shapeManager;
+    PhysicsEnginePointer _physicsEngine;
+    QUuid _sessionID;
+
+    SetOfEntities _entitiesToAddToPhysics;
+    SetOfMotionStates _physicalObjects;
+    QSet<EntityMotionState*> _incomingChanges;
+
+    uint64_t _tickPeriod;
+    uint64_t _adjustedTickPeriod;
+    uint64_t _stepBudget { 0 };
+    uint64_t _nextStepTime { 0 };
+
+    float _averageStepTime { 0.0f }; // usec
+    uint32_t _numSteps { 0 };
+    uint32_t _numStepsOverBudget { 0 };
+    uint32_t _numOwned { 0 };
+
+    bool _physicsEnabled { false };
+};
+
+#endif // hifi_ServerPhysicalEntitySimulation_h
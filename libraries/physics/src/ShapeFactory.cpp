@@ -11,6 +11,9 @@
 
 #include <glm/gtx/norm.hpp>
 
+#include <QtCore/QDataStream>
+
+#include <HashKey.h>
 #include <SharedUtil.h> // for MILLIMETERS_PER_METER
 
 #include "ShapeFactory.h"
@@ -26,7 +29,21 @@ public:
         assert(_dataArray);
     }
 
+    // use a BVH that was deserialized in place inside bvhBuffer rather than build a new one
+    StaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, void* bvhBuffer)
+    :   btBvhTriangleMeshShape(dataArray, true, false), _dataArray(dataArray), _bvhBuffer(bvhBuffer) {
+        assert(_dataArray);
+        assert(bvh && _bvhBuffer);
+        setOptimizedBvh(bvh);
+    }
+
     ~StaticMeshShape() {
+        if (_bvhBuffer) {
+            // the base class doesn't own a BVH it was handed so we must tear it down
+            m_bvh->~btOptimizedBvh();
+            btAlignedFree(_bvhBuffer);
+            _bvhBuffer = nullptr;
+        }
         assert(_dataArray);
         IndexedMeshArray& meshes = _dataArray->getIndexedMeshArray();
         for (int32_t i = 0; i < meshes.size(); ++i) {
@@ -46,6 +63,7 @@ public:
 private:
     // the StaticMeshShape owns its vertex/index data
     btTriangleIndexVertexArray* _dataArray;
+    void* _bvhBuffer { nullptr };
 };
 
 // the dataArray must be created before we create the StaticMeshShape
@@ -464,3 +482,195 @@ void ShapeFactory::deleteShape(const btCollisionShape* shape) {
     }
     delete nonConstShape;
 }
+
+bool ShapeFactory::isExpensive(ShapeType type) {
+    switch (type) {
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Cached shape data is a header followed by a tree of nodes mirroring the btCollisionShape hierarchy.
+// Hulls store their final (reduced and margin-corrected) points and static meshes store their BVH.
+// The mesh itself is not stored: it is rebuilt from the ShapeInfo, which is cheap.
+const uint32_t SHAPE_CACHE_MAGIC = 0x48534843; // "HSHC"
+const uint32_t SHAPE_CACHE_VERSION = 1;
+
+enum CachedShapeNode : uint8_t {
+    CACHED_HULL = 1,
+    CACHED_COMPOUND,
+    CACHED_STATIC_MESH
+};
+
+// the HashKey of a ShapeInfo doesn't cover its points for all types (e.g. COMPOUND hashes its URL)
+// so we hash the geometry as well to catch content that changed under the same key
+static uint64_t hashShapeGeometry(const ShapeInfo& info) {
+    HashKey key;
+    for (const ShapeInfo::PointList& points : info.getPointCollection()) {
+        key.hashUint64((uint64_t)points.size());
+        for (const glm::vec3& point : points) {
+            key.hashVec3(point);
+        }
+    }
+    for (int32_t index : info.getTriangleIndices()) {
+        key.hashUint64((uint64_t)(uint32_t)index);
+    }
+    return key.getHash64();
+}
+
+static bool serializeShapeNode(QDataStream& stream, const btCollisionShape* shape) {
+    switch (shape->getShapeType()) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(shape);
+            int32_t numPoints = hull->getNumPoints();
+            const btVector3* points = hull->getUnscaledPoints();
+            stream << (quint8)CACHED_HULL << (float)hull->getMargin() << (qint32)numPoints;
+            for (int32_t i = 0; i < numPoints; ++i) {
+                stream << (float)points[i].getX() << (float)points[i].getY() << (float)points[i].getZ();
+            }
+            return true;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+            int32_t numChildren = compound->getNumChildShapes();
+            stream << (quint8)CACHED_COMPOUND << (qint32)numChildren;
+            for (int32_t i = 0; i < numChildren; ++i) {
+                const btTransform& transform = compound->getChildTransform(i);
+                btVector3 origin = transform.getOrigin();
+                btQuaternion rotation = transform.getRotation();
+                stream << (float)origin.getX() << (float)origin.getY() << (float)origin.getZ();
+                stream << (float)rotation.getX() << (float)rotation.getY() << (float)rotation.getZ() << (float)rotation.getW();
+                if (!serializeShapeNode(stream, compound->getChildShape(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+            const btBvhTriangleMeshShape* mesh = static_cast<const btBvhTriangleMeshShape*>(shape);
+            const btOptimizedBvh* bvh = const_cast<btBvhTriangleMeshShape*>(mesh)->getOptimizedBvh();
+            if (!bvh) {
+                return false;
+            }
+            uint32_t bufferSize = bvh->calculateSerializeBufferSize();
+            void* buffer = btAlignedAlloc(bufferSize, 16);
+            bool success = bvh->serializeInPlace(buffer, bufferSize, false);
+            if (success) {
+                stream << (quint8)CACHED_STATIC_MESH << (quint32)bufferSize;
+                stream.writeRawData(static_cast<const char*>(buffer), (int)bufferSize);
+            }
+            btAlignedFree(buffer);
+            return success;
+        }
+        default:
+            // cheap primitive, not worth caching
+            return false;
+    }
+}
+
+static btCollisionShape* createShapeFromCachedNode(QDataStream& stream, const ShapeInfo& info) {
+    quint8 nodeType = 0;
+    stream >> nodeType;
+    switch (nodeType) {
+        case CACHED_HULL: {
+            float margin = 0.0f;
+            qint32 numPoints = 0;
+            stream >> margin >> numPoints;
+            if (numPoints <= 0 || stream.status() != QDataStream::Ok) {
+                return nullptr;
+            }
+            btConvexHullShape* hull = new btConvexHullShape();
+            hull->setMargin(margin);
+            for (qint32 i = 0; i < numPoints; ++i) {
+                float x, y, z;
+                stream >> x >> y >> z;
+                hull->addPoint(btVector3(x, y, z), false);
+            }
+            hull->recalcLocalAabb();
+            return hull;
+        }
+        case CACHED_COMPOUND: {
+            qint32 numChildren = 0;
+            stream >> numChildren;
+            if (numChildren < 0 || stream.status() != QDataStream::Ok) {
+                return nullptr;
+            }
+            btCompoundShape* compound = new btCompoundShape();
+            for (qint32 i = 0; i < numChildren; ++i) {
+                float x, y, z, qx, qy, qz, qw;
+                stream >> x >> y >> z >> qx >> qy >> qz >> qw;
+                btCollisionShape* child = createShapeFromCachedNode(stream, info);
+                if (!child) {
+                    ShapeFactory::deleteShape(compound);
+                    return nullptr;
+                }
+                compound->addChildShape(btTransform(btQuaternion(qx, qy, qz, qw), btVector3(x, y, z)), child);
+            }
+            return compound;
+        }
+        case CACHED_STATIC_MESH: {
+            quint32 bufferSize = 0;
+            stream >> bufferSize;
+            if (bufferSize == 0 || info.getType() != SHAPE_TYPE_STATIC_MESH || stream.status() != QDataStream::Ok) {
+                return nullptr;
+            }
+            void* buffer = btAlignedAlloc(bufferSize, 16);
+            if (stream.readRawData(static_cast<char*>(buffer), (int)bufferSize) != (int)bufferSize) {
+                btAlignedFree(buffer);
+                return nullptr;
+            }
+            btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(buffer, bufferSize, false);
+            btTriangleIndexVertexArray* dataArray = bvh ? createStaticMeshArray(info) : nullptr;
+            if (!dataArray) {
+                if (bvh) {
+                    bvh->~btOptimizedBvh();
+                }
+                btAlignedFree(buffer);
+                return nullptr;
+            }
+            return new StaticMeshShape(dataArray, bvh, buffer);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+QByteArray ShapeFactory::serializeShape(const ShapeInfo& info, const btCollisionShape* shape) {
+    QByteArray data;
+    if (!shape || !isExpensive(info.getType())) {
+        return data;
+    }
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << (quint32)SHAPE_CACHE_MAGIC << (quint32)SHAPE_CACHE_VERSION;
+    stream << (quint32)info.getType() << (quint64)hashShapeGeometry(info);
+    if (!serializeShapeNode(stream, shape)) {
+        data.clear();
+    }
+    return data;
+}
+
+const btCollisionShape* ShapeFactory::createShapeFromCache(const ShapeInfo& info, const QByteArray& data) {
+    QDataStream stream(data);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 type = 0;
+    quint64 geometryHash = 0;
+    stream >> magic >> version >> type >> geometryHash;
+    if (stream.status() != QDataStream::Ok || magic != SHAPE_CACHE_MAGIC || version != SHAPE_CACHE_VERSION ||
+            type != (quint32)info.getType() || geometryHash != (quint64)hashShapeGeometry(info)) {
+        return nullptr;
+    }
+    btCollisionShape* shape = createShapeFromCachedNode(stream, info);
+    if (shape && (stream.status() != QDataStream::Ok || !stream.atEnd())) {
+        deleteShape(shape);
+        shape = nullptr;
+    }
+    return shape;
+}
@@ -15,6 +15,8 @@
 #include <btBulletDynamicsCommon.h>
 #include <glm/glm.hpp>
 
+#include <QtCore/QByteArray>
+
 #include <ShapeInfo.h>
 
 // The ShapeFactory assembles and correctly disassembles btCollisionShapes.
@@ -22,6 +24,16 @@
 namespace ShapeFactory {
     const btCollisionShape* createShapeFromInfo(const ShapeInfo& info);
     void deleteShape(const btCollisionShape* shape);
+
+    /// \return true if shapes of this type are costly to build (hull reduction, BVH construction)
+    bool isExpensive(ShapeType type);
+
+    /// \return data from which createShapeFromCache() can rebuild the shape without redoing the costly parts,
+    /// or an empty array when the shape isn't worth caching
+    QByteArray serializeShape(const ShapeInfo& info, const btCollisionShape* shape);
+
+    /// \return shape rebuilt from data produced by serializeShape(), or nullptr if data doesn't match info
+    const btCollisionShape* createShapeFromCache(const ShapeInfo& info, const QByteArray& data);
 };
 
 #endif // hifi_ShapeFactory_h
@@ -10,16 +10,65 @@
 //
 
 #include <QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <glm/gtx/norm.hpp>
 
 #include "ShapeFactory.h"
 #include "ShapeManager.h"
+#include "PhysicsLogging.h"
+
+static QString getDiskCachePath(const QString& directory, const HashKey& key) {
+    return QDir(directory).absoluteFilePath(QString::number(key.getHash64(), 16) + ".shape");
+}
+
+// NOTE: this may run on a worker thread so it must not touch any ShapeManager state
+static const btCollisionShape* loadOrBuildShape(const ShapeInfo& info, const QString& diskCacheDirectory) {
+    if (diskCacheDirectory.isEmpty() || !ShapeFactory::isExpensive(info.getType())) {
+        return ShapeFactory::createShapeFromInfo(info);
+    }
+
+    QString path = getDiskCachePath(diskCacheDirectory, info.getHash());
+    QFile cacheFile(path);
+    if (cacheFile.open(QIODevice::ReadOnly)) {
+        const btCollisionShape* shape = ShapeFactory::createShapeFromCache(info, cacheFile.readAll());
+        if (shape) {
+            return shape;
+        }
+        // stale or corrupt --> rebuild and overwrite below
+    }
+
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    if (shape) {
+        QByteArray data = ShapeFactory::serializeShape(info, shape);
+        if (!data.isEmpty()) {
+            QSaveFile saveFile(path);
+            if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(data) != data.size() || !saveFile.commit()) {
+                qCWarning(physics) << "ShapeManager failed to write shape cache file" << path;
+            }
+        }
+    }
+    return shape;
+}
 
 ShapeManager::ShapeManager() {
 }
 
 ShapeManager::~ShapeManager() {
+    int numPending = _pendingShapes.size();
+    for (int i = 0; i < numPending; ++i) {
+        QFuture<const btCollisionShape*>* future = _pendingShapes.getAtIndex(i);
+        future->waitForFinished();
+        const btCollisionShape* shape = future->result();
+        if (shape) {
+            ShapeFactory::deleteShape(shape);
+        }
+    }
+    _pendingShapes.clear();
+
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
@@ -38,17 +87,59 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+
+    if (!_asyncEnabled || !ShapeFactory::isExpensive(info.getType())) {
+        const btCollisionShape* shape = loadOrBuildShape(info, _diskCacheDirectory);
+        if (shape) {
+            addShapeReference(key, shape);
+        }
+        return shape;
+    }
+
+    QFuture<const btCollisionShape*>* future = _pendingShapes.find(key);
+    if (!future) {
+        // NOTE: the key was computed above so the copy of info we hand to the worker already has it cached
+        _pendingShapes.insert(key, QtConcurrent::run(loadOrBuildShape, info, _diskCacheDirectory));
+        return nullptr;
+    }
+    if (!future->isFinished()) {
+        return nullptr;
+    }
+    // a failed build is dropped too, the next request for the shape retries it as the synchronous path does
+    const btCollisionShape* shape = future->result();
+    _pendingShapes.remove(key);
     if (shape) {
-        ShapeReference newRef;
-        newRef.refCount = 1;
-        newRef.shape = shape;
-        newRef.key = key;
-        _shapeMap.insert(key, newRef);
+        addShapeReference(key, shape);
     }
     return shape;
 }
 
+bool ShapeManager::isPending(const ShapeInfo& info) const {
+    if (info.getType() == SHAPE_TYPE_NONE) {
+        return false;
+    }
+    const QFuture<const btCollisionShape*>* future = _pendingShapes.find(info.getHash());
+    return future && !future->isFinished();
+}
+
+void ShapeManager::setDiskCacheDirectory(const QString& directory) {
+    if (!directory.isEmpty() && !QDir().mkpath(directory)) {
+        qCWarning(physics) << "ShapeManager could not create shape cache directory" << directory;
+        _diskCacheDirectory.clear();
+        return;
+    }
+    _diskCacheDirectory = directory;
+}
+
+// private helper method
+void ShapeManager::addShapeReference(const HashKey& key, const btCollisionShape* shape) {
+    ShapeReference newRef;
+    newRef.refCount = 1;
+    newRef.shape = shape;
+    newRef.key = key;
+    _shapeMap.insert(key, newRef);
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(const HashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -15,6 +15,9 @@
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
+#include <QtCore/QFuture>
+#include <QtCore/QString>
+
 #include <ShapeInfo.h>
 
 #include "HashKey.h"
@@ -40,6 +43,13 @@
 // doesn't delete it right away.  Instead it puts the shape's key on a list delete
 // later.  When that list grows big enough the ShapeManager will remove any matching
 // entries that still have zero ref-count.
+//
+// Expensive shapes (convex hulls, compounds and static meshes) can optionally be built
+// on worker threads.  In that case getShape() returns nullptr until the build finishes
+// and the caller is expected to ask again later; isPending() distinguishes this from
+// a shape that failed to build.  Expensive shapes can also be persisted to a disk
+// cache keyed by the ShapeInfo's HashKey so that later loads of the same model skip
+// hull reduction and BVH construction.
 
 class ShapeManager {
 public:
@@ -47,9 +57,20 @@ public:
     ShapeManager();
     ~ShapeManager();
 
-    /// \return pointer to shape
+    /// \return pointer to shape, or nullptr if it failed to build or is still being built on a worker thread
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    /// \return true if the shape for info is being built on a worker thread
+    bool isPending(const ShapeInfo& info) const;
+
+    /// \param enabled build expensive shapes on worker threads rather than in getShape()
+    void setAsyncEnabled(bool enabled) { _asyncEnabled = enabled; }
+    bool isAsyncEnabled() const { return _asyncEnabled; }
+
+    /// \param directory where expensive shapes are persisted between sessions, empty to disable the disk cache
+    void setDiskCacheDirectory(const QString& directory);
+    const QString& getDiskCacheDirectory() const { return _diskCacheDirectory; }
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
@@ -58,12 +79,14 @@ public:
 
     // validation methods
     int getNumShapes() const { return _shapeMap.size(); }
+    int getNumPendingShapes() const { return _pendingShapes.size(); }
     int getNumReferences(const ShapeInfo& info) const;
     int getNumReferences(const btCollisionShape* shape) const;
     bool hasShape(const btCollisionShape* shape) const;
 
 private:
     bool releaseShapeByKey(const HashKey& key);
+    void addShapeReference(const HashKey& key, const btCollisionShape* shape);
 
     class ShapeReference {
     public:
@@ -76,6 +99,11 @@ private:
     // btHashMap is required because it supports memory alignment of the btCollisionShapes
     btHashMap<HashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<HashKey> _pendingGarbage;
+
+    // builds in flight on worker threads, plus finished builds nobody has picked up yet
+    btHashMap<HashKey, QFuture<const btCollisionShape*>> _pendingShapes;
+    QString _diskCacheDirectory;
+    bool _asyncEnabled { false };
 };
 
 #endif // hifi_ShapeManager_h
@@ -17,6 +17,8 @@
 
 #include <LinearMath/btQuickprof.h>
 
+#include <TBBHelpers.h>
+
 #include "ThreadSafeDynamicsWorld.h"
 #include "Profile.h"
 
@@ -94,6 +96,13 @@ int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep
     return subSteps;
 }
 
+void ThreadSafeDynamicsWorld::computeInterpolatedTransform(btRigidBody* body, btTransform& interpolatedTransform) const {
+    btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(),
+        body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),
+        (m_latencyMotionStateInterpolation && m_fixedTimeStep) ? m_localTime - m_fixedTimeStep : m_localTime*body->getHitFraction(),
+        interpolatedTransform);
+}
+
 // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
 void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body) {
     btAssert(body);
@@ -103,20 +112,81 @@ void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body) {
         ///@todo: add 'dirty' flag
         //if (body->getActivationState() != ISLAND_SLEEPING)
         {
-            if (body->isKinematicObject()) {
-                ObjectMotionState* objectMotionState = static_cast<ObjectMotionState*>(body->getMotionState());
-                if (objectMotionState->hasInternalKinematicChanges()) {
-                    objectMotionState->clearInternalKinematicChanges();
-                    body->getMotionState()->setWorldTransform(body->getWorldTransform());
+            btTransform interpolatedTransform;
+            if (!body->isKinematicObject()) {
+                computeInterpolatedTransform(body, interpolatedTransform);
+            }
+            synchronizeMotionState(body, interpolatedTransform);
+        }
+    }
+}
+
+// same as above but with the interpolated transform already computed (ignored for kinematic objects)
+void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body, const btTransform& interpolatedTransform) {
+    if (body->isKinematicObject()) {
+        ObjectMotionState* objectMotionState = static_cast<ObjectMotionState*>(body->getMotionState());
+        if (objectMotionState->hasInternalKinematicChanges()) {
+            objectMotionState->clearInternalKinematicChanges();
+            body->getMotionState()->setWorldTransform(body->getWorldTransform());
+        }
+        return;
+    }
+    body->getMotionState()->setWorldTransform(interpolatedTransform);
+}
+
+enum SyncAction : uint8_t {
+    SYNC_ACTION_NONE = 0,
+    SYNC_ACTION_ACTIVE,
+    SYNC_ACTION_DEACTIVATED
+};
+
+// below this many bodies the overhead of dispatching to worker threads outweighs the work itself
+const int MIN_NUM_BODIES_FOR_PARALLEL_SYNC = 256;
+
+void ThreadSafeDynamicsWorld::synchronizeActiveMotionStatesInParallel() {
+    // NOTE: MotionState::setWorldTransform() modifies external objects (e.g. entities) which may share
+    // locks or parent/child relationships so it must stay on this thread.  The pure Bullet math and the
+    // activation bookkeeping are independent per body and are computed in parallel into scratch arrays.
+    int numBodies = m_nonStaticRigidBodies.size();
+    _interpolatedTransforms.resize(numBodies);
+    _syncActions.resize(numBodies);
+    {
+        BT_PROFILE("computeTransforms");
+        tbb::parallel_for(tbb::blocked_range<int>(0, numBodies), [&](const tbb::blocked_range<int>& range) {
+            for (int i = range.begin(); i != range.end(); ++i) {
+                btRigidBody* body = m_nonStaticRigidBodies[i];
+                ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getMotionState());
+                uint8_t action = SYNC_ACTION_NONE;
+                if (motionState) {
+                    if (body->isActive()) {
+                        if (!body->isKinematicObject()) {
+                            computeInterpolatedTransform(body, _interpolatedTransforms[i]);
+                        }
+                        action = SYNC_ACTION_ACTIVE;
+                    } else if (_lastActiveStates.contains(motionState)) {
+                        // this object was active last frame but is no longer
+                        action = SYNC_ACTION_DEACTIVATED;
+                    }
                 }
-                return;
+                _syncActions[i] = action;
             }
-            btTransform interpolatedTransform;
-            btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(),
-                body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),
-                (m_latencyMotionStateInterpolation && m_fixedTimeStep) ? m_localTime - m_fixedTimeStep : m_localTime*body->getHitFraction(),
-                interpolatedTransform);
-            body->getMotionState()->setWorldTransform(interpolatedTransform);
+        });
+    }
+
+    BT_PROFILE("applyTransforms");
+    for (int i = 0; i < numBodies; ++i) {
+        uint8_t action = _syncActions[i];
+        if (action == SYNC_ACTION_NONE) {
+            continue;
+        }
+        btRigidBody* body = m_nonStaticRigidBodies[i];
+        ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getMotionState());
+        if (action == SYNC_ACTION_ACTIVE) {
+            synchronizeMotionState(body, _interpolatedTransforms[i]);
+            _changedMotionStates.push_back(motionState);
+            _activeStates.insert(motionState);
+        } else {
+            _deactivatedStates.push_back(motionState);
         }
     }
 }
@@ -144,17 +214,21 @@ void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
         // that remembers a list of objects deactivated last step
         _activeStates.clear();
         _deactivatedStates.clear();
-        for (int i=0;i<m_nonStaticRigidBodies.size();i++) {
-            btRigidBody* body = m_nonStaticRigidBodies[i];
-            ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getMotionState());
-            if (motionState) {
-                if (body->isActive()) {
-                    synchronizeMotionState(body);
-                    _changedMotionStates.push_back(motionState);
-                    _activeStates.insert(motionState);
-                } else if (_lastActiveStates.find(motionState) != _lastActiveStates.end()) {
-                    // this object was active last frame but is no longer
-                    _deactivatedStates.push_back(motionState);
+        if (_multithreaded && m_nonStaticRigidBodies.size() >= MIN_NUM_BODIES_FOR_PARALLEL_SYNC) {
+            synchronizeActiveMotionStatesInParallel();
+        } else {
+            for (int i=0;i<m_nonStaticRigidBodies.size();i++) {
+                btRigidBody* body = m_nonStaticRigidBodies[i];
+                ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getMotionState());
+                if (motionState) {
+                    if (body->isActive()) {
+                        synchronizeMotionState(body);
+                        _changedMotionStates.push_back(motionState);
+                        _activeStates.insert(motionState);
+                    } else if (_lastActiveStates.find(motionState) != _lastActiveStates.end()) {
+                        // this object was active last frame but is no longer
+                        _deactivatedStates.push_back(motionState);
+                    }
                 }
             }
         }
@@ -24,6 +24,7 @@
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <vector>
 
 using SubStepCallback = std::function<void()>;
 
@@ -53,14 +54,28 @@ public:
 
     void addChangedMotionState(ObjectMotionState* motionState) { _changedMotionStates.push_back(motionState); }
 
+    // When multithreaded the per-body work of synchronizeMotionStates() (transform interpolation and
+    // activation bookkeeping) is spread across worker threads and only the MotionState updates, which
+    // touch external object data, are done serially on the calling thread.
+    void setMultithreaded(bool multithreaded) { _multithreaded = multithreaded; }
+    bool isMultithreaded() const { return _multithreaded; }
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
+    void synchronizeMotionState(btRigidBody* body, const btTransform& interpolatedTransform);
+    void computeInterpolatedTransform(btRigidBody* body, btTransform& interpolatedTransform) const;
+    void synchronizeActiveMotionStatesInParallel();
 
     VectorOfMotionStates _changedMotionStates;
     VectorOfMotionStates _deactivatedStates;
     SetOfMotionStates _activeStates;
     SetOfMotionStates _lastActiveStates;
+
+    // scratch space for synchronizeActiveMotionStatesInParallel(), indexed like m_nonStaticRigidBodies
+    btAlignedObjectArray<btTransform> _interpolatedTransforms;
+    std::vector<uint8_t> _syncActions;
+    bool _multithreaded { true };
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -54,9 +54,12 @@ void CauterizedMeshPartPayload::updateTransformForCauterizedMesh(const Transform
     _cauterizedTransform = renderTransform;
 }
 
+bool CauterizedMeshPartPayload::useCauterizedMesh(RenderArgs::RenderMode renderMode) const {
+    return (renderMode != RenderArgs::RenderMode::SHADOW_RENDER_MODE && renderMode != RenderArgs::RenderMode::SECONDARY_CAMERA_RENDER_MODE) && _enableCauterization;
+}
+
 void CauterizedMeshPartPayload::bindTransform(gpu::Batch& batch, RenderArgs::RenderMode renderMode) const {
-    bool useCauterizedMesh = (renderMode != RenderArgs::RenderMode::SHADOW_RENDER_MODE && renderMode != RenderArgs::RenderMode::SECONDARY_CAMERA_RENDER_MODE) && _enableCauterization;
-    if (useCauterizedMesh) {
+    if (useCauterizedMesh(renderMode)) {
         if (_cauterizedClusterBuffer) {
             batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::SKINNING, _cauterizedClusterBuffer);
         }
@@ -66,3 +69,6 @@ void CauterizedMeshPartPayload::bindTransform(gpu::Batch& batch, RenderArgs::Ren
     }
 }
 
+Transform CauterizedMeshPartPayload::getInstanceTransform(RenderArgs::RenderMode renderMode) const {
+    return useCauterizedMesh(renderMode) ? _cauterizedTransform : _transform;
+}
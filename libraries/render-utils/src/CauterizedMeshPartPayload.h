@@ -26,10 +26,13 @@ public:
     void updateTransformForCauterizedMesh(const Transform& renderTransform);
 
     void bindTransform(gpu::Batch& batch, RenderArgs::RenderMode renderMode) const override;
+    Transform getInstanceTransform(RenderArgs::RenderMode renderMode) const override;
 
     void setEnableCauterization(bool enableCauterization) { _enableCauterization = enableCauterization; }
 
 private:
+    bool useCauterizedMesh(RenderArgs::RenderMode renderMode) const;
+
     gpu::BufferPointer _cauterizedClusterBuffer;
     Transform _cauterizedTransform;
     bool _enableCauterization { false };
@@ -111,21 +111,14 @@ void CauterizedModel::updateClusterMatrices() {
     _needsUpdateClusterMatrices = false;
     const FBXGeometry& geometry = getFBXGeometry();
 
-    for (int i = 0; i < (int)_meshStates.size(); i++) {
-        Model::MeshState& state = _meshStates[i];
-        const FBXMesh& mesh = geometry.meshes.at(i);
-        for (int j = 0; j < mesh.clusters.size(); j++) {
-            const FBXCluster& cluster = mesh.clusters.at(j);
-            if (_useDualQuaternionSkinning) {
-                auto jointPose = _rig.getJointPose(cluster.jointIndex);
-                Transform jointTransform(jointPose.rot(), jointPose.scale(), jointPose.trans());
-                Transform clusterTransform;
-                Transform::mult(clusterTransform, jointTransform, cluster.inverseBindTransform);
-                state.clusterDualQuaternions[j] = Model::TransformDualQuaternion(clusterTransform);
+    computeClusters();
+    if (_useDualQuaternionSkinning) {
+        for (int i = 0; i < (int)_meshStates.size(); i++) {
+            Model::MeshState& state = _meshStates[i];
+            const FBXMesh& mesh = geometry.meshes.at(i);
+            for (int j = 0; j < mesh.clusters.size(); j++) {
+                auto jointPose = _rig.getJointPose(mesh.clusters.at(j).jointIndex);
                 state.clusterDualQuaternions[j].setCauterizationParameters(0.0f, jointPose.trans());
-            } else {
-                auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
-                glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, state.clusterMatrices[j]);
             }
         }
     }
@@ -186,6 +186,33 @@ void MeshPartPayload::render(RenderArgs* args) {
     args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
 }
 
+void MeshPartPayload::renderInstance(RenderArgs* args, const Transform& transform) const {
+    gpu::Batch& batch = *(args->_batch);
+    auto pipeline = args->_shapePipeline;
+    auto material = !_drawMaterials.empty() ? _drawMaterials.top().material : DEFAULT_MATERIAL;
+    std::string instanceName = "mesh_parts_" + std::to_string(std::hash<const graphics::Mesh*>()(_drawMesh.get())) +
+        "_" + std::to_string(_partIndex) + "_" + std::to_string(std::hash<graphics::MaterialPointer>()(material)) +
+        "_" + std::to_string(std::hash<render::ShapePipelinePointer>()(pipeline));
+
+    // The transform of the instance goes in the batch transforms, along with the other instances of the named call
+    batch.setModelTransform(transform);
+
+    auto mesh = _drawMesh;
+    auto part = _drawPart;
+    bool enableTexturing = args->_enableTexturing;
+    batch.setupNamedCalls(instanceName, [args, pipeline, mesh, part, material, enableTexturing](gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+        batch.setPipeline(pipeline->pipeline);
+        pipeline->prepare(batch, args);
+
+        batch.setIndexBuffer(gpu::UINT32, (mesh->getIndexBuffer()._buffer), 0);
+        batch.setInputFormat((mesh->getVertexFormat()));
+        batch.setInputStream(0, mesh->getVertexStream());
+
+        RenderPipelines::bindMaterial(material, batch, enableTexturing);
+        batch.drawIndexedInstanced((gpu::uint32)data.count(), gpu::TRIANGLES, part._numIndices, part._startIndex);
+    });
+}
+
 namespace render {
 template <> const ItemKey payloadGetKey(const ModelMeshPartPayload::Pointer& payload) {
     if (payload) {
@@ -456,6 +483,13 @@ void ModelMeshPartPayload::bindTransform(gpu::Batch& batch, RenderArgs::RenderMo
     batch.setModelTransform(_transform);
 }
 
+bool ModelMeshPartPayload::canRenderInstanced(RenderArgs* args) const {
+    // The instances are drawn at the end of the batch, after the rest of its commands, which is fine for opaque parts
+    // Skinned and blendshaped parts have their own vertices, faded ones have their own fade parameters
+    return args->_shapePipeline && args->_shapePipeline->canDrawInstanced() &&
+        !_shapeKey.isTranslucent() && !_isSkinned && !_isBlendShaped;
+}
+
 void ModelMeshPartPayload::render(RenderArgs* args) {
     PerformanceTimer perfTimer("ModelMeshPartPayload::render");
 
@@ -463,6 +497,14 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
         return;
     }
 
+    const int INDICES_PER_TRIANGLE = 3;
+    if (canRenderInstanced(args)) {
+        renderInstance(args, getInstanceTransform(args->_renderMode));
+        args->_details._materialSwitches++;
+        args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+        return;
+    }
+
     gpu::Batch& batch = *(args->_batch);
 
     bindTransform(batch, args->_renderMode);
@@ -480,7 +522,6 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
         drawCall(batch);
     }
 
-    const int INDICES_PER_TRIANGLE = 3;
     args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
 }
 
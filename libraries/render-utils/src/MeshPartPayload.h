@@ -77,6 +77,10 @@ protected:
     render::ItemKey _itemKey{ render::ItemKey::Builder::opaqueShape().build() };
 
     bool topMaterialExists() const { return !_drawMaterials.empty() && _drawMaterials.top().material; }
+
+    // Records the part as an instance of the named call shared by the parts of the same mesh, drawn with the same
+    // material and pipeline, which draws them all at once at the end of the batch
+    void renderInstance(RenderArgs* args, const Transform& transform) const;
 };
 
 namespace render {
@@ -112,6 +116,11 @@ public:
     void setLayer(bool isLayeredInFront, bool isLayeredInHUD);
     void setShapeKey(bool invalidateShapeKey, bool isWireframe, bool useDualQuaternionSkinning);
 
+    // The parts of the same mesh, drawn with the same material and pipeline, are merged into instanced draws
+    bool canRenderInstanced(RenderArgs* args) const;
+    // transform of the part when drawn as an instance
+    virtual Transform getInstanceTransform(RenderArgs::RenderMode renderMode) const { return _transform; }
+
     // ModelMeshPartPayload functions to perform render
     void bindMesh(gpu::Batch& batch) override;
     void bindTransform(gpu::Batch& batch, RenderArgs::RenderMode renderMode) const override;
@@ -43,7 +43,7 @@ using namespace std;
 
 int nakedModelPointerTypeId = qRegisterMetaType<ModelPointer>();
 int weakGeometryResourceBridgePointerTypeId = qRegisterMetaType<Geometry::WeakPointer >();
-int vec3VectorTypeId = qRegisterMetaType<QVector<glm::vec3> >();
+int blendedVerticesPointerTypeId = qRegisterMetaType<BlendedVerticesPointer>();
 float Model::FAKE_DIMENSION_PLACEHOLDER = -1.0f;
 #define HTTP_INVALID_COM "http://invalid.com"
 
@@ -362,7 +362,12 @@ bool Model::updateGeometry() {
         assert(_meshStates.empty());
 
         const FBXGeometry& fbxGeometry = getFBXGeometry();
-        foreach (const FBXMesh& mesh, fbxGeometry.meshes) {
+        _skinClusters = SkinClusters(fbxGeometry);
+        if (fbxGeometry.hasBlendedMeshes()) {
+            _blendshapeMeshes = std::make_shared<BlendshapeMeshes>(fbxGeometry);
+        }
+        for (int i = 0; i < fbxGeometry.meshes.size(); i++) {
+            const FBXMesh& mesh = fbxGeometry.meshes.at(i);
             MeshState state;
             state.clusterDualQuaternions.resize(mesh.clusters.size());
             state.clusterMatrices.resize(mesh.clusters.size());
@@ -373,30 +378,14 @@ bool Model::updateGeometry() {
             // TODO? make _blendedVertexBuffers a map instead of vector and only add for meshes with blendshapes?
             auto buffer = std::make_shared<gpu::Buffer>();
             if (!mesh.blendshapes.isEmpty()) {
-                std::vector<NormalType> normalsAndTangents;
-                normalsAndTangents.reserve(mesh.normals.size() + mesh.tangents.size());
-
-                for (auto normalIt = mesh.normals.begin(), tangentIt = mesh.tangents.begin();
-                     normalIt != mesh.normals.end();
-                     ++normalIt, ++tangentIt) {
-#if FBX_PACK_NORMALS
-                    glm::uint32 finalNormal;
-                    glm::uint32 finalTangent;
-                    buffer_helpers::packNormalAndTangent(*normalIt, *tangentIt, finalNormal, finalTangent);
-#else
-                    const auto finalNormal = *normalIt;
-                    const auto finalTangent = *tangentIt;
-#endif
-                    normalsAndTangents.push_back(finalNormal);
-                    normalsAndTangents.push_back(finalTangent);
-                }
-
+                const auto& normalsAndTangents = _blendshapeMeshes->getNormalsAndTangents(i);
                 buffer->resize(mesh.vertices.size() * (sizeof(glm::vec3) + 2 * sizeof(NormalType)));
                 buffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (const gpu::Byte*) mesh.vertices.constData());
                 buffer->setSubData(mesh.vertices.size() * sizeof(glm::vec3),
-                                   mesh.normals.size() * 2 * sizeof(NormalType), (const gpu::Byte*) normalsAndTangents.data());
+                                   normalsAndTangents.size() * sizeof(NormalType), (const gpu::Byte*) normalsAndTangents.data());
             }
             _blendedVertexBuffers.push_back(buffer);
+            _blendedVertexRanges.push_back({ 0, 0 });
         }
         needFullUpdate = true;
         emit rigReady();
@@ -1197,7 +1186,7 @@ class Blender : public QRunnable {
 public:
 
     Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients);
+        const BlendedVerticesPointer& blendedVertices, const QVector<float>& blendshapeCoefficients);
 
     virtual void run() override;
 
@@ -1206,60 +1195,29 @@ private:
     ModelPointer _model;
     int _blendNumber;
     Geometry::WeakPointer _geometry;
-    QVector<FBXMesh> _meshes;
+    BlendedVerticesPointer _blendedVertices;
     QVector<float> _blendshapeCoefficients;
 };
 
 Blender::Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients) :
+        const BlendedVerticesPointer& blendedVertices, const QVector<float>& blendshapeCoefficients) :
     _model(model),
     _blendNumber(blendNumber),
     _geometry(geometry),
-    _meshes(meshes),
+    _blendedVertices(blendedVertices),
     _blendshapeCoefficients(blendshapeCoefficients) {
 }
 
 void Blender::run() {
     DETAILED_PROFILE_RANGE_EX(simulation_animation, __FUNCTION__, 0xFFFF0000, 0, { { "url", _model->getURL().toString() } });
-    QVector<glm::vec3> vertices, normals, tangents;
     if (_model) {
-        int offset = 0;
-        foreach (const FBXMesh& mesh, _meshes) {
-            if (mesh.blendshapes.isEmpty()) {
-                continue;
-            }
-            vertices += mesh.vertices;
-            normals += mesh.normals;
-            tangents += mesh.tangents;
-            glm::vec3* meshVertices = vertices.data() + offset;
-            glm::vec3* meshNormals = normals.data() + offset;
-            glm::vec3* meshTangents = tangents.data() + offset;
-            offset += mesh.vertices.size();
-            const float NORMAL_COEFFICIENT_SCALE = 0.01f;
-            for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
-                float vertexCoefficient = _blendshapeCoefficients.at(i);
-                const float EPSILON = 0.0001f;
-                if (vertexCoefficient < EPSILON) {
-                    continue;
-                }
-                float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
-                const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
-                for (int j = 0; j < blendshape.indices.size(); j++) {
-                    int index = blendshape.indices.at(j);
-                    meshVertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
-                    meshNormals[index] += blendshape.normals.at(j) * normalCoefficient;
-                    if (blendshape.tangents.size() > j) {
-                        meshTangents[index] += blendshape.tangents.at(j) * normalCoefficient;
-                    }
-                }
-            }
-        }
+        // blend straight into the buffer layout, which the main thread uploads as is
+        _blendedVertices->blend(_blendshapeCoefficients);
     }
     // post the result to the geometry cache, which will dispatch to the model if still alive
     QMetaObject::invokeMethod(DependencyManager::get<ModelBlender>().data(), "setBlendedVertices",
         Q_ARG(ModelPointer, _model), Q_ARG(int, _blendNumber),
-        Q_ARG(const Geometry::WeakPointer&, _geometry), Q_ARG(const QVector<glm::vec3>&, vertices),
-        Q_ARG(const QVector<glm::vec3>&, normals), Q_ARG(const QVector<glm::vec3>&, tangents));
+        Q_ARG(const Geometry::WeakPointer&, _geometry), Q_ARG(const BlendedVerticesPointer&, _blendedVertices));
 }
 
 void Model::setScaleToFit(bool scaleToFit, const glm::vec3& dimensions, bool forceRescale) {
@@ -1400,23 +1358,7 @@ void Model::updateClusterMatrices() {
 
     _needsUpdateClusterMatrices = false;
     const FBXGeometry& geometry = getFBXGeometry();
-    for (int i = 0; i < (int) _meshStates.size(); i++) {
-        MeshState& state = _meshStates[i];
-        const FBXMesh& mesh = geometry.meshes.at(i);
-        for (int j = 0; j < mesh.clusters.size(); j++) {
-            const FBXCluster& cluster = mesh.clusters.at(j);
-            if (_useDualQuaternionSkinning) {
-                auto jointPose = _rig.getJointPose(cluster.jointIndex);
-                Transform jointTransform(jointPose.rot(), jointPose.scale(), jointPose.trans());
-                Transform clusterTransform;
-                Transform::mult(clusterTransform, jointTransform, cluster.inverseBindTransform);
-                state.clusterDualQuaternions[j] = Model::TransformDualQuaternion(clusterTransform);
-            } else {
-                auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
-                glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, state.clusterMatrices[j]);
-            }
-        }
-    }
+    computeClusters();
 
     // post the blender if we're not currently waiting for one to finish
     if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
@@ -1425,103 +1367,93 @@ void Model::updateClusterMatrices() {
     }
 }
 
+void Model::computeClusters() {
+    // the clusters of all the meshes are computed together, from the joint poses of the rig
+    const AnimPoseVec& jointPoses = _rig.getAbsoluteJointPoses();
+    if (_useDualQuaternionSkinning) {
+        _skinClusters.computePoses(jointPoses, _clusterPoses);
+        for (int i = 0; i < (int)_meshStates.size(); i++) {
+            MeshState& state = _meshStates[i];
+            int offset = _skinClusters.getMeshOffset(i);
+            for (int j = 0; j < (int)state.clusterDualQuaternions.size(); j++) {
+                state.clusterDualQuaternions[j] = Model::TransformDualQuaternion(_clusterPoses.getScale(offset + j),
+                    _clusterPoses.getRotation(offset + j), _clusterPoses.getTranslation(offset + j));
+            }
+        }
+    } else {
+        SkinClusters::evalJointMatrices(jointPoses, _jointMatrices);
+        for (int i = 0; i < (int)_meshStates.size(); i++) {
+            _skinClusters.computeMatrices(i, _jointMatrices, _meshStates[i].clusterMatrices.data());
+        }
+    }
+}
+
 bool Model::maybeStartBlender() {
-    if (isLoaded()) {
-        const FBXGeometry& fbxGeometry = getFBXGeometry();
-        if (fbxGeometry.hasBlendedMeshes()) {
-            QThreadPool::globalInstance()->start(new Blender(getThisPointer(), ++_blendNumber, _renderGeometry,
-                fbxGeometry.meshes, _blendshapeCoefficients));
-            return true;
+    if (isLoaded() && _blendshapeMeshes) {
+        // blend into vertices already uploaded, or new ones when the previous blends are still running
+        BlendedVerticesPointer blendedVertices;
+        if (_freeBlendedVertices.empty()) {
+            blendedVertices = std::make_shared<BlendedVertices>(_blendshapeMeshes);
+        } else {
+            blendedVertices = _freeBlendedVertices.back();
+            _freeBlendedVertices.pop_back();
         }
+        QThreadPool::globalInstance()->start(new Blender(getThisPointer(), ++_blendNumber, _renderGeometry,
+            blendedVertices, _blendshapeCoefficients));
+        return true;
     }
     return false;
 }
 
-void Model::setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals, const QVector<glm::vec3>& tangents) {
+void Model::setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry, const BlendedVerticesPointer& blendedVertices) {
     auto geometryRef = geometry.lock();
-    if (!geometryRef || _renderGeometry != geometryRef || _blendedVertexBuffers.empty() || blendNumber < _appliedBlendNumber) {
+    if (!geometryRef || _renderGeometry != geometryRef || _blendedVertexBuffers.empty() ||
+            blendedVertices->getMeshes() != _blendshapeMeshes) {
+        return;
+    }
+    if (blendNumber < _appliedBlendNumber) {
+        _freeBlendedVertices.push_back(blendedVertices);
         return;
     }
     _appliedBlendNumber = blendNumber;
-    const FBXGeometry& fbxGeometry = getFBXGeometry();
-    int index = 0;
-    std::vector<NormalType> normalsAndTangents;
-    for (int i = 0; i < fbxGeometry.meshes.size(); i++) {
-        const FBXMesh& mesh = fbxGeometry.meshes.at(i);
-        if (mesh.blendshapes.isEmpty()) {
+    for (int i = 0; i < _blendshapeMeshes->getNumMeshes(); i++) {
+        if (!_blendshapeMeshes->isBlendshaped(i)) {
             continue;
         }
 
-        gpu::BufferPointer& buffer = _blendedVertexBuffers[i];
-        const auto vertexCount = mesh.vertices.size();
-        const auto verticesSize = vertexCount * sizeof(glm::vec3);
-        const auto offset = index * sizeof(glm::vec3);
-
-        normalsAndTangents.clear();
-        normalsAndTangents.resize(normals.size()+tangents.size());
-//        assert(normalsAndTangents.size() == 2 * vertexCount);
-
-        // Interleave normals and tangents
-#if 0
-        // Sequential version for debugging
-        auto normalsRange = std::make_pair(normals.begin() + index, normals.begin() + index + vertexCount);
-        auto tangentsRange = std::make_pair(tangents.begin() + index, tangents.begin() + index + vertexCount);
-        auto normalsAndTangentsIt = normalsAndTangents.begin();
-
-        for (auto normalIt = normalsRange.first, tangentIt = tangentsRange.first;
-             normalIt != normalsRange.second;
-             ++normalIt, ++tangentIt) {
-#if FBX_PACK_NORMALS
-            glm::uint32 finalNormal;
-            glm::uint32 finalTangent;
-            buffer_helpers::packNormalAndTangent(*normalIt, *tangentIt, finalNormal, finalTangent);
-#else
-            const auto finalNormal = *normalIt;
-            const auto finalTangent = *tangentIt;
-#endif
-            *normalsAndTangentsIt = finalNormal;
-            ++normalsAndTangentsIt;
-            *normalsAndTangentsIt = finalTangent;
-            ++normalsAndTangentsIt;
+        // the buffer differs from these vertices where the previous or this blend moved the mesh
+        std::pair<int, int>& previousRange = _blendedVertexRanges[i];
+        std::pair<int, int> range { blendedVertices->getBlendedBegin(i), blendedVertices->getBlendedEnd(i) };
+        int begin = range.first;
+        int end = range.second;
+        if (previousRange.first < previousRange.second) {
+            begin = (begin < end) ? std::min(begin, previousRange.first) : previousRange.first;
+            end = std::max(end, previousRange.second);
+        }
+        previousRange = range;
+        if (begin >= end) {
+            continue;
         }
-#else
-        // Parallel version for performance
-        tbb::parallel_for(tbb::blocked_range<size_t>(index, index+vertexCount), [&](const tbb::blocked_range<size_t>& range) {
-            auto normalsRange = std::make_pair(normals.begin() + range.begin(), normals.begin() + range.end());
-            auto tangentsRange = std::make_pair(tangents.begin() + range.begin(), tangents.begin() + range.end());
-            auto normalsAndTangentsIt = normalsAndTangents.begin() + (range.begin()-index)*2;
-
-            for (auto normalIt = normalsRange.first, tangentIt = tangentsRange.first;
-                 normalIt != normalsRange.second;
-                 ++normalIt, ++tangentIt) {
-#if FBX_PACK_NORMALS
-                glm::uint32 finalNormal;
-                glm::uint32 finalTangent;
-                buffer_helpers::packNormalAndTangent(*normalIt, *tangentIt, finalNormal, finalTangent);
-#else
-                const auto finalNormal = *normalIt;
-                const auto finalTangent = *tangentIt;
-#endif
-                *normalsAndTangentsIt = finalNormal;
-                ++normalsAndTangentsIt;
-                *normalsAndTangentsIt = finalTangent;
-                ++normalsAndTangentsIt;
-            }
-        });
-#endif
-
-        buffer->setSubData(0, verticesSize, (gpu::Byte*) vertices.constData() + offset);
-        buffer->setSubData(verticesSize, 2 * vertexCount * sizeof(NormalType), (const gpu::Byte*) normalsAndTangents.data());
 
-        index += vertexCount;
+        gpu::BufferPointer& buffer = _blendedVertexBuffers[i];
+        const auto& vertices = blendedVertices->getVertices(i);
+        const auto& normalsAndTangents = blendedVertices->getNormalsAndTangents(i);
+        const auto verticesSize = vertices.size() * sizeof(glm::vec3);
+        buffer->setSubData(begin * sizeof(glm::vec3), (end - begin) * sizeof(glm::vec3), (const gpu::Byte*) (vertices.data() + begin));
+        buffer->setSubData(verticesSize + 2 * begin * sizeof(NormalType), 2 * (end - begin) * sizeof(NormalType),
+            (const gpu::Byte*) (normalsAndTangents.data() + 2 * begin));
     }
+    _freeBlendedVertices.push_back(blendedVertices);
 }
 
 void Model::deleteGeometry() {
     _deleteGeometryCounter++;
     _blendedVertexBuffers.clear();
+    _blendshapeMeshes.reset();
+    _freeBlendedVertices.clear();
+    _blendedVertexRanges.clear();
     _meshStates.clear();
+    _skinClusters = SkinClusters();
     _rig.destroyAnimGraph();
     _blendedBlendshapeCoefficients.clear();
     _renderGeometry.reset();
@@ -1767,11 +1699,10 @@ void ModelBlender::noteRequiresBlend(ModelPointer model) {
     }
 }
 
-void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry, 
-                                      const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals, 
-                                      const QVector<glm::vec3>& tangents) {
+void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
+                                      const BlendedVerticesPointer& blendedVertices) {
     if (model) {
-        model->setBlendedVertices(blendNumber, geometry, vertices, normals, tangents);
+        model->setBlendedVertices(blendNumber, geometry, blendedVertices);
     }
     _pendingBlenders--;
     {
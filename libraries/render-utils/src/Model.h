@@ -35,7 +35,9 @@
 
 #include "GeometryCache.h"
 #include "TextureCache.h"
+#include "BlendshapeMeshes.h"
 #include "Rig.h"
+#include "SkinClusters.h"
 
 // Use dual quaternion skinning!
 // Must match define in Skinning.slh
@@ -125,8 +127,7 @@ public:
     bool maybeStartBlender();
 
     /// Sets blended vertices computed in a separate thread.
-    void setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals, const QVector<glm::vec3>& tangents);
+    void setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry, const BlendedVerticesPointer& blendedVertices);
 
     bool isLoaded() const { return (bool)_renderGeometry && _renderGeometry->isGeometryLoaded(); }
     bool isAddedToScene() const { return _addedToScene; }
@@ -382,6 +383,9 @@ protected:
     glm::vec3 _registrationPoint = glm::vec3(0.5f); /// the point in model space our center is snapped to
 
     std::vector<MeshState> _meshStates;
+    SkinClusters _skinClusters;
+    std::vector<glm::mat4> _jointMatrices;
+    SkinClusters::Poses _clusterPoses;
 
     virtual void initJointStates();
 
@@ -401,6 +405,9 @@ protected:
 
     virtual void deleteGeometry();
 
+    // Computes the cluster matrices or dual quaternions of the mesh states from the joint poses of the rig
+    void computeClusters();
+
     QVector<float> _blendshapeCoefficients;
 
     QUrl _url;
@@ -410,6 +417,11 @@ protected:
     bool _canCastShadow;
 
     gpu::Buffers _blendedVertexBuffers;
+    std::shared_ptr<const BlendshapeMeshes> _blendshapeMeshes;
+    // the blended vertices uploaded to the buffers, ready to blend again
+    std::vector<BlendedVerticesPointer> _freeBlendedVertices;
+    // the range of the vertices of each buffer that differ from the base mesh
+    std::vector<std::pair<int, int>> _blendedVertexRanges;
 
     QVector<QVector<QSharedPointer<Texture> > > _dilatedTextures;
 
@@ -488,6 +500,7 @@ private:
 
 Q_DECLARE_METATYPE(ModelPointer)
 Q_DECLARE_METATYPE(Geometry::WeakPointer)
+Q_DECLARE_METATYPE(BlendedVerticesPointer)
 
 /// Handle management of pending models that need blending
 class ModelBlender : public QObject, public Dependency {
@@ -501,7 +514,7 @@ public:
 
 public slots:
     void setBlendedVertices(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals, const QVector<glm::vec3>& tangents);
+        const BlendedVerticesPointer& blendedVertices);
 
 private:
     using Mutex = std::mutex;
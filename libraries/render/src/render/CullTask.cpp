@@ -16,6 +16,7 @@
 
 #include <PerfStat.h>
 #include <OctreeUtils.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
@@ -28,7 +29,7 @@ struct Test {
     glm::vec3 _eyePos;
     float _squareTanAlpha;
 
-    Test(CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails, ViewFrustumPointer antiFrustum = nullptr) :
+    Test(const CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails, ViewFrustumPointer antiFrustum = nullptr) :
         _functor(functor),
         _args(pargs),
         _renderDetails(renderDetails),
@@ -74,6 +75,42 @@ struct Test {
     }
 };
 
+// The items culled out of a range of the inputs, with their stats and bound
+struct CulledRange {
+    ItemBounds items;
+    RenderDetails::Item details;
+    AABox bound;
+};
+
+// The inputs are culled in ranges of this many items
+static const size_t CULL_RANGE_SIZE = 1024;
+
+// Calls cullRange() on consecutive ranges of the inputs, on the worker threads when there are several, then appends the
+// items they keep to outItems in the order of the ranges: the output is the same as when culling the items in sequence.
+template <class F>
+static void cullInRanges(size_t numItems, ItemBounds& outItems, RenderDetails::Item& details, AABox* outBound, const F& cullRange) {
+    const size_t numRanges = (numItems + CULL_RANGE_SIZE - 1) / CULL_RANGE_SIZE;
+    std::vector<CulledRange> ranges(numRanges);
+    auto cull = [&](size_t range) {
+        size_t begin = range * CULL_RANGE_SIZE;
+        cullRange(begin, std::min(numItems, begin + CULL_RANGE_SIZE), ranges[range]);
+    };
+    if (numRanges == 1) {
+        cull(0);
+    } else if (numRanges > 1) {
+        tbb::parallel_for((size_t)0, numRanges, cull);
+    }
+
+    for (auto& range : ranges) {
+        outItems.insert(outItems.end(), range.items.begin(), range.items.end());
+        details._outOfView += range.details._outOfView;
+        details._tooSmall += range.details._tooSmall;
+        if (outBound) {
+            *outBound += range.bound;
+        }
+    }
+}
+
 void render::cullItems(const RenderContextPointer& renderContext, const CullFunctor& cullFunctor, RenderDetails::Item& details,
                        const ItemBounds& inItems, ItemBounds& outItems) {
     assert(renderContext->args);
@@ -85,34 +122,27 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
     details._considered += (int)inItems.size();
 
     // Culling / LOD
-    for (auto item : inItems) {
-        if (item.bound.isNull()) {
-            outItems.emplace_back(item); // One more Item to render
-            continue;
-        }
-
-        // TODO: some entity types (like lights) might want to be rendered even
-        // when they are outside of the view frustum...
-        bool inView;
-        {
-            PerformanceTimer perfTimer("boxIntersectsFrustum");
-            inView = frustum.boxIntersectsFrustum(item.bound);
-        }
-        if (inView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = cullFunctor(args, item.bound);
+    cullInRanges(inItems.size(), outItems, details, nullptr, [&](size_t begin, size_t end, CulledRange& culled) {
+        for (size_t i = begin; i < end; ++i) {
+            auto& item = inItems[i];
+            if (item.bound.isNull()) {
+                culled.items.emplace_back(item); // One more Item to render
+                continue;
             }
-            if (bigEnoughToRender) {
-                outItems.emplace_back(item); // One more Item to render
+
+            // TODO: some entity types (like lights) might want to be rendered even
+            // when they are outside of the view frustum...
+            if (frustum.boxIntersectsFrustum(item.bound)) {
+                if (cullFunctor(args, item.bound)) {
+                    culled.items.emplace_back(item); // One more Item to render
+                } else {
+                    culled.details._tooSmall++;
+                }
             } else {
-                details._tooSmall++;
+                culled.details._outOfView++;
             }
-        } else {
-            details._outOfView++;
         }
-    }
+    });
     details._rendered += (int)outItems.size();
 }
 
@@ -126,9 +156,8 @@ void FetchNonspatialItems::run(const RenderContextPointer& renderContext, const
     const auto& items = scene->getNonspatialSet();
     outItems.reserve(items.size());
     for (auto& id : items) {
-        auto& item = scene->getItem(id);
-        if (filter.test(item.getKey())) {
-            outItems.emplace_back(ItemBound(id, item.getBound()));
+        if (filter.test(scene->getItemKey(id))) {
+            outItems.emplace_back(id, scene->getItemBound(id));
         }
     }
 }
@@ -196,17 +225,18 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
     auto& details = args->_details.edit(_detailType);
     details._considered += (int)inSelection.numItems();
 
-    // Eventually use a frozen frustum
+    // Eventually use a frozen frustum, on a copy of the args since other jobs can read them at the same time
+    std::unique_ptr<RenderArgs> frozenArgs;
     if (_freezeFrustum) {
         if (_justFrozeFrustum) {
             _justFrozeFrustum = false;
             _frozenFrustum = args->getViewFrustum();
         }
-        args->pushViewFrustum(_frozenFrustum); // replace the true view frustum by the frozen one
+        frozenArgs.reset(new RenderArgs(*args));
+        frozenArgs->pushViewFrustum(_frozenFrustum); // replace the true view frustum by the frozen one
+        args = frozenArgs.get();
     }
 
-    Test test(_cullFunctor, args, details);
-
     // Now we have a selection of items to render
     outItems.clear();
     outItems.reserve(inSelection.numItems());
@@ -215,150 +245,60 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
     if (!srcFilter.selectsNothing()) {
         auto filter = render::ItemFilter::Builder(srcFilter).withoutSubMetaCulled().build();
 
-            // Now get the bound, and
-        // filter individually against the _filter
-        // visibility cull if partially selected ( octree cell contianing it was partial)
-        // distance cull if was a subcell item ( octree cell is way bigger than the item bound itself, so now need to test per item)
-        if (_skipCulling) {
-            // inside & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // inside & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
+        // Filter and cull a list of the selection, on ranges of it in parallel
+        auto cullSelection = [&](const ItemIDs& itemIDs, bool frustumCull, bool solidAngleCull) {
+            cullInRanges(itemIDs.size(), outItems, details, nullptr, [&](size_t begin, size_t end, CulledRange& culled) {
+                Test test(_cullFunctor, args, culled.details);
+                for (size_t i = begin; i < end; ++i) {
+                    auto id = itemIDs[i];
+                    const auto& key = scene->getItemKey(id);
+                    if (filter.test(key)) {
+                        const auto& bound = scene->getItemBound(id);
+                        if ((!frustumCull || test.frustumTest(bound)) && (!solidAngleCull || test.solidAngleTest(bound))) {
+                            culled.items.emplace_back(id, bound);
+                            if (key.isMetaCullGroup()) {
+                                scene->getItem(id).fetchMetaSubItemBounds(culled.items, (*scene));
+                            }
                         }
                     }
                 }
-            }
+            });
+        };
 
-        } else {
+        // Now get the bound, and
+        // filter individually against the _filter
+        // visibility cull if partially selected ( octree cell contianing it was partial)
+        // distance cull if was a subcell item ( octree cell is way bigger than the item bound itself, so now need to test per item)
+        // When culling is disabled, only filter.
+        bool cull = !_skipCulling;
 
-            // inside & fit items: easy, just filter
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
+        // inside & fit items: easy, just filter
+        {
+            PerformanceTimer perfTimer("insideFitItems");
+            cullSelection(inSelection.insideItems, false, false);
+        }
 
-            // inside & subcell items: filter & distance cull
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
+        // inside & subcell items: filter & distance cull
+        {
+            PerformanceTimer perfTimer("insideSmallItems");
+            cullSelection(inSelection.insideSubcellItems, false, cull);
+        }
 
-            // partial & fit items: filter & frustum cull
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
+        // partial & fit items: filter & frustum cull
+        {
+            PerformanceTimer perfTimer("partialFitItems");
+            cullSelection(inSelection.partialItems, cull, false);
+        }
 
-            // partial & subcell items:: filter & frutum cull & solidangle cull
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            if (test.solidAngleTest(itemBound.bound)) {
-                                outItems.emplace_back(itemBound);
-                                if (item.getKey().isMetaCullGroup()) {
-                                    item.fetchMetaSubItemBounds(outItems, (*scene));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        // partial & subcell items:: filter & frutum cull & solidangle cull
+        {
+            PerformanceTimer perfTimer("partialSmallItems");
+            cullSelection(inSelection.partialSubcellItems, cull, cull);
         }
     }
 
     details._rendered += (int)outItems.size();
 
-    // Restore frustum if using the frozen one:
-    if (_freezeFrustum) {
-        args->popViewFrustum();
-    }
-
     std::static_pointer_cast<Config>(renderContext->jobConfig)->numItems = (int)outItems.size();
 }
 
@@ -378,7 +318,6 @@ void CullShapeBounds::run(const RenderContextPointer& renderContext, const Input
 
     if (!filter.selectsNothing()) {
         auto& details = args->_details.edit(_detailType);
-        Test test(_cullFunctor, args, details, antiFrustum);
 
         for (auto& inItems : inShapes) {
             auto key = inItems.first;
@@ -390,21 +329,17 @@ void CullShapeBounds::run(const RenderContextPointer& renderContext, const Input
 
             details._considered += (int)inItems.second.size();
 
-            if (antiFrustum == nullptr) {
-                for (auto& item : inItems.second) {
-                    if (test.solidAngleTest(item.bound) && test.frustumTest(item.bound)) {
-                        outItems->second.emplace_back(item);
-                        outBounds += item.bound;
+            cullInRanges(inItems.second.size(), outItems->second, details, &outBounds, [&](size_t begin, size_t end, CulledRange& culled) {
+                Test test(_cullFunctor, args, culled.details, antiFrustum);
+                for (size_t i = begin; i < end; ++i) {
+                    auto& item = inItems.second[i];
+                    if (test.solidAngleTest(item.bound) && test.frustumTest(item.bound) &&
+                        (antiFrustum == nullptr || test.antiFrustumTest(item.bound))) {
+                        culled.items.emplace_back(item);
+                        culled.bound += item.bound;
                     }
                 }
-            } else {
-                for (auto& item : inItems.second) {
-                    if (test.solidAngleTest(item.bound) && test.frustumTest(item.bound) && test.antiFrustumTest(item.bound)) {
-                        outItems->second.emplace_back(item);
-                        outBounds += item.bound;
-                    }
-                }
-            }
+            });
             details._rendered += (int)outItems->second.size();
         }
 
@@ -459,10 +394,8 @@ void FetchSpatialSelection::run(const RenderContextPointer& renderContext,
         {
             PerformanceTimer perfTimer("insideFitItems");
             for (auto id : inSelection.insideItems) {
-                auto& item = scene->getItem(id);
-                if (filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    outItems.emplace_back(itemBound);
+                if (filter.test(scene->getItemKey(id))) {
+                    outItems.emplace_back(id, scene->getItemBound(id));
                 }
             }
         }
@@ -471,10 +404,8 @@ void FetchSpatialSelection::run(const RenderContextPointer& renderContext,
         {
             PerformanceTimer perfTimer("insideSmallItems");
             for (auto id : inSelection.insideSubcellItems) {
-                auto& item = scene->getItem(id);
-                if (filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    outItems.emplace_back(itemBound);
+                if (filter.test(scene->getItemKey(id))) {
+                    outItems.emplace_back(id, scene->getItemBound(id));
                 }
             }
         }
@@ -483,10 +414,8 @@ void FetchSpatialSelection::run(const RenderContextPointer& renderContext,
         {
             PerformanceTimer perfTimer("partialFitItems");
             for (auto id : inSelection.partialItems) {
-                auto& item = scene->getItem(id);
-                if (filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    outItems.emplace_back(itemBound);
+                if (filter.test(scene->getItemKey(id))) {
+                    outItems.emplace_back(id, scene->getItemBound(id));
                 }
             }
         }
@@ -495,10 +424,8 @@ void FetchSpatialSelection::run(const RenderContextPointer& renderContext,
         {
             PerformanceTimer perfTimer("partialSmallItems");
             for (auto id : inSelection.partialSubcellItems) {
-                auto& item = scene->getItem(id);
-                if (filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    outItems.emplace_back(itemBound);
+                if (filter.test(scene->getItemKey(id))) {
+                    outItems.emplace_back(id, scene->getItemBound(id));
                 }
             }
         }
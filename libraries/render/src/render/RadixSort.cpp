@@ -0,0 +1,100 @@
+//
+//  RadixSort.cpp
+//  render/src/render
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <array>
+
+#include <TBBHelpers.h>
+
+using namespace render;
+
+static const int RADIX_BITS = 8;
+static const uint32_t RADIX_SIZE = 1 << RADIX_BITS;
+static const uint32_t RADIX_MASK = RADIX_SIZE - 1;
+static const int NUM_PASSES = 32 / RADIX_BITS;
+
+// smaller arrays are sorted on the calling thread
+static const size_t MIN_ENTRIES_PER_RANGE = 8192;
+static const size_t MAX_NUM_RANGES = 64;
+
+using Histogram = std::array<uint32_t, RADIX_SIZE>;
+
+template <class F> static void forEachRange(size_t numRanges, const F& function) {
+    if (numRanges == 1) {
+        function((size_t)0);
+    } else {
+        tbb::parallel_for((size_t)0, numRanges, function);
+    }
+}
+
+void render::radixSort(RadixSortEntries& entries, RadixSortEntries& scratch) {
+    const size_t numEntries = entries.size();
+    if (numEntries < 2) {
+        return;
+    }
+    scratch.resize(numEntries);
+
+    const size_t numRanges = std::max((size_t)1, std::min(MAX_NUM_RANGES, numEntries / MIN_ENTRIES_PER_RANGE));
+    const size_t rangeSize = (numEntries + numRanges - 1) / numRanges;
+    std::vector<Histogram> histograms(numRanges);
+
+    const RadixSortEntry* source = entries.data();
+    RadixSortEntry* destination = scratch.data();
+    bool sortedInScratch = false;
+
+    for (int pass = 0; pass < NUM_PASSES; ++pass) {
+        const int shift = pass * RADIX_BITS;
+
+        forEachRange(numRanges, [&](size_t range) {
+            Histogram& histogram = histograms[range];
+            histogram.fill(0);
+            const size_t end = std::min(numEntries, (range + 1) * rangeSize);
+            for (size_t i = range * rangeSize; i < end; ++i) {
+                ++histogram[(source[i].key >> shift) & RADIX_MASK];
+            }
+        });
+
+        // Turn the counts into where each range writes its entries of each digit: after the smaller digits,
+        // and after the previous ranges for the same digit.  Skip the pass if all the keys have the same digit.
+        bool sameDigit = false;
+        uint32_t offset = 0;
+        for (uint32_t digit = 0; digit < RADIX_SIZE && !sameDigit; ++digit) {
+            uint32_t digitStart = offset;
+            for (auto& histogram : histograms) {
+                uint32_t count = histogram[digit];
+                histogram[digit] = offset;
+                offset += count;
+            }
+            sameDigit = (offset - digitStart == numEntries);
+        }
+        if (sameDigit) {
+            continue;
+        }
+
+        forEachRange(numRanges, [&](size_t range) {
+            Histogram& offsets = histograms[range];
+            const size_t end = std::min(numEntries, (range + 1) * rangeSize);
+            for (size_t i = range * rangeSize; i < end; ++i) {
+                const RadixSortEntry& entry = source[i];
+                destination[offsets[(entry.key >> shift) & RADIX_MASK]++] = entry;
+            }
+        });
+
+        sortedInScratch = !sortedInScratch;
+        source = destination;
+        destination = sortedInScratch ? entries.data() : scratch.data();
+    }
+
+    if (sortedInScratch) {
+        entries.swap(scratch);
+    }
+}
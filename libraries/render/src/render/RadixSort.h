@@ -0,0 +1,42 @@
+//
+//  RadixSort.h
+//  render/src/render
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_RadixSort_h
+#define hifi_render_RadixSort_h
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace render {
+
+    // A sort key and what it sorts, typically the index of an item in another array
+    struct RadixSortEntry {
+        uint32_t key;
+        uint32_t value;
+    };
+    using RadixSortEntries = std::vector<RadixSortEntry>;
+
+    // Maps a float to a key that radixSort() orders like the float
+    inline uint32_t floatToRadixSortKey(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        // flip the negatives entirely so that they sort in reverse, and the sign bit of the positives to put them after
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    // Sorts the entries in increasing order of their keys, keeping the order of the entries with equal keys.
+    // Large arrays are split in fixed ranges that are counted and scattered on the worker threads, so the result doesn't
+    // depend on the scheduling.  scratch is the buffer the passes alternate with, it can be kept to save its allocation.
+    void radixSort(RadixSortEntries& entries, RadixSortEntries& scratch);
+
+}
+
+#endif // hifi_render_RadixSort_h
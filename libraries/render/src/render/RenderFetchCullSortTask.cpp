@@ -20,6 +20,10 @@ using namespace render;
 void RenderFetchCullSortTask::build(JobModel& task, const Varying& input, Varying& output, CullFunctor cullFunctor, uint8_t tagBits, uint8_t tagMask) {
     cullFunctor = cullFunctor ? cullFunctor : [](const RenderArgs*, const AABox&){ return true; };
 
+    // The fetch, cull, filter and sort jobs only read the args and the scene:
+    // the spatial and overlay branches and the depth sorts of every bucket can run concurrently
+    task.setParallel(true);
+
     // CPU jobs:
     // Fetch and cull the items from the scene
     const ItemFilter filter = ItemFilter::Builder::visibleWorldItems().withoutLayered().withTagBits(tagBits, tagMask);
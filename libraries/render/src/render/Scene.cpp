@@ -12,6 +12,9 @@
 
 #include <numeric>
 #include <gpu/Batch.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <TBBHelpers.h>
 #include "Logging.h"
 #include "TransitionStage.h"
 #include "HighlightStage.h"
@@ -179,6 +182,8 @@ Scene::Scene(glm::vec3 origin, float size) :
     _masterSpatialTree(origin, size)
 {
     _items.push_back(Item()); // add the itemID #0 to nothing
+    _itemKeys.resize(_items.size());
+    _itemBounds.resize(_items.size());
 }
 
 Scene::~Scene() {
@@ -224,22 +229,65 @@ uint32_t Scene::enqueueFrame() {
 }
 
  
+const uint64_t Scene::DEFAULT_TRANSACTION_BUDGET = 4 * USECS_PER_MSEC;
+const size_t Scene::MAX_RESETS_PER_STEP = 1000;
+
 void Scene::processTransactionQueue() {
+    processTransactions(_transactionBudget);
+}
+
+void Scene::flushTransactionQueue() {
+    processTransactions(0);
+}
+
+bool Scene::hasPendingTransactions() const {
+    std::unique_lock<std::mutex> lock(_transactionFramesMutex);
+    return !_transactionFrames.empty() || !_processedFrames.empty();
+}
+
+void Scene::processTransactions(uint64_t budget) {
     PROFILE_RANGE(render, __FUNCTION__);
+    uint64_t start = usecTimestampNow();
 
-    static TransactionFrames queuedFrames;
     {
-        // capture the queued frames and clear the queue
+        // capture the queued frames after the ones left by the previous call, and clear the queue
         std::unique_lock<std::mutex> lock(_transactionFramesMutex);
-        queuedFrames.swap(_transactionFrames);
+        if (_processedFrames.empty()) {
+            _processedFrames.swap(_transactionFrames);
+        } else {
+            _processedFrames.insert(_processedFrames.end(),
+                std::make_move_iterator(_transactionFrames.begin()), std::make_move_iterator(_transactionFrames.end()));
+            _transactionFrames.clear();
+        }
     }
 
-    // go through the queue of frames and process them
-    for (auto& frame : queuedFrames) {
-        processTransactionFrame(frame);
+    // go through the queue of frames and process them, by steps so that a large frame is spread over several calls
+    size_t numProcessedFrames = 0;
+    while (numProcessedFrames < _processedFrames.size()) {
+        auto& frame = _processedFrames[numProcessedFrames];
+        if (frame._resetItems.size() - _numAppliedResets > MAX_RESETS_PER_STEP) {
+            // only apply the next resets, the updates and removes of the frame come after all of them
+            Transaction step;
+            auto stepBegin = frame._resetItems.begin() + _numAppliedResets;
+            step._resetItems.assign(stepBegin, stepBegin + MAX_RESETS_PER_STEP);
+            processTransactionFrame(step);
+            _numAppliedResets += MAX_RESETS_PER_STEP;
+        } else {
+            if (_numAppliedResets > 0) {
+                frame._resetItems.erase(frame._resetItems.begin(), frame._resetItems.begin() + _numAppliedResets);
+                _numAppliedResets = 0;
+            }
+            processTransactionFrame(frame);
+            ++numProcessedFrames;
+        }
+
+        if (budget > 0 && usecTimestampNow() - start > budget) {
+            break;
+        }
     }
 
-    queuedFrames.clear();
+    std::unique_lock<std::mutex> lock(_transactionFramesMutex);
+    _processedFrames.erase(_processedFrames.begin(), _processedFrames.begin() + numProcessedFrames);
 }
 
 void Scene::processTransactionFrame(const Transaction& transaction) {
@@ -251,6 +299,8 @@ void Scene::processTransactionFrame(const Transaction& transaction) {
         ItemID maxID = _IDAllocator.load();
         if (maxID > _items.size()) {
             _items.resize(maxID + 100); // allocate the maxId and more
+            _itemKeys.resize(_items.size());
+            _itemBounds.resize(_items.size());
         }
         // Now we know for sure that we have enough items in the array to
         // capture anything coming from the transaction
@@ -288,13 +338,32 @@ void Scene::processTransactionFrame(const Transaction& transaction) {
     queryHighlights(transaction._highlightQueries);
 }
 
+// Below this many resets or updates, the bounds of their payloads are evaluated on the calling thread
+static const size_t TRANSACTION_BOUNDS_GRAIN_SIZE = 256;
+
+template <class F> static void evalTransactionBounds(size_t numBounds, std::vector<Item::Bound>& bounds, const F& evalBound) {
+    bounds.resize(numBounds);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numBounds, TRANSACTION_BOUNDS_GRAIN_SIZE), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            bounds[i] = evalBound(i);
+        }
+    });
+}
+
 void Scene::resetItems(const Transaction::Resets& transactions) {
-    for (auto& reset : transactions) {
+    // The bounds of the new payloads are evaluated on the worker threads, the payloads aren't in the scene yet
+    evalTransactionBounds(transactions.size(), _transactionBounds, [&](size_t i) {
+        return std::get<1>(transactions[i])->getBound();
+    });
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
         // Access the true item
+        auto& reset = transactions[i];
         auto itemId = std::get<0>(reset);
         auto& item = _items[itemId];
         auto oldKey = item.getKey();
         auto oldCell = item.getCell();
+        const auto& bound = _transactionBounds[i];
 
         // Reset the item with a new payload
         item.resetPayload(std::get<1>(reset));
@@ -303,12 +372,26 @@ void Scene::resetItems(const Transaction::Resets& transactions) {
         // Update the item's container
         assert((oldKey.isSpatial() == newKey.isSpatial()) || oldKey._flags.none());
         if (newKey.isSpatial()) {
-            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), itemId, newKey);
-            item.resetCell(newCell, newKey.isSmall());
+            if (oldCell == Item::INVALID_CELL) {
+                // New items are inserted in the spatial tree together, a cell at a time
+                auto newCell = _masterSpatialTree.indexItemCell(bound, newKey);
+                if (newCell != Item::INVALID_CELL) {
+                    _spatialInserts.push_back({ newCell, newKey, itemId });
+                }
+                item.resetCell(newCell, newKey.isSmall());
+            } else {
+                // the item may be one of the inserts if reset twice, so insert them first
+                _masterSpatialTree.insertItems(_spatialInserts);
+                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, bound, itemId, newKey);
+                item.resetCell(newCell, newKey.isSmall());
+            }
         } else {
             _masterNonspatialSet.insert(itemId);
         }
+        _itemKeys[itemId] = item.getKey();
+        _itemBounds[itemId] = bound;
     }
+    _masterSpatialTree.insertItems(_spatialInserts);
 }
 
 void Scene::removeItems(const Transaction::Removes& transactions) {
@@ -330,10 +413,12 @@ void Scene::removeItems(const Transaction::Removes& transactions) {
 
         // Kill it
         item.kill();
+        cacheItemKeyAndBound(removedID);
     }
 }
 
 void Scene::updateItems(const Transaction::Updates& transactions) {
+    // The update functors can touch more than their payload, run them in order
     for (auto& update : transactions) {
         auto updateID = std::get<0>(update);
         if (updateID == Item::INVALID_ITEM_ID) {
@@ -348,25 +433,45 @@ void Scene::updateItems(const Transaction::Updates& transactions) {
             continue;
         }
 
-        // Good to go, deal with the update
-        auto oldCell = item.getCell();
-        auto oldKey = item.getKey();
-
         // Update the item
         item.update(std::get<1>(update));
+    }
+
+    // Then evaluate the updated bounds on the worker threads
+    evalTransactionBounds(transactions.size(), _transactionBounds, [&](size_t i) {
+        auto updateID = std::get<0>(transactions[i]);
+        auto& item = _items[updateID];
+        return ((updateID != Item::INVALID_ITEM_ID && item.exist()) ? item.getBound() : Item::Bound());
+    });
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        auto updateID = std::get<0>(transactions[i]);
+        if (updateID == Item::INVALID_ITEM_ID) {
+            continue;
+        }
+        auto& item = _items[updateID];
+        if (!item.exist()) {
+            continue;
+        }
+
+        // Good to go, deal with the update
+        // the cached key is the one the item was stored with before the update
+        auto oldCell = item.getCell();
+        auto oldKey = _itemKeys[updateID];
         auto newKey = item.getKey();
+        const auto& bound = _transactionBounds[i];
 
         // Update the item's container
         if (oldKey.isSpatial() == newKey.isSpatial()) {
             if (newKey.isSpatial()) {
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
+                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, bound, updateID, newKey);
                 item.resetCell(newCell, newKey.isSmall());
             }
         } else {
             if (newKey.isSpatial()) {
                 _masterNonspatialSet.erase(updateID);
 
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
+                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, bound, updateID, newKey);
                 item.resetCell(newCell, newKey.isSmall());
             } else {
                 _masterSpatialTree.removeItem(oldCell, oldKey, updateID);
@@ -375,9 +480,17 @@ void Scene::updateItems(const Transaction::Updates& transactions) {
                 _masterNonspatialSet.insert(updateID);
             }
         }
+        _itemKeys[updateID] = item.getKey();
+        _itemBounds[updateID] = bound;
     }
 }
 
+void Scene::cacheItemKeyAndBound(ItemID id) {
+    const auto& item = _items[id];
+    _itemKeys[id] = item.getKey();
+    _itemBounds[id] = (item.exist() ? item.getBound() : Item::Bound());
+}
+
 void Scene::transitionItems(const Transaction::TransitionAdds& transactions) {
     auto transitionStage = getStage<TransitionStage>(TransitionStage::getName());
 
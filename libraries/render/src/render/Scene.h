@@ -123,6 +123,11 @@ typedef std::vector<Transaction> TransactionQueue;
 class Scene {
 public:
 
+    // usecs processTransactionQueue() spends on the transactions of a frame before leaving the rest for the next
+    static const uint64_t DEFAULT_TRANSACTION_BUDGET;
+    // A large frame of transactions gets its resets applied by steps of this many, checking the budget in between
+    static const size_t MAX_RESETS_PER_STEP;
+
     Scene(glm::vec3 origin, float size);
     ~Scene();
 
@@ -144,9 +149,20 @@ public:
     // Enqueue end of frame transactions boundary
     uint32_t enqueueFrame();
 
-    // Process the pending transactions queued
+    // Process the pending transactions queued, until the time spent exceeds the transaction budget:
+    // the frames left, and the rest of the resets of a large frame, are processed by the next calls
     void processTransactionQueue();
 
+    // Process all the pending transactions queued, regardless of the budget
+    void flushTransactionQueue();
+
+    // The time processTransactionQueue() can spend before leaving the rest for the next call, 0 for no limit
+    void setTransactionBudget(uint64_t usecs) { _transactionBudget = usecs; }
+    uint64_t getTransactionBudget() const { return _transactionBudget; }
+
+    // Are there transaction frames enqueued but not processed yet, or partly processed
+    bool hasPendingTransactions() const;
+
     // Access a particular selection (empty if doesn't exist)
     // Thread safe
     Selection getSelection(const Selection::Name& name) const;
@@ -164,6 +180,12 @@ public:
     // Same as getItem, checking if the id is valid
     const Item getItemSafe(const ItemID& id) const { if (isAllocatedID(id)) { return _items[id]; } else { return Item(); } }
 
+    // The key and bound of an item, cached in arrays indexed by ItemID when the item is reset or updated so that culling
+    // and filtering read them without going through the payload
+    // WARNING, There is No check on the validity of the ID
+    const ItemKey& getItemKey(const ItemID& id) const { return _itemKeys[id]; }
+    const Item::Bound& getItemBound(const ItemID& id) const { return _itemBounds[id]; }
+
     // Access the spatialized items
     const ItemSpatialTree& getSpatialTree() const { return _masterSpatialTree; }
 
@@ -194,11 +216,18 @@ protected:
     TransactionQueue _transactionQueue;
 
     
-    std::mutex _transactionFramesMutex;
+    mutable std::mutex _transactionFramesMutex; // mutable so it can be used in the thread safe hasPendingTransactions const method
     using TransactionFrames = std::vector<Transaction>;
     TransactionFrames _transactionFrames;
     uint32_t _transactionFrameNumber{ 0 };
 
+    // The frames being processed, and the number of resets already applied from the first one
+    TransactionFrames _processedFrames;
+    size_t _numAppliedResets { 0 };
+    uint64_t _transactionBudget { DEFAULT_TRANSACTION_BUDGET };
+
+    void processTransactions(uint64_t budget);
+
     // Process one transaction frame 
     void processTransactionFrame(const Transaction& transaction);
 
@@ -206,6 +235,11 @@ protected:
     // database of items is protected for editing by a mutex
     std::mutex _itemsMutex;
     Item::Vector _items;
+    std::vector<ItemKey> _itemKeys;
+    std::vector<Item::Bound> _itemBounds;
+    // the bounds of the payloads reset or updated by a transaction, evaluated on the worker threads
+    std::vector<Item::Bound> _transactionBounds;
+    ItemSpatialTree::ItemInserts _spatialInserts;
     ItemSpatialTree _masterSpatialTree;
     ItemIDSet _masterNonspatialSet;
 
@@ -220,6 +254,7 @@ protected:
     void queryHighlights(const Transaction::HighlightQueries& transactions);
 
     void collectSubItems(ItemID parentId, ItemIDs& subItems) const;
+    void cacheItemKeyAndBound(ItemID id);
 
     // The Selection map
     mutable std::mutex _selectionsMutex; // mutable so it can be used in the thread safe getSelection const method
@@ -303,6 +303,9 @@ public:
 
     void prepareShapeItem(Args* args, const ShapeKey& key, const Item& shape);
 
+    // Without per item setup, the items drawn with the pipeline can be merged into instanced draws
+    bool canDrawInstanced() const { return !_itemSetter; }
+
 protected:
     friend class ShapePlumber;
 
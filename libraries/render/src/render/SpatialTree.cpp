@@ -10,6 +10,8 @@
 //
 #include "SpatialTree.h"
 
+#include <algorithm>
+
 #include <ViewFrustum.h>
 
 using namespace render;
@@ -379,7 +381,7 @@ bool ItemSpatialTree::removeItem(Index cellIdx, const ItemKey& key, const ItemID
     return success;
 }
 
-ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey) {
+ItemSpatialTree::Index ItemSpatialTree::indexItemCell(const AABox& bound, ItemKey& newKey) {
     auto newCell = INVALID_CELL;
     if (!newKey.isViewSpace()) {
         Coord3f minCoordf, maxCoordf;
@@ -400,6 +402,35 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
     } else {
         // A very rare case, if we were adding items with boundary semantic expressed in view space
     }
+    return newCell;
+}
+
+void ItemSpatialTree::insertItems(ItemInserts& inserts) {
+    // group the items by cell, keeping their order within a cell
+    std::stable_sort(inserts.begin(), inserts.end(), [](const ItemInsert& a, const ItemInsert& b) {
+        return a.cell < b.cell;
+    });
+
+    auto begin = inserts.begin();
+    while (begin != inserts.end()) {
+        auto end = begin;
+        while (end != inserts.end() && end->cell == begin->cell) {
+            ++end;
+        }
+        accessCellBrick(begin->cell, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
+            for (auto insert = begin; insert != end; ++insert) {
+                auto& itemIn = (insert->key.isSmall() ? brick.subcellItems : brick.items);
+                itemIn.push_back(insert->item);
+            }
+            cell.setBrickFilled();
+        }, true);
+        begin = end;
+    }
+    inserts.clear();
+}
+
+ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey) {
+    auto newCell = indexItemCell(bound, newKey);
 
     // Did we fail finding a cell for the item?
     if (newCell == INVALID_CELL) {
@@ -446,6 +446,21 @@ namespace render {
 
         Index resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey);
 
+        // Index the cell for an item bound and tag the item key as small if the bound fits in a subcell, as resetItem does,
+        // without inserting the item: new items can be inserted together with insertItems()
+        Index indexItemCell(const AABox& bound, ItemKey& newKey);
+
+        class ItemInsert {
+        public:
+            Index cell;
+            ItemKey key;
+            ItemID item;
+        };
+        using ItemInserts = std::vector<ItemInsert>;
+
+        // Insert items in their cell, accessing the brick of each cell once for all its items, and clear the inserts
+        void insertItems(ItemInserts& inserts);
+
         // Selection and traverse
         int selectCells(CellSelection& selection, const ViewFrustum& frustum, float threshold) const;
 
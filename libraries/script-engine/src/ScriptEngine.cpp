@@ -1145,11 +1145,14 @@ void ScriptEngine::run() {
                 auto preUpdate = clock::now();
                 {
                     PROFILE_RANGE(script, "ScriptUpdate");
+                    ++_executionDepth;
                     emit update(deltaTime);
+                    --_executionDepth;
                 }
                 auto postUpdate = clock::now();
-                auto elapsed = (postUpdate - preUpdate);
-                totalUpdates += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(postUpdate - preUpdate);
+                totalUpdates += elapsed;
+                _totalExecutionTime += elapsed.count();
             }
         }
         _lastUpdate = now;
@@ -2456,6 +2459,8 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     QUrl oldSandboxURL = currentSandboxURL;
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
+    bool isOutermostCall = (_executionDepth++ == 0);
+    uint64_t startTime = isOutermostCall ? usecTimestampNow() : 0;
 
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
@@ -2466,6 +2471,10 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     operation();
 #endif
     maybeEmitUncaughtException(!entityID.isNull() ? entityID.toString() : __FUNCTION__);
+    if (isOutermostCall) {
+        _totalExecutionTime += usecTimestampNow() - startTime;
+    }
+    --_executionDepth;
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_ScriptEngine_h
 #define hifi_ScriptEngine_h
 
+#include <atomic>
 #include <vector>
 
 #include <QtCore/QObject>
@@ -238,6 +239,9 @@ public:
     int getNumRunningEntityScripts() const;
     bool getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails &details) const;
 
+    /// \return total time spent running script code (updates, timers and entity script calls) on this engine (usec)
+    uint64_t getTotalExecutionTime() const { return _totalExecutionTime; }
+
 public slots:
     void callAnimationStateHandler(QScriptValue callback, AnimVariantMap parameters, QStringList names, bool useNames, AnimVariantResultHandler resultHandler);
     void updateMemoryCost(const qint64&);
@@ -328,6 +332,8 @@ protected:
     std::recursive_mutex _lock;
 
     std::chrono::microseconds _totalTimerExecution { 0 };
+    std::atomic<uint64_t> _totalExecutionTime { 0 };
+    int _executionDepth { 0 }; // so nested calls are only counted once
 
     static const QString _SETTINGS_ENABLE_EXTENDED_MODULE_COMPAT;
     static const QString _SETTINGS_ENABLE_EXTENDED_EXCEPTIONS;
@@ -80,6 +80,7 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // ----------------------------------------------------------------------------
 
 std::atomic<bool> PerformanceTimer::_isActive(false);
+std::mutex PerformanceTimer::_mutex;
 QHash<QThread*, QString> PerformanceTimer::_fullNames;
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
@@ -87,6 +88,7 @@ QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
         _name = name;
+        std::lock_guard<std::mutex> lock(_mutex);
         QString& fullName = _fullNames[QThread::currentThread()];
         fullName.append("/");
         fullName.append(_name);
@@ -97,6 +99,7 @@ PerformanceTimer::PerformanceTimer(const QString& name) {
 PerformanceTimer::~PerformanceTimer() {
     if (_isActive && _start != 0) {
         quint64 elapsedUsec = (usecTimestampNow() - _start);
+        std::lock_guard<std::mutex> lock(_mutex);
         QString& fullName = _fullNames[QThread::currentThread()];
         PerformanceTimerRecord& namedRecord = _records[fullName];
         namedRecord.accumulateResult(elapsedUsec);
@@ -104,6 +107,23 @@ PerformanceTimer::~PerformanceTimer() {
     }
 }
 
+PerformanceTimer::ContextScope::ContextScope(const QString& contextName) {
+    if (_isActive) {
+        _isEntered = true;
+        std::lock_guard<std::mutex> lock(_mutex);
+        QString& fullName = _fullNames[QThread::currentThread()];
+        _previousName = fullName;
+        fullName = contextName;
+    }
+}
+
+PerformanceTimer::ContextScope::~ContextScope() {
+    if (_isActive && _isEntered) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fullNames[QThread::currentThread()] = _previousName;
+    }
+}
+
 // static
 bool PerformanceTimer::isActive() {
     return _isActive;
@@ -111,11 +131,13 @@ bool PerformanceTimer::isActive() {
 
 // static
 QString PerformanceTimer::getContextName() {
+    std::lock_guard<std::mutex> lock(_mutex);
     return _fullNames[QThread::currentThread()];
 }
 
 // static
 void PerformanceTimer::addTimerRecord(const QString& fullName, quint64 elapsedUsec) {
+    std::lock_guard<std::mutex> lock(_mutex);
     PerformanceTimerRecord& namedRecord = _records[fullName];
     namedRecord.accumulateResult(elapsedUsec);
 }
@@ -125,6 +147,7 @@ void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
         if (!active) {
+            std::lock_guard<std::mutex> lock(_mutex);
             _fullNames.clear();
             _records.clear();
         }
@@ -135,6 +158,7 @@ void PerformanceTimer::setActive(bool active) {
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
+    std::lock_guard<std::mutex> lock(_mutex);
     QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
     QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
     quint64 now = usecTimestampNow();
@@ -150,6 +174,7 @@ void PerformanceTimer::tallyAllTimerRecords() {
 }
 
 void PerformanceTimer::dumpAllTimerRecords() {
+    std::lock_guard<std::mutex> lock(_mutex);
     QMapIterator<QString, PerformanceTimerRecord> i(_records);
     while (i.hasNext()) {
         i.next();
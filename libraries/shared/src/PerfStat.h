@@ -23,6 +23,7 @@
 #include <cstring>
 #include <string>
 #include <map>
+#include <mutex>
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
@@ -76,6 +77,18 @@ private:
 class PerformanceTimer {
 public:
 
+    // Nests the timers of the current thread under the given context name while in scope,
+    // for work handed over to other threads by a timed scope
+    class ContextScope {
+    public:
+        ContextScope(const QString& contextName);
+        ~ContextScope();
+
+    private:
+        QString _previousName;
+        bool _isEntered { false };
+    };
+
     PerformanceTimer(const QString& name);
     ~PerformanceTimer();
 
@@ -93,6 +106,8 @@ private:
     quint64 _start = 0;
     QString _name;
     static std::atomic<bool> _isActive;
+    // guards the names and records, the timers can run on any thread
+    static std::mutex _mutex;
     static QHash<QThread*, QString> _fullNames;
     static QMap<QString, PerformanceTimerRecord> _records;
 };
@@ -12,8 +12,8 @@
 #include "FileCache.h"
 
 
+#include <algorithm>
 #include <unordered_set>
-#include <queue>
 #include <cassert>
 
 #include <QtCore/QDateTime>
@@ -23,6 +23,8 @@
 
 #include "../PathUtils.h"
 #include "../NumericalConstants.h"
+#include "../SharedUtil.h"
+#include "../ThreadHelpers.h"
 
 #ifdef Q_OS_WIN
 #include <sys/utime.h>
@@ -83,11 +85,11 @@ FileCache::FileCache(const std::string& dirname, const std::string& ext, QObject
 }
 
 FileCache::~FileCache() {
+    stopEvictionThread();
     clear();
 }
 
 void FileCache::initialize() {
-    Lock lock(_mutex);
     if (_initialized) {
         qCWarning(file_cache) << "File cache already initialized";
         return;
@@ -106,7 +108,9 @@ void FileCache::initialize() {
             const Key key = filename.section('.', 0, 0).toStdString();
             const std::string filepath = dir.filePath(filename).toStdString();
             const size_t length = QFileInfo(filepath.c_str()).size();
-            addFile(Metadata(key, length), filepath);
+            Shard& shard = getShard(key);
+            Lock lock = lockShard(shard);
+            addFile(shard, Metadata(key, length), filepath);
         }
 
         qCDebug(file_cache, "[%s] Initialized %s", _dirname.c_str(), _dirpath.c_str());
@@ -115,14 +119,25 @@ void FileCache::initialize() {
         qCDebug(file_cache, "[%s] Created %s", _dirname.c_str(), _dirpath.c_str());
     }
 
+    startEvictionThread();
     _initialized = true;
 }
 
+FileCache::Lock FileCache::lockShard(Shard& shard) {
+    Lock lock(shard.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        quint64 start = usecTimestampNow();
+        lock.lock();
+        _lockWaitTime += usecTimestampNow() - start;
+    }
+    return lock;
+}
+
 std::unique_ptr<File> FileCache::createFile(Metadata&& metadata, const std::string& filepath) {
     return std::unique_ptr<File>(new cache::File(std::move(metadata), filepath));
 }
 
-FilePointer FileCache::addFile(Metadata&& metadata, const std::string& filepath) {
+FilePointer FileCache::addFile(Shard& shard, Metadata&& metadata, const std::string& filepath) {
     File* rawFile = createFile(std::move(metadata), filepath).release();
     FilePointer file(rawFile, std::bind(&File::deleter, rawFile));
     if (file) {
@@ -132,7 +147,7 @@ FilePointer FileCache::addFile(Metadata&& metadata, const std::string& filepath)
         file->_locked = true;
         emit dirty();
 
-        _files[file->getKey()] = file;
+        shard.files[file->getKey()] = file;
     }
     return file;
 }
@@ -145,9 +160,6 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         return file;
     }
 
-
-    Lock lock(_mutex);
-
     if (!_initialized) {
         qCWarning(file_cache) << "File cache used before initialization";
         return file;
@@ -155,15 +167,23 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
 
     std::string filepath = getFilepath(metadata.key);
 
+    // Declared ahead of the lock so that it is released after the shard is unlocked
+    FilePointer replaced;
+    Shard& shard = getShard(metadata.key);
+    Lock lock = lockShard(shard);
+
     // if file already exists, return it
-    file = getFile(metadata.key);
+    file = findFile(shard, metadata.key);
     if (file) {
         if (!overwrite) {
             qCWarning(file_cache, "[%s] Attempted to overwrite %s", _dirname.c_str(), metadata.key.c_str());
             return file;
         } else {
             qCWarning(file_cache, "[%s] Overwriting %s", _dirname.c_str(), metadata.key.c_str());
-            file.reset();
+            // the new file takes over the path, so the old one must not unlink it
+            eject(shard, file);
+            file->_shouldPersist = true;
+            replaced = std::move(file);
         }
     }
 
@@ -172,7 +192,7 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         && saveFile.write(data, metadata.length) == static_cast<qint64>(metadata.length)
         && saveFile.commit()) {
 
-        file = addFile(std::move(metadata), filepath);
+        file = addFile(shard, std::move(metadata), filepath);
     } else {
         qCWarning(file_cache, "[%s] Failed to write %s", _dirname.c_str(), metadata.key.c_str());
     }
@@ -182,22 +202,37 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
 
 
 FilePointer FileCache::getFile(const Key& key) {
-    Lock lock(_mutex);
-
     FilePointer file;
     if (!_initialized) {
         qCWarning(file_cache) << "File cache used before initialization";
         return file;
     }
 
+    Shard& shard = getShard(key);
+    Lock lock = lockShard(shard);
+
+    file = findFile(shard, key);
+    if (file) {
+        _numHits += 1;
+        qCDebug(file_cache, "[%s] Found %s", _dirname.c_str(), key.c_str());
+        emit dirty();
+    } else {
+        _numMisses += 1;
+    }
+    return file;
+}
+
+FilePointer FileCache::findFile(Shard& shard, const Key& key) {
+    FilePointer file;
+
     // check if file exists
-    const auto it = _files.find(key);
-    if (it != _files.cend()) {
+    const auto it = shard.files.find(key);
+    if (it != shard.files.cend()) {
         file = it->second.lock();
         if (file) {
             file->touch();
             // if it exists, it is active - remove it from the cache
-            if (_unusedFiles.erase(file)) {
+            if (shard.unusedFiles.erase(file)) {
                 assert(!file->_locked);
                 file->_locked = true;
                 _numUnusedFiles -= 1;
@@ -205,11 +240,9 @@ FilePointer FileCache::getFile(const Key& key) {
             } else {
                 assert(file->_locked);
             }
-            qCDebug(file_cache, "[%s] Found %s", _dirname.c_str(), key.c_str());
-            emit dirty();
         } else {
             // if not, remove the weak_ptr
-            _files.erase(it);
+            shard.files.erase(it);
         }
     }
 
@@ -221,16 +254,13 @@ std::string FileCache::getFilepath(const Key& key) {
     return _dirpath + DIR_SEP + key + EXT_SEP + _ext;
 }
 
-// This is a non-public function that uses the mutex because it's 
-// essentially a public function specifically to a File object
-void FileCache::addUnusedFile(const FilePointer& file) {
+void FileCache::addUnusedFile(Shard& shard, const FilePointer& file) {
     assert(file->_locked);
     file->_locked = false;
-    _files[file->getKey()] = file;
-    _unusedFiles.insert(file);
+    shard.files[file->getKey()] = file;
+    shard.unusedFiles.insert(file);
     _numUnusedFiles += 1;
     _unusedFilesSize += file->getLength();
-    clean();
 
     emit dirty();
 }
@@ -250,31 +280,26 @@ size_t FileCache::getOverbudgetAmount() const {
     return result;
 }
 
-namespace cache {
-    struct FilePointerComparator {
-        bool operator()(const FilePointer& a, const FilePointer& b) {
-            return a->_modified > b->_modified;
-        }
-    };
-}
-
-// Take file pointer by value to insure it doesn't get destructed during the "erase()" calls
-void FileCache::eject(FilePointer file) {
+void FileCache::eject(Shard& shard, const FilePointer& file) {
     file->_locked = false;
     const auto& length = file->getLength();
     const auto& key = file->getKey();
 
-    if (0 != _files.erase(key)) {
+    if (0 != shard.files.erase(key)) {
         _numTotalFiles -= 1;
         _totalFilesSize -= length;
     }
-    if (0 != _unusedFiles.erase(file)) {
+    if (0 != shard.unusedFiles.erase(file)) {
         _numUnusedFiles -= 1;
         _unusedFilesSize -= length;
     }
 }
 
 void FileCache::clean() {
+    // The ejected files are unlinked as the candidates are released, after every shard is unlocked
+    std::vector<std::pair<int64_t, FilePointer>> candidates;
+    std::lock_guard<Mutex> cleanLock(_cleanMutex);
+
     size_t overbudgetAmount = getOverbudgetAmount();
 
     // Avoid sorting the unused files by LRU if we're not over budget / under free space
@@ -282,52 +307,147 @@ void FileCache::clean() {
         return;
     }
 
-    using Queue = std::priority_queue<FilePointer, std::vector<FilePointer>, FilePointerComparator>;
-    Queue queue;
-    for (const auto& file : _unusedFiles) {
-        queue.push(file);
+    for (auto& shard : _shards) {
+        Lock lock = lockShard(shard);
+        for (const auto& file : shard.unusedFiles) {
+            candidates.emplace_back(file->_modified, file);
+        }
     }
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<int64_t, FilePointer>& a, const std::pair<int64_t, FilePointer>& b) {
+        return a.first < b.first;
+    });
+
+    for (const auto& candidate : candidates) {
+        if (0 == overbudgetAmount) {
+            break;
+        }
 
-    while (!queue.empty() && overbudgetAmount > 0) {
-        auto file = queue.top();
-        queue.pop();
-        eject(file);
+        const auto& file = candidate.second;
+        Shard& shard = getShard(file->getKey());
+        Lock lock = lockShard(shard);
+        // skip the files that were picked up again since we looked
+        if (0 == shard.unusedFiles.count(file)) {
+            continue;
+        }
+        eject(shard, file);
+        _numEvicted += 1;
         auto length = file->getLength();
         overbudgetAmount -= std::min(length, overbudgetAmount);
     }
+    emit dirty();
 }
 
 void FileCache::wipe() {
-    Lock lock(_mutex);
-    while (!_unusedFiles.empty()) {
-        eject(*_unusedFiles.begin());
+    std::vector<FilePointer> ejected;
+    for (auto& shard : _shards) {
+        Lock lock = lockShard(shard);
+        while (!shard.unusedFiles.empty()) {
+            FilePointer file = *shard.unusedFiles.begin();
+            eject(shard, file);
+            ejected.push_back(file);
+        }
     }
 }
 
 void FileCache::clear() {
-    Lock lock(_mutex);
-
     // Eliminate any overbudget files
     clean();
 
+    qCDebug(file_cache, "[%s] %lu hits, %lu misses, %lu evicted, %llu usec waiting on locks", _dirname.c_str(),
+        (unsigned long)_numHits, (unsigned long)_numMisses, (unsigned long)_numEvicted, (unsigned long long)_lockWaitTime);
+
     // Mark everything remaining as persisted while effectively ejecting from the cache
-    for (auto& file : _unusedFiles) {
-        file->_shouldPersist = true;
-        file->_parent.reset();
-        qCDebug(file_cache, "[%s] Persisting %s", _dirname.c_str(), file->getKey().c_str());
+    for (auto& shard : _shards) {
+        Set unusedFiles;
+        {
+            Lock lock = lockShard(shard);
+            unusedFiles.swap(shard.unusedFiles);
+        }
+        for (auto& file : unusedFiles) {
+            file->_shouldPersist = true;
+            file->_parent.reset();
+            qCDebug(file_cache, "[%s] Persisting %s", _dirname.c_str(), file->getKey().c_str());
+        }
     }
-    _unusedFiles.clear();
 }
 
 void FileCache::releaseFile(File* file) {
-    Lock lock(_mutex);
-    if (file->_locked) {
-        addUnusedFile(FilePointer(file, std::bind(&File::deleter, file)));
+    bool unused = false;
+    {
+        Shard& shard = getShard(file->getKey());
+        Lock lock = lockShard(shard);
+        if (file->_locked) {
+            addUnusedFile(shard, FilePointer(file, std::bind(&File::deleter, file)));
+            unused = true;
+        }
+    }
+
+    if (unused) {
+        requestEviction();
     } else {
         delete file;
     }
 }
 
+void FileCache::startEvictionThread() {
+    auto eviction = _eviction;
+    FileCacheWeakPointer weakCache = shared_from_this();
+    std::string name = "Hifi_FileCache_" + _dirname;
+    _evictionThread = std::thread([eviction, weakCache, name] {
+        setThreadName(name);
+        std::unique_lock<std::mutex> lock(eviction->mutex);
+        while (true) {
+            eviction->condition.wait(lock, [&] { return eviction->requested || eviction->stopped; });
+            if (eviction->stopped) {
+                break;
+            }
+            eviction->requested = false;
+            eviction->running = true;
+            lock.unlock();
+
+            // if this turns out to be the last reference, the cache is destroyed here and stops the thread
+            if (auto cache = weakCache.lock()) {
+                cache->clean();
+            }
+
+            lock.lock();
+            eviction->running = false;
+            eviction->condition.notify_all();
+        }
+    });
+}
+
+void FileCache::stopEvictionThread() {
+    {
+        std::lock_guard<std::mutex> lock(_eviction->mutex);
+        _eviction->stopped = true;
+    }
+    _eviction->condition.notify_all();
+
+    if (_evictionThread.joinable()) {
+        if (_evictionThread.get_id() == std::this_thread::get_id()) {
+            _evictionThread.detach();
+        } else {
+            _evictionThread.join();
+        }
+    }
+}
+
+void FileCache::requestEviction() {
+    {
+        std::lock_guard<std::mutex> lock(_eviction->mutex);
+        _eviction->requested = true;
+    }
+    _eviction->condition.notify_all();
+}
+
+void FileCache::waitForEviction() {
+    std::unique_lock<std::mutex> lock(_eviction->mutex);
+    _eviction->condition.wait(lock, [&] {
+        return _eviction->stopped || (!_eviction->requested && !_eviction->running);
+    });
+}
+
 void File::deleter(File* file) {
     // If the cache shut down before the file was destroyed, then we should leave the file alone (prevents crash on shutdown)
     FileCachePointer cache = file->_parent.lock();
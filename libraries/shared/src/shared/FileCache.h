@@ -10,13 +10,16 @@
 #ifndef hifi_FileCache_h
 #define hifi_FileCache_h
 
+#include <array>
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <cstddef>
 #include <map>
 #include <unordered_set>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include <QObject>
@@ -40,10 +43,15 @@ class FileCache : public QObject, public std::enable_shared_from_this<FileCache>
     Q_PROPERTY(size_t numCached READ getNumCachedFiles NOTIFY dirty)
     Q_PROPERTY(size_t sizeTotal READ getSizeTotalFiles NOTIFY dirty)
     Q_PROPERTY(size_t sizeCached READ getSizeCachedFiles NOTIFY dirty)
+    Q_PROPERTY(size_t numHits READ getNumHits NOTIFY dirty)
+    Q_PROPERTY(size_t numMisses READ getNumMisses NOTIFY dirty)
+    Q_PROPERTY(size_t numEvicted READ getNumEvicted NOTIFY dirty)
+    Q_PROPERTY(quint64 lockWaitTime READ getLockWaitTime NOTIFY dirty)
 
     static const size_t DEFAULT_MAX_SIZE;
     static const size_t MAX_MAX_SIZE;
     static const size_t DEFAULT_MIN_FREE_STORAGE_SPACE;
+    static const size_t NUM_SHARDS { 16 };
 
     friend class ::FileCacheTests;
 
@@ -60,6 +68,11 @@ public:
     size_t getNumCachedFiles() const { return _numUnusedFiles; }
     size_t getSizeTotalFiles() const { return _totalFilesSize; }
     size_t getSizeCachedFiles() const { return _unusedFilesSize; }
+    size_t getNumHits() const { return _numHits; }
+    size_t getNumMisses() const { return _numMisses; }
+    size_t getNumEvicted() const { return _numEvicted; }
+    // Total time threads spent waiting on the cache locks (usec)
+    quint64 getLockWaitTime() const { return _lockWaitTime; }
 
     // Set the maximum amount of disk space to use on disk
     void setMaxSize(size_t maxCacheSize);
@@ -103,23 +116,53 @@ public:
     virtual std::unique_ptr<File> createFile(Metadata&& metadata, const std::string& filepath);
 
 private:
-    using Mutex = std::recursive_mutex;
+    using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using Map = std::unordered_map<Key, std::weak_ptr<File>>;
     using Set = std::unordered_set<FilePointer>;
     using KeySet = std::unordered_set<Key>;
 
+    // Files are spread over the shards by key hash, so threads working on different keys rarely contend.
+    // A shard lock must never be held while a FilePointer may be dropped: releasing a file locks its shard.
+    struct Shard {
+        Mutex mutex;
+        Map files;
+        Set unusedFiles;
+    };
+
+    // Shared with the eviction thread, which may outlive the cache by the time it takes to notice the stop
+    struct Eviction {
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool requested { false };
+        bool running { false };
+        bool stopped { false };
+    };
+
     friend class File;
 
     std::string getFilepath(const Key& key);
 
-    FilePointer addFile(Metadata&& metadata, const std::string& filepath);
-    void addUnusedFile(const FilePointer& file);
+    Shard& getShard(const Key& key) { return _shards[std::hash<Key>()(key) % NUM_SHARDS]; }
+    Lock lockShard(Shard& shard);
+
+    // These expect the shard to be locked
+    FilePointer addFile(Shard& shard, Metadata&& metadata, const std::string& filepath);
+    FilePointer findFile(Shard& shard, const Key& key);
+    void addUnusedFile(Shard& shard, const FilePointer& file);
+    // Remove a file from the cache
+    void eject(Shard& shard, const FilePointer& file);
+
     void releaseFile(File* file);
+    // Eject the least recently used files until the cache is back within budget
     void clean();
     void clear();
-    // Remove a file from the cache
-    void eject(FilePointer file);
+
+    void startEvictionThread();
+    void stopEvictionThread();
+    // Have the eviction thread clean the cache, so that unlinking files never blocks the callers
+    void requestEviction();
+    void waitForEviction();
 
     size_t getOverbudgetAmount() const;
 
@@ -131,15 +174,20 @@ private:
     std::atomic<size_t> _numUnusedFiles { 0 };
     std::atomic<size_t> _totalFilesSize { 0 };
     std::atomic<size_t> _unusedFilesSize { 0 };
+    std::atomic<size_t> _numHits { 0 };
+    std::atomic<size_t> _numMisses { 0 };
+    std::atomic<size_t> _numEvicted { 0 };
+    std::atomic<quint64> _lockWaitTime { 0 };
 
     const std::string _ext;
     const std::string _dirname;
     const std::string _dirpath;
-    bool _initialized { false };
+    std::atomic<bool> _initialized { false };
 
-    Mutex _mutex;
-    Map _files;
-    Set _unusedFiles;
+    std::array<Shard, NUM_SHARDS> _shards;
+    Mutex _cleanMutex;
+    std::shared_ptr<Eviction> _eviction { std::make_shared<Eviction>() };
+    std::thread _evictionThread;
 };
 
 class File {
@@ -161,7 +209,6 @@ protected:
 
 private:
     friend class FileCache;
-    friend struct FilePointerComparator;
     friend class ::FileCacheTests;
 
     const Key _key;
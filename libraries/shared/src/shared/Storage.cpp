@@ -102,4 +102,49 @@ FileStorage::~FileStorage() {
     if (_file.isOpen()) {
         _file.close();
     }
-}
\ No newline at end of file
+}
+
+LazyFileStorage::LazyFileStorage(const QString& filename, size_t offset, size_t size) :
+    _offset(offset), _size(size), _file(filename) {
+    if (!_file.open(QFile::ReadOnly)) {
+        qCWarning(storagelogging) << "Failed to open file " << filename;
+    }
+}
+
+LazyFileStorage::~LazyFileStorage() {
+    if (_mapped && _fallback.isEmpty()) {
+        _file.unmap(_mapped);
+    }
+    _mapped = nullptr;
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
+
+const uint8_t* LazyFileStorage::data() const {
+    std::call_once(_mapOnce, [this] { map(); });
+    return _mapped;
+}
+
+void LazyFileStorage::map() const {
+    if (!_file.isOpen() || _size == 0) {
+        return;
+    }
+    if ((qint64)(_offset + _size) > _file.size()) {
+        qCWarning(storagelogging) << "Range" << _offset << "+" << _size << "is past the end of" << _file.fileName();
+        return;
+    }
+
+    _mapped = _file.map(_offset, _size);
+    if (!_mapped) {
+        qCDebug(storagelogging) << "Failed to map file range, falling back to memory storage " << _file.fileName();
+        if (_file.seek(_offset)) {
+            _fallback = _file.read(_size);
+        }
+        if ((size_t)_fallback.size() == _size) {
+            _mapped = (uint8_t*)_fallback.data();
+        } else {
+            _fallback.clear();
+        }
+    }
+}
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <QFile>
 #include <QString>
 
@@ -73,6 +74,36 @@ namespace storage {
         uint8_t* _mapped { nullptr };
     };
 
+    // Read-only range of a file, mapped the first time its data is accessed.  The file is opened up front so
+    // that the range stays readable even if the file is removed before then.
+    class LazyFileStorage : public Storage {
+    public:
+        LazyFileStorage(const QString& filename, size_t offset, size_t size);
+        ~LazyFileStorage();
+        // Prevent copying
+        LazyFileStorage(const LazyFileStorage& other) = delete;
+        LazyFileStorage& operator=(const LazyFileStorage& other) = delete;
+
+        const uint8_t* data() const override;
+        uint8_t* mutableData() override { return nullptr; }
+        size_t size() const override { return _size; }
+        operator bool() const override { return data() != nullptr; }
+
+        bool isOpen() const { return _file.isOpen(); }
+        bool isMapped() const { return _mapped != nullptr; }
+
+    private:
+        void map() const;
+
+        const size_t _offset;
+        const size_t _size;
+        mutable std::once_flag _mapOnce;
+        mutable QFile _file;
+        // For compressed QRC files we can't map the file object, so we need to read the range into memory
+        mutable QByteArray _fallback;
+        mutable uint8_t* _mapped { nullptr };
+    };
+
     class ViewStorage : public Storage {
     public:
         ViewStorage(const storage::StoragePointer& owner, size_t size, const uint8_t* data);
@@ -10,8 +10,108 @@
 //
 #include "Task.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include <tbb/task_group.h>
+
 using namespace task;
 
+static void collectVaryingIDs(const Varying& varying, std::vector<const void*>& ids) {
+    if (varying.isNull()) {
+        return;
+    }
+    ids.push_back(varying.getID());
+    uint8_t length = varying.length();
+    for (uint8_t i = 0; i < length; ++i) {
+        collectVaryingIDs(varying[i], ids);
+    }
+}
+
+const JobGraph::Dependencies& JobGraph::addJob(const Varying& input, const Varying& output) {
+    uint32_t job = getNumJobs();
+
+    std::vector<const void*> inputIDs;
+    collectVaryingIDs(input, inputIDs);
+    std::sort(inputIDs.begin(), inputIDs.end());
+
+    Dependencies dependencies;
+    for (uint32_t other = 0; other < job; ++other) {
+        const auto& outputIDs = _outputIDs[other];
+        auto inputItr = inputIDs.begin();
+        auto outputItr = outputIDs.begin();
+        while (inputItr != inputIDs.end() && outputItr != outputIDs.end()) {
+            if (*inputItr < *outputItr) {
+                ++inputItr;
+            } else if (*outputItr < *inputItr) {
+                ++outputItr;
+            } else {
+                dependencies.push_back(other);
+                _dependents[other].push_back(job);
+                break;
+            }
+        }
+    }
+
+    std::vector<const void*> outputIDs;
+    collectVaryingIDs(output, outputIDs);
+    std::sort(outputIDs.begin(), outputIDs.end());
+
+    _outputIDs.push_back(std::move(outputIDs));
+    _dependencies.push_back(std::move(dependencies));
+    _dependents.push_back(Dependencies());
+    return _dependencies.back();
+}
+
+void JobGraph::run(const std::function<bool(uint32_t)>& runJob) const {
+    uint32_t numJobs = getNumJobs();
+    std::unique_ptr<std::atomic<uint32_t>[]> numPendingDependencies(new std::atomic<uint32_t>[numJobs]);
+    for (uint32_t job = 0; job < numJobs; ++job) {
+        numPendingDependencies[job] = (uint32_t)_dependencies[job].size();
+    }
+    std::atomic<bool> aborted { false };
+    tbb::task_group group;
+
+    // The jobs may run on worker threads, time them under the timer of the task that runs the graph
+    const QString contextName = PerformanceTimer::isActive() ? PerformanceTimer::getContextName() : QString();
+
+    // Runs a job then the jobs it was the last dependency of, the first on this same thread and the others on new tasks
+    std::function<void(uint32_t)> runFrom = [&](uint32_t job) {
+        const uint32_t NO_JOB = (uint32_t)-1;
+        while (job != NO_JOB && !aborted) {
+            if (!runJob(job)) {
+                aborted = true;
+                return;
+            }
+            uint32_t nextJob = NO_JOB;
+            for (auto dependent : _dependents[job]) {
+                if (--numPendingDependencies[dependent] == 0) {
+                    if (nextJob == NO_JOB) {
+                        nextJob = dependent;
+                    } else {
+                        group.run([&runFrom, &contextName, dependent] {
+                            PerformanceTimer::ContextScope timerContext(contextName);
+                            runFrom(dependent);
+                        });
+                    }
+                }
+            }
+            job = nextJob;
+        }
+    };
+
+    for (uint32_t job = 0; job < numJobs; ++job) {
+        if (_dependencies[job].empty()) {
+            group.run([&runFrom, &contextName, job] {
+                PerformanceTimer::ContextScope timerContext(contextName);
+                runFrom(job);
+            });
+        }
+    }
+    group.wait();
+}
+
 JobContext::JobContext(const QLoggingCategory& category) :
     profileCategory(category) {
     assert(&category);
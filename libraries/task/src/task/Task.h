@@ -12,6 +12,9 @@
 #ifndef hifi_task_Task_h
 #define hifi_task_Task_h
 
+#include <functional>
+#include <vector>
+
 #include "Config.h"
 #include "Varying.h"
 
@@ -91,6 +94,28 @@ protected:
 };
 
 
+// The data dependencies between the jobs of a task, found from the Varyings that connect them: a job depends on the
+// jobs whose output its input refers to, directly or through the VaryingSets and VaryingArrays they contain.
+class JobGraph {
+public:
+    using Dependencies = std::vector<uint32_t>;
+
+    // Adds a job after the others and returns the indices of the jobs it depends on
+    const Dependencies& addJob(const Varying& input, const Varying& output);
+
+    uint32_t getNumJobs() const { return (uint32_t)_dependencies.size(); }
+    const Dependencies& getDependencies(uint32_t job) const { return _dependencies[job]; }
+
+    // Calls runJob() for every job on the worker threads, each as soon as the jobs it depends on are done.
+    // Once a call returns false no other job is started.
+    void run(const std::function<bool(uint32_t)>& runJob) const;
+
+private:
+    std::vector<std::vector<const void*>> _outputIDs; // sorted
+    std::vector<Dependencies> _dependencies;
+    std::vector<Dependencies> _dependents;
+};
+
 template <class T, class C> void jobConfigure(T& data, const C& configuration) {
     data.configure(configuration);
 }
@@ -239,6 +264,8 @@ public:
         Varying _input;
         Varying _output;
         Jobs _jobs;
+        JobGraph _graph;
+        bool _parallel { false };
 
         const Varying getInput() const override { return _input; }
         const Varying getOutput() const override { return _output; }
@@ -263,9 +290,16 @@ public:
 
         TaskConcept(const std::string& name, const Varying& input, QConfigPointer config) : Concept(name, config), _input(input) {}
 
+        // Lets the jobs that don't depend on each other run concurrently, each with its own copy of the context.
+        // Only for tasks whose jobs share no other state than their inputs and outputs.
+        void setParallel(bool parallel) { _parallel = parallel; }
+        bool isParallel() const { return _parallel; }
+        const JobGraph& getGraph() const { return _graph; }
+
         // Create a new job in the container's queue; returns the job's output
         template <class NT, class... NA> const Varying addJob(std::string name, const Varying& input, NA&&... args) {
             _jobs.emplace_back((NT::JobModel::create(name, input, std::forward<NA>(args)...)));
+            _graph.addJob(_jobs.back().getInput(), _jobs.back().getOutput());
 
             // Conect the child config to this task's config
             std::static_pointer_cast<TaskConfig>(Concept::getConfiguration())->connectChildConfig(_jobs.back().getConfiguration(), name);
@@ -340,6 +374,15 @@ public:
         void run(const ContextPointer& jobContext) override {
             auto config = std::static_pointer_cast<C>(Concept::_config);
             if (config->alwaysEnabled || config->enabled) {
+                if (TaskConcept::_parallel && TaskConcept::_jobs.size() > 1) {
+                    TaskConcept::_graph.run([&](uint32_t index) {
+                        // the job sets the config it runs with and its flow control commands on its own context
+                        auto context = std::make_shared<Context>(*jobContext);
+                        TaskConcept::_jobs[index].run(context);
+                        return !context->taskFlow.doAbortTask();
+                    });
+                    return;
+                }
                 for (auto job : TaskConcept::_jobs) {
                     job.run(jobContext);
                     if (jobContext->taskFlow.doAbortTask()) {
@@ -14,9 +14,20 @@
 
 #include <tuple>
 #include <array>
+#include <memory>
+#include <type_traits>
 
 namespace task {
 
+class Varying;
+
+// Gives access to the varyings contained in a VaryingSet or a VaryingArray, the other types contain none
+template <class T, class Enable = void> class VaryingContainer {
+public:
+    static Varying at(const T& data, uint8_t index);
+    static uint8_t length(const T& data) { return 0; }
+};
+
 // A varying piece of data, to be used as Job/Task I/O
 class Varying {
 public:
@@ -42,6 +53,9 @@ public:
 
     bool isNull() const { return _concept == nullptr; }
 
+    // identifies the data shared by the copies of this varying
+    const void* getID() const { return _concept.get(); }
+
 protected:
     class Concept {
     public:
@@ -57,11 +71,8 @@ protected:
         Model(const Data& data) : _data(data) {}
         virtual ~Model() = default;
 
-        virtual Varying operator[] (uint8_t index) const override {
-            Varying var;
-            return var;
-        }
-        virtual uint8_t length() const override { return 0; }
+        virtual Varying operator[] (uint8_t index) const override { return VaryingContainer<Data>::at(_data, index); }
+        virtual uint8_t length() const override { return VaryingContainer<Data>::length(_data); }
 
         Data _data;
     };
@@ -69,6 +80,18 @@ protected:
     std::shared_ptr<Concept> _concept;
 };
 
+template <class T, class Enable> Varying VaryingContainer<T, Enable>::at(const T& data, uint8_t index) {
+    return Varying();
+}
+
+template <class T> class VaryingContainer<T, typename std::enable_if<
+        std::is_same<typename std::decay<decltype(std::declval<const T&>()[0])>::type, Varying>::value &&
+        std::is_integral<decltype(std::declval<const T&>().length())>::value>::type> {
+public:
+    static Varying at(const T& data, uint8_t index) { return (index < data.length() ? data[index] : Varying()); }
+    static uint8_t length(const T& data) { return data.length(); }
+};
+
 using VaryingPairBase = std::pair<Varying, Varying>;
 template < typename T0, typename T1 >
 class VaryingSet2 : public VaryingPairBase {
@@ -288,7 +311,27 @@ public:
     
     const T6& get6() const { return std::get<6>((*this)).template get<T6>(); }
     T6& edit6() { return std::get<6>((*this)).template edit<T6>(); }
-    
+
+    virtual Varying operator[] (uint8_t index) const {
+        switch (index) {
+        default:
+            return std::get<0>((*this));
+        case 1:
+            return std::get<1>((*this));
+        case 2:
+            return std::get<2>((*this));
+        case 3:
+            return std::get<3>((*this));
+        case 4:
+            return std::get<4>((*this));
+        case 5:
+            return std::get<5>((*this));
+        case 6:
+            return std::get<6>((*this));
+        }
+    }
+    virtual uint8_t length() const { return 7; }
+
     Varying asVarying() const { return Varying((*this)); }
 };
 
@@ -325,6 +368,28 @@ public:
     const T7& get7() const { return std::get<7>((*this)).template get<T7>(); }
     T7& edit7() { return std::get<7>((*this)).template edit<T7>(); }
 
+    virtual Varying operator[] (uint8_t index) const {
+        switch (index) {
+        default:
+            return std::get<0>((*this));
+        case 1:
+            return std::get<1>((*this));
+        case 2:
+            return std::get<2>((*this));
+        case 3:
+            return std::get<3>((*this));
+        case 4:
+            return std::get<4>((*this));
+        case 5:
+            return std::get<5>((*this));
+        case 6:
+            return std::get<6>((*this));
+        case 7:
+            return std::get<7>((*this));
+        }
+    }
+    virtual uint8_t length() const { return 8; }
+
     Varying asVarying() const { return Varying((*this)); }
 };
 
@@ -341,6 +406,8 @@ public:
         assert(list.size() == NUM);
         std::copy(list.begin(), list.end(), std::array<Varying, NUM>::begin());
     }
+
+    uint8_t length() const { return NUM; }
 };
 }
 
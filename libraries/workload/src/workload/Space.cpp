@@ -18,77 +18,335 @@
 
 #include <glm/gtx/quaternion.hpp>
 
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
+
+#include <TBBHelpers.h>
+
 using namespace workload;
 
+const uint8_t Space::REGION_NEAR;
+const uint8_t Space::REGION_MIDDLE;
+const uint8_t Space::REGION_FAR;
+const uint8_t Space::REGION_UNKNOWN;
+const uint8_t Space::REGION_INVALID;
+const float Space::DEFAULT_CELL_SIZE = 128.0f;
+
+// below this many cells the categorization isn't worth splitting across threads
+const int32_t MIN_NUM_CELLS_FOR_PARALLEL_CATEGORIZATION = 256;
+
 int32_t Space::createProxy(const Space::Sphere& newSphere) {
+    int32_t index;
     if (_freeIndices.empty()) {
-        _proxies.emplace_back(Space::Proxy(newSphere));
-        return (int32_t)_proxies.size() - 1;
+        index = (int32_t)_cellIndices.size();
+        _cellIndices.push_back(-1);
+        _cellSlots.push_back(-1);
     } else {
-        int32_t index = _freeIndices.back();
+        index = _freeIndices.back();
         _freeIndices.pop_back();
-        _proxies[index].sphere = newSphere;
-        _proxies[index].region = Space::REGION_UNKNOWN;
-        _proxies[index].prevRegion = Space::REGION_UNKNOWN;
-        return index;
     }
+    addToCell(index, getCellKey(glm::vec3(newSphere)), newSphere, Space::REGION_UNKNOWN);
+    return index;
 }
 
 void Space::deleteProxy(int32_t proxyId) {
-    if (proxyId >= (int32_t)_proxies.size() || _proxies.empty()) {
+    if (proxyId >= (int32_t)_cellIndices.size() || _cellIndices.empty() || _cellIndices[proxyId] == -1) {
         return;
     }
-    if (proxyId == (int32_t)_proxies.size() - 1) {
+    removeFromCell(proxyId);
+    if (proxyId == (int32_t)_cellIndices.size() - 1) {
         // remove proxy on back
-        _proxies.pop_back();
+        _cellIndices.pop_back();
+        _cellSlots.pop_back();
         if (!_freeIndices.empty()) {
             // remove any freeIndices on back
             std::sort(_freeIndices.begin(), _freeIndices.end());
-            while(!_freeIndices.empty() && _freeIndices.back() == (int32_t)_proxies.size() - 1) {
+            while(!_freeIndices.empty() && _freeIndices.back() == (int32_t)_cellIndices.size() - 1) {
                 _freeIndices.pop_back();
-                _proxies.pop_back();
+                _cellIndices.pop_back();
+                _cellSlots.pop_back();
             }
         }
     } else {
-        _proxies[proxyId].region = Space::REGION_INVALID;
         _freeIndices.push_back(proxyId);
     }
 }
 
 void Space::updateProxy(int32_t proxyId, const Space::Sphere& newSphere) {
-    if (proxyId >= (int32_t)_proxies.size()) {
+    if (proxyId >= (int32_t)_cellIndices.size() || _cellIndices[proxyId] == -1) {
         return;
     }
-    _proxies[proxyId].sphere = newSphere;
+    Cell& cell = _cells[_cellIndices[proxyId]];
+    uint64_t key = getCellKey(glm::vec3(newSphere));
+    if (key == cell.key) {
+        int32_t slot = _cellSlots[proxyId];
+        cell.xs[slot] = newSphere.x;
+        cell.ys[slot] = newSphere.y;
+        cell.zs[slot] = newSphere.z;
+        cell.radiuses[slot] = newSphere.w;
+        cell.dirty = true;
+    } else {
+        uint8_t region = removeFromCell(proxyId);
+        addToCell(proxyId, key, newSphere, region);
+    }
 }
 
 void Space::setViews(const std::vector<Space::View>& views) {
-    _views = views;
+    bool changed = views.size() != _views.size();
+    for (size_t i = 0; i < views.size() && !changed; ++i) {
+        changed = views[i].center != _views[i].center || views[i].radiuses[0] != _views[i].radiuses[0] ||
+            views[i].radiuses[1] != _views[i].radiuses[1] || views[i].radiuses[2] != _views[i].radiuses[2];
+    }
+    if (changed) {
+        _views = views;
+        _viewsChanged = true;
+    }
 }
 
 void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
-    uint32_t numProxies = (uint32_t)_proxies.size();
-    uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Space::REGION_INVALID) {
-            uint8_t region = Space::REGION_UNKNOWN;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                float distance2 = glm::distance2(_views[j].center, glm::vec3(_proxies[i].sphere));
-                for (uint8_t c = 0; c < region; ++c) {
-                    float touchDistance = _views[j].radiuses[c] + _proxies[i].sphere.w;
-                    if (distance2 < touchDistance * touchDistance) {
-                        region = c;
-                        break;
-                    }
-                }
+    int32_t numCells = (int32_t)_cells.size();
+    if (numCells >= MIN_NUM_CELLS_FOR_PARALLEL_CATEGORIZATION) {
+        // every proxy belongs to a single cell, so the cells can be categorized independently
+        tbb::parallel_for(tbb::blocked_range<int32_t>(0, numCells), [&](const tbb::blocked_range<int32_t>& range) {
+            for (int32_t i = range.begin(); i != range.end(); ++i) {
+                categorizeCell(_cells[i]);
             }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+        });
+    } else {
+        for (int32_t i = 0; i < numCells; ++i) {
+            categorizeCell(_cells[i]);
+        }
+    }
+    _viewsChanged = false;
+
+    size_t firstChange = changes.size();
+    for (auto& cell : _cells) {
+        if (!cell.changes.empty()) {
+            changes.insert(changes.end(), cell.changes.begin(), cell.changes.end());
+            cell.changes.clear();
+        }
+    }
+    std::sort(changes.begin() + firstChange, changes.end(), [](const Space::Change& a, const Space::Change& b) {
+        return a.proxyId < b.proxyId;
+    });
+}
+
+// Cells are keyed by their integer coordinates, 21 bits for each axis, which covers 2^20 cells on either side of
+// the origin.  Proxies further out share the cells at the edge.
+uint64_t Space::getCellKey(const glm::vec3& position) const {
+    const float MAX_COORDINATE = (float)((1 << 20) - 1);
+    const uint64_t COORDINATE_MASK = (1 << 21) - 1;
+    uint64_t key = 0;
+    for (int i = 0; i < 3; ++i) {
+        float coordinate = floorf(position[i] / _cellSize);
+        // also catches NaN
+        if (!(coordinate >= -MAX_COORDINATE)) {
+            coordinate = -MAX_COORDINATE;
+        } else if (coordinate > MAX_COORDINATE) {
+            coordinate = MAX_COORDINATE;
+        }
+        key = (key << 21) | ((uint64_t)(int64_t)coordinate & COORDINATE_MASK);
+    }
+    return key;
+}
+
+void Space::addToCell(int32_t proxyId, uint64_t key, const Space::Sphere& sphere, uint8_t region) {
+    int32_t cellIndex;
+    auto itr = _cellMap.find(key);
+    if (itr == _cellMap.end()) {
+        if (_freeCells.empty()) {
+            cellIndex = (int32_t)_cells.size();
+            _cells.emplace_back();
+        } else {
+            // the arrays of a recycled cell are empty but keep their capacity
+            cellIndex = _freeCells.back();
+            _freeCells.pop_back();
+            _cells[cellIndex].region = REGION_INVALID;
+            _cells[cellIndex].dirty = true;
+        }
+        _cells[cellIndex].key = key;
+        _cellMap[key] = cellIndex;
+    } else {
+        cellIndex = itr->second;
+    }
+
+    Cell& cell = _cells[cellIndex];
+    _cellIndices[proxyId] = cellIndex;
+    _cellSlots[proxyId] = (int32_t)cell.proxyIds.size();
+    cell.proxyIds.push_back(proxyId);
+    cell.xs.push_back(sphere.x);
+    cell.ys.push_back(sphere.y);
+    cell.zs.push_back(sphere.z);
+    cell.radiuses.push_back(sphere.w);
+    cell.regions.push_back(region);
+    cell.dirty = true;
+}
+
+// answers the region of the removed proxy
+uint8_t Space::removeFromCell(int32_t proxyId) {
+    Cell& cell = _cells[_cellIndices[proxyId]];
+    int32_t slot = _cellSlots[proxyId];
+    uint8_t region = cell.regions[slot];
+
+    // move the last proxy of the cell into the hole
+    int32_t lastId = cell.proxyIds.back();
+    cell.proxyIds[slot] = lastId;
+    cell.xs[slot] = cell.xs.back();
+    cell.ys[slot] = cell.ys.back();
+    cell.zs[slot] = cell.zs.back();
+    cell.radiuses[slot] = cell.radiuses.back();
+    cell.regions[slot] = cell.regions.back();
+    _cellSlots[lastId] = slot;
+
+    cell.proxyIds.pop_back();
+    cell.xs.pop_back();
+    cell.ys.pop_back();
+    cell.zs.pop_back();
+    cell.radiuses.pop_back();
+    cell.regions.pop_back();
+    cell.dirty = true;
+
+    if (cell.proxyIds.empty()) {
+        _cellMap.erase(cell.key);
+        _freeCells.push_back(_cellIndices[proxyId]);
+    }
+
+    _cellIndices[proxyId] = -1;
+    _cellSlots[proxyId] = -1;
+    return region;
+}
+
+// The nearest region of any view that the sphere touches.  This is the reference for the other categorizations,
+// which must give the same answer.
+static uint8_t categorizeSphere(float x, float y, float z, float radius, const std::vector<Space::View>& views) {
+    uint8_t region = Space::REGION_UNKNOWN;
+    glm::vec3 center(x, y, z);
+    for (const auto& view : views) {
+        float distance2 = glm::distance2(view.center, center);
+        for (uint8_t c = 0; c < region; ++c) {
+            float touchDistance = view.radiuses[c] + radius;
+            if (distance2 < touchDistance * touchDistance) {
+                region = c;
+                break;
             }
         }
     }
+    return region;
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// categorizeSphere() of 4 spheres, with the regions as floats
+static inline __m128 categorizeSpheres(__m128 x, __m128 y, __m128 z, __m128 radius, const std::vector<Space::View>& views) {
+    __m128 region = _mm_set1_ps((float)Space::REGION_UNKNOWN);
+    for (const auto& view : views) {
+        __m128 dx = _mm_sub_ps(x, _mm_set1_ps(view.center.x));
+        __m128 dy = _mm_sub_ps(y, _mm_set1_ps(view.center.y));
+        __m128 dz = _mm_sub_ps(z, _mm_set1_ps(view.center.z));
+        __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        // the nearest band that is touched wins, so test them from the outside in
+        __m128 viewRegion = _mm_set1_ps((float)Space::REGION_UNKNOWN);
+        for (int c = Space::REGION_FAR; c >= Space::REGION_NEAR; --c) {
+            __m128 touchDistance = _mm_add_ps(_mm_set1_ps(view.radiuses[c]), radius);
+            __m128 touching = _mm_cmplt_ps(distance2, _mm_mul_ps(touchDistance, touchDistance));
+            viewRegion = _mm_or_ps(_mm_and_ps(touching, _mm_set1_ps((float)c)), _mm_andnot_ps(touching, viewRegion));
+        }
+        region = _mm_min_ps(region, viewRegion);
+    }
+    return region;
+}
+
+#endif
+
+// The range of regions that spheres within the bounds of a cell can be in, for one view.  The bounds are padded by
+// a relative margin, which is far larger than the rounding errors of categorizeSphere().
+static void getRegionRange(const Space::View& view, const glm::vec3& minCenter, const glm::vec3& maxCenter,
+                           float minRadius, float maxRadius, uint8_t& lowest, uint8_t& highest) {
+    const float MARGIN = 0.0001f;
+    glm::vec3 nearOffset = glm::max(glm::max(minCenter - view.center, view.center - maxCenter), glm::vec3(0.0f));
+    glm::vec3 farOffset = glm::max(glm::abs(minCenter - view.center), glm::abs(maxCenter - view.center));
+    float minDistance = glm::length(nearOffset) * (1.0f - MARGIN);
+    float maxDistance = glm::length(farOffset) * (1.0f + MARGIN);
+
+    lowest = Space::REGION_UNKNOWN;
+    highest = Space::REGION_UNKNOWN;
+    for (uint8_t c = 0; c < Space::REGION_UNKNOWN; ++c) {
+        float minTouchDistance = (view.radiuses[c] + minRadius) * (1.0f - MARGIN);
+        float maxTouchDistance = (view.radiuses[c] + maxRadius) * (1.0f + MARGIN);
+        // a negative touch distance still touches when squared, so it never rules a band out
+        bool noneTouch = minTouchDistance >= 0.0f && minDistance > maxTouchDistance;
+        bool allTouch = maxDistance < minTouchDistance;
+        if (!noneTouch && lowest == Space::REGION_UNKNOWN) {
+            lowest = c;
+        }
+        if (allTouch) {
+            highest = c;
+            break;
+        }
+    }
 }
 
+void Space::categorizeCell(Cell& cell) const {
+    if (cell.proxyIds.empty() || !(cell.dirty || _viewsChanged)) {
+        return;
+    }
+    int32_t numProxies = (int32_t)cell.proxyIds.size();
+
+    if (cell.dirty) {
+        cell.minCenter = cell.maxCenter = glm::vec3(cell.xs[0], cell.ys[0], cell.zs[0]);
+        cell.minRadius = cell.maxRadius = cell.radiuses[0];
+        for (int32_t i = 1; i < numProxies; ++i) {
+            glm::vec3 center(cell.xs[i], cell.ys[i], cell.zs[i]);
+            cell.minCenter = glm::min(cell.minCenter, center);
+            cell.maxCenter = glm::max(cell.maxCenter, center);
+            cell.minRadius = std::min(cell.minRadius, cell.radiuses[i]);
+            cell.maxRadius = std::max(cell.maxRadius, cell.radiuses[i]);
+        }
+    }
+
+    uint8_t lowest = Space::REGION_UNKNOWN;
+    uint8_t highest = Space::REGION_UNKNOWN;
+    for (const auto& view : _views) {
+        uint8_t viewLowest, viewHighest;
+        getRegionRange(view, cell.minCenter, cell.maxCenter, cell.minRadius, cell.maxRadius, viewLowest, viewHighest);
+        lowest = std::min(lowest, viewLowest);
+        highest = std::min(highest, viewHighest);
+    }
+
+    auto setRegion = [&](int32_t i, uint8_t region) {
+        if (region != cell.regions[i]) {
+            cell.changes.emplace_back(Space::Change(cell.proxyIds[i], region, cell.regions[i]));
+            cell.regions[i] = region;
+        }
+    };
+
+    if (lowest == highest) {
+        // all the proxies are in the same region, and already were unless they or that region changed
+        if (cell.dirty || cell.region != lowest) {
+            for (int32_t i = 0; i < numProxies; ++i) {
+                setRegion(i, lowest);
+            }
+            cell.region = lowest;
+        }
+    } else {
+        int32_t i = 0;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+        for (; i + 4 <= numProxies; i += 4) {
+            __m128 regions = categorizeSpheres(_mm_loadu_ps(&cell.xs[i]), _mm_loadu_ps(&cell.ys[i]),
+                                               _mm_loadu_ps(&cell.zs[i]), _mm_loadu_ps(&cell.radiuses[i]), _views);
+            float lanes[4];
+            _mm_storeu_ps(lanes, regions);
+            for (int32_t j = 0; j < 4; ++j) {
+                setRegion(i + j, (uint8_t)lanes[j]);
+            }
+        }
+#endif
+        for (; i < numProxies; ++i) {
+            setRegion(i, categorizeSphere(cell.xs[i], cell.ys[i], cell.zs[i], cell.radiuses[i], _views));
+        }
+        cell.region = Space::REGION_INVALID;
+    }
+    cell.dirty = false;
+}
@@ -15,6 +15,8 @@
 #ifndef hifi_workload_Space_h
 #define hifi_workload_Space_h
 
+#include <stdint.h>
+#include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -28,15 +30,10 @@ public:
     static const uint8_t REGION_UNKNOWN = 3;
     static const uint8_t REGION_INVALID = 4;
 
-    using Sphere = glm::vec4; // <x,y,z> = center, w = radius
+    // edge of the cubic cells that proxies are binned into
+    static const float DEFAULT_CELL_SIZE;
 
-    class Proxy {
-    public:
-        Proxy(const Sphere& s) : sphere(s) {}
-        Sphere sphere;
-        uint8_t region { REGION_UNKNOWN };
-        uint8_t prevRegion { REGION_UNKNOWN };
-    };
+    using Sphere = glm::vec4; // <x,y,z> = center, w = radius
 
     class View {
     public:
@@ -57,21 +54,64 @@ public:
         uint8_t prevRegion { 0 };
     };
 
-    Space() {}
+    Space(float cellSize = DEFAULT_CELL_SIZE) : _cellSize(cellSize) {}
 
     int32_t createProxy(const Sphere& sphere);
     void deleteProxy(int32_t proxyId);
     void updateProxy(int32_t proxyId, const Sphere& sphere);
     void setViews(const std::vector<View>& views);
 
-    uint32_t getNumObjects() const { return (uint32_t)(_proxies.size() - _freeIndices.size()); }
+    uint32_t getNumObjects() const { return (uint32_t)(_cellIndices.size() - _freeIndices.size()); }
+    // cells holding at least one proxy, and cells allocated including the empty ones kept for reuse
+    uint32_t getNumCells() const { return (uint32_t)_cellMap.size(); }
+    uint32_t getNumAllocatedCells() const { return (uint32_t)_cells.size(); }
 
+    // Appends the proxies whose region changed since the last call, in order of proxyId
     void categorizeAndGetChanges(std::vector<Change>& changes);
 
 private:
-    std::vector<Proxy> _proxies;
-    std::vector<View> _views;
+    // The proxies are binned into cells, which store their spheres and regions as arrays of each component so that
+    // they can be categorized several at a time.  A cell also keeps the bounds of its proxies, to tell when they are all
+    // in the same region: then they are categorized together, or skipped when that region and the proxies haven't changed.
+    class Cell {
+    public:
+        // the bounds come first, they are all that is read of the cells that can be skipped
+        glm::vec3 minCenter;
+        glm::vec3 maxCenter;
+        float minRadius { 0.0f };
+        float maxRadius { 0.0f };
+        // region of all the proxies when they were last categorized together, REGION_INVALID if they weren't
+        uint8_t region { REGION_INVALID };
+        bool dirty { true };
+
+        uint64_t key { 0 };
+        std::vector<int32_t> proxyIds;
+        std::vector<float> xs;
+        std::vector<float> ys;
+        std::vector<float> zs;
+        std::vector<float> radiuses;
+        std::vector<uint8_t> regions;
+        std::vector<Change> changes;
+    };
+
+    uint64_t getCellKey(const glm::vec3& position) const;
+    void addToCell(int32_t proxyId, uint64_t key, const Sphere& sphere, uint8_t region);
+    uint8_t removeFromCell(int32_t proxyId);
+
+    void categorizeCell(Cell& cell) const;
+
+    // cell and index within it of each proxy, -1 for deleted proxies
+    std::vector<int32_t> _cellIndices;
+    std::vector<int32_t> _cellSlots;
     std::vector<int32_t> _freeIndices;
+
+    // cells emptied by their last proxy leave the map and are reused for the next new key
+    std::vector<Cell> _cells;
+    std::vector<int32_t> _freeCells;
+    std::unordered_map<uint64_t, int32_t> _cellMap;
+    std::vector<View> _views;
+    float _cellSize;
+    bool _viewsChanged { false };
 };
 
 } // namespace workload
@@ -0,0 +1,160 @@
+//
+//  AnimClipDataTests.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimClipDataTests.h"
+
+#include <iostream>
+
+#include <AnimClipData.h>
+#include <AnimUtil.h>
+#include <GLMHelpers.h>
+
+QTEST_MAIN(AnimClipDataTests)
+
+// Joints swing at different rates around different axes and translate along a circle, like limbs and hips do
+static std::vector<AnimPoseVec> makeFrames(int numFrames, int numJoints) {
+    std::vector<AnimPoseVec> frames(numFrames, AnimPoseVec(numJoints));
+    for (int frame = 0; frame < numFrames; frame++) {
+        float time = (float)frame / 30.0f;
+        for (int joint = 0; joint < numJoints; joint++) {
+            glm::vec3 axis = glm::normalize(glm::vec3(1.0f + joint, 2.0f, 3.0f - joint));
+            float angle = 0.8f * sinf(time * (1.0f + 0.1f * joint));
+            glm::vec3 trans(0.0f, 10.0f + joint, 0.0f);
+            if (joint % 4 == 0) {
+                trans += 5.0f * glm::vec3(cosf(time), 0.0f, sinf(time));
+            }
+            frames[frame][joint] = AnimPose(glm::vec3(1.0f), glm::angleAxis(angle, axis), trans);
+        }
+    }
+    return frames;
+}
+
+// from the distance between the quaternions rather than their dot product, which has no precision near zero
+static float angleBetween(const glm::quat& a, const glm::quat& b) {
+    glm::quat difference = glm::dot(a, b) < 0.0f ? a + b : a + (-b);
+    return 4.0f * asinf(std::min(1.0f, 0.5f * glm::length(difference)));
+}
+
+void AnimClipDataTests::testConstantTracks() {
+    const int NUM_FRAMES = 100;
+    const int NUM_JOINTS = 10;
+    AnimPose pose(glm::vec3(1.0f, 2.0f, 3.0f), glm::angleAxis(0.5f, glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f))), glm::vec3(4.0f, 5.0f, 6.0f));
+    std::vector<AnimPoseVec> frames(NUM_FRAMES, AnimPoseVec(NUM_JOINTS, pose));
+
+    AnimClipData clipData(frames);
+    QCOMPARE(clipData.getNumFrames(), NUM_FRAMES);
+    QCOMPARE(clipData.getNumJoints(), NUM_JOINTS);
+    // one key for each rotation, translation and scale track
+    QCOMPARE(clipData.getNumKeys(), (size_t)(3 * NUM_JOINTS));
+
+    // translations and scales come back exactly, rotations within quantization error
+    AnimPoseVec poses(NUM_JOINTS);
+    clipData.evaluate(NUM_FRAMES / 2, &poses[0]);
+    for (const auto& result : poses) {
+        QCOMPARE(result.trans(), pose.trans());
+        QCOMPARE(result.scale(), pose.scale());
+        QVERIFY(angleBetween(result.rot(), pose.rot()) < 0.0001f);
+    }
+}
+
+void AnimClipDataTests::testCompressionError() {
+    const int NUM_FRAMES = 300;
+    const int NUM_JOINTS = 20;
+    auto frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+
+    AnimClipData clipData(frames);
+    QVERIFY(clipData.getNumKeys() < (size_t)(NUM_FRAMES * NUM_JOINTS));
+    QVERIFY(clipData.getMemoryUsage() * 4 < clipData.getUncompressedSize());
+
+    // key reduction plus quantization
+    const float MAX_ROTATION_ERROR = AnimClipData::ROTATION_TOLERANCE + 0.0002f;
+    const float MAX_TRANSLATION_ERROR = 2.0f * AnimClipData::TRANSLATION_TOLERANCE * 16.0f;
+
+    AnimPoseVec poses(NUM_JOINTS);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        clipData.evaluate(frame, &poses[0]);
+        for (int joint = 0; joint < NUM_JOINTS; joint++) {
+            const AnimPose& expected = frames[frame][joint];
+            QVERIFY(angleBetween(poses[joint].rot(), expected.rot()) <= MAX_ROTATION_ERROR);
+            QVERIFY(glm::distance(poses[joint].trans(), expected.trans()) <= MAX_TRANSLATION_ERROR);
+            QCOMPARE(poses[joint].scale(), expected.scale());
+        }
+    }
+}
+
+void AnimClipDataTests::testBlend() {
+    const int NUM_FRAMES = 120;
+    const int NUM_JOINTS = 20;
+    auto frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+    AnimClipData clipData(frames);
+
+    const float MAX_ROTATION_ERROR = AnimClipData::ROTATION_TOLERANCE + 0.0002f;
+    const float MAX_TRANSLATION_ERROR = 2.0f * AnimClipData::TRANSLATION_TOLERANCE * 16.0f;
+
+    // neighbouring frames, and the wrap from the last frame back to the first that looping clips do
+    const int PAIRS[][2] = { { 10, 11 }, { 59, 60 }, { NUM_FRAMES - 1, 0 } };
+    const float ALPHAS[] = { 0.0f, 0.25f, 0.5f, 0.9f };
+
+    AnimPoseVec poses(NUM_JOINTS);
+    AnimPoseVec expected(NUM_JOINTS);
+    for (const auto& pair : PAIRS) {
+        for (float alpha : ALPHAS) {
+            clipData.evaluate(pair[0], pair[1], alpha, &poses[0]);
+            ::blend(NUM_JOINTS, &frames[pair[0]][0], &frames[pair[1]][0], alpha, &expected[0]);
+            for (int joint = 0; joint < NUM_JOINTS; joint++) {
+                QVERIFY(angleBetween(poses[joint].rot(), expected[joint].rot()) <= MAX_ROTATION_ERROR);
+                QVERIFY(glm::distance(poses[joint].trans(), expected[joint].trans()) <= MAX_TRANSLATION_ERROR);
+            }
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+void AnimClipDataTests::benchmarkClipEvaluation() {
+    // a minute of a typical avatar skeleton
+    const int NUM_FRAMES = 1800;
+    const int NUM_JOINTS = 60;
+    const int NUM_EVALUATIONS = 100000;
+    auto frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+
+    QElapsedTimer timer;
+    timer.start();
+    AnimClipData clipData(frames);
+    auto compressTime = timer.elapsed();
+
+    // before, each clip held its frames and their mirror
+    size_t poseSize = NUM_JOINTS * sizeof(AnimPose);
+    size_t uncompressedPerClip = 2 * clipData.getUncompressedSize() + poseSize;
+    std::cout << "compressed " << NUM_FRAMES << " frames of " << NUM_JOINTS << " joints in " << compressTime << " ms, "
+        << clipData.getNumKeys() << " keys, " << clipData.getMemoryUsage() << " bytes shared from "
+        << clipData.getUncompressedSize() << std::endl;
+    std::cout << "per clip instance: " << poseSize << " bytes, was " << uncompressedPerClip << std::endl;
+
+    AnimPoseVec poses(NUM_JOINTS);
+    float frame = 0.0f;
+    timer.restart();
+    for (int i = 0; i < NUM_EVALUATIONS; i++) {
+        frame = fmodf(frame + 1.37f, (float)(NUM_FRAMES - 1));
+        int prevIndex = (int)frame;
+        ::blend(NUM_JOINTS, &frames[prevIndex][0], &frames[prevIndex + 1][0], glm::fract(frame), &poses[0]);
+    }
+    auto blendTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < NUM_EVALUATIONS; i++) {
+        frame = fmodf(frame + 1.37f, (float)(NUM_FRAMES - 1));
+        int prevIndex = (int)frame;
+        clipData.evaluate(prevIndex, prevIndex + 1, glm::fract(frame), &poses[0]);
+    }
+    auto evaluateTime = timer.nsecsElapsed();
+
+    std::cout << "evaluate: " << evaluateTime / NUM_EVALUATIONS << " ns per frame, blending uncompressed frames "
+        << blendTime / NUM_EVALUATIONS << " ns" << std::endl;
+}
+#endif
@@ -0,0 +1,29 @@
+//
+//  AnimClipDataTests.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimClipDataTests_h
+#define hifi_AnimClipDataTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AnimClipDataTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testConstantTracks();
+    void testCompressionError();
+    void testBlend();
+#ifdef MANUAL_TEST
+    void benchmarkClipEvaluation();
+#endif
+};
+
+#endif // hifi_AnimClipDataTests_h
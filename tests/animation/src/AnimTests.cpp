@@ -8,6 +8,7 @@
 //
 
 #include "AnimTests.h"
+#include <iostream>
 #include <AnimNodeLoader.h>
 #include <AnimClip.h>
 #include <AnimBlendLinear.h>
@@ -15,6 +16,9 @@
 #include <AnimVariant.h>
 #include <AnimExpression.h>
 #include <AnimUtil.h>
+#include <FBXReader.h>
+#include <FSTReader.h>
+#include <Rig.h>
 #include <NodeList.h>
 #include <AddressManager.h>
 #include <AccountManager.h>
@@ -256,6 +260,63 @@ void AnimTests::testVariant() {
     QVERIFY(q.z == 4.0f);
 }
 
+void AnimTests::testVariantMap() {
+    AnimVariantMap vars;
+
+    // names are interned once and keep their id
+    AnimVariantKey alphaKey("testVariantMapAlpha");
+    QVERIFY(alphaKey.isValid());
+    QVERIFY(AnimVariantKey("testVariantMapAlpha") == alphaKey);
+    QVERIFY(AnimVariantKey::find("testVariantMapAlpha") == alphaKey);
+    QVERIFY(alphaKey.getName() == "testVariantMapAlpha");
+    QVERIFY(!AnimVariantKey::find("testVariantMapNeverInterned").isValid());
+    QVERIFY(!AnimVariantKey("").isValid());
+
+    // keys and strings find the same slot
+    vars.set(alphaKey, 0.5f);
+    QVERIFY(vars.hasKey("testVariantMapAlpha"));
+    QVERIFY(vars.lookup("testVariantMapAlpha", 0.0f) == 0.5f);
+    vars.set("testVariantMapAlpha", 0.25f);
+    QVERIFY(vars.lookup(alphaKey, 0.0f) == 0.25f);
+
+    // the empty key answers the default
+    vars.set(AnimVariantKey(), 1);
+    QVERIFY(vars.lookup(AnimVariantKey(), 7) == 7);
+
+    // a key interned after the map was sized still fits
+    AnimVariantKey lateKey(QString("testVariantMapLate%1").arg(AnimVariantKey::getNumKeys()));
+    QVERIFY(!vars.hasKey(lateKey));
+    vars.set(lateKey, glm::vec3(1.0f, 2.0f, 3.0f));
+    QVERIFY(vars.lookupRaw(lateKey, glm::vec3()) == glm::vec3(1.0f, 2.0f, 3.0f));
+
+    vars.unset(lateKey);
+    QVERIFY(!vars.hasKey(lateKey));
+    QVERIFY(vars.lookupRaw(lateKey, glm::vec3()) == glm::vec3());
+
+    // triggers override bools until they are cleared, but aren't values
+    vars.set("testVariantMapFlag", false);
+    vars.setTrigger("testVariantMapFlag");
+    vars.setTrigger("testVariantMapTrigger");
+    QVERIFY(vars.lookup("testVariantMapFlag", false));
+    QVERIFY(vars.lookup("testVariantMapTrigger", false));
+    QVERIFY(!vars.hasKey("testVariantMapTrigger"));
+    vars.clearTriggers();
+    QVERIFY(!vars.lookup("testVariantMapFlag", true));
+    QVERIFY(!vars.lookup("testVariantMapTrigger", false));
+
+    AnimVariantMap copy;
+    copy.set("testVariantMapOther", QString("other"));
+    copy.copyVariantsFrom(vars);
+    QVERIFY(copy.lookup(alphaKey, 0.0f) == 0.25f);
+    QVERIFY(copy.hasKey("testVariantMapFlag"));
+    QVERIFY(!copy.hasKey(lateKey));
+    QVERIFY(copy.lookup("testVariantMapOther", QString()) == "other");
+
+    vars.clearMap();
+    QVERIFY(!vars.hasKey(alphaKey));
+    QVERIFY(!vars.hasKey("testVariantMapFlag"));
+}
+
 void AnimTests::testAccumulateTime() {
 
     float startFrame = 0.0f;
@@ -442,6 +503,135 @@ void AnimTests::testAnimPose() {
     }
 }
 
+// the pose that glm::mat4 multiplication and inversion give, which is what AnimPose did before it composed the parts
+static AnimPose multiplyWithMatrices(const AnimPose& lhs, const AnimPose& rhs) {
+    return AnimPose((glm::mat4)lhs * (glm::mat4)rhs);
+}
+
+static AnimPose inverseWithMatrices(const AnimPose& pose) {
+    return AnimPose(glm::inverse((glm::mat4)pose));
+}
+
+void AnimTests::testAnimPoseComposition() {
+    const float PI = (float)M_PI;
+    const glm::quat ROT_X_90 = glm::angleAxis(PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::quat ROT_Y_180 = glm::angleAxis(PI, glm::vec3(0.0f, 1.0, 0.0f));
+    const glm::quat ROT_Z_30 = glm::angleAxis(PI / 6.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+
+    // uniform scales take the fast path, the others the matrix one
+    std::vector<glm::vec3> scaleVec = {
+        glm::vec3(1.0f),
+        glm::vec3(2.0f),
+        glm::vec3(0.01f),
+        glm::vec3(2.0f, 0.5f, 1.5f),
+        glm::vec3(-2.0f, 0.5f, 1.5f)
+    };
+
+    std::vector<glm::quat> rotVec = {
+        glm::quat(),
+        ROT_X_90,
+        ROT_Y_180,
+        ROT_X_90 * ROT_Y_180 * ROT_Z_30,
+        -ROT_Z_30
+    };
+
+    std::vector<glm::vec3> transVec = {
+        glm::vec3(),
+        glm::vec3(10.0f, 5.0f, 7.5f),
+        glm::vec3(-1.0f, 0.5f, -0.25f)
+    };
+
+    std::vector<AnimPose> poses;
+    for (auto& scale : scaleVec) {
+        for (auto& rot : rotVec) {
+            for (auto& trans : transVec) {
+                poses.push_back(AnimPose(scale, rot, trans));
+            }
+        }
+    }
+
+    const float EPSILON = 0.001f;
+    for (auto& lhs : poses) {
+        glm::mat4 inverseMat = inverseWithMatrices(lhs);
+        QCOMPARE_WITH_ABS_ERROR((glm::mat4)lhs.inverse(), inverseMat, EPSILON);
+
+        for (auto& rhs : poses) {
+            glm::mat4 resultMat = multiplyWithMatrices(lhs, rhs);
+            AnimPose result = lhs * rhs;
+            QCOMPARE_WITH_ABS_ERROR((glm::mat4)result, resultMat, EPSILON * (1.0f + glm::length(lhs.trans())));
+
+            // rotations are not renormalized by a decomposition anymore, make sure they don't drift
+            QCOMPARE_WITH_ABS_ERROR(glm::length(result.rot()), 1.0f, EPSILON);
+        }
+    }
+}
+
+static void blendReference(int numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    for (int i = 0; i < numPoses; i++) {
+        const AnimPose& aPose = a[i];
+        const AnimPose& bPose = b[i];
+        result[i].scale() = lerp(aPose.scale(), bPose.scale(), alpha);
+        result[i].rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
+        result[i].trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+    }
+}
+
+static AnimPoseVec randomPoses(int numPoses) {
+    AnimPoseVec poses;
+    for (int i = 0; i < numPoses; i++) {
+        glm::quat rot = glm::normalize(glm::quat(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                                                 randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f)));
+        glm::vec3 scale(randFloatInRange(0.5f, 2.0f), randFloatInRange(0.5f, 2.0f), randFloatInRange(0.5f, 2.0f));
+        glm::vec3 trans(randFloatInRange(-10.0f, 10.0f), randFloatInRange(-10.0f, 10.0f), randFloatInRange(-10.0f, 10.0f));
+        poses.push_back(AnimPose(scale, rot, trans));
+    }
+    return poses;
+}
+
+void AnimTests::testBlend() {
+    const float EPSILON = 0.0001f;
+
+    // a count that isn't a multiple of the vector width, so both the vector loop and the tail run
+    const int NUM_POSES = 23;
+    AnimPoseVec a = randomPoses(NUM_POSES);
+    AnimPoseVec b = randomPoses(NUM_POSES);
+    std::vector<float> weights;
+    for (int i = 0; i < NUM_POSES; i++) {
+        weights.push_back(randFloatInRange(0.0f, 1.0f));
+    }
+
+    std::vector<float> alphas = { 0.0f, 0.25f, 0.5f, 1.0f };
+    for (float alpha : alphas) {
+        AnimPoseVec expected(NUM_POSES);
+        AnimPoseVec result(NUM_POSES);
+        blendReference(NUM_POSES, &a[0], &b[0], alpha, &expected[0]);
+        ::blend(NUM_POSES, &a[0], &b[0], alpha, &result[0]);
+        for (int i = 0; i < NUM_POSES; i++) {
+            QCOMPARE_WITH_ABS_ERROR(result[i].scale(), expected[i].scale(), EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(result[i].trans(), expected[i].trans(), EPSILON);
+            QCOMPARE_QUATS(result[i].rot(), expected[i].rot(), EPSILON);
+        }
+
+        // the weighted overload scales each alpha, as AnimOverlay does with its bone set
+        ::blend(NUM_POSES, &a[0], &b[0], alpha, &weights[0], &result[0]);
+        for (int i = 0; i < NUM_POSES; i++) {
+            blendReference(1, &a[i], &b[i], alpha * weights[i], &expected[i]);
+            QCOMPARE_WITH_ABS_ERROR(result[i].scale(), expected[i].scale(), EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(result[i].trans(), expected[i].trans(), EPSILON);
+            QCOMPARE_QUATS(result[i].rot(), expected[i].rot(), EPSILON);
+        }
+
+        // blending in place, as AnimBlendLinear does
+        AnimPoseVec inPlace = a;
+        blendReference(NUM_POSES, &a[0], &b[0], alpha, &expected[0]);
+        ::blend(NUM_POSES, &inPlace[0], &b[0], alpha, &inPlace[0]);
+        for (int i = 0; i < NUM_POSES; i++) {
+            QCOMPARE_WITH_ABS_ERROR(inPlace[i].trans(), expected[i].trans(), EPSILON);
+            QCOMPARE_QUATS(inPlace[i].rot(), expected[i].rot(), EPSILON);
+        }
+    }
+}
+
 void AnimTests::testExpressionTokenizer() {
     QString str = "(10 +  x) >= 20.1 && (y != !z)";
     AnimExpression e("x");
@@ -671,4 +861,248 @@ void AnimTests::testExpressionEvaluator() {
     TEST_BOOL_EXPR(!(true && f) && true);
 }
 
+#ifdef MANUAL_TEST
+static void collectVarNames(const QJsonValue& value, QSet<QString>& names) {
+    if (value.isArray()) {
+        for (auto element : value.toArray()) {
+            collectVarNames(element, names);
+        }
+    } else if (value.isObject()) {
+        QJsonObject object = value.toObject();
+        for (auto iter = object.begin(); iter != object.end(); ++iter) {
+            if ((iter.key() == "var" || iter.key().endsWith("Var")) && iter.value().isString()) {
+                names.insert(iter.value().toString());
+            } else {
+                collectVarNames(iter.value(), names);
+            }
+        }
+    }
+}
+
+// Evaluates the default avatar anim graph the way Rig does every frame: the vars are set, then the graph looks them up
+// as it is evaluated.  The vars are set through keys interned up front, and by name for comparison.  There is no
+// skeleton, so this measures the graph and its variables, not the poses.
+void AnimTests::benchmarkGraphEvaluation() {
+    QFileInfo source(__FILE__);
+    QString filename = QDir::cleanPath(source.absolutePath() + "/../../../interface/resources/avatar/avatar-animation.json");
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    AnimNodeLoader loader(QUrl::fromLocalFile(filename));
+    AnimNode::Pointer root = nullptr;
+    QEventLoop loop;
+    connect(&loader, &AnimNodeLoader::success, [&](AnimNode::Pointer node) { root = node; });
+    loop.connect(&loader, SIGNAL(success(AnimNode::Pointer)), SLOT(quit()));
+    loop.connect(&loader, SIGNAL(error(int, QString)), SLOT(quit()));
+    QTimer::singleShot(1000, &loop, SLOT(quit()));
+    loop.exec();
+    QVERIFY((bool)root);
+
+    QSet<QString> nameSet;
+    collectVarNames(QJsonDocument::fromJson(file.readAll()).object(), nameSet);
+    QStringList names = nameSet.toList();
+    std::vector<AnimVariantKey> keys;
+    for (const auto& name : names) {
+        keys.push_back(AnimVariantKey(name));
+    }
+
+    const int NUM_FRAMES = 10000;
+    const float DT = 1.0f / 90.0f;
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4());
+    AnimVariantMap vars;
+    AnimNode::Triggers triggers;
+
+    QElapsedTimer timer;
+    qint64 setByKeyTime = 0;
+    qint64 setByNameTime = 0;
+    qint64 evaluateTime = 0;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        // walk the state machines through their transitions
+        timer.start();
+        for (int i = 0; i < names.size(); i++) {
+            vars.set(names[i], (frame + i) % 64 == 0);
+        }
+        setByNameTime += timer.nsecsElapsed();
+
+        timer.start();
+        for (size_t i = 0; i < keys.size(); i++) {
+            vars.set(keys[i], (frame + (int)i) % 64 == 0);
+        }
+        setByKeyTime += timer.nsecsElapsed();
+
+        timer.start();
+        triggers.clear();
+        root->evaluate(vars, context, DT, triggers);
+        vars.clearTriggers();
+        for (auto& trigger : triggers) {
+            vars.setTrigger(trigger);
+        }
+        evaluateTime += timer.nsecsElapsed();
+    }
+
+    std::cout << names.size() << " vars, per avatar per frame: set by key " << setByKeyTime / NUM_FRAMES
+        << " ns (by name " << setByNameTime / NUM_FRAMES << " ns), evaluate " << evaluateTime / NUM_FRAMES << " ns"
+        << std::endl;
+}
+
+// Drives many avatars with the default anim graph and skeleton, evaluating their rigs in parallel on
+// an increasing number of threads.
+void AnimTests::benchmarkRigEvaluation() {
+    QFileInfo source(__FILE__);
+    QString resources = QDir::cleanPath(source.absolutePath() + "/../../../interface/resources");
+
+    QFile fstFile(resources + "/meshes/defaultAvatar_full.fst");
+    QVERIFY(fstFile.open(QIODevice::ReadOnly));
+    QVariantHash mapping = FSTReader::readMapping(fstFile.readAll());
+    QFile fbxFile(resources + "/meshes/" + mapping.value("filename").toString());
+    QVERIFY(fbxFile.open(QIODevice::ReadOnly));
+    std::unique_ptr<FBXGeometry> geometry(readFBX(fbxFile.readAll(), mapping, fbxFile.fileName()));
+    QVERIFY((bool)geometry);
+
+    const int NUM_RIGS = 128;
+    const float DT = 1.0f / 90.0f;
+    QUrl graphURL = QUrl::fromLocalFile(resources + "/avatar/avatar-animation.json");
+
+    std::vector<std::unique_ptr<Rig>> rigs;
+    std::vector<Rig*> rigPointers;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        rigs.emplace_back(new Rig());
+        rigs.back()->initJointStates(*geometry, glm::mat4());
+        rigs.back()->initAnimGraph(graphURL);
+        rigPointers.push_back(rigs.back().get());
+    }
+
+    // answers the time spent evaluating, the state handlers and vars are always updated serially
+    int frame = 0;
+    QElapsedTimer evaluateTimer;
+    auto simulateFrame = [&](int maxConcurrency) -> qint64 {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            // stagger the avatars so that they are idle, walking and turning at different times
+            float t = (float)(frame + i * 37) * DT;
+            glm::quat rotation = glm::angleAxis(0.5f * sinf(0.3f * t), Vectors::UNIT_Y);
+            glm::vec3 velocity = rotation * glm::vec3(0.0f, 0.0f, 1.5f * std::max(0.0f, sinf(0.7f * t)));
+            glm::vec3 position = velocity * t;
+            rigs[i]->computeMotionAnimationState(DT, position, velocity, rotation, Rig::CharacterControllerState::Ground);
+            rigs[i]->prepareAnimations(DT, glm::mat4(), glm::mat4());
+        }
+        evaluateTimer.start();
+        Rig::evaluateAnimationsInParallel(rigPointers, maxConcurrency);
+        frame++;
+        return evaluateTimer.nsecsElapsed();
+    };
+
+    // let the graph and its animations load, evaluating as they arrive
+    const qint64 LOAD_TIME = 5000;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < LOAD_TIME) {
+        QCoreApplication::processEvents();
+        simulateFrame(0);
+    }
+    for (auto& rig : rigs) {
+        QVERIFY((bool)rig->getAnimNode());
+    }
+
+    const int NUM_FRAMES = 300;
+    int maxThreads = QThread::idealThreadCount();
+    std::vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2) {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    qint64 singleThreadTime = 0;
+    for (int numThreads : threadCounts) {
+        qint64 time = 0;
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            time += simulateFrame(numThreads);
+        }
+        time /= NUM_FRAMES;
+        if (numThreads == 1) {
+            singleThreadTime = time;
+        }
+        std::cout << NUM_RIGS << " rigs on " << numThreads << " threads: " << time / 1000 << " us per frame, "
+            << time / NUM_RIGS / 1000 << " us per rig, " << (float)singleThreadTime / (float)time << "x" << std::endl;
+    }
+}
+// Compares the pose blending and hierarchy conversion of a 100 joint skeleton with the scalar and matrix
+// versions they replaced.
+void AnimTests::benchmarkPoseMath() {
+    const int NUM_JOINTS = 100;
+    const int NUM_ITERATIONS = 100000;
+
+    // a spine with limbs branching off it, like a humanoid
+    std::vector<int> parents;
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        parents.push_back(i == 0 ? -1 : (i % 5 == 0 ? i / 2 : i - 1));
+    }
 
+    // the uniform scales of an avatar's skeleton
+    AnimPoseVec a = randomPoses(NUM_JOINTS);
+    AnimPoseVec b = randomPoses(NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        a[i].scale() = glm::vec3(1.0f);
+        b[i].scale() = glm::vec3(1.0f);
+    }
+    AnimPoseVec result(NUM_JOINTS);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        blendReference(NUM_JOINTS, &a[0], &b[0], 0.3f, &result[0]);
+    }
+    qint64 scalarBlendTime = timer.nsecsElapsed();
+
+    timer.start();
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        ::blend(NUM_JOINTS, &a[0], &b[0], 0.3f, &result[0]);
+    }
+    qint64 blendTime = timer.nsecsElapsed();
+
+    // relative to absolute and back, the way AnimSkeleton converts them
+    auto convertWithMatrices = [&](AnimPoseVec& poses) {
+        for (int i = 0; i < NUM_JOINTS; i++) {
+            if (parents[i] != -1) {
+                poses[i] = multiplyWithMatrices(poses[parents[i]], poses[i]);
+            }
+        }
+        for (int i = NUM_JOINTS - 1; i >= 0; i--) {
+            if (parents[i] != -1) {
+                poses[i] = multiplyWithMatrices(inverseWithMatrices(poses[parents[i]]), poses[i]);
+            }
+        }
+    };
+    auto convert = [&](AnimPoseVec& poses) {
+        for (int i = 0; i < NUM_JOINTS; i++) {
+            if (parents[i] != -1) {
+                poses[i] = poses[parents[i]] * poses[i];
+            }
+        }
+        for (int i = NUM_JOINTS - 1; i >= 0; i--) {
+            if (parents[i] != -1) {
+                poses[i] = poses[parents[i]].inverse() * poses[i];
+            }
+        }
+    };
+
+    const int NUM_CONVERSIONS = NUM_ITERATIONS / 10;
+    result = a;
+    timer.start();
+    for (int i = 0; i < NUM_CONVERSIONS; i++) {
+        convertWithMatrices(result);
+    }
+    qint64 matrixConvertTime = timer.nsecsElapsed();
+
+    result = a;
+    timer.start();
+    for (int i = 0; i < NUM_CONVERSIONS; i++) {
+        convert(result);
+    }
+    qint64 convertTime = timer.nsecsElapsed();
+
+    std::cout << NUM_JOINTS << " joints, blend: " << scalarBlendTime / NUM_ITERATIONS << " ns before, "
+        << blendTime / NUM_ITERATIONS << " ns after" << std::endl;
+    std::cout << NUM_JOINTS << " joints, to absolute and back: " << matrixConvertTime / NUM_CONVERSIONS << " ns before, "
+        << convertTime / NUM_CONVERSIONS << " ns after" << std::endl;
+}
+#endif
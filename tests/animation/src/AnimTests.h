@@ -13,6 +13,8 @@
 #include <QtTest/QtTest>
 #include <glm/glm.hpp>
 
+//#define MANUAL_TEST
+
 class AnimTests : public QObject {
     Q_OBJECT
 public:
@@ -25,11 +27,19 @@ private slots:
     void testClipEvaulateWithVars();
     void testLoader();
     void testVariant();
+    void testVariantMap();
     void testAccumulateTime();
     void testAnimPose();
+    void testAnimPoseComposition();
+    void testBlend();
     void testExpressionTokenizer();
     void testExpressionParser();
     void testExpressionEvaluator();
+#ifdef MANUAL_TEST
+    void benchmarkGraphEvaluation();
+    void benchmarkRigEvaluation();
+    void benchmarkPoseMath();
+#endif
 };
 
 #endif // hifi_AnimTests_h
@@ -0,0 +1,214 @@
+//
+//  BlendshapeMeshesTests.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlendshapeMeshesTests.h"
+
+#include <iostream>
+
+#include <BlendshapeMeshes.h>
+#include <TBBHelpers.h>
+#include <graphics/BufferViewHelpers.h>
+
+QTEST_MAIN(BlendshapeMeshesTests)
+
+static float randomFloat() {
+    return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+}
+
+static glm::vec3 randomVec3() {
+    return glm::vec3(randomFloat(), randomFloat(), randomFloat());
+}
+
+// A mesh without blendshapes then a face whose blendshapes each move a part of its vertices
+static FBXGeometry makeGeometry(int numVertices, int numBlendshapes, int numBlendshapeVertices) {
+    FBXGeometry geometry;
+    FBXMesh body;
+    body.vertices.push_back(glm::vec3(0.0f));
+    body.normals.push_back(glm::vec3(0.0f, 1.0f, 0.0f));
+    body.tangents.push_back(glm::vec3(1.0f, 0.0f, 0.0f));
+    geometry.meshes.push_back(body);
+
+    FBXMesh face;
+    for (int i = 0; i < numVertices; i++) {
+        face.vertices.push_back(randomVec3());
+        face.normals.push_back(glm::normalize(randomVec3() + glm::vec3(0.01f)));
+        face.tangents.push_back(glm::normalize(randomVec3() + glm::vec3(0.01f)));
+    }
+    for (int i = 0; i < numBlendshapes; i++) {
+        FBXBlendshape blendshape;
+        int first = rand() % numVertices;
+        for (int j = 0; j < numBlendshapeVertices; j++) {
+            blendshape.indices.push_back((first + 3 * j) % numVertices);
+            blendshape.vertices.push_back(0.1f * randomVec3());
+            blendshape.normals.push_back(randomVec3());
+            // some blendshapes lack tangents
+            if (i % 2 == 0) {
+                blendshape.tangents.push_back(randomVec3());
+            }
+        }
+        face.blendshapes.push_back(blendshape);
+    }
+    geometry.meshes.push_back(face);
+    return geometry;
+}
+
+// What the blender computed before: the whole mesh blended then interleaved
+static void blendMesh(const FBXMesh& mesh, const QVector<float>& coefficients, QVector<glm::vec3>& vertices,
+        std::vector<NormalType>& normalsAndTangents) {
+    vertices = mesh.vertices;
+    QVector<glm::vec3> normals = mesh.normals;
+    QVector<glm::vec3> tangents = mesh.tangents;
+    const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+    for (int i = 0, n = qMin(coefficients.size(), mesh.blendshapes.size()); i < n; i++) {
+        float vertexCoefficient = coefficients.at(i);
+        const float EPSILON = 0.0001f;
+        if (vertexCoefficient < EPSILON) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
+        for (int j = 0; j < blendshape.indices.size(); j++) {
+            int index = blendshape.indices.at(j);
+            vertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
+            normals[index] += blendshape.normals.at(j) * normalCoefficient;
+            if (blendshape.tangents.size() > j) {
+                tangents[index] += blendshape.tangents.at(j) * normalCoefficient;
+            }
+        }
+    }
+    normalsAndTangents.resize(2 * normals.size());
+    for (int i = 0; i < normals.size(); i++) {
+#if FBX_PACK_NORMALS
+        buffer_helpers::packNormalAndTangent(normals[i], tangents[i], normalsAndTangents[2 * i], normalsAndTangents[2 * i + 1]);
+#else
+        normalsAndTangents[2 * i] = normals[i];
+        normalsAndTangents[2 * i + 1] = tangents[i];
+#endif
+    }
+}
+
+static QVector<float> randomCoefficients(int numBlendshapes, int numActive) {
+    QVector<float> coefficients(numBlendshapes, 0.0f);
+    for (int i = 0; i < numActive; i++) {
+        coefficients[rand() % numBlendshapes] = 0.5f * (randomFloat() + 1.0f);
+    }
+    return coefficients;
+}
+
+static void compareBlend(const FBXMesh& mesh, const BlendedVertices& blendedVertices, const QVector<float>& coefficients) {
+    QVector<glm::vec3> expectedVertices;
+    std::vector<NormalType> expectedNormalsAndTangents;
+    blendMesh(mesh, coefficients, expectedVertices, expectedNormalsAndTangents);
+    QVERIFY(blendedVertices.getVertices(1) == std::vector<glm::vec3>(expectedVertices.begin(), expectedVertices.end()));
+    QVERIFY(blendedVertices.getNormalsAndTangents(1) == expectedNormalsAndTangents);
+}
+
+void BlendshapeMeshesTests::testBlend() {
+    const int NUM_VERTICES = 20000;
+    const int NUM_BLENDSHAPES = 20;
+    FBXGeometry geometry = makeGeometry(NUM_VERTICES, NUM_BLENDSHAPES, 1000);
+    auto meshes = std::make_shared<BlendshapeMeshes>(geometry);
+    QCOMPARE(meshes->getNumMeshes(), 2);
+    QVERIFY(!meshes->isBlendshaped(0));
+    QVERIFY(meshes->isBlendshaped(1));
+
+    // a buffer blended again matches a blend of the whole mesh, however it was blended before
+    BlendedVertices blendedVertices(meshes);
+    compareBlend(geometry.meshes[1], blendedVertices, QVector<float>());
+    for (int i = 0; i < 10; i++) {
+        QVector<float> coefficients = randomCoefficients(NUM_BLENDSHAPES, i);
+        blendedVertices.blend(coefficients);
+        compareBlend(geometry.meshes[1], blendedVertices, coefficients);
+    }
+
+    // more coefficients than blendshapes
+    QVector<float> coefficients(2 * NUM_BLENDSHAPES, 1.0f);
+    blendedVertices.blend(coefficients);
+    compareBlend(geometry.meshes[1], blendedVertices, coefficients);
+
+    blendedVertices.blend(QVector<float>());
+    compareBlend(geometry.meshes[1], blendedVertices, QVector<float>());
+}
+
+void BlendshapeMeshesTests::testBlendRanges() {
+    const int NUM_VERTICES = 1000;
+    FBXGeometry geometry = makeGeometry(NUM_VERTICES, 2, 10);
+    auto meshes = std::make_shared<BlendshapeMeshes>(geometry);
+    BlendedVertices blendedVertices(meshes);
+    QVERIFY(blendedVertices.getBlendedBegin(1) >= blendedVertices.getBlendedEnd(1));
+
+    // the range covers the vertices the active blendshapes move, and only those
+    blendedVertices.blend({ 0.0f, 1.0f });
+    const QVector<int>& indices = geometry.meshes[1].blendshapes[1].indices;
+    QCOMPARE(blendedVertices.getBlendedBegin(1), *std::min_element(indices.begin(), indices.end()));
+    QCOMPARE(blendedVertices.getBlendedEnd(1), *std::max_element(indices.begin(), indices.end()) + 1);
+    const auto& vertices = blendedVertices.getVertices(1);
+    for (int i = 0; i < NUM_VERTICES; i++) {
+        if (i < blendedVertices.getBlendedBegin(1) || i >= blendedVertices.getBlendedEnd(1)) {
+            QVERIFY(vertices[i] == geometry.meshes[1].vertices[i]);
+        }
+    }
+
+    blendedVertices.blend({ 0.0f, 0.0f });
+    QVERIFY(blendedVertices.getBlendedBegin(1) >= blendedVertices.getBlendedEnd(1));
+}
+
+#ifdef MANUAL_TEST
+
+void BlendshapeMeshesTests::benchmarkAvatars() {
+    // faces of a few thousand vertices, a handful of their blendshapes active at once
+    const int NUM_AVATARS = 50;
+    const int NUM_VERTICES = 5000;
+    const int NUM_BLENDSHAPES = 50;
+    const int NUM_ACTIVE_BLENDSHAPES = 8;
+    const int NUM_FRAMES = 20;
+    std::vector<FBXGeometry> geometries;
+    std::vector<BlendedVerticesPointer> blendedVertices;
+    std::vector<QVector<float>> coefficients;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        geometries.push_back(makeGeometry(NUM_VERTICES, NUM_BLENDSHAPES, 300));
+        blendedVertices.push_back(std::make_shared<BlendedVertices>(std::make_shared<BlendshapeMeshes>(geometries.back())));
+        coefficients.push_back(randomCoefficients(NUM_BLENDSHAPES, NUM_ACTIVE_BLENDSHAPES));
+    }
+    std::vector<QVector<glm::vec3>> vertices(NUM_AVATARS);
+    std::vector<std::vector<NormalType>> normalsAndTangents(NUM_AVATARS);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            blendMesh(geometries[i].meshes[1], coefficients[i], vertices[i], normalsAndTangents[i]);
+        }
+    }
+    auto wholeMeshTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            blendedVertices[i]->blend(coefficients[i]);
+        }
+    }
+    auto sparseTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        tbb::parallel_for(0, NUM_AVATARS, [&](int i) {
+            blendedVertices[i]->blend(coefficients[i]);
+        });
+    }
+    auto sparseParallelTime = timer.nsecsElapsed();
+
+    const qint64 NSECS_PER_USEC = 1000;
+    std::cout << NUM_AVATARS << " avatars of " << NUM_VERTICES << " vertices, usecs per frame:"
+        << "  whole meshes " << wholeMeshTime / NUM_FRAMES / NSECS_PER_USEC
+        << ", moved vertices " << sparseTime / NUM_FRAMES / NSECS_PER_USEC
+        << ", moved vertices in parallel " << sparseParallelTime / NUM_FRAMES / NSECS_PER_USEC << std::endl;
+}
+
+#endif // MANUAL_TEST
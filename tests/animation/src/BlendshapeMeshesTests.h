@@ -0,0 +1,28 @@
+//
+//  BlendshapeMeshesTests.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlendshapeMeshesTests_h
+#define hifi_BlendshapeMeshesTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class BlendshapeMeshesTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBlend();
+    void testBlendRanges();
+#ifdef MANUAL_TEST
+    void benchmarkAvatars();
+#endif
+};
+
+#endif // hifi_BlendshapeMeshesTests_h
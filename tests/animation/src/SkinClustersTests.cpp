@@ -0,0 +1,246 @@
+//
+//  SkinClustersTests.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SkinClustersTests.h"
+
+#include <iostream>
+
+#include <GLMHelpers.h>
+#include <SkinClusters.h>
+#include <TBBHelpers.h>
+
+QTEST_MAIN(SkinClustersTests)
+
+static float randomFloat() {
+    return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+}
+
+static glm::quat randomRotation() {
+    return glm::angleAxis(3.0f * randomFloat(), glm::normalize(glm::vec3(randomFloat(), randomFloat(), randomFloat()) + glm::vec3(0.01f)));
+}
+
+static glm::vec3 randomVec3() {
+    return glm::vec3(randomFloat(), randomFloat(), randomFloat());
+}
+
+// Meshes skinned to every other joint, and a cluster bound to a joint the rig doesn't have
+static FBXGeometry makeGeometry(int numMeshes, int numJoints) {
+    FBXGeometry geometry;
+    for (int i = 0; i < numMeshes; i++) {
+        FBXMesh mesh;
+        for (int joint = i % 2; joint < numJoints; joint += 2) {
+            FBXCluster cluster;
+            cluster.jointIndex = joint;
+            cluster.inverseBindTransform = Transform(randomRotation(), glm::vec3(1.0f + 0.5f * randomFloat()), 10.0f * randomVec3());
+            cluster.inverseBindMatrix = cluster.inverseBindTransform.getMatrix();
+            mesh.clusters.push_back(cluster);
+        }
+        FBXCluster missing;
+        missing.jointIndex = numJoints;
+        missing.inverseBindTransform = Transform(randomRotation(), glm::vec3(1.0f), randomVec3());
+        missing.inverseBindMatrix = missing.inverseBindTransform.getMatrix();
+        mesh.clusters.push_back(missing);
+        geometry.meshes.push_back(mesh);
+    }
+    return geometry;
+}
+
+static AnimPoseVec makeJointPoses(int numJoints) {
+    AnimPoseVec poses(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        poses[i] = AnimPose(glm::vec3(1.0f + 0.2f * randomFloat()), randomRotation(), 10.0f * randomVec3());
+    }
+    // a non uniformly scaled joint
+    poses[numJoints / 2].scale() = glm::vec3(1.0f, 2.0f, 0.5f);
+    return poses;
+}
+
+static const AnimPose& getJointPose(const AnimPoseVec& poses, int joint) {
+    return (joint >= 0 && joint < (int)poses.size()) ? poses[joint] : AnimPose::identity;
+}
+
+void SkinClustersTests::testMatrices() {
+    const int NUM_MESHES = 3;
+    const int NUM_JOINTS = 40;
+    FBXGeometry geometry = makeGeometry(NUM_MESHES, NUM_JOINTS);
+    AnimPoseVec jointPoses = makeJointPoses(NUM_JOINTS);
+
+    SkinClusters clusters(geometry);
+    QCOMPARE(clusters.getNumMeshes(), NUM_MESHES);
+    std::vector<glm::mat4> jointMatrices;
+    SkinClusters::evalJointMatrices(jointPoses, jointMatrices);
+
+    for (int i = 0; i < NUM_MESHES; i++) {
+        const FBXMesh& mesh = geometry.meshes[i];
+        std::vector<glm::mat4> clusterMatrices(mesh.clusters.size());
+        clusters.computeMatrices(i, jointMatrices, clusterMatrices.data());
+        for (int j = 0; j < mesh.clusters.size(); j++) {
+            glm::mat4 expected;
+            glm_mat4u_mul(glm::mat4(getJointPose(jointPoses, mesh.clusters[j].jointIndex)), mesh.clusters[j].inverseBindMatrix, expected);
+            QCOMPARE(clusterMatrices[j], expected);
+        }
+    }
+}
+
+void SkinClustersTests::testPoses() {
+    const int NUM_MESHES = 3;
+    const int NUM_JOINTS = 40;
+    FBXGeometry geometry = makeGeometry(NUM_MESHES, NUM_JOINTS);
+    AnimPoseVec jointPoses = makeJointPoses(NUM_JOINTS);
+
+    SkinClusters clusters(geometry);
+    SkinClusters::Poses poses;
+    clusters.computePoses(jointPoses, poses);
+    // only the clusters of the non uniformly scaled joint leave the batched path
+    size_t numNonUniformClusters = 0;
+    for (const FBXMesh& mesh : geometry.meshes) {
+        for (const FBXCluster& cluster : mesh.clusters) {
+            if (cluster.jointIndex == NUM_JOINTS / 2) {
+                numNonUniformClusters++;
+            }
+        }
+    }
+    QCOMPARE(poses.nonUniformClusters.size(), numNonUniformClusters);
+
+    // the same transforms as composing the joint and inverse bind Transforms
+    const float EPSILON = 0.001f;
+    for (int i = 0; i < NUM_MESHES; i++) {
+        const FBXMesh& mesh = geometry.meshes[i];
+        int offset = clusters.getMeshOffset(i);
+        for (int j = 0; j < mesh.clusters.size(); j++) {
+            const AnimPose& jointPose = getJointPose(jointPoses, mesh.clusters[j].jointIndex);
+            Transform jointTransform(jointPose.rot(), jointPose.scale(), jointPose.trans());
+            Transform expected;
+            Transform::mult(expected, jointTransform, mesh.clusters[j].inverseBindTransform);
+
+            glm::mat4 expectedMatrix = createMatFromScaleQuatAndPos(expected.getScale(), expected.getRotation(), expected.getTranslation());
+            glm::mat4 matrix = createMatFromScaleQuatAndPos(poses.getScale(offset + j), poses.getRotation(offset + j),
+                poses.getTranslation(offset + j));
+            for (int column = 0; column < 4; column++) {
+                QVERIFY(glm::length(matrix[column] - expectedMatrix[column]) < EPSILON * glm::length(expectedMatrix[column]) + EPSILON);
+            }
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+
+// what Model::updateClusterMatrices() computed for each cluster before
+static void computeDualQuaternionsPerCluster(const FBXGeometry& geometry, const AnimPoseVec& jointPoses, std::vector<glm::vec3>& scales,
+        std::vector<glm::quat>& rotations, std::vector<glm::vec3>& translations) {
+    int k = 0;
+    for (const FBXMesh& mesh : geometry.meshes) {
+        for (const FBXCluster& cluster : mesh.clusters) {
+            const AnimPose& jointPose = getJointPose(jointPoses, cluster.jointIndex);
+            Transform jointTransform(jointPose.rot(), jointPose.scale(), jointPose.trans());
+            Transform clusterTransform;
+            Transform::mult(clusterTransform, jointTransform, cluster.inverseBindTransform);
+            scales[k] = clusterTransform.getScale();
+            rotations[k] = clusterTransform.getRotation();
+            translations[k] = clusterTransform.getTranslation();
+            k++;
+        }
+    }
+}
+
+static void computeMatricesPerCluster(const FBXGeometry& geometry, const AnimPoseVec& jointPoses, std::vector<glm::mat4>& matrices) {
+    int k = 0;
+    for (const FBXMesh& mesh : geometry.meshes) {
+        for (const FBXCluster& cluster : mesh.clusters) {
+            glm_mat4u_mul(glm::mat4(getJointPose(jointPoses, cluster.jointIndex)), cluster.inverseBindMatrix, matrices[k++]);
+        }
+    }
+}
+
+void SkinClustersTests::benchmarkAvatars() {
+    // avatars with a body, a head and clothes skinned to a typical skeleton
+    const int NUM_AVATARS = 200;
+    const int NUM_MESHES = 5;
+    const int NUM_JOINTS = 100;
+    const int NUM_FRAMES = 20;
+    FBXGeometry geometry = makeGeometry(NUM_MESHES, NUM_JOINTS);
+    SkinClusters clusters(geometry);
+    std::vector<AnimPoseVec> jointPoses;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        jointPoses.push_back(makeJointPoses(NUM_JOINTS));
+    }
+    int numClusters = clusters.getNumClusters();
+
+    std::vector<std::vector<glm::mat4>> matrices(NUM_AVATARS, std::vector<glm::mat4>(numClusters));
+    std::vector<std::vector<glm::vec3>> scales(NUM_AVATARS, std::vector<glm::vec3>(numClusters));
+    std::vector<std::vector<glm::quat>> rotations(NUM_AVATARS, std::vector<glm::quat>(numClusters));
+    std::vector<std::vector<glm::vec3>> translations(NUM_AVATARS, std::vector<glm::vec3>(numClusters));
+    std::vector<std::vector<glm::mat4>> jointMatrices(NUM_AVATARS);
+    std::vector<SkinClusters::Poses> poses(NUM_AVATARS);
+
+    auto computeMatrices = [&](int avatar) {
+        SkinClusters::evalJointMatrices(jointPoses[avatar], jointMatrices[avatar]);
+        for (int mesh = 0; mesh < NUM_MESHES; mesh++) {
+            clusters.computeMatrices(mesh, jointMatrices[avatar], &matrices[avatar][clusters.getMeshOffset(mesh)]);
+        }
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            computeMatricesPerCluster(geometry, jointPoses[i], matrices[i]);
+        }
+    }
+    auto matricesPerClusterTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            computeMatrices(i);
+        }
+    }
+    auto matricesTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        tbb::parallel_for(0, NUM_AVATARS, computeMatrices);
+    }
+    auto matricesParallelTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            computeDualQuaternionsPerCluster(geometry, jointPoses[i], scales[i], rotations[i], translations[i]);
+        }
+    }
+    auto posesPerClusterTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            clusters.computePoses(jointPoses[i], poses[i]);
+        }
+    }
+    auto posesTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        tbb::parallel_for(0, NUM_AVATARS, [&](int i) {
+            clusters.computePoses(jointPoses[i], poses[i]);
+        });
+    }
+    auto posesParallelTime = timer.nsecsElapsed();
+
+    const qint64 NSECS_PER_USEC = 1000;
+    std::cout << NUM_AVATARS << " avatars of " << numClusters << " clusters, usecs per frame:" << std::endl;
+    std::cout << "  matrices: per cluster " << matricesPerClusterTime / NUM_FRAMES / NSECS_PER_USEC
+        << ", batched " << matricesTime / NUM_FRAMES / NSECS_PER_USEC
+        << ", batched in parallel " << matricesParallelTime / NUM_FRAMES / NSECS_PER_USEC << std::endl;
+    std::cout << "  dual quaternions: per cluster " << posesPerClusterTime / NUM_FRAMES / NSECS_PER_USEC
+        << ", batched " << posesTime / NUM_FRAMES / NSECS_PER_USEC
+        << ", batched in parallel " << posesParallelTime / NUM_FRAMES / NSECS_PER_USEC << std::endl;
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,28 @@
+//
+//  SkinClustersTests.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SkinClustersTests_h
+#define hifi_SkinClustersTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class SkinClustersTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testMatrices();
+    void testPoses();
+#ifdef MANUAL_TEST
+    void benchmarkAvatars();
+#endif
+};
+
+#endif // hifi_SkinClustersTests_h
@@ -0,0 +1,151 @@
+//
+//  BatchTests.cpp
+//  tests/gpu/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BatchTests.h"
+
+#include <iostream>
+
+#include <SharedUtil.h>
+#include <gpu/Context.h>
+#include <gpu/null/NullBackend.h>
+
+QTEST_MAIN(BatchTests)
+
+// the draws of a sub batch have its index as start vertex, and their order in it as number of vertices
+static void recordDraws(gpu::Batch& batch, size_t index, size_t numDraws) {
+    for (size_t i = 0; i < numDraws; ++i) {
+        batch.setModelTransform(Transform());
+        batch.draw(gpu::TRIANGLES, (gpu::uint32)i, (gpu::uint32)index);
+    }
+}
+
+void BatchTests::initTestCase() {
+    gpu::Context::init<gpu::null::Backend>();
+}
+
+void BatchTests::testRecordFrameBatches() {
+    auto context = std::make_shared<gpu::Context>();
+    const size_t NUM_BATCHES = 32;
+    const size_t NUM_DRAWS = 100;
+
+    context->beginFrame();
+    gpu::doInBatch("BatchTests::begin", context, [&](gpu::Batch& batch) {
+        batch.resetStages();
+    });
+    context->recordFrameBatches("BatchTests::record", NUM_BATCHES, [&](gpu::Batch& batch, size_t index) {
+        recordDraws(batch, index, NUM_DRAWS + index);
+    });
+    auto frame = context->endFrame();
+
+    // the sub batches come in order, after the batch appended before them
+    QCOMPARE(frame->batches.size(), NUM_BATCHES + 1);
+    QCOMPARE(frame->batches[0].getCommands().size(), (size_t)1);
+    for (size_t index = 0; index < NUM_BATCHES; ++index) {
+        const auto& batch = frame->batches[index + 1];
+        size_t numDraws = NUM_DRAWS + index;
+        QCOMPARE(batch.getCommands().size(), 2 * numDraws);
+        QCOMPARE(batch._drawCallInfos.size(), numDraws);
+        for (size_t i = 0; i < numDraws; ++i) {
+            QCOMPARE(batch.getCommands()[2 * i + 1], gpu::Batch::COMMAND_draw);
+            auto offset = batch.getCommandOffsets()[2 * i + 1];
+            QCOMPARE(batch.getParams()[offset]._uint, (gpu::uint32)index);
+            QCOMPARE(batch.getParams()[offset + 1]._uint, (gpu::uint32)i);
+        }
+    }
+
+    context->executeFrame(frame);
+}
+
+void BatchTests::testStorageRecycled() {
+    const size_t NUM_DRAWS = 5000;
+    size_t numCommands = 0;
+    {
+        gpu::Batch batch("BatchTests::first");
+        recordDraws(batch, 0, NUM_DRAWS);
+        numCommands = batch.getCommands().size();
+    }
+
+    // the next batch records in the storage of the previous one, without growing it
+    gpu::Batch batch("BatchTests::second");
+    QVERIFY(batch.getCommands().empty());
+    QVERIFY(batch.getParams().empty());
+    QVERIFY(batch._commands.capacity() >= numCommands);
+    QVERIFY(batch._params.capacity() >= 3 * NUM_DRAWS);
+}
+
+void BatchTests::testNamedCallsInstanced() {
+    auto context = std::make_shared<gpu::Context>();
+    const size_t NUM_MESHES = 3;
+    const size_t NUM_INSTANCES = 100;
+
+    // the instances of the same mesh share a named call, whatever the order they are recorded in
+    context->beginFrame();
+    gpu::doInBatch("BatchTests::instanced", context, [&](gpu::Batch& batch) {
+        for (size_t i = 0; i < NUM_INSTANCES; ++i) {
+            size_t mesh = i % NUM_MESHES;
+            batch.setModelTransform(Transform().setTranslation(glm::vec3((float)i)));
+            batch.setupNamedCalls("mesh_" + std::to_string(mesh), [mesh](gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+                batch.drawIndexedInstanced((gpu::uint32)data.count(), gpu::TRIANGLES, 36, (gpu::uint32)mesh);
+            });
+        }
+    });
+    auto frame = context->endFrame();
+
+    const auto& batch = frame->batches[0];
+    size_t numInstances = 0;
+    size_t numDraws = 0;
+    for (size_t i = 0; i < batch.getCommands().size(); ++i) {
+        if (batch.getCommands()[i] == gpu::Batch::COMMAND_drawIndexedInstanced) {
+            ++numDraws;
+            numInstances += batch.getParams()[batch.getCommandOffsets()[i] + 4]._uint;
+        }
+    }
+    QCOMPARE(numDraws, NUM_MESHES);
+    QCOMPARE(numInstances, NUM_INSTANCES);
+    QCOMPARE(batch._namedData.size(), NUM_MESHES);
+    for (const auto& namedData : batch._namedData) {
+        QCOMPARE(namedData.second.count(), NUM_INSTANCES / NUM_MESHES + (namedData.first == "mesh_0" ? 1 : 0));
+    }
+
+    context->executeFrame(frame);
+}
+
+#ifdef MANUAL_TEST
+
+void BatchTests::benchmark() {
+    auto context = std::make_shared<gpu::Context>();
+    const int NUM_FRAMES = 20;
+    const size_t NUM_DRAWS = 200000;
+    for (size_t numBatches : { 1, 2, 4, 8, 16 }) {
+        uint64_t singleTime = 0;
+        uint64_t parallelTime = 0;
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            context->beginFrame();
+            uint64_t start = usecTimestampNow();
+            gpu::doInBatch("BatchTests::single", context, [&](gpu::Batch& batch) {
+                recordDraws(batch, 0, NUM_DRAWS);
+            });
+            singleTime += usecTimestampNow() - start;
+
+            start = usecTimestampNow();
+            context->recordFrameBatches("BatchTests::parallel", numBatches, [&](gpu::Batch& batch, size_t index) {
+                recordDraws(batch, index, NUM_DRAWS / numBatches);
+            });
+            parallelTime += usecTimestampNow() - start;
+            context->executeFrame(context->endFrame());
+        }
+
+        std::cout << NUM_DRAWS << " draws:"
+            << "  1 batch = " << (singleTime / NUM_FRAMES) << " usec"
+            << "  " << numBatches << " parallel batches = " << (parallelTime / NUM_FRAMES) << " usec" << std::endl;
+    }
+}
+
+#endif // MANUAL_TEST
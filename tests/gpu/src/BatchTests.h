@@ -0,0 +1,31 @@
+//
+//  BatchTests.h
+//  tests/gpu/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_gpu_BatchTests_h
+#define hifi_gpu_BatchTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class BatchTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testRecordFrameBatches();
+    void testStorageRecycled();
+    void testNamedCallsInstanced();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_gpu_BatchTests_h
@@ -0,0 +1,226 @@
+//
+//  ImageKernelsTests.cpp
+//  tests/ktx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageKernelsTests.h"
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/qrgb.h>
+#include <QtTest/QtTest>
+
+#include <CPUDetect.h>
+#include <image/ImageKernels.h>
+
+QTEST_GUILESS_MAIN(ImageKernelsTests)
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define HAS_SIMD_KERNELS
+#endif
+
+// odd sizes so that every kernel runs its scalar tail as well as its vector loop
+static const int TEST_WIDTHS[] = { 1, 2, 3, 8, 9, 17, 18, 33, 257 };
+
+static std::vector<uint8_t> randomBytes(std::mt19937& random, int count) {
+    std::vector<uint8_t> bytes(count);
+    for (auto& byte : bytes) {
+        byte = (uint8_t)random();
+    }
+    return bytes;
+}
+
+void ImageKernelsTests::countAlpha() {
+    std::mt19937 random(1);
+    for (int width : TEST_WIDTHS) {
+        std::vector<uint32_t> pixels(width);
+        for (auto& pixel : pixels) {
+            // a mix of opaque, transparent and translucent pixels
+            uint32_t kind = random() % 3;
+            uint32_t alpha = kind == 0 ? 0 : (kind == 1 ? 255 : 1 + random() % 254);
+            pixel = (alpha << 24) | (random() & 0xffffff);
+        }
+
+        int refOpaques = 0, refTranslucents = 0;
+        image::countAlphaRow_ref(pixels.data(), width, refOpaques, refTranslucents);
+#ifdef HAS_SIMD_KERNELS
+        int opaques = 0, translucents = 0;
+        image::countAlphaRow_SSE2(pixels.data(), width, opaques, translucents);
+        QCOMPARE(opaques, refOpaques);
+        QCOMPARE(translucents, refTranslucents);
+        if (cpuSupportsAVX2()) {
+            opaques = 0, translucents = 0;
+            image::countAlphaRow_AVX2(pixels.data(), width, opaques, translucents);
+            QCOMPARE(opaques, refOpaques);
+            QCOMPARE(translucents, refTranslucents);
+        }
+#endif
+    }
+}
+
+void ImageKernelsTests::bumpToNormal() {
+    std::mt19937 random(2);
+    for (int width : TEST_WIDTHS) {
+        // random heights, then the extremes where the derivatives are largest
+        std::vector<std::vector<uint8_t>> rows { randomBytes(random, width), randomBytes(random, width),
+                                                 randomBytes(random, width), std::vector<uint8_t>(width, 0),
+                                                 std::vector<uint8_t>(width, 255) };
+        for (size_t i = 0; i + 2 < rows.size(); ++i) {
+            const uint8_t* prev = rows[i].data();
+            const uint8_t* row = rows[i + 1].data();
+            const uint8_t* next = rows[i + 2].data();
+
+            std::vector<uint32_t> reference(width);
+            image::bumpToNormalRow_ref(prev, row, next, reference.data(), width);
+
+            // the reference matches the per pixel floating point filter it replaced
+            for (int x = 0; x < width; ++x) {
+                int left = std::max(x - 1, 0);
+                int right = std::min(x + 1, width - 1);
+                double dX = (next[left] + 2.0 * next[x] + next[right]) - (prev[left] + 2.0 * prev[x] + prev[right]);
+                double dY = (prev[right] + 2.0 * row[right] + next[right]) - (prev[left] + 2.0 * row[left] + next[left]);
+                glm::vec3 v(dX, dY, 255.0 / 2.0);
+                auto mapComponent = [](double value) { return (value + 1.0) * (255.0 / 2.0); };
+                QRgb expected = qRgba(mapComponent(v.z), mapComponent(v.y), mapComponent(v.x), 1.0);
+                QCOMPARE(reference[x], (uint32_t)expected);
+            }
+
+#ifdef HAS_SIMD_KERNELS
+            std::vector<uint32_t> normals(width);
+            image::bumpToNormalRow_SSE2(prev, row, next, normals.data(), width);
+            QVERIFY(normals == reference);
+            if (cpuSupportsAVX2()) {
+                image::bumpToNormalRow_AVX2(prev, row, next, normals.data(), width);
+                QVERIFY(normals == reference);
+            }
+#endif
+        }
+    }
+}
+
+void ImageKernelsTests::packR11G11B10F() {
+    std::mt19937 random(3);
+    std::vector<float> values;
+    // arbitrary bit patterns, including NaNs, infinities and denormals
+    for (int i = 0; i < 3000; ++i) {
+        uint32_t bits = random();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        values.push_back(value);
+    }
+    std::uniform_real_distribution<float> range(-1.0f, 70000.0f);
+    for (int i = 0; i < 3000; ++i) {
+        values.push_back(range(random));
+    }
+    const float SPECIAL_VALUES[] = { 0.0f, -0.0f, 6.09e-5f, 6.10e-5f, 6.11e-5f, 6.50e4f, 1.0e9f, -1.0e9f,
+                                     std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                                     std::numeric_limits<float>::quiet_NaN(), 1.0f, 0.5f };
+    for (int i = 0; i < 12; ++i) {
+        values.insert(values.end(), std::begin(SPECIAL_VALUES), std::end(SPECIAL_VALUES));
+    }
+    values.resize(values.size() - values.size() % 3);
+    int count = (int)values.size() / 3;
+
+    std::vector<uint32_t> reference(count);
+    image::packR11G11B10FRow_ref(values.data(), reference.data(), count);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(reference[i], image::packR11G11B10F(glm::vec3(values[3 * i], values[3 * i + 1], values[3 * i + 2])));
+    }
+
+#ifdef HAS_SIMD_KERNELS
+    // start at an odd texel so the loads are unaligned and the tail is exercised
+    std::vector<uint32_t> packed(count - 1);
+    image::packR11G11B10FRow_SSE2(values.data() + 3, packed.data(), count - 1);
+    QVERIFY(std::equal(packed.begin(), packed.end(), reference.begin() + 1));
+    if (cpuSupportsAVX2()) {
+        image::packR11G11B10FRow_AVX2(values.data() + 3, packed.data(), count - 1);
+        QVERIFY(std::equal(packed.begin(), packed.end(), reference.begin() + 1));
+    }
+#endif
+}
+
+void ImageKernelsTests::convertToR11G11B10F() {
+    std::mt19937 random(4);
+    const int COUNT = 1027;
+    std::vector<uint32_t> pixels(COUNT);
+    for (auto& pixel : pixels) {
+        pixel = random();
+    }
+
+    std::vector<uint32_t> reference(COUNT);
+    image::convertToR11G11B10FRow_ref(pixels.data(), reference.data(), COUNT);
+
+    // the tables match the per pixel conversion they replaced
+    for (int i = 0; i < COUNT; ++i) {
+        glm::vec3 color(qRed(pixels[i]), qGreen(pixels[i]), qBlue(pixels[i]));
+        color /= 255.0f;
+        color.r = powf(color.r, 2.2f);
+        color.g = powf(color.g, 2.2f);
+        color.b = powf(color.b, 2.2f);
+        QCOMPARE(reference[i], image::packR11G11B10F(color));
+    }
+
+#ifdef HAS_SIMD_KERNELS
+    if (cpuSupportsAVX2()) {
+        std::vector<uint32_t> packed(COUNT);
+        image::convertToR11G11B10FRow_AVX2(pixels.data(), packed.data(), COUNT);
+        QVERIFY(packed == reference);
+    }
+#endif
+}
+
+void ImageKernelsTests::kernelBenchmarks() {
+#ifdef MANUAL_TEST
+    const int WIDTH = 4096;
+    const int ROWS = 1024;
+    std::mt19937 random(5);
+
+    std::vector<uint32_t> pixels(WIDTH);
+    for (auto& pixel : pixels) {
+        pixel = random();
+    }
+    std::vector<uint8_t> heights = randomBytes(random, WIDTH * 3);
+    std::vector<float> rgb(WIDTH * 3);
+    for (auto& value : rgb) {
+        value = (float)(random() % 65536) / 256.0f;
+    }
+    std::vector<uint32_t> output(WIDTH);
+
+    auto time = [&](const char* name, std::function<void()> kernel) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int row = 0; row < ROWS; ++row) {
+            kernel();
+        }
+        qint64 nsecs = timer.nsecsElapsed();
+        std::cout << name << ": " << (float)nsecs / (float)(WIDTH * ROWS) << " nsec/texel" << std::endl;
+    };
+
+    int opaques = 0, translucents = 0;
+    time("countAlphaRow_ref", [&] { image::countAlphaRow_ref(pixels.data(), WIDTH, opaques, translucents); });
+    time("countAlphaRow", [&] { image::countAlphaRow(pixels.data(), WIDTH, opaques, translucents); });
+
+    const uint8_t* prev = heights.data();
+    const uint8_t* row = prev + WIDTH;
+    const uint8_t* next = row + WIDTH;
+    time("bumpToNormalRow_ref", [&] { image::bumpToNormalRow_ref(prev, row, next, output.data(), WIDTH); });
+    time("bumpToNormalRow", [&] { image::bumpToNormalRow(prev, row, next, output.data(), WIDTH); });
+
+    time("packR11G11B10FRow_ref", [&] { image::packR11G11B10FRow_ref(rgb.data(), output.data(), WIDTH); });
+    time("packR11G11B10FRow", [&] { image::packR11G11B10FRow(rgb.data(), output.data(), WIDTH); });
+
+    time("convertToR11G11B10FRow_ref", [&] { image::convertToR11G11B10FRow_ref(pixels.data(), output.data(), WIDTH); });
+    time("convertToR11G11B10FRow", [&] { image::convertToR11G11B10FRow(pixels.data(), output.data(), WIDTH); });
+#endif
+}
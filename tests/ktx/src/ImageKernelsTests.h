@@ -0,0 +1,28 @@
+//
+//  ImageKernelsTests.h
+//  tests/ktx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ImageKernelsTests_h
+#define hifi_ImageKernelsTests_h
+
+#include <QtCore/QObject>
+
+//#define MANUAL_TEST
+
+class ImageKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void countAlpha();
+    void bumpToNormal();
+    void packR11G11B10F();
+    void convertToR11G11B10F();
+    void kernelBenchmarks();
+};
+
+#endif // hifi_ImageKernelsTests_h
@@ -8,6 +8,8 @@
 
 #include "KtxTests.h"
 
+#include <algorithm>
+#include <iostream>
 #include <mutex>
 
 #include <QtTest/QtTest>
@@ -15,6 +17,7 @@
 #include <ktx/KTX.h>
 #include <gpu/Texture.h>
 #include <image/Image.h>
+#include <SharedUtil.h>
 
 
 QTEST_GUILESS_MAIN(KtxTests)
@@ -140,6 +143,169 @@ void KtxTests::testKtxSerialization() {
     testTexture->setKtxBacking(TEST_IMAGE_KTX.fileName().toStdString());
 }
 
+static void writeKtxFile(const gpu::TexturePointer& texture, const QString& filename) {
+    auto ktxMemory = gpu::Texture::serialize(*texture);
+    QVERIFY(ktxMemory.get());
+    const auto& ktxStorage = ktxMemory->getStorage();
+    QFile file(filename);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    QCOMPARE(file.write(reinterpret_cast<const char*>(ktxStorage->data()), ktxStorage->size()), (qint64)ktxStorage->size());
+}
+
+void KtxTests::testKtxReader() {
+    const QString TEST_IMAGE = getRootPath() + "/scripts/developer/tests/cube_texture.png";
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // a horizontal cross, so it loads as a cube map
+    QImage cross(256, 192, QImage::Format_ARGB32);
+    for (int y = 0; y < cross.height(); ++y) {
+        for (int x = 0; x < cross.width(); ++x) {
+            cross.setPixel(x, y, qRgba(x & 0xff, y & 0xff, (x ^ y) & 0xff, 255));
+        }
+    }
+
+    std::vector<gpu::TexturePointer> textures {
+        image::TextureUsage::process2DTextureColorFromImage(QImage(TEST_IMAGE), TEST_IMAGE.toStdString(), true, false),
+        image::TextureUsage::processCubeTextureColorFromImage(std::move(cross), "cross", false, false)
+    };
+
+    for (size_t i = 0; i < textures.size(); ++i) {
+        QVERIFY(textures[i]);
+        const QString filename = dir.filePath(QString("test%1.ktx").arg(i));
+        writeKtxFile(textures[i], filename);
+
+        // the reader must find the same layout as parsing the whole file
+        auto ktxFile = ktx::KTX::create(std::make_shared<storage::FileStorage>(filename));
+        QVERIFY(ktxFile.get());
+        auto reader = ktx::KTXReader::open(filename.toStdString());
+        QVERIFY(reader.get());
+
+        const auto expected = ktxFile->toDescriptor();
+        const auto& descriptor = reader->getDescriptor();
+        QVERIFY(0 == memcmp(&expected.header, &descriptor.header, sizeof(ktx::Header)));
+        QCOMPARE(descriptor.keyValues.size(), expected.keyValues.size());
+        QCOMPARE(descriptor.images.size(), expected.images.size());
+        for (size_t level = 0; level < expected.images.size(); ++level) {
+            const auto& expectedImage = expected.images[level];
+            const auto& image = descriptor.images[level];
+            QCOMPARE(image._numFaces, expectedImage._numFaces);
+            QCOMPARE(image._imageOffset, expectedImage._imageOffset);
+            QCOMPARE(image._imageSize, expectedImage._imageSize);
+            QCOMPARE(image._faceSize, expectedImage._faceSize);
+            QCOMPARE(image._padding, expectedImage._padding);
+            QVERIFY(image._faceOffsets == expectedImage._faceOffsets);
+
+            for (uint8_t face = 0; face < image._numFaces; ++face) {
+                auto texels = reader->getMipFaceTexelsData(level, face);
+                QVERIFY(texels.get());
+                auto lazy = std::dynamic_pointer_cast<const storage::LazyFileStorage>(texels);
+                QVERIFY(lazy.get());
+                QVERIFY(!lazy->isMapped());
+
+                auto expectedTexels = ktxFile->getMipFaceTexelsData(level, face);
+                QCOMPARE(texels->size(), expectedTexels->size());
+                QVERIFY(0 == memcmp(texels->data(), expectedTexels->data(), texels->size()));
+                QVERIFY(lazy->isMapped());
+            }
+        }
+        QVERIFY(!reader->getMipFaceTexelsData((uint16_t)expected.images.size(), 0));
+    }
+
+    // truncated files are rejected rather than exposing mips past the end
+    const QString truncated = dir.filePath("truncated.ktx");
+    QVERIFY(QFile::copy(dir.filePath("test0.ktx"), truncated));
+    QFile file(truncated);
+    QVERIFY(file.resize(file.size() - 8));
+    QVERIFY(!ktx::KTXReader::open(truncated.toStdString()));
+}
+
+#ifdef MANUAL_TEST
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+static const uint64_t BYTES_PER_MEGABYTE = 1024 * 1024;
+
+static uint64_t getResidentMemory() {
+#if defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (statm.open(QFile::ReadOnly)) {
+        auto fields = QString(statm.readAll()).split(' ');
+        if (fields.size() > 1) {
+            return fields[1].toULongLong() * (uint64_t)sysconf(_SC_PAGESIZE);
+        }
+    }
+    return 0;
+#else
+    MemoryInfo info;
+    return getMemoryInfo(info) ? info.processUsedMemoryBytes : 0;
+#endif
+}
+#endif
+
+// Loads a scene's worth of KTX files the old way (whole files in memory) and with the reader, keeping only
+// the low mips a distant scene would display, and reports the resident memory of each
+void KtxTests::benchmarkSceneLoadMemory() {
+#ifdef MANUAL_TEST
+    const int NUM_TEXTURES = 1000;
+    const uint16_t DISPLAYED_MIP = 3;
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QImage image(512, 512, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, qRgba(x & 0xff, y & 0xff, (x ^ y) & 0xff, 255));
+        }
+    }
+    auto texture = image::TextureUsage::process2DTextureColorFromImage(std::move(image), "scene", true, false);
+    QVERIFY(texture);
+    QStringList filenames;
+    writeKtxFile(texture, dir.filePath("texture0.ktx"));
+    filenames << dir.filePath("texture0.ktx");
+    for (int i = 1; i < NUM_TEXTURES; ++i) {
+        filenames << dir.filePath(QString("texture%1.ktx").arg(i));
+        QVERIFY(QFile::copy(filenames.front(), filenames.back()));
+    }
+
+    uint64_t baseline = getResidentMemory();
+    {
+        std::vector<storage::StoragePointer> loaded;
+        for (const auto& filename : filenames) {
+            loaded.push_back(storage::FileStorage(filename).toMemoryStorage());
+        }
+        std::cout << "whole files: " << (getResidentMemory() - baseline) / BYTES_PER_MEGABYTE << " MB" << std::endl;
+    }
+
+    baseline = getResidentMemory();
+    {
+        // Each mip mapping keeps its file open, so the files are read in batches and the displayed mips copied to
+        // memory, as the texture buffering does, to stay well under the open file limit
+        const int FILE_BATCH_SIZE = 64;
+        std::vector<storage::StoragePointer> mips;
+        uint32_t checksum = 0;
+        for (int begin = 0; begin < filenames.size(); begin += FILE_BATCH_SIZE) {
+            std::vector<std::unique_ptr<ktx::KTXReader>> readers;
+            for (int i = begin; i < std::min(begin + FILE_BATCH_SIZE, (int)filenames.size()); ++i) {
+                readers.push_back(ktx::KTXReader::open(filenames[i].toStdString()));
+                QVERIFY(readers.back());
+                uint16_t numLevels = (uint16_t)readers.back()->getDescriptor().images.size();
+                for (uint16_t level = DISPLAYED_MIP; level < numLevels; ++level) {
+                    mips.push_back(readers.back()->getMipFaceTexelsData(level)->toMemoryStorage());
+                    const auto& mip = mips.back();
+                    for (size_t offset = 0; offset < mip->size(); offset += 64) {
+                        checksum += mip->data()[offset];
+                    }
+                }
+            }
+        }
+        std::cout << "reader, mips " << DISPLAYED_MIP << "+: " << (getResidentMemory() - baseline) / BYTES_PER_MEGABYTE
+            << " MB (" << mips.size() << " mips, checksum " << checksum << ")" << std::endl;
+    }
+#endif
+}
+
 #if 0
 
 static const QString TEST_FOLDER { "H:/ktx_cacheold" };
@@ -8,6 +8,8 @@
 
 #include <QtCore/QObject>
 
+//#define MANUAL_TEST
+
 class KtxTests : public QObject {
     Q_OBJECT
 private slots:
@@ -16,6 +18,8 @@ private slots:
     void testKtxEvalFunctions();
     void testKhronosCompressionFunctions();
     void testKtxSerialization();
+    void testKtxReader();
+    void benchmarkSceneLoadMemory();
 };
 
 
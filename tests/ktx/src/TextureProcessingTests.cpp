@@ -0,0 +1,150 @@
+//
+//  TextureProcessingTests.cpp
+//  tests/ktx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureProcessingTests.h"
+
+#include <iostream>
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+#include <ktx/KTX.h>
+#include <gpu/Texture.h>
+#include <image/Image.h>
+
+QTEST_GUILESS_MAIN(TextureProcessingTests)
+
+// Deterministic image with enough detail that the block compressors have real work to do
+static QImage makeTestImage(int width, int height, uint32_t seed) {
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            int noise = (seed >> 24) & 0x1f;
+            line[x] = qRgba((x * 255 / width + noise) & 0xff, (y * 255 / height + noise) & 0xff,
+                            ((x ^ y) + noise) & 0xff, 255);
+        }
+    }
+    return image;
+}
+
+// Horizontal cross layout, one of the layouts the cube loader recognizes
+static QImage makeTestCubeImage(int faceSize) {
+    QImage image(faceSize * 4, faceSize * 3, QImage::Format_ARGB32);
+    image.fill(Qt::black);
+    QImage face = makeTestImage(faceSize, faceSize, 7);
+    const QPoint FACE_OFFSETS[] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 }, { 3, 1 }, { 1, 2 } };
+    for (const auto& offset : FACE_OFFSETS) {
+        QImage source = face.mirrored(offset.x() & 1, offset.y() & 1);
+        for (int y = 0; y < faceSize; ++y) {
+            memcpy(image.scanLine(offset.y() * faceSize + y) + offset.x() * faceSize * sizeof(QRgb),
+                   source.constScanLine(y), faceSize * sizeof(QRgb));
+        }
+    }
+    return image;
+}
+
+static QByteArray serialize(const gpu::TexturePointer& texture) {
+    auto ktxMemory = gpu::Texture::serialize(*texture);
+    if (!ktxMemory) {
+        return QByteArray();
+    }
+    const auto& storage = ktxMemory->getStorage();
+    return QByteArray(reinterpret_cast<const char*>(storage->data()), (int)storage->size());
+}
+
+static gpu::TexturePointer bake(const QImage& image, bool isCube, bool parallel,
+                                const std::atomic<bool>& abortProcessing = false) {
+    image::setParallelProcessingEnabled(parallel);
+    QImage copy = image;
+    if (isCube) {
+        return image::TextureUsage::processCubeTextureColorFromImage(std::move(copy), "test", false, abortProcessing);
+    }
+    return image::TextureUsage::process2DTextureColorFromImage(std::move(copy), "test", false, abortProcessing);
+}
+
+void TextureProcessingTests::initTestCase() {
+    image::setColorTexturesCompressionEnabled(true);
+    image::setCubeTexturesCompressionEnabled(true);
+}
+
+void TextureProcessingTests::cleanupTestCase() {
+    image::setParallelProcessingEnabled(true);
+    image::setColorTexturesCompressionEnabled(false);
+    image::setCubeTexturesCompressionEnabled(false);
+}
+
+void TextureProcessingTests::parallelMatchesSequential() {
+    QImage image = makeTestImage(512, 256, 1);
+
+    auto sequential = bake(image, false, false);
+    auto parallel = bake(image, false, true);
+    QVERIFY(sequential);
+    QVERIFY(parallel);
+    QCOMPARE(parallel->getNumMips(), sequential->getNumMips());
+
+    QByteArray sequentialBytes = serialize(sequential);
+    QVERIFY(!sequentialBytes.isEmpty());
+    QVERIFY(serialize(parallel) == sequentialBytes);
+}
+
+void TextureProcessingTests::parallelCubeMatchesSequential() {
+    QImage image = makeTestCubeImage(128);
+
+    auto sequential = bake(image, true, false);
+    auto parallel = bake(image, true, true);
+    QVERIFY(sequential);
+    QVERIFY(parallel);
+    QCOMPARE(parallel->getNumFaces(), (gpu::uint8)gpu::Texture::CUBE_FACE_COUNT);
+
+    QByteArray sequentialBytes = serialize(sequential);
+    QVERIFY(!sequentialBytes.isEmpty());
+    QVERIFY(serialize(parallel) == sequentialBytes);
+}
+
+void TextureProcessingTests::abortStopsProcessing() {
+    std::atomic<bool> abortProcessing { true };
+    auto texture = bake(makeTestImage(256, 256, 3), false, true, abortProcessing);
+    // an aborted bake may hand back a partial texture or none at all, but must return promptly without crashing
+    if (texture) {
+        QVERIFY(texture->getNumMips() > 0);
+    }
+}
+
+void TextureProcessingTests::bakingBenchmark() {
+#ifdef MANUAL_TEST
+    struct Fixture {
+        const char* name;
+        QImage image;
+        bool isCube;
+    };
+    const std::vector<Fixture> FIXTURES {
+        { "1k", makeTestImage(1024, 1024, 1), false },
+        { "2k", makeTestImage(2048, 2048, 2), false },
+        { "4k", makeTestImage(4096, 4096, 3), false },
+        { "cube 512", makeTestCubeImage(512), true },
+    };
+
+    for (const auto& fixture : FIXTURES) {
+        quint64 elapsed[2];
+        for (int parallel = 0; parallel < 2; ++parallel) {
+            QElapsedTimer timer;
+            timer.start();
+            auto texture = bake(fixture.image, fixture.isCube, parallel != 0);
+            elapsed[parallel] = timer.elapsed();
+            QVERIFY(texture);
+        }
+        std::cout << fixture.name << ": sequential " << elapsed[0] << " msec, parallel " << elapsed[1]
+            << " msec (" << (float)elapsed[0] / (float)std::max((quint64)1, elapsed[1]) << "x)" << std::endl;
+    }
+#endif
+}
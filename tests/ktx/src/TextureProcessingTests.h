@@ -0,0 +1,29 @@
+//
+//  TextureProcessingTests.h
+//  tests/ktx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureProcessingTests_h
+#define hifi_TextureProcessingTests_h
+
+#include <QtCore/QObject>
+
+//#define MANUAL_TEST
+
+class TextureProcessingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void parallelMatchesSequential();
+    void parallelCubeMatchesSequential();
+    void abortStopsProcessing();
+    void bakingBenchmark();
+};
+
+#endif // hifi_TextureProcessingTests_h
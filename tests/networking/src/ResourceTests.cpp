@@ -7,11 +7,15 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <iostream>
+
 #include <QNetworkDiskCache>
 
 #include "ResourceCache.h"
+#include "ResourceRequestLimiter.h"
 #include "NetworkAccessManager.h"
 #include "DependencyManager.h"
+#include "SharedUtil.h"
 
 #include "ResourceTests.h"
 
@@ -82,3 +86,184 @@ void ResourceTests::downloadAgain() {
 
     QVERIFY(resource->isLoaded());
 }
+
+static QSharedPointer<Resource> createPendingResource(const QString& url, QObject* owner, float priority) {
+    auto pendingResource = QSharedPointer<Resource>::create(QUrl(url));
+    pendingResource->setSelf(pendingResource);
+    pendingResource->setLoadPriority(owner, priority);
+    return pendingResource;
+}
+
+void ResourceTests::pendingRequestOrder() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+
+    QList<QSharedPointer<Resource>> resources;
+    const float priorities[] = { 3.0f, -1.0f, 7.0f, 0.0f, 5.0f, 5.0f };
+    for (int i = 0; i < 6; ++i) {
+        resources.append(createPendingResource(QString("http://localhost/%1.png").arg(i), &owner, priorities[i]));
+        sharedItems->appendPendingRequest(resources.last());
+    }
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)6);
+
+    // local files come first, regardless of priority
+    auto file = createPendingResource("file:///tmp/file.png", &owner, -10.0f);
+    sharedItems->appendPendingRequest(file);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), file);
+
+    // a priority change while pending re-sorts the request
+    resources[1]->setLoadPriority(&owner, 10.0f);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), resources[1]);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), resources[2]);
+
+    // ties go to the newest request
+    QCOMPARE(sharedItems->getHighestPendingRequest(), resources[5]);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), resources[4]);
+
+    // freed resources are skipped
+    resources[0].reset();
+    QCOMPARE(sharedItems->getHighestPendingRequest(), resources[3]);
+    QVERIFY(sharedItems->getHighestPendingRequest().isNull());
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)0);
+}
+
+void ResourceTests::requestLimiterGrows() {
+    ResourceRequestLimiter limiter;
+    QCOMPARE(limiter.getLimit(), ResourceRequestLimiter::DEFAULT_LIMIT);
+
+    // every slot busy, flat latency and steady throughput
+    const uint64_t LATENCY = 20 * USECS_PER_MSEC;
+    uint64_t now = USECS_PER_SECOND;
+    for (int i = 0; i < 400; ++i) {
+        limiter.requestStarted(limiter.getLimit());
+        now += 10 * USECS_PER_MSEC;
+        limiter.requestCompleted(now, LATENCY, 100000);
+    }
+    QCOMPARE(limiter.getLimit(), ResourceRequestLimiter::MAX_LIMIT);
+
+    // a fixed limit overrides adaptation
+    limiter.setFixedLimit(4);
+    QVERIFY(!limiter.isAdaptive());
+    QCOMPARE(limiter.getLimit(), 4);
+}
+
+void ResourceTests::requestLimiterBacksOff() {
+    ResourceRequestLimiter limiter;
+
+    uint64_t now = USECS_PER_SECOND;
+    uint64_t latency = 20 * USECS_PER_MSEC;
+    for (int i = 0; i < 40; ++i) {
+        limiter.requestStarted(limiter.getLimit());
+        now += 10 * USECS_PER_MSEC;
+        limiter.requestCompleted(now, latency, 100000);
+    }
+    int limit = limiter.getLimit();
+    QVERIFY(limit > ResourceRequestLimiter::DEFAULT_LIMIT);
+
+    // the origin starts queueing our requests
+    for (int i = 0; i < 40; ++i) {
+        limiter.requestStarted(limiter.getLimit());
+        now += 10 * USECS_PER_MSEC;
+        latency += 2 * USECS_PER_MSEC;
+        limiter.requestCompleted(now, latency, 100000);
+    }
+    QVERIFY(limiter.getLimit() < limit);
+    QVERIFY(limiter.getLimit() >= ResourceRequestLimiter::MIN_LIMIT);
+}
+
+void ResourceTests::resourceOrigins() {
+    QCOMPARE(resourceOriginForURL(QUrl("file:///tmp/model.fbx")), RESOURCE_ORIGIN_FILE);
+    QCOMPARE(resourceOriginForURL(QUrl("qrc:///meshes/defaultAvatar_full.fst")), RESOURCE_ORIGIN_FILE);
+    QCOMPARE(resourceOriginForURL(QUrl("atp:/model.fbx")), RESOURCE_ORIGIN_ATP);
+    QCOMPARE(resourceOriginForURL(QUrl("https://example.com/model.fbx")), RESOURCE_ORIGIN_HTTP);
+    QCOMPARE(resourceOriginForURL(QUrl("ftp://example.com/model.fbx")), RESOURCE_ORIGIN_HTTP);
+
+    // unknown schemes aren't loaded ahead of the network
+    QCOMPARE(resourceOriginForURL(QUrl("htps://example.com/model.fbx")), RESOURCE_ORIGIN_HTTP);
+}
+
+#ifdef MANUAL_TEST
+
+void ResourceTests::pendingRequestBenchmark() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+
+    uint32_t numRequests[] = { 1000, 10000, 100000 };
+    std::cout << "[numRequests, appendUsec, reprioritizeUsec, drainUsec] = [" << std::endl;
+    for (uint32_t numRequest : numRequests) {
+        QList<QSharedPointer<Resource>> resources;
+        for (uint32_t i = 0; i < numRequest; ++i) {
+            resources.append(createPendingResource(QString("http://localhost/%1.png").arg(i), &owner, (float)(rand() % 1000)));
+        }
+
+        uint64_t startTime = usecTimestampNow();
+        for (auto& pendingResource : resources) {
+            sharedItems->appendPendingRequest(pendingResource);
+        }
+        uint64_t appendTime = usecTimestampNow() - startTime;
+
+        // simulate the camera moving: a tenth of the queue changes priority between each dispatch
+        startTime = usecTimestampNow();
+        for (uint32_t i = 0; i < numRequest / 10; ++i) {
+            resources[rand() % numRequest]->setLoadPriority(&owner, (float)(rand() % 1000));
+        }
+        uint64_t reprioritizeTime = usecTimestampNow() - startTime;
+
+        startTime = usecTimestampNow();
+        while (sharedItems->getHighestPendingRequest()) {
+        }
+        uint64_t drainTime = usecTimestampNow() - startTime;
+
+        std::cout << "    " << numRequest << ", " << appendTime << ", " << reprioritizeTime << ", " << drainTime << std::endl;
+    }
+    std::cout << "];" << std::endl;
+}
+
+// Loads a scene's worth of small local files, standing in for an asset server, and reports the time until
+// all of them are loaded with a fixed and with an adaptive limit
+void ResourceTests::sceneLoadBenchmark() {
+    DependencyManager::set<ResourceManager>();
+    DependencyManager::get<ResourceManager>()->init();
+
+    const int NUM_FILES = 2000;
+    const int FILE_SIZE = 64 * 1024;
+    QTemporaryDir sceneDir;
+    QByteArray contents(FILE_SIZE, 'x');
+    for (int i = 0; i < NUM_FILES; ++i) {
+        QFile file(sceneDir.filePath(QString("%1.bin").arg(i)));
+        file.open(QIODevice::WriteOnly);
+        file.write(contents);
+    }
+
+    int limits[] = { 10, 0 };
+    for (int limit : limits) {
+        ResourceCache::setRequestLimit(limit);
+
+        QObject owner;
+        QList<QSharedPointer<Resource>> resources;
+        int numFinished = 0;
+        QEventLoop loop;
+        uint64_t startTime = usecTimestampNow();
+        for (int i = 0; i < NUM_FILES; ++i) {
+            QUrl url = QUrl::fromLocalFile(sceneDir.filePath(QString("%1.bin").arg(i)));
+            url.setQuery(QString("limit=%1").arg(limit));
+            auto sceneResource = createPendingResource(url.toString(), &owner, (float)i);
+            connect(sceneResource.data(), &Resource::finished, &loop, [&](bool) {
+                if (++numFinished == NUM_FILES) {
+                    loop.quit();
+                }
+            });
+            resources.append(sceneResource);
+            sceneResource->ensureLoading();
+        }
+        loop.exec();
+        uint64_t loadTime = usecTimestampNow() - startTime;
+
+        std::cout << "limit = " << (limit > 0 ? QString::number(limit).toStdString() : "adaptive")
+            << ", timeToLoaded = " << loadTime << " usec" << std::endl;
+    }
+
+    DependencyManager::get<ResourceManager>()->cleanup();
+}
+
+#endif // MANUAL_TEST
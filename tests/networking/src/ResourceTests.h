@@ -12,12 +12,22 @@
 
 #include <QtTest/QtTest>
 
+//#define MANUAL_TEST
+
 class ResourceTests : public QObject {
     Q_OBJECT
 private slots:
     void initTestCase();
     void downloadFirst();
     void downloadAgain();
+    void pendingRequestOrder();
+    void requestLimiterGrows();
+    void requestLimiterBacksOff();
+    void resourceOrigins();
+#ifdef MANUAL_TEST
+    void pendingRequestBenchmark();
+    void sceneLoadBenchmark();
+#endif // MANUAL_TEST
 };
 
 #endif // hifi_ResourceTests_h
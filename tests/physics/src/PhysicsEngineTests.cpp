@@ -0,0 +1,231 @@
+//
+//  PhysicsEngineTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsEngineTests.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <PhysicsEngine.h>
+#include <PhysicsHelpers.h>
+#include <ShapeManager.h>
+#include <SharedUtil.h>
+
+#include "TestMotionState.h"
+
+QTEST_MAIN(PhysicsEngineTests)
+
+const float BOX_SIZE = 1.0f;
+const float BOX_SPACING = 1.5f * BOX_SIZE;
+const float DROP_HEIGHT = 2.0f * BOX_SIZE;
+
+// Builds a deterministic scene: a large static floor with columns of dynamic boxes dropped onto it.
+// Each added layer is offset by half a box so the columns topple and keep many bodies active.
+static void addBoxLayers(PhysicsEngine& engine, ShapeManager& shapeManager, VectorOfMotionStates& motionStates,
+        uint32_t gridWidth, uint32_t numLayers, uint32_t firstLayer) {
+    ShapeInfo info;
+    info.setBox(0.5f * glm::vec3(BOX_SIZE));
+    VectorOfMotionStates newStates;
+    for (uint32_t k = firstLayer; k < firstLayer + numLayers; ++k) {
+        float offset = (k % 2) ? 0.5f * BOX_SIZE : 0.0f;
+        for (uint32_t i = 0; i < gridWidth; ++i) {
+            for (uint32_t j = 0; j < gridWidth; ++j) {
+                glm::vec3 position(BOX_SPACING * (float)i + offset,
+                        DROP_HEIGHT + BOX_SPACING * (float)k,
+                        BOX_SPACING * (float)j + offset);
+                newStates.push_back(new TestMotionState(shapeManager.getShape(info), position, MOTION_TYPE_DYNAMIC));
+            }
+        }
+    }
+    engine.addObjects(newStates);
+    motionStates += newStates;
+}
+
+static TestMotionState* addFloor(PhysicsEngine& engine, ShapeManager& shapeManager, uint32_t gridWidth) {
+    float halfWidth = BOX_SPACING * (float)(gridWidth + 2);
+    ShapeInfo info;
+    info.setBox(glm::vec3(halfWidth, 0.5f, halfWidth));
+    TestMotionState* floor = new TestMotionState(shapeManager.getShape(info), glm::vec3(0.0f, -0.5f, 0.0f), MOTION_TYPE_STATIC);
+    VectorOfMotionStates floorStates;
+    floorStates.push_back(floor);
+    engine.addObjects(floorStates);
+    return floor;
+}
+
+static void removeAll(PhysicsEngine& engine, VectorOfMotionStates& motionStates) {
+    engine.removeObjects(motionStates);
+    foreach (ObjectMotionState* motionState, motionStates) {
+        delete motionState;
+    }
+    motionStates.clear();
+}
+
+// the positions of the motion states changed by a harvest, by their index in the scene
+static std::vector<std::pair<int, glm::vec3>> getChangedPositions(PhysicsEngine& engine, const VectorOfMotionStates& motionStates) {
+    std::vector<std::pair<int, glm::vec3>> positions;
+    foreach (ObjectMotionState* motionState, engine.getChangedMotionStates()) {
+        positions.push_back({ motionStates.indexOf(motionState), motionState->getObjectPosition() });
+    }
+    std::sort(positions.begin(), positions.end(), [](const std::pair<int, glm::vec3>& a, const std::pair<int, glm::vec3>& b) {
+        return a.first < b.first;
+    });
+    return positions;
+}
+
+void PhysicsEngineTests::testParallelSyncMatchesSerial() {
+    ShapeManager shapeManager;
+    ObjectMotionState::setShapeManager(&shapeManager);
+
+    // two identical worlds, one harvested serially and the other in parallel
+    PhysicsEngine serialEngine(glm::vec3(0.0f));
+    PhysicsEngine parallelEngine(glm::vec3(0.0f));
+    serialEngine.init();
+    parallelEngine.init();
+    serialEngine.setMultithreaded(false);
+    parallelEngine.setMultithreaded(true);
+
+    // enough bodies to cross the threshold for the parallel path
+    const uint32_t GRID_WIDTH = 12;
+    const uint32_t NUM_LAYERS = 3;
+    VectorOfMotionStates serialStates;
+    serialStates.push_back(addFloor(serialEngine, shapeManager, GRID_WIDTH));
+    addBoxLayers(serialEngine, shapeManager, serialStates, GRID_WIDTH, NUM_LAYERS, 0);
+    VectorOfMotionStates parallelStates;
+    parallelStates.push_back(addFloor(parallelEngine, shapeManager, GRID_WIDTH));
+    addBoxLayers(parallelEngine, shapeManager, parallelStates, GRID_WIDTH, NUM_LAYERS, 0);
+
+    // the motion states only move when a harvest writes them, so the parallel harvest must keep up with the serial one
+    const uint32_t NUM_STEPS = 30;
+    size_t numChanges = 0;
+    for (uint32_t i = 0; i < NUM_STEPS; ++i) {
+        serialEngine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+        parallelEngine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+        auto serialPositions = getChangedPositions(serialEngine, serialStates);
+        auto parallelPositions = getChangedPositions(parallelEngine, parallelStates);
+        QCOMPARE(parallelPositions.size(), serialPositions.size());
+        for (size_t j = 0; j < serialPositions.size(); ++j) {
+            QCOMPARE(parallelPositions[j].first, serialPositions[j].first);
+            QVERIFY(parallelPositions[j].second == serialPositions[j].second);
+        }
+        numChanges += serialPositions.size();
+    }
+    QVERIFY(numChanges > 0);
+    for (int i = 0; i < serialStates.size(); ++i) {
+        QVERIFY(parallelStates[i]->getObjectPosition() == serialStates[i]->getObjectPosition());
+    }
+
+    removeAll(serialEngine, serialStates);
+    removeAll(parallelEngine, parallelStates);
+}
+
+void PhysicsEngineTests::testContactEvents() {
+    ShapeManager shapeManager;
+    ObjectMotionState::setShapeManager(&shapeManager);
+
+    PhysicsEngine engine(glm::vec3(0.0f, -9.8f, 0.0f));
+    engine.init();
+
+    const uint32_t GRID_WIDTH = 3;
+    VectorOfMotionStates motionStates;
+    motionStates.push_back(addFloor(engine, shapeManager, GRID_WIDTH));
+    addBoxLayers(engine, shapeManager, motionStates, GRID_WIDTH, 1, 0);
+
+    // step until the boxes land
+    uint32_t numStarted = 0;
+    const uint32_t MAX_STEPS = 120;
+    for (uint32_t i = 0; i < MAX_STEPS && numStarted == 0; ++i) {
+        engine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+        engine.getChangedMotionStates();
+        const CollisionEvents& events = engine.getCollisionEvents();
+        for (const auto& event : events) {
+            if (event.type == CONTACT_EVENT_TYPE_START) {
+                ++numStarted;
+            }
+        }
+    }
+    QVERIFY(numStarted > 0);
+    QVERIFY(engine.getContactStats().numProcessed > 0);
+    QCOMPARE(engine.getContactStats().numStarted, numStarted);
+
+    // removing the boxes prunes their contacts without emitting END events
+    VectorOfMotionStates boxes = motionStates.mid(1);
+    engine.removeObjects(boxes);
+    foreach (ObjectMotionState* motionState, boxes) {
+        delete motionState;
+    }
+    motionStates.resize(1);
+    engine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+    QVERIFY(engine.getCollisionEvents().empty());
+    QCOMPARE(engine.getContactStats().numProcessed, (uint32_t)0);
+
+    removeAll(engine, motionStates);
+}
+
+#ifdef MANUAL_TEST
+
+void PhysicsEngineTests::benchmark() {
+    ShapeManager shapeManager;
+    ObjectMotionState::setShapeManager(&shapeManager);
+
+    PhysicsEngine engine(glm::vec3(0.0f));
+    engine.init();
+
+    // NOTE: we grow a single engine rather than build one per case because ObjectMotionState
+    // expects the world simulation step to increase monotonically for the lifetime of the process
+    const uint32_t GRID_WIDTH = 32;
+    const uint32_t LAYERS_PER_CASE = 2;
+    const uint32_t NUM_CASES = 4;
+    const uint32_t NUM_WARMUP_STEPS = 10;
+    const uint32_t NUM_TIMED_STEPS = 60;
+
+    VectorOfMotionStates motionStates;
+    motionStates.push_back(addFloor(engine, shapeManager, GRID_WIDTH));
+
+    std::cout << "[numBodies, stepUsec, serialSyncUsec, parallelSyncUsec, serialContactUsec, parallelContactUsec] = [" << std::endl;
+    for (uint32_t i = 0; i < NUM_CASES; ++i) {
+        addBoxLayers(engine, shapeManager, motionStates, GRID_WIDTH, LAYERS_PER_CASE, i * LAYERS_PER_CASE);
+        for (uint32_t j = 0; j < NUM_WARMUP_STEPS; ++j) {
+            engine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+            engine.getChangedMotionStates();
+        }
+
+        uint64_t stepTime = 0;
+        uint64_t syncTime[] = { 0, 0 };
+        uint64_t contactTime[] = { 0, 0 };
+        for (uint32_t j = 0; j < NUM_TIMED_STEPS; ++j) {
+            uint64_t startTime = usecTimestampNow();
+            engine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+            stepTime += usecTimestampNow() - startTime;
+
+            for (int k = 0; k < 2; ++k) {
+                engine.setMultithreaded(k == 1);
+                startTime = usecTimestampNow();
+                engine.getChangedMotionStates();
+                syncTime[k] += usecTimestampNow() - startTime;
+
+                startTime = usecTimestampNow();
+                engine.updateContactMap();
+                contactTime[k] += usecTimestampNow() - startTime;
+            }
+            engine.getCollisionEvents();
+        }
+        std::cout << "    " << (motionStates.size() - 1)
+            << ", " << stepTime / NUM_TIMED_STEPS
+            << ", " << syncTime[0] / NUM_TIMED_STEPS
+            << ", " << syncTime[1] / NUM_TIMED_STEPS
+            << ", " << contactTime[0] / NUM_TIMED_STEPS
+            << ", " << contactTime[1] / NUM_TIMED_STEPS << std::endl;
+    }
+    std::cout << "];" << std::endl;
+
+    removeAll(engine, motionStates);
+}
+
+#endif // MANUAL_TEST
@@ -10,6 +10,11 @@
 //
 
 #include <iostream>
+
+#include <QtCore/QDir>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 #include <Extents.h>
@@ -243,3 +248,216 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+// builds a COMPOUND ShapeInfo of numHulls tetrahedra of increasing size strung along the x-axis
+static ShapeInfo makeCompoundInfo(int numHulls) {
+    QVector<glm::vec3> tetrahedron;
+    tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
+    tetrahedron.push_back(glm::vec3(1.0f, -1.0f, -1.0f));
+    tetrahedron.push_back(glm::vec3(-1.0f, 1.0f, -1.0f));
+    tetrahedron.push_back(glm::vec3(-1.0f, -1.0f, 1.0f));
+
+    ShapeInfo::PointCollection pointCollection;
+    glm::vec3 offsetNormal(1.0f, 0.0f, 0.0f);
+    Extents extents;
+    for (int i = 0; i < numHulls; ++i) {
+        glm::vec3 offset = (float)(i - numHulls/2) * offsetNormal;
+        ShapeInfo::PointList pointList;
+        float radius = (float)(i + 1);
+        for (int j = 0; j < tetrahedron.size(); ++j) {
+            glm::vec3 point = radius * tetrahedron[j] + offset;
+            pointList.push_back(point);
+            extents.addPoint(point);
+        }
+        pointCollection.push_back(pointList);
+    }
+
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_COMPOUND, 0.5f * (extents.maximum - extents.minimum), "http://example.com/hulls.fbx");
+    info.setPointCollection(pointCollection);
+    return info;
+}
+
+// builds a STATIC_MESH ShapeInfo for a gridWidth x gridWidth bumpy floor
+static ShapeInfo makeStaticMeshInfo(int gridWidth) {
+    ShapeInfo::PointList points;
+    for (int i = 0; i <= gridWidth; ++i) {
+        for (int j = 0; j <= gridWidth; ++j) {
+            points.push_back(glm::vec3((float)i, 0.1f * (float)((i * j) % 3), (float)j));
+        }
+    }
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.push_back(points);
+
+    ShapeInfo info;
+    float halfWidth = 0.5f * (float)gridWidth;
+    info.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3(halfWidth, 0.1f, halfWidth), "http://example.com/floor.fbx");
+    info.setPointCollection(pointCollection);
+
+    ShapeInfo::TriangleIndices& triangles = info.getTriangleIndices();
+    int rowSize = gridWidth + 1;
+    for (int i = 0; i < gridWidth; ++i) {
+        for (int j = 0; j < gridWidth; ++j) {
+            int32_t corner = i * rowSize + j;
+            triangles.push_back(corner);
+            triangles.push_back(corner + 1);
+            triangles.push_back(corner + rowSize);
+            triangles.push_back(corner + 1);
+            triangles.push_back(corner + rowSize + 1);
+            triangles.push_back(corner + rowSize);
+        }
+    }
+    return info;
+}
+
+static bool hullsMatch(const btCollisionShape* shapeA, const btCollisionShape* shapeB) {
+    if (shapeA->getShapeType() != (int)CONVEX_HULL_SHAPE_PROXYTYPE || shapeB->getShapeType() != (int)CONVEX_HULL_SHAPE_PROXYTYPE) {
+        return false;
+    }
+    const btConvexHullShape* hullA = static_cast<const btConvexHullShape*>(shapeA);
+    const btConvexHullShape* hullB = static_cast<const btConvexHullShape*>(shapeB);
+    if (hullA->getNumPoints() != hullB->getNumPoints() || hullA->getMargin() != hullB->getMargin()) {
+        return false;
+    }
+    for (int i = 0; i < hullA->getNumPoints(); ++i) {
+        if (hullA->getUnscaledPoints()[i] != hullB->getUnscaledPoints()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShapeManagerTests::addCompoundShapeAsync() {
+    const int numHulls = 5;
+    ShapeInfo info = makeCompoundInfo(numHulls);
+
+    ShapeManager shapeManager;
+    shapeManager.setAsyncEnabled(true);
+
+    // the first request only starts the build
+    const btCollisionShape* shape = shapeManager.getShape(info);
+    QVERIFY(shape == nullptr);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 1);
+
+    const int MAX_WAIT_MSEC = 5000;
+    const int WAIT_STEP_MSEC = 5;
+    for (int i = 0; i < MAX_WAIT_MSEC / WAIT_STEP_MSEC && !shape; ++i) {
+        shape = shapeManager.getShape(info);
+        if (!shape) {
+            QVERIFY(shapeManager.isPending(info));
+            QThread::msleep(WAIT_STEP_MSEC);
+        }
+    }
+    QVERIFY(shape != nullptr);
+    QVERIFY(!shapeManager.isPending(info));
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), numHulls);
+
+    // once harvested it is managed like any other shape
+    QCOMPARE(shapeManager.getNumPendingShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+    QCOMPARE(shapeManager.getShape(info), shape);
+    QCOMPARE(shapeManager.getNumReferences(info), 2);
+
+    shapeManager.releaseShape(shape);
+    shapeManager.releaseShape(shape);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::failedShapeAsync() {
+    // a simple compound without meshes builds no shape
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_SIMPLE_COMPOUND, glm::vec3(1.0f), "http://example.com/empty.fbx");
+
+    ShapeManager shapeManager;
+    shapeManager.setAsyncEnabled(true);
+    QVERIFY(shapeManager.getShape(info) == nullptr);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 1);
+
+    const int MAX_WAIT_MSEC = 5000;
+    const int WAIT_STEP_MSEC = 5;
+    for (int i = 0; i < MAX_WAIT_MSEC / WAIT_STEP_MSEC && shapeManager.isPending(info); ++i) {
+        QThread::msleep(WAIT_STEP_MSEC);
+    }
+    QVERIFY(!shapeManager.isPending(info));
+
+    // harvesting the failed build drops it
+    QVERIFY(shapeManager.getShape(info) == nullptr);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::diskCacheCompoundShape() {
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const int numHulls = 5;
+    ShapeInfo info = makeCompoundInfo(numHulls);
+
+    ShapeManager builder;
+    builder.setDiskCacheDirectory(cacheDir.path());
+    const btCollisionShape* builtShape = builder.getShape(info);
+    QVERIFY(builtShape != nullptr);
+    QCOMPARE(QDir(cacheDir.path()).entryList(QStringList("*.shape"), QDir::Files).size(), 1);
+
+    ShapeManager loader;
+    loader.setDiskCacheDirectory(cacheDir.path());
+    const btCollisionShape* loadedShape = loader.getShape(info);
+    QVERIFY(loadedShape != nullptr);
+    QCOMPARE(loadedShape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+
+    const btCompoundShape* builtCompound = static_cast<const btCompoundShape*>(builtShape);
+    const btCompoundShape* loadedCompound = static_cast<const btCompoundShape*>(loadedShape);
+    QCOMPARE(loadedCompound->getNumChildShapes(), numHulls);
+    for (int i = 0; i < numHulls; ++i) {
+        QVERIFY(hullsMatch(builtCompound->getChildShape(i), loadedCompound->getChildShape(i)));
+        QVERIFY(builtCompound->getChildTransform(i).getOrigin() == loadedCompound->getChildTransform(i).getOrigin());
+    }
+
+    // content that changed under the same key must not be satisfied from the stale cache entry
+    ShapeInfo changedInfo = info;
+    changedInfo.getPointCollection()[0][0] *= 2.0f;
+    QVERIFY(changedInfo.getHash().equals(info.getHash()));
+    ShapeManager changedLoader;
+    changedLoader.setDiskCacheDirectory(cacheDir.path());
+    const btCollisionShape* changedShape = changedLoader.getShape(changedInfo);
+    QVERIFY(changedShape != nullptr);
+    QVERIFY(!hullsMatch(builtCompound->getChildShape(0), static_cast<const btCompoundShape*>(changedShape)->getChildShape(0)));
+}
+
+void ShapeManagerTests::diskCacheStaticMeshShape() {
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const int gridWidth = 16;
+    ShapeInfo info = makeStaticMeshInfo(gridWidth);
+
+    ShapeManager builder;
+    builder.setDiskCacheDirectory(cacheDir.path());
+    const btCollisionShape* builtShape = builder.getShape(info);
+    QVERIFY(builtShape != nullptr);
+    QCOMPARE(builtShape->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+
+    ShapeManager loader;
+    loader.setDiskCacheDirectory(cacheDir.path());
+    const btCollisionShape* loadedShape = loader.getShape(info);
+    QVERIFY(loadedShape != nullptr);
+    QCOMPARE(loadedShape->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+
+    // the deserialized BVH must describe the same mesh
+    btBvhTriangleMeshShape* builtMesh = const_cast<btBvhTriangleMeshShape*>(static_cast<const btBvhTriangleMeshShape*>(builtShape));
+    btBvhTriangleMeshShape* loadedMesh = const_cast<btBvhTriangleMeshShape*>(static_cast<const btBvhTriangleMeshShape*>(loadedShape));
+    QVERIFY(loadedMesh->getOptimizedBvh() != nullptr);
+    QCOMPARE(loadedMesh->getOptimizedBvh()->calculateSerializeBufferSize(), builtMesh->getOptimizedBvh()->calculateSerializeBufferSize());
+
+    btTransform identity;
+    identity.setIdentity();
+    btVector3 builtMin, builtMax, loadedMin, loadedMax;
+    builtShape->getAabb(identity, builtMin, builtMax);
+    loadedShape->getAabb(identity, loadedMin, loadedMax);
+    QVERIFY(builtMin == loadedMin);
+    QVERIFY(builtMax == loadedMax);
+}
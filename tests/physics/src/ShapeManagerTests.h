@@ -25,6 +25,10 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void addCompoundShapeAsync();
+    void failedShapeAsync();
+    void diskCacheCompoundShape();
+    void diskCacheStaticMeshShape();
 };
 
 #endif // hifi_ShapeManagerTests_h
@@ -0,0 +1,155 @@
+//
+//  SimpleEntitySimulationTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SimpleEntitySimulationTests.h"
+
+#include <ShapeEntityItem.h>
+#include <SharedUtil.h>
+#include <SimpleEntitySimulation.h>
+#include <workload/Space.h>
+
+QTEST_MAIN(SimpleEntitySimulationTests)
+
+const float NEAR_RADIUS = 10.0f;
+const float MID_RADIUS = 20.0f;
+const float FAR_RADIUS = 40.0f;
+
+// Exposes the sets of kinematic entities and categorizes them without extrapolating them, which needs a tree
+class TestEntitySimulation : public SimpleEntitySimulation {
+public:
+    void updateWorkload() {
+        QMutexLocker lock(&_mutex);
+        SimpleEntitySimulation::updateWorkload(usecTimestampNow());
+    }
+
+    bool isFullRate(const EntityItemPointer& entity) { return _simpleKinematicEntities.contains(entity); }
+    bool isFar(const EntityItemPointer& entity) { return _farKinematicEntities.contains(entity); }
+    bool isSleeping(const EntityItemPointer& entity) { return _sleepingKinematicEntities.contains(entity); }
+};
+
+static EntityItemPointer makeEntity(const glm::vec3& position, bool moving) {
+    EntityItemPointer entity = std::make_shared<ShapeEntityItem>(EntityItemID(QUuid::createUuid()));
+    entity->setWorldPosition(position);
+    if (moving) {
+        entity->setVelocity(glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+    entity->updateQueryAACube();
+    return entity;
+}
+
+void SimpleEntitySimulationTests::testRegionTransitions() {
+    auto simulation = std::make_shared<TestEntitySimulation>();
+    simulation->setWorkloadRadiuses(NEAR_RADIUS, MID_RADIUS, FAR_RADIUS);
+    simulation->setWorkloadEnabled(true);
+
+    auto nearEntity = makeEntity(glm::vec3(5.0f, 0.0f, 0.0f), true);
+    auto midEntity = makeEntity(glm::vec3(15.0f, 0.0f, 0.0f), true);
+    auto farEntity = makeEntity(glm::vec3(30.0f, 0.0f, 0.0f), true);
+    auto outOfRangeEntity = makeEntity(glm::vec3(100.0f, 0.0f, 0.0f), true);
+    auto staticEntity = makeEntity(glm::vec3(30.0f, 0.0f, 0.0f), false);
+    for (auto& entity : { nearEntity, midEntity, farEntity, outOfRangeEntity, staticEntity }) {
+        simulation->addEntity(entity);
+    }
+
+    // the new entities are out of range, like their proxies, until they are categorized
+    for (auto& entity : { nearEntity, midEntity, farEntity, outOfRangeEntity }) {
+        QVERIFY(simulation->isSleeping(entity));
+        QVERIFY(entity->isFarFromViewers());
+    }
+    QVERIFY(!simulation->isSleeping(staticEntity));
+
+    simulation->setWorkloadViews({ glm::vec3(0.0f) });
+    simulation->updateWorkload();
+    QVERIFY(nearEntity->getRegion() == workload::Space::REGION_NEAR);
+    QVERIFY(midEntity->getRegion() == workload::Space::REGION_MIDDLE);
+    QVERIFY(farEntity->getRegion() == workload::Space::REGION_FAR);
+    QVERIFY(outOfRangeEntity->getRegion() == workload::Space::REGION_UNKNOWN);
+    QVERIFY(simulation->isFullRate(nearEntity));
+    QVERIFY(simulation->isFullRate(midEntity));
+    QVERIFY(simulation->isFar(farEntity));
+    QVERIFY(simulation->isSleeping(outOfRangeEntity));
+    QCOMPARE(simulation->getNumFarKinematicEntities(), 1);
+    QCOMPARE(simulation->getNumSleepingKinematicEntities(), 1);
+
+    // the entities far from the closest viewer are sent after the others
+    QVERIFY(!nearEntity->isFarFromViewers());
+    QVERIFY(!midEntity->isFarFromViewers());
+    QVERIFY(farEntity->isFarFromViewers());
+    QVERIFY(outOfRangeEntity->isFarFromViewers());
+
+    // a static entity is categorized but isn't extrapolated at any rate
+    QVERIFY(staticEntity->getRegion() == workload::Space::REGION_FAR);
+    QVERIFY(!simulation->isFullRate(staticEntity) && !simulation->isFar(staticEntity) && !simulation->isSleeping(staticEntity));
+
+    // every transition moves the entity from the set it is in
+    simulation->setWorkloadViews({ glm::vec3(100.0f, 0.0f, 0.0f) });
+    simulation->updateWorkload();
+    QVERIFY(simulation->isSleeping(nearEntity));
+    QVERIFY(simulation->isSleeping(midEntity));
+    QVERIFY(simulation->isFullRate(outOfRangeEntity));
+    QVERIFY(!outOfRangeEntity->isFarFromViewers());
+
+    simulation->setWorkloadViews({ glm::vec3(0.0f), glm::vec3(100.0f, 0.0f, 0.0f) });
+    simulation->updateWorkload();
+    QVERIFY(simulation->isFullRate(nearEntity));
+    QVERIFY(simulation->isFullRate(midEntity));
+    QVERIFY(simulation->isFar(farEntity));
+    QVERIFY(simulation->isFullRate(outOfRangeEntity));
+
+    // without viewers everything sleeps
+    simulation->setWorkloadViews({});
+    simulation->updateWorkload();
+    for (auto& entity : { nearEntity, midEntity, farEntity, outOfRangeEntity }) {
+        QVERIFY(simulation->isSleeping(entity));
+    }
+}
+
+void SimpleEntitySimulationTests::testEnableWorkload() {
+    auto simulation = std::make_shared<TestEntitySimulation>();
+    simulation->setWorkloadRadiuses(NEAR_RADIUS, MID_RADIUS, FAR_RADIUS);
+
+    // without the workload the entities have no proxy and move at full rate
+    auto nearEntity = makeEntity(glm::vec3(5.0f, 0.0f, 0.0f), true);
+    auto outOfRangeEntity = makeEntity(glm::vec3(100.0f, 0.0f, 0.0f), true);
+    simulation->addEntity(nearEntity);
+    simulation->addEntity(outOfRangeEntity);
+    for (auto& entity : { nearEntity, outOfRangeEntity }) {
+        QCOMPARE(entity->getSpaceIndex(), -1);
+        QVERIFY(entity->getRegion() == EntityItem::UNCATEGORIZED);
+        QVERIFY(simulation->isFullRate(entity));
+        QVERIFY(!entity->isFarFromViewers());
+    }
+
+    // enabling it categorizes the entities that were there before, even those that stay out of range
+    simulation->setWorkloadViews({ glm::vec3(0.0f) });
+    simulation->setWorkloadEnabled(true);
+    simulation->updateWorkload();
+    QVERIFY(nearEntity->getSpaceIndex() != -1);
+    QVERIFY(simulation->isFullRate(nearEntity));
+    QVERIFY(simulation->isSleeping(outOfRangeEntity));
+
+    // disabling it wakes them up
+    simulation->setWorkloadEnabled(false);
+    for (auto& entity : { nearEntity, outOfRangeEntity }) {
+        QCOMPARE(entity->getSpaceIndex(), -1);
+        QVERIFY(entity->getRegion() == EntityItem::UNCATEGORIZED);
+        QVERIFY(simulation->isFullRate(entity));
+    }
+    QCOMPARE(simulation->getNumSleepingKinematicEntities(), 0);
+
+    // removed entities leave every set
+    simulation->setWorkloadEnabled(true);
+    simulation->updateWorkload();
+    QVERIFY(simulation->isSleeping(outOfRangeEntity));
+    outOfRangeEntity->die();
+    simulation->prepareEntityForDelete(outOfRangeEntity);
+    QCOMPARE(simulation->getNumSleepingKinematicEntities(), 0);
+    QCOMPARE(outOfRangeEntity->getSpaceIndex(), -1);
+}
@@ -0,0 +1,24 @@
+//
+//  SimpleEntitySimulationTests.h
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SimpleEntitySimulationTests_h
+#define hifi_SimpleEntitySimulationTests_h
+
+#include <QtTest/QtTest>
+
+class SimpleEntitySimulationTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRegionTransitions();
+    void testEnableWorkload();
+};
+
+#endif // hifi_SimpleEntitySimulationTests_h
@@ -0,0 +1,89 @@
+//
+//  TestMotionState.h
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TestMotionState_h
+#define hifi_TestMotionState_h
+
+#include <QUuid>
+
+#include <BulletUtil.h>
+#include <ObjectMotionState.h>
+#include <PhysicsCollisionGroups.h>
+
+// Minimal ObjectMotionState with no backing entity, for driving a PhysicsEngine in tests and benchmarks.
+// The shape must come from the ShapeManager registered with ObjectMotionState::setShapeManager().
+class TestMotionState : public ObjectMotionState {
+public:
+    TestMotionState(const btCollisionShape* shape, const glm::vec3& position, PhysicsMotionType motionType) :
+        ObjectMotionState(shape),
+        _id(QUuid::createUuid()),
+        _position(position),
+        _rotation(),
+        _requestedMotionType(motionType) {
+        _type = MOTIONSTATE_TYPE_ENTITY;
+        if (motionType == MOTION_TYPE_DYNAMIC) {
+            _gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+        }
+    }
+
+    void getWorldTransform(btTransform& worldTrans) const override {
+        worldTrans.setOrigin(glmToBullet(_position));
+        worldTrans.setRotation(glmToBullet(_rotation));
+    }
+
+    void setWorldTransform(const btTransform& worldTrans) override {
+        _position = bulletToGLM(worldTrans.getOrigin());
+        _rotation = bulletToGLM(worldTrans.getRotation());
+    }
+
+    uint32_t getIncomingDirtyFlags() override { return 0; }
+    void clearIncomingDirtyFlags() override { }
+
+    PhysicsMotionType computePhysicsMotionType() const override { return _requestedMotionType; }
+    bool isMoving() const override { return _requestedMotionType == MOTION_TYPE_DYNAMIC; }
+
+    float getObjectRestitution() const override { return 0.5f; }
+    float getObjectFriction() const override { return 0.5f; }
+    float getObjectLinearDamping() const override { return 0.0f; }
+    float getObjectAngularDamping() const override { return 0.0f; }
+
+    glm::vec3 getObjectPosition() const override { return _position; }
+    glm::quat getObjectRotation() const override { return _rotation; }
+    glm::vec3 getObjectLinearVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectAngularVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectGravity() const override { return _gravity; }
+
+    const QUuid getObjectID() const override { return _id; }
+    QUuid getSimulatorID() const override { return QUuid(); }
+
+    bool isLocallyOwnedOrShouldBe() const override { return true; }
+
+    void computeCollisionGroupAndMask(int16_t& group, int16_t& mask) const override {
+        if (_requestedMotionType == MOTION_TYPE_DYNAMIC) {
+            group = BULLET_COLLISION_GROUP_DYNAMIC;
+            mask = BULLET_COLLISION_MASK_DYNAMIC;
+        } else {
+            group = BULLET_COLLISION_GROUP_STATIC;
+            mask = BULLET_COLLISION_MASK_STATIC;
+        }
+    }
+
+protected:
+    bool isReadyToComputeShape() const override { return true; }
+    const btCollisionShape* computeNewShape() override { return _shape; }
+
+    QUuid _id;
+    glm::vec3 _position;
+    glm::quat _rotation;
+    glm::vec3 _gravity { 0.0f };
+    PhysicsMotionType _requestedMotionType;
+};
+
+#endif // hifi_TestMotionState_h
@@ -0,0 +1,195 @@
+//
+//  CullSortTests.cpp
+//  tests/render/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullSortTests.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <SharedUtil.h>
+#include <render/CullTask.h>
+#include <render/RadixSort.h>
+#include <render/SortTask.h>
+
+QTEST_MAIN(CullSortTests)
+
+const float WORLD_WIDTH = 1000.0f;
+const float MAX_ITEM_SIZE = 20.0f;
+
+float randomFloat() {
+    return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+}
+
+render::ItemBounds generateItems(size_t numItems) {
+    render::ItemBounds items;
+    items.reserve(numItems);
+    for (size_t i = 0; i < numItems; ++i) {
+        glm::vec3 corner = WORLD_WIDTH * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        float size = MAX_ITEM_SIZE * 0.5f * (randomFloat() + 1.0f);
+        items.emplace_back(render::ItemID(i), AABox(corner, size));
+    }
+    return items;
+}
+
+render::RenderContextPointer createRenderContext(RenderArgs& args) {
+    ViewFrustum frustum;
+    frustum.setPosition(glm::vec3(0.0f));
+    frustum.setOrientation(glm::quat());
+    frustum.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, WORLD_WIDTH));
+    frustum.calculate();
+    args.setViewFrustum(frustum);
+
+    auto renderContext = std::make_shared<render::RenderContext>();
+    renderContext->args = &args;
+    return renderContext;
+}
+
+// culls out the items too small to see from the camera
+bool cullTooSmall(const RenderArgs* args, const AABox& bound) {
+    float size = glm::length(bound.getScale());
+    return size > 0.01f * args->getViewFrustum().distanceToCamera(bound.calcCenter());
+}
+
+void CullSortTests::testRadixSort() {
+    using namespace render;
+    for (size_t numEntries : { 0, 1, 100, 10000, 200000 }) {
+        RadixSortEntries entries(numEntries);
+        for (size_t i = 0; i < numEntries; ++i) {
+            // few different keys to check that equal keys stay in order
+            float value = (float)(rand() % 1000) - 500.0f;
+            entries[i] = { floatToRadixSortKey(value), (uint32_t)i };
+        }
+        RadixSortEntries expected = entries;
+        std::stable_sort(expected.begin(), expected.end(), [](const RadixSortEntry& a, const RadixSortEntry& b) {
+            return a.key < b.key;
+        });
+
+        RadixSortEntries scratch;
+        radixSort(entries, scratch);
+        QCOMPARE(entries.size(), numEntries);
+        for (size_t i = 0; i < numEntries; ++i) {
+            QCOMPARE(entries[i].key, expected[i].key);
+            QCOMPARE(entries[i].value, expected[i].value);
+        }
+    }
+
+    QVERIFY(floatToRadixSortKey(-2.0f) < floatToRadixSortKey(-1.0f));
+    QVERIFY(floatToRadixSortKey(-1.0f) < floatToRadixSortKey(0.0f));
+    QVERIFY(floatToRadixSortKey(0.0f) < floatToRadixSortKey(0.5f));
+    QVERIFY(floatToRadixSortKey(0.5f) < floatToRadixSortKey(1.0e20f));
+}
+
+void CullSortTests::testDepthSortItems() {
+    RenderArgs args;
+    auto renderContext = createRenderContext(args);
+    const ViewFrustum& frustum = args.getViewFrustum();
+
+    const size_t NUM_ITEMS = 50000;
+    render::ItemBounds inItems = generateItems(NUM_ITEMS);
+
+    for (bool frontToBack : { true, false }) {
+        render::ItemBounds outItems;
+        AABox bounds;
+        render::depthSortItems(renderContext, frontToBack, inItems, outItems, &bounds);
+        QCOMPARE(outItems.size(), NUM_ITEMS);
+
+        AABox expectedBounds;
+        for (auto& item : inItems) {
+            expectedBounds += item.bound;
+        }
+        QCOMPARE(bounds.getCorner(), expectedBounds.getCorner());
+
+        for (size_t i = 1; i < NUM_ITEMS; ++i) {
+            float previousDistance = frustum.distanceToCamera(outItems[i - 1].bound.calcCenter());
+            float distance = frustum.distanceToCamera(outItems[i].bound.calcCenter());
+            QVERIFY(frontToBack ? (previousDistance <= distance) : (previousDistance >= distance));
+            if (previousDistance == distance) {
+                QVERIFY(outItems[i - 1].id < outItems[i].id);
+            }
+        }
+    }
+}
+
+void CullSortTests::testCullItemsMatchesSequential() {
+    RenderArgs args;
+    auto renderContext = createRenderContext(args);
+    const ViewFrustum& frustum = args.getViewFrustum();
+
+    const size_t NUM_ITEMS = 50000;
+    render::ItemBounds inItems = generateItems(NUM_ITEMS);
+    // items without a bound are always kept
+    inItems[NUM_ITEMS / 2].bound = AABox(glm::vec3(0.0f), 0.0f);
+
+    render::ItemBounds expectedItems;
+    int expectedOutOfView = 0;
+    int expectedTooSmall = 0;
+    for (auto& item : inItems) {
+        if (item.bound.isNull()) {
+            expectedItems.push_back(item);
+        } else if (!frustum.boxIntersectsFrustum(item.bound)) {
+            ++expectedOutOfView;
+        } else if (!cullTooSmall(&args, item.bound)) {
+            ++expectedTooSmall;
+        } else {
+            expectedItems.push_back(item);
+        }
+    }
+    QVERIFY(expectedOutOfView > 0);
+    QVERIFY(expectedTooSmall > 0);
+
+    render::ItemBounds outItems;
+    render::RenderDetails::Item details;
+    render::cullItems(renderContext, cullTooSmall, details, inItems, outItems);
+
+    QCOMPARE(outItems.size(), expectedItems.size());
+    for (size_t i = 0; i < outItems.size(); ++i) {
+        QCOMPARE(outItems[i].id, expectedItems[i].id);
+    }
+    QCOMPARE(details._considered, (int)NUM_ITEMS);
+    QCOMPARE(details._outOfView, expectedOutOfView);
+    QCOMPARE(details._tooSmall, expectedTooSmall);
+    QCOMPARE(details._rendered, (int)expectedItems.size());
+}
+
+#ifdef MANUAL_TEST
+
+void CullSortTests::benchmark() {
+    RenderArgs args;
+    auto renderContext = createRenderContext(args);
+
+    const int NUM_FRAMES = 20;
+    for (size_t numItems : { 1000, 10000, 100000 }) {
+        render::ItemBounds inItems = generateItems(numItems);
+        render::ItemBounds culledItems;
+        render::ItemBounds sortedItems;
+
+        uint64_t cullTime = 0;
+        uint64_t sortTime = 0;
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            culledItems.clear();
+            render::RenderDetails::Item details;
+            uint64_t start = usecTimestampNow();
+            render::cullItems(renderContext, cullTooSmall, details, inItems, culledItems);
+            cullTime += usecTimestampNow() - start;
+
+            start = usecTimestampNow();
+            render::depthSortItems(renderContext, true, inItems, sortedItems);
+            sortTime += usecTimestampNow() - start;
+        }
+
+        std::cout << numItems << " items:"
+            << "  cull = " << (cullTime / NUM_FRAMES) << " usec"
+            << "  depth sort = " << (sortTime / NUM_FRAMES) << " usec" << std::endl;
+    }
+}
+
+#endif // MANUAL_TEST
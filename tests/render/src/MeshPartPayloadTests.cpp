@@ -0,0 +1,95 @@
+//
+//  MeshPartPayloadTests.cpp
+//  tests/render/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshPartPayloadTests.h"
+
+#include <gpu/Context.h>
+#include <gpu/null/NullBackend.h>
+#include <render/ShapePipeline.h>
+
+#include <MeshPartPayload.h>
+
+QTEST_MAIN(MeshPartPayloadTests)
+
+// A ModelMeshPartPayload needs a loaded Model, its parts go through the same instanced path
+class TestMeshPartPayload : public MeshPartPayload {
+public:
+    TestMeshPartPayload(const std::shared_ptr<const graphics::Mesh>& mesh, const graphics::MaterialPointer& material, const Transform& transform) :
+        MeshPartPayload(mesh, 0, material) {
+        updateTransform(transform, Transform());
+    }
+
+    void render(RenderArgs* args) override { renderInstance(args, _transform); }
+};
+
+static graphics::MeshPointer createTriangle() {
+    const glm::vec3 VERTICES[] = { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+    const uint32_t INDICES[] = { 0, 1, 2 };
+    return graphics::Mesh::createIndexedTriangles_P3F(3, 3, VERTICES, INDICES);
+}
+
+static size_t countInstancedDraws(const gpu::Batch& batch, size_t& numInstances) {
+    size_t numDraws = 0;
+    numInstances = 0;
+    for (size_t i = 0; i < batch.getCommands().size(); ++i) {
+        if (batch.getCommands()[i] == gpu::Batch::COMMAND_drawIndexedInstanced) {
+            ++numDraws;
+            numInstances += batch.getParams()[batch.getCommandOffsets()[i] + 4]._uint;
+        }
+    }
+    return numDraws;
+}
+
+void MeshPartPayloadTests::initTestCase() {
+    gpu::Context::init<gpu::null::Backend>();
+}
+
+void MeshPartPayloadTests::testRenderInstanced() {
+    auto context = std::make_shared<gpu::Context>();
+    const size_t NUM_MESHES = 3;
+    const size_t NUM_PAYLOADS = 60;
+
+    std::vector<graphics::MeshPointer> meshes;
+    for (size_t i = 0; i < NUM_MESHES; ++i) {
+        meshes.push_back(createTriangle());
+    }
+    auto material = std::make_shared<graphics::Material>();
+    auto otherMaterial = std::make_shared<graphics::Material>();
+
+    // the payloads of the same mesh and material share a draw, whatever the order they render in
+    std::vector<std::shared_ptr<TestMeshPartPayload>> payloads;
+    for (size_t i = 0; i < NUM_PAYLOADS; ++i) {
+        payloads.push_back(std::make_shared<TestMeshPartPayload>(meshes[i % NUM_MESHES], material,
+            Transform().setTranslation(glm::vec3((float)i))));
+    }
+    // and a different material draws apart
+    payloads.push_back(std::make_shared<TestMeshPartPayload>(meshes[0], otherMaterial, Transform()));
+
+    RenderArgs args(context);
+    args._shapePipeline = std::make_shared<render::ShapePipeline>(gpu::PipelinePointer(), render::ShapePipeline::LocationsPointer());
+
+    context->beginFrame();
+    gpu::doInBatch("MeshPartPayloadTests::instanced", context, [&](gpu::Batch& batch) {
+        args._batch = &batch;
+        for (auto& payload : payloads) {
+            payload->render(&args);
+        }
+        args._batch = nullptr;
+    });
+    auto frame = context->endFrame();
+
+    const auto& batch = frame->batches[0];
+    size_t numInstances = 0;
+    QCOMPARE(countInstancedDraws(batch, numInstances), NUM_MESHES + 1);
+    QCOMPARE(numInstances, NUM_PAYLOADS + 1);
+    QCOMPARE(batch._namedData.size(), NUM_MESHES + 1);
+
+    context->executeFrame(frame);
+}
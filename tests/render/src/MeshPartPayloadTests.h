@@ -0,0 +1,24 @@
+//
+//  MeshPartPayloadTests.h
+//  tests/render/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_MeshPartPayloadTests_h
+#define hifi_render_MeshPartPayloadTests_h
+
+#include <QtTest/QtTest>
+
+class MeshPartPayloadTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testRenderInstanced();
+};
+
+#endif // hifi_render_MeshPartPayloadTests_h
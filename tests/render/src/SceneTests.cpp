@@ -0,0 +1,238 @@
+//
+//  SceneTests.cpp
+//  tests/render/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SceneTests.h"
+
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <SharedUtil.h>
+#include <render/CullTask.h>
+#include <render/Scene.h>
+
+QTEST_MAIN(SceneTests)
+
+const float WORLD_WIDTH = 1000.0f;
+
+class TestItem {
+public:
+    using Pointer = std::shared_ptr<TestItem>;
+    using Payload = render::Payload<TestItem>;
+
+    TestItem(const AABox& bound) : bound(bound) {}
+
+    AABox bound;
+};
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const TestItem::Pointer& item) {
+        return ItemKey::Builder::opaqueShape();
+    }
+    template <> const Item::Bound payloadGetBound(const TestItem::Pointer& item) {
+        return item->bound;
+    }
+}
+
+void processTransaction(const render::ScenePointer& scene, const render::Transaction& transaction) {
+    scene->enqueueTransaction(transaction);
+    scene->enqueueFrame();
+    scene->flushTransactionQueue();
+}
+
+render::ScenePointer createScene() {
+    return std::make_shared<render::Scene>(glm::vec3(-WORLD_WIDTH), 2.0f * WORLD_WIDTH);
+}
+
+void SceneTests::testItemKeyAndBoundCache() {
+    auto scene = createScene();
+
+    const int NUM_ITEMS = 100;
+    std::vector<render::ItemID> ids;
+    std::vector<TestItem::Pointer> items;
+    render::Transaction transaction;
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        auto id = scene->allocateID();
+        auto item = std::make_shared<TestItem>(AABox(glm::vec3((float)i), 1.0f));
+        transaction.resetItem(id, std::make_shared<TestItem::Payload>(item));
+        ids.push_back(id);
+        items.push_back(item);
+    }
+    processTransaction(scene, transaction);
+
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        QVERIFY(scene->getItemKey(ids[i])._flags == scene->getItem(ids[i]).getKey()._flags);
+        QVERIFY(scene->getItemBound(ids[i]) == items[i]->bound);
+    }
+
+    // an update refreshes the cached bound
+    const AABox MOVED_BOUND(glm::vec3(500.0f), 2.0f);
+    render::Transaction updateTransaction;
+    updateTransaction.updateItem<TestItem>(ids[0], [&](TestItem& item) {
+        item.bound = MOVED_BOUND;
+    });
+    processTransaction(scene, updateTransaction);
+    QVERIFY(scene->getItemBound(ids[0]) == MOVED_BOUND);
+    QVERIFY(scene->getItemKey(ids[0])._flags == scene->getItem(ids[0]).getKey()._flags);
+
+    // a removed item has no key nor bound
+    render::Transaction removeTransaction;
+    removeTransaction.removeItem(ids[1]);
+    processTransaction(scene, removeTransaction);
+    QVERIFY(scene->getItemKey(ids[1])._flags.none());
+    QVERIFY(scene->getItemBound(ids[1]) == AABox());
+    QVERIFY(scene->getItemBound(ids[2]) == items[2]->bound);
+}
+
+void SceneTests::testTransactionBudget() {
+    auto scene = createScene();
+    // the smallest budget lets a call process a single step
+    scene->setTransactionBudget(1);
+
+    const int NUM_ITEMS = 2 * (int)render::Scene::MAX_RESETS_PER_STEP + 10;
+    std::vector<render::ItemID> ids;
+    render::Transaction transaction;
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        auto id = scene->allocateID();
+        auto item = std::make_shared<TestItem>(AABox(glm::vec3((float)i), 1.0f));
+        transaction.resetItem(id, std::make_shared<TestItem::Payload>(item));
+        ids.push_back(id);
+    }
+    // the removal comes after all the resets of the frame
+    transaction.removeItem(ids[0]);
+    scene->enqueueTransaction(transaction);
+    scene->enqueueFrame();
+
+    render::Transaction nextTransaction;
+    nextTransaction.removeItem(ids[1]);
+    scene->enqueueTransaction(nextTransaction);
+    scene->enqueueFrame();
+
+    const int NUM_REMOVED = 2;
+    int numCalls = 0;
+    while (scene->hasPendingTransactions()) {
+        scene->processTransactionQueue();
+        ++numCalls;
+
+        // the resets are applied in order, skipping the first two items which are removed along the way
+        int numApplied = NUM_REMOVED;
+        while (numApplied < NUM_ITEMS && scene->getItem(ids[numApplied]).exist()) {
+            ++numApplied;
+        }
+        for (int i = numApplied; i < NUM_ITEMS; ++i) {
+            QVERIFY(!scene->getItem(ids[i]).exist());
+        }
+    }
+    QVERIFY(numCalls >= 3);
+    QVERIFY(!scene->getItem(ids[0]).exist());
+    QVERIFY(!scene->getItem(ids[1]).exist());
+    for (int i = NUM_REMOVED; i < NUM_ITEMS; ++i) {
+        QVERIFY(scene->getItem(ids[i]).exist());
+        QVERIFY(scene->getItemKey(ids[i]).isSpatial());
+    }
+
+    // flushing applies everything at once
+    render::Transaction removeTransaction;
+    for (int i = NUM_REMOVED; i < NUM_ITEMS; ++i) {
+        removeTransaction.removeItem(ids[i]);
+    }
+    scene->enqueueTransaction(removeTransaction);
+    scene->enqueueFrame();
+    scene->flushTransactionQueue();
+    QVERIFY(!scene->hasPendingTransactions());
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        QVERIFY(!scene->getItem(ids[i]).exist());
+    }
+}
+
+#ifdef MANUAL_TEST
+
+float randomFloat() {
+    return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+}
+
+void SceneTests::benchmark() {
+    const int NUM_ITEMS = 100000;
+    const float MAX_ITEM_SIZE = 20.0f;
+    auto scene = createScene();
+    render::Transaction transaction;
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        glm::vec3 corner = WORLD_WIDTH * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        float size = MAX_ITEM_SIZE * 0.5f * (randomFloat() + 1.0f);
+        auto item = std::make_shared<TestItem>(AABox(corner, size));
+        transaction.resetItem(scene->allocateID(), std::make_shared<TestItem::Payload>(item));
+    }
+    processTransaction(scene, transaction);
+
+    ViewFrustum frustum;
+    frustum.setPosition(glm::vec3(0.0f));
+    frustum.setOrientation(glm::quat());
+    frustum.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, WORLD_WIDTH));
+    frustum.calculate();
+    RenderArgs args;
+    args.setViewFrustum(frustum);
+    auto renderContext = std::make_shared<render::RenderContext>();
+    renderContext->args = &args;
+    renderContext->_scene = scene;
+    renderContext->jobConfig = std::make_shared<render::CullSpatialSelectionConfig>();
+
+    const render::ItemFilter filter = render::ItemFilter::Builder::visibleWorldItems();
+    const float LOD_ANGLE = 0.001f;
+    render::CullSpatialSelection cull([](const RenderArgs*, const AABox&) { return true; }, render::RenderDetails::ITEM);
+    render::CullSpatialSelection::Inputs inputs;
+    render::ItemBounds culledItems;
+
+    const int NUM_FRAMES = 20;
+    uint64_t selectTime = 0;
+    uint64_t cullTime = 0;
+    uint64_t payloadReadTime = 0;
+    uint64_t cachedReadTime = 0;
+    AABox payloadBounds;
+    AABox cachedBounds;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        auto& selection = inputs.edit0();
+        selection.clear();
+        inputs.edit1() = filter;
+        uint64_t start = usecTimestampNow();
+        scene->getSpatialTree().selectCellItems(selection, filter, frustum, LOD_ANGLE);
+        selectTime += usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        cull.run(renderContext, inputs, culledItems);
+        cullTime += usecTimestampNow() - start;
+
+        // read the key and bound of every selected item, through their payload then from the cache
+        start = usecTimestampNow();
+        for (auto id : selection.partialItems) {
+            auto& item = scene->getItem(id);
+            if (filter.test(item.getKey())) {
+                payloadBounds += item.getBound();
+            }
+        }
+        payloadReadTime += usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        for (auto id : selection.partialItems) {
+            if (filter.test(scene->getItemKey(id))) {
+                cachedBounds += scene->getItemBound(id);
+            }
+        }
+        cachedReadTime += usecTimestampNow() - start;
+    }
+    QVERIFY(payloadBounds == cachedBounds);
+
+    std::cout << NUM_ITEMS << " items, " << culledItems.size() << " in view:"
+        << "  select = " << (selectTime / NUM_FRAMES) << " usec"
+        << "  cull = " << (cullTime / NUM_FRAMES) << " usec"
+        << "  read through payloads = " << (payloadReadTime / NUM_FRAMES) << " usec"
+        << "  read from cache = " << (cachedReadTime / NUM_FRAMES) << " usec" << std::endl;
+}
+
+#endif // MANUAL_TEST
@@ -10,6 +10,11 @@
 
 #include "FileCacheTests.h"
 
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
 #include <shared/FileCache.h>
 
 QTEST_GUILESS_MAIN(FileCacheTests)
@@ -60,6 +65,7 @@ void FileCacheTests::testUnusedFiles() {
         QCOMPARE(cache->getNumTotalFiles(), (size_t)100);
         // Release the in-use files
         inUseFiles.clear();
+        cache->waitForEviction();
         QCOMPARE(cache->getNumCachedFiles(), (size_t)10);
         QCOMPARE(cache->getNumTotalFiles(), (size_t)10);
         QVERIFY(getCacheDirectorySize() <= MAX_UNUSED_SIZE);
@@ -156,6 +162,90 @@ void FileCacheTests::testWipe() {
     QCOMPARE(getCacheDirectorySize(), (size_t)0);
 }
 
+static const int NUM_CONCURRENT_THREADS { 8 };
+static const int NUM_CONCURRENT_KEYS { 64 };
+
+// Each thread reads the same keys in its own order, writing whatever is missing
+static void accessFiles(FileCachePointer cache, const QByteArray& data, int thread, int iterations) {
+    std::list<FilePointer> inUseFiles;
+    for (int i = 0; i < iterations; ++i) {
+        std::string key = getFileKey((i * (thread + 1) * 7) % NUM_CONCURRENT_KEYS);
+        auto file = cache->getFile(key);
+        if (!file) {
+            file = cache->writeFile(data.data(), FileCache::Metadata(key, data.size()));
+        }
+        // hold on to a few files at a time, so that some of them are in use while others get evicted
+        inUseFiles.push_back(file);
+        if (inUseFiles.size() > 4) {
+            inUseFiles.pop_front();
+        }
+    }
+}
+
+void FileCacheTests::testConcurrentAccess() {
+    QTemporaryDir testDir;
+    static const QByteArray SMALL_DATA { 1024 * 64, '0' };
+    // room for a quarter of the keys
+    static const size_t MAX_SIZE = SMALL_DATA.size() * NUM_CONCURRENT_KEYS / 4;
+
+    auto cache = std::make_shared<FileCache>(testDir.path().toStdString(), "tmp");
+    cache->initialize();
+    cache->setMaxSize(MAX_SIZE);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_CONCURRENT_THREADS; ++i) {
+        threads.emplace_back(accessFiles, cache, SMALL_DATA, i, 1000);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    cache->waitForEviction();
+
+    QCOMPARE(cache->getNumHits() + cache->getNumMisses(), (size_t)(NUM_CONCURRENT_THREADS * 1000));
+    QVERIFY(cache->getNumEvicted() > 0);
+    QCOMPARE(cache->getNumCachedFiles(), cache->getNumTotalFiles());
+    QVERIFY(cache->getSizeTotalFiles() <= MAX_SIZE);
+
+    // the counts must match what's left on disk
+    QDir dir(testDir.path());
+    QCOMPARE((size_t)dir.entryList({ "*.tmp" }).size(), cache->getNumTotalFiles());
+    for (int i = 0; i < NUM_CONCURRENT_KEYS; ++i) {
+        auto file = cache->getFile(getFileKey(i));
+        QCOMPARE((bool)file, QFileInfo(dir.absoluteFilePath(QString::fromStdString(getFileKey(i)) + ".tmp")).exists());
+    }
+}
+
+#ifdef MANUAL_TEST
+void FileCacheTests::benchmarkConcurrentAccess() {
+    static const QByteArray SMALL_DATA { 1024 * 16, '0' };
+    static const int ITERATIONS { 20000 };
+
+    for (int numThreads = 1; numThreads <= NUM_CONCURRENT_THREADS; numThreads *= 2) {
+        QTemporaryDir testDir;
+        auto cache = std::make_shared<FileCache>(testDir.path().toStdString(), "tmp");
+        cache->initialize();
+        // keep the cache over budget so that eviction runs throughout
+        cache->setMaxSize(SMALL_DATA.size() * NUM_CONCURRENT_KEYS / 2);
+
+        QElapsedTimer timer;
+        timer.start();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back(accessFiles, cache, SMALL_DATA, i, ITERATIONS);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto elapsed = timer.nsecsElapsed();
+
+        size_t operations = (size_t)(numThreads * ITERATIONS);
+        std::cout << numThreads << " threads: " << (double)elapsed / (double)operations << " ns/access, "
+            << cache->getNumHits() << " hits, " << cache->getNumMisses() << " misses, "
+            << cache->getNumEvicted() << " evicted, " << cache->getLockWaitTime() << " usec waiting on locks" << std::endl;
+    }
+}
+#endif
+
 
 void FileCacheTests::cleanupTestCase() {
 }
@@ -13,6 +13,8 @@
 #include <QtTest/QtTest>
 #include <QtCore/QTemporaryDir>
 
+//#define MANUAL_TEST
+
 class FileCacheTests : public QObject {
     Q_OBJECT
 private slots:
@@ -21,6 +23,10 @@ private slots:
     void testFreeSpacePreservation();
     void cleanupTestCase();
     void testWipe();
+    void testConcurrentAccess();
+#ifdef MANUAL_TEST
+    void benchmarkConcurrentAccess();
+#endif
 
 private:
     size_t getFreeSpace() const;
@@ -0,0 +1,225 @@
+//
+//  TaskTests.cpp
+//  tests/task/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TaskTests.h"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+#include <Profile.h>
+#include <SharedUtil.h>
+#include <task/Task.h>
+
+QTEST_MAIN(TaskTests)
+
+class TestContext : public task::JobContext {
+public:
+    TestContext() : task::JobContext(trace_app()) {}
+};
+using TestContextPointer = std::shared_ptr<TestContext>;
+
+Task_DeclareTypeAliases(TestContext)
+
+// the jobs log the values they output, in the order they run
+static std::mutex logMutex;
+static std::vector<int> outputLog;
+
+static void logOutput(int value) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    outputLog.push_back(value);
+}
+
+template <int VALUE>
+class Constant {
+public:
+    using JobModel = Job::ModelO<Constant, int>;
+
+    void run(const TestContextPointer& context, int& output) {
+        output = VALUE;
+        logOutput(output);
+    }
+};
+
+class Sum {
+public:
+    using Inputs = VaryingSet2<int, int>;
+    using JobModel = Job::ModelIO<Sum, Inputs, int>;
+
+    void run(const TestContextPointer& context, const Inputs& inputs, int& output) {
+        output = inputs.get0() + inputs.get1();
+        logOutput(output);
+    }
+};
+
+// Every job outputs a different value:
+//   A = 1, B = 2, C = A + B, D = 10, E = C + D, F = 100, G = B + F, H = E + G
+class TestTask {
+public:
+    using JobModel = Task::ModelO<TestTask, int>;
+
+    void build(JobModel& task, const Varying& input, Varying& output, bool parallel) {
+        task.setParallel(parallel);
+        const auto a = task.addJob<Constant<1>>("A");
+        const auto b = task.addJob<Constant<2>>("B");
+        const auto c = task.addJob<Sum>("C", Sum::Inputs(a, b).asVarying());
+        const auto d = task.addJob<Constant<10>>("D");
+        const auto e = task.addJob<Sum>("E", Sum::Inputs(c, d).asVarying());
+        const auto f = task.addJob<Constant<100>>("F");
+        const auto g = task.addJob<Sum>("G", Sum::Inputs(b, f).asVarying());
+        output = task.addJob<Sum>("H", Sum::Inputs(e, g).asVarying());
+    }
+};
+
+static const std::vector<int> TEST_TASK_OUTPUTS { 1, 2, 3, 10, 13, 100, 102, 115 };
+
+static std::vector<int> runTestTask(bool parallel, int& result) {
+    outputLog.clear();
+    Task task(TestTask::JobModel::create("TestTask", parallel));
+    task.run(std::make_shared<TestContext>());
+    result = task.getOutput().get<int>();
+    return outputLog;
+}
+
+void TaskTests::testDependencies() {
+    using Dependencies = task::JobGraph::Dependencies;
+
+    auto model = TestTask::JobModel::create("TestTask", false);
+    const auto& graph = model->getGraph();
+    QCOMPARE(graph.getNumJobs(), (uint32_t)8);
+    QVERIFY(graph.getDependencies(0).empty());
+    QVERIFY(graph.getDependencies(1).empty());
+    QVERIFY(graph.getDependencies(2) == Dependencies({ 0, 1 }));
+    QVERIFY(graph.getDependencies(3).empty());
+    QVERIFY(graph.getDependencies(4) == Dependencies({ 2, 3 }));
+    QVERIFY(graph.getDependencies(5).empty());
+    QVERIFY(graph.getDependencies(6) == Dependencies({ 1, 5 }));
+    QVERIFY(graph.getDependencies(7) == Dependencies({ 4, 6 }));
+
+    // a job that reads an element of the array output by another depends on it
+    using Array = VaryingArray<int, 3>;
+    task::JobGraph arrayGraph;
+    const Varying arrayOutput = Varying(Array());
+    arrayGraph.addJob(Varying(), arrayOutput);
+    QVERIFY(arrayGraph.addJob(arrayOutput.getN<Array>(2), Varying(0)) == Dependencies({ 0 }));
+    QVERIFY(arrayGraph.addJob(Varying(0), Varying(0)).empty());
+}
+
+void TaskTests::testParallelMatchesSequential() {
+    int sequentialResult = 0;
+    auto sequentialOutputs = runTestTask(false, sequentialResult);
+    QCOMPARE(sequentialResult, 115);
+    QVERIFY(sequentialOutputs == TEST_TASK_OUTPUTS);
+
+    const int NUM_RUNS = 100;
+    for (int i = 0; i < NUM_RUNS; ++i) {
+        int parallelResult = 0;
+        auto parallelOutputs = runTestTask(true, parallelResult);
+        QCOMPARE(parallelResult, sequentialResult);
+        std::sort(parallelOutputs.begin(), parallelOutputs.end());
+        QVERIFY(parallelOutputs == TEST_TASK_OUTPUTS);
+    }
+}
+
+void TaskTests::testParallelRespectsDependencies() {
+    const int NUM_RUNS = 100;
+    for (int i = 0; i < NUM_RUNS; ++i) {
+        int result = 0;
+        auto outputs = runTestTask(true, result);
+        auto position = [&](int value) {
+            return std::find(outputs.begin(), outputs.end(), value) - outputs.begin();
+        };
+        QVERIFY(position(1) < position(3));
+        QVERIFY(position(2) < position(3));
+        QVERIFY(position(3) < position(13));
+        QVERIFY(position(10) < position(13));
+        QVERIFY(position(2) < position(102));
+        QVERIFY(position(100) < position(102));
+        QVERIFY(position(13) < position(115));
+        QVERIFY(position(102) < position(115));
+    }
+}
+
+void TaskTests::testParallelTimerNames() {
+    PerformanceTimer::setActive(true);
+    int result = 0;
+    runTestTask(true, result);
+    auto records = PerformanceTimer::getAllTimerRecords();
+    PerformanceTimer::setActive(false);
+
+    // the jobs run on worker threads are timed under the task that ran them, not as top level timers
+    QCOMPARE(records.size(), 9);
+    QVERIFY(records.contains("/TestTask"));
+    for (auto jobName : { "A", "B", "C", "D", "E", "F", "G", "H" }) {
+        QVERIFY(records.contains(QString("/TestTask/") + jobName));
+    }
+}
+
+#ifdef MANUAL_TEST
+
+const uint32_t SPIN_ITERATIONS = 1000000;
+
+class Spin {
+public:
+    using JobModel = Job::ModelIO<Spin, int, int>;
+
+    void run(const TestContextPointer& context, const int& input, int& output) {
+        uint32_t x = (uint32_t)input;
+        for (uint32_t i = 0; i < SPIN_ITERATIONS; ++i) {
+            x = x * 1664525u + 1013904223u;
+        }
+        output = (int)x;
+    }
+};
+
+// Branches of jobs that each depend on the previous one of their branch
+class SpinTask {
+public:
+    using JobModel = Task::Model<SpinTask>;
+
+    void build(JobModel& task, const Varying& input, Varying& output, bool parallel, int numBranches, int depth) {
+        task.setParallel(parallel);
+        for (int branch = 0; branch < numBranches; ++branch) {
+            Varying spin = Varying(branch);
+            for (int level = 0; level < depth; ++level) {
+                const Varying spinInput = spin;
+                spin = task.addJob<Spin>("Spin" + std::to_string(branch) + "_" + std::to_string(level), spinInput);
+            }
+        }
+    }
+};
+
+void TaskTests::benchmark() {
+    const int NUM_FRAMES = 20;
+    const int DEPTH = 4;
+    auto context = std::make_shared<TestContext>();
+    for (int numBranches : { 1, 2, 4, 8 }) {
+        Task sequentialTask(SpinTask::JobModel::create("Sequential", false, numBranches, DEPTH));
+        Task parallelTask(SpinTask::JobModel::create("Parallel", true, numBranches, DEPTH));
+
+        uint64_t start = usecTimestampNow();
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            sequentialTask.run(context);
+        }
+        uint64_t sequentialTime = usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            parallelTask.run(context);
+        }
+        uint64_t parallelTime = usecTimestampNow() - start;
+
+        std::cout << numBranches << " branches of " << DEPTH << " jobs:"
+            << "  sequential = " << (sequentialTime / NUM_FRAMES) << " usec/frame"
+            << "  parallel = " << (parallelTime / NUM_FRAMES) << " usec/frame" << std::endl;
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,31 @@
+//
+//  TaskTests.h
+//  tests/task/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_task_TaskTests_h
+#define hifi_task_TaskTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class TaskTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testDependencies();
+    void testParallelMatchesSequential();
+    void testParallelRespectsDependencies();
+    void testParallelTimerNames();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_task_TaskTests_h
@@ -13,6 +13,8 @@
 
 #include <iostream>
 
+#include <glm/gtx/norm.hpp>
+
 #include <workload/Space.h>
 #include <StreamUtils.h>
 #include <SharedUtil.h>
@@ -100,6 +102,165 @@ void SpaceTests::testOverlaps() {
     }
 }
 
+// The proxies and the categorization of the original Space, which checked every proxy against every view
+class BruteForceSpace {
+public:
+    void setProxy(int32_t proxyId, const workload::Space::Sphere& sphere) {
+        if (proxyId >= (int32_t)spheres.size()) {
+            spheres.resize(proxyId + 1);
+            regions.resize(proxyId + 1, workload::Space::REGION_INVALID);
+        }
+        if (regions[proxyId] == workload::Space::REGION_INVALID) {
+            regions[proxyId] = workload::Space::REGION_UNKNOWN;
+        }
+        spheres[proxyId] = sphere;
+    }
+
+    void categorizeAndGetChanges(const std::vector<workload::Space::View>& views, std::vector<workload::Space::Change>& changes) {
+        for (uint32_t i = 0; i < (uint32_t)spheres.size(); ++i) {
+            if (regions[i] < workload::Space::REGION_INVALID) {
+                uint8_t region = workload::Space::REGION_UNKNOWN;
+                for (uint32_t j = 0; j < views.size(); ++j) {
+                    float distance2 = glm::distance2(views[j].center, glm::vec3(spheres[i]));
+                    for (uint8_t c = 0; c < region; ++c) {
+                        float touchDistance = views[j].radiuses[c] + spheres[i].w;
+                        if (distance2 < touchDistance * touchDistance) {
+                            region = c;
+                            break;
+                        }
+                    }
+                }
+                if (region != regions[i]) {
+                    changes.emplace_back(workload::Space::Change((int32_t)i, region, regions[i]));
+                    regions[i] = region;
+                }
+            }
+        }
+    }
+
+    std::vector<workload::Space::Sphere> spheres;
+    std::vector<uint8_t> regions;
+};
+
+void SpaceTests::testCategorizeMatchesBruteForce() {
+    // small cells so that there are many of them, several of which straddle the regions
+    const float CELL_SIZE = 20.0f;
+    const float WORLD_HALF_WIDTH = 200.0f;
+    const uint32_t NUM_PROXIES = 5000;
+    const uint32_t NUM_FRAMES = 50;
+    workload::Space space(CELL_SIZE);
+    BruteForceSpace bruteForce;
+
+    auto randomSphere = [&]() {
+        glm::vec3 center(randFloatInRange(-WORLD_HALF_WIDTH, WORLD_HALF_WIDTH), randFloatInRange(-WORLD_HALF_WIDTH, WORLD_HALF_WIDTH),
+                         randFloatInRange(-WORLD_HALF_WIDTH, WORLD_HALF_WIDTH));
+        return workload::Space::Sphere(center, randFloatInRange(0.1f, 10.0f));
+    };
+
+    std::vector<int32_t> proxyIds;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        workload::Space::Sphere sphere = randomSphere();
+        int32_t proxyId = space.createProxy(sphere);
+        bruteForce.setProxy(proxyId, sphere);
+        proxyIds.push_back(proxyId);
+    }
+
+    glm::vec3 viewCenter(0.0f);
+    for (uint32_t frame = 0; frame < NUM_FRAMES; ++frame) {
+        // move the views a little every frame, and change how many there are now and then
+        viewCenter += glm::vec3(1.0f, 0.25f, -0.5f);
+        std::vector<workload::Space::View> views;
+        views.push_back(workload::Space::View(viewCenter, 20.0f, 50.0f, 100.0f));
+        if (frame % 10 < 7) {
+            views.push_back(workload::Space::View(-viewCenter, 10.0f, 30.0f, 60.0f));
+        }
+        space.setViews(views);
+
+        // move some proxies, sometimes into another cell, delete a few and create new ones
+        for (uint32_t i = 0; i < NUM_PROXIES / 20; ++i) {
+            uint32_t index = rand() % proxyIds.size();
+            int32_t proxyId = proxyIds[index];
+            if (proxyId == -1) {
+                continue;
+            }
+            if (i % 10 == 0) {
+                space.deleteProxy(proxyId);
+                bruteForce.regions[proxyId] = workload::Space::REGION_INVALID;
+                proxyIds[index] = -1;
+            } else {
+                workload::Space::Sphere sphere = bruteForce.spheres[proxyId];
+                sphere += workload::Space::Sphere(randFloatInRange(-5.0f, 5.0f), randFloatInRange(-5.0f, 5.0f),
+                                                  randFloatInRange(-5.0f, 5.0f), 0.0f);
+                sphere.w *= randFloatInRange(0.5f, 1.5f);
+                space.updateProxy(proxyId, sphere);
+                bruteForce.setProxy(proxyId, sphere);
+            }
+        }
+        for (uint32_t i = 0; i < NUM_PROXIES / 100; ++i) {
+            workload::Space::Sphere sphere = randomSphere();
+            int32_t proxyId = space.createProxy(sphere);
+            bruteForce.setProxy(proxyId, sphere);
+            proxyIds.push_back(proxyId);
+        }
+
+        std::vector<workload::Space::Change> changes;
+        std::vector<workload::Space::Change> expectedChanges;
+        space.categorizeAndGetChanges(changes);
+        bruteForce.categorizeAndGetChanges(views, expectedChanges);
+        QCOMPARE(changes.size(), expectedChanges.size());
+        for (size_t i = 0; i < changes.size(); ++i) {
+            QCOMPARE(changes[i].proxyId, expectedChanges[i].proxyId);
+            QCOMPARE(changes[i].region, expectedChanges[i].region);
+            QCOMPARE(changes[i].prevRegion, expectedChanges[i].prevRegion);
+        }
+    }
+
+    // nothing changes when nothing moves
+    std::vector<workload::Space::Change> changes;
+    space.categorizeAndGetChanges(changes);
+    QVERIFY(changes.empty());
+}
+
+void SpaceTests::testCellsRecycled() {
+    const float CELL_SIZE = 1.0f;
+    workload::Space space(CELL_SIZE);
+    std::vector<workload::Space::View> views;
+    views.push_back(workload::Space::View(glm::vec3(0.0f), 5.0f, 10.0f, 20.0f));
+    space.setViews(views);
+
+    // a proxy that stays put, and one that crosses a hundred cells through every region
+    int32_t stillId = space.createProxy(workload::Space::Sphere(glm::vec3(0.0f, 100.0f, 0.0f), 0.1f));
+    int32_t movingId = space.createProxy(workload::Space::Sphere(glm::vec3(-50.0f, 0.0f, 0.0f), 0.1f));
+    std::vector<workload::Space::Change> changes;
+    space.categorizeAndGetChanges(changes);
+
+    uint8_t region = workload::Space::REGION_UNKNOWN;
+    for (int i = -50; i <= 50; ++i) {
+        glm::vec3 center((float)i + 0.5f, 0.0f, 0.0f);
+        space.updateProxy(movingId, workload::Space::Sphere(center, 0.1f));
+        changes.clear();
+        space.categorizeAndGetChanges(changes);
+        for (const auto& change : changes) {
+            QVERIFY(change.proxyId == movingId);
+            region = change.region;
+        }
+
+        // the emptied cell is reused for the next one
+        QCOMPARE(space.getNumCells(), (uint32_t)2);
+        QCOMPARE(space.getNumAllocatedCells(), (uint32_t)2);
+
+        float distance = glm::length(center);
+        uint8_t expected = distance < 5.1f ? workload::Space::REGION_NEAR : distance < 10.1f ? workload::Space::REGION_MIDDLE :
+            distance < 20.1f ? workload::Space::REGION_FAR : workload::Space::REGION_UNKNOWN;
+        QVERIFY(region == expected);
+    }
+
+    space.deleteProxy(movingId);
+    space.deleteProxy(stillId);
+    QCOMPARE(space.getNumCells(), (uint32_t)0);
+    QCOMPARE(space.getNumAllocatedCells(), (uint32_t)2);
+}
+
 #ifdef MANUAL_TEST
 
 const float WORLD_WIDTH = 1000.0f;
@@ -122,7 +283,7 @@ void generateSpheres(uint32_t numProxies, std::vector<workload::Space::Sphere>&
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
-                (MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS)) * randomFloat());
+                MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * 0.5f * (randomFloat() + 1.0f));
         spheres.push_back(sphere);
     }
 }
@@ -142,11 +303,13 @@ void generateRadiuses(uint32_t numRadiuses, std::vector<float>& radiuses) {
 }
 
 void SpaceTests::benchmark() {
-    uint32_t numProxies[] = { 100, 1000, 10000, 100000 };
-    uint32_t numTests = 4;
+    uint32_t numProxies[] = { 10000, 100000, 1000000 };
+    uint32_t numTests = 3;
     std::vector<uint64_t> timeToAddAll;
     std::vector<uint64_t> timeToRemoveAll;
     std::vector<uint64_t> timeToMoveView;
+    std::vector<uint64_t> timeToNudgeView;
+    std::vector<uint64_t> bruteForceTimeToNudgeView;
     std::vector<uint64_t> timeToMoveProxies;
     for (uint32_t i = 0; i < numTests; ++i) {
 
@@ -202,6 +365,37 @@ void SpaceTests::benchmark() {
         usec = usecTimestampNow() - startTime;
         timeToMoveView.push_back(usec);
 
+        // measure time to categorize after the views move a little, as they do every frame
+        BruteForceSpace bruteForce;
+        for (uint32_t j = 0; j < n; ++j) {
+            bruteForce.setProxy(proxyKeys[j], proxySpheres[j]);
+        }
+        std::vector<workload::Space::Change> bruteForceChanges;
+        const uint32_t NUM_NUDGES = 10;
+        uint64_t nudgeTime = 0;
+        uint64_t bruteForceNudgeTime = 0;
+        for (uint32_t k = 0; k <= NUM_NUDGES; ++k) {
+            std::vector<workload::Space::View> views;
+            glm::vec3 offset(0.5f * (float)k, 0.0f, 0.0f);
+            views.push_back(workload::Space::View(offset + glm::vec3(1.0f, 2.0f, 3.0f), 0.25f * WORLD_WIDTH, 0.50f * WORLD_WIDTH, 0.75f * WORLD_WIDTH));
+            views.push_back(workload::Space::View(offset + glm::vec3(1.0f, 2.0f, 3.0f + 0.1f * WORLD_WIDTH), 0.25f * WORLD_WIDTH, 0.50f * WORLD_WIDTH, 0.75f * WORLD_WIDTH));
+            space.setViews(views);
+            changes.clear();
+            bruteForceChanges.clear();
+            startTime = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            uint64_t midTime = usecTimestampNow();
+            bruteForce.categorizeAndGetChanges(views, bruteForceChanges);
+            // the first pass brings the brute force regions up to date
+            if (k > 0) {
+                nudgeTime += midTime - startTime;
+                bruteForceNudgeTime += usecTimestampNow() - midTime;
+                QCOMPARE(changes.size(), bruteForceChanges.size());
+            }
+        }
+        timeToNudgeView.push_back(nudgeTime / NUM_NUDGES);
+        bruteForceTimeToNudgeView.push_back(bruteForceNudgeTime / NUM_NUDGES);
+
         // move every 10th proxy around
         const float proxySpeed = 1.0f;
         std::vector<workload::Space::Sphere> newSpheres;
@@ -254,6 +448,13 @@ void SpaceTests::benchmark() {
     }
     std::cout << "];" << std::endl;
 
+    std::cout << "[numProxies, timeToNudgeView, bruteForceTimeToNudgeView] = [" << std::endl;
+    for (uint32_t i = 0; i < timeToNudgeView.size(); ++i) {
+        uint32_t n = numProxies[i];
+        std::cout << "    " << n << ", " << timeToNudgeView[i] << ", " << bruteForceTimeToNudgeView[i] << std::endl;
+    }
+    std::cout << "];" << std::endl;
+
     std::cout << "[numProxies, timeToMoveProxies] = [" << std::endl;
     for (uint32_t i = 0; i < timeToMoveProxies.size(); ++i) {
         uint32_t n = numProxies[i];